@@ -182,6 +182,12 @@ typedef struct {
 /** Enable/disable support for deadline checking. Defaults to 1, unless
     GRPC_ARG_MINIMAL_STACK is enabled, in which case it defaults to 0 */
 #define GRPC_ARG_ENABLE_DEADLINE_CHECKS "grpc.enable_deadline_checking"
+/** If non-zero, op batches jump over the filters that declared they do not
+    act on any of the batch's ops, instead of calling through them. Defaults
+    to 0: nothing yet checks that the ops a filter declares match what its
+    batch handler actually does, and a wrong declaration silently drops that
+    filter's work. */
+#define GRPC_ARG_SKIP_PASSTHROUGH_FILTERS "grpc.skip_passthrough_filters"
 /** Initial stream ID for http2 transports. Int valued. */
 #define GRPC_ARG_HTTP2_INITIAL_SEQUENCE_NUMBER \
   "grpc.http2.initial_sequence_number"
@@ -190,12 +196,25 @@ typedef struct {
     NOTE: at some point we'd like to auto-tune this, and this parameter
     will become a no-op. Int valued, bytes. */
 #define GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES "grpc.http2.lookahead_bytes"
+/** Upper bound, in bytes, on the receive window shared by all streams of one
+    HTTP2 connection. Each stream is given a share of this budget in
+    proportion to how quickly the application has been consuming its data,
+    and the budget shrinks further under resource quota memory pressure.
+    Int valued. Defaults to 0, which disables the budget. */
+#define GRPC_ARG_HTTP2_STREAM_MEMORY_BUDGET "grpc.http2.stream_memory_budget"
 /** How much memory to use for hpack decoding. Int valued, bytes. */
 #define GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_DECODER \
   "grpc.http2.hpack_table_size.decoder"
 /** How much memory to use for hpack encoding. Int valued, bytes. */
 #define GRPC_ARG_HTTP2_HPACK_TABLE_SIZE_ENCODER \
   "grpc.http2.hpack_table_size.encoder"
+/** Should the hpack encoder track the peer's dynamic table exactly and admit
+    new entries by estimated frequency, instead of using its fixed-size
+    approximate tables? Trades a little memory per connection for better
+    compression of workloads with many distinct headers. Defaults to off
+    (0). */
+#define GRPC_ARG_HTTP2_HPACK_ENCODER_EXACT_INDEX \
+  "grpc.http2.hpack_encoder_exact_index"
 /** How big a frame are we willing to receive via HTTP2.
     Min 16384, max 16777215. Larger values give lower CPU usage for large
     messages, but more head of line blocking for small messages. */
@@ -232,6 +251,20 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** Upper bound on how many bytes the http2 transport gathers for a single
+    write to the endpoint. Int valued, bytes. Defaults to 1MB. */
+#define GRPC_ARG_HTTP2_TARGET_WRITE_SIZE "grpc.http2.target_write_size"
+/** Should the http2 transport size each write from its bandwidth-delay product
+    estimate (bounded above by GRPC_ARG_HTTP2_TARGET_WRITE_SIZE) rather than
+    always filling up to GRPC_ARG_HTTP2_TARGET_WRITE_SIZE? Has no effect when
+    BDP probing is disabled. Defaults to off (0). */
+#define GRPC_ARG_HTTP2_ADAPTIVE_WRITE_SIZE "grpc.http2.adaptive_write_size"
+/** How the http2 transport shares each write between streams with data to
+    send. "drr" (deficit round robin, the default) gives every stream a
+    turn of one frame per unit of weight; "fifo" lets each stream flush
+    everything flow control allows before the next stream goes. String
+    valued. */
+#define GRPC_ARG_HTTP2_STREAM_SCHEDULER "grpc.http2.stream_scheduler"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -262,12 +295,49 @@ typedef struct {
 /** The time between the first and second connection attempts, in ms */
 #define GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS \
   "grpc.initial_reconnect_backoff_ms"
+/** Maximum number of connections a subchannel keeps open to its address.
+    When greater than 1, another connection is opened whenever every existing
+    connection carries GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION active
+    streams, and each new call is started on the connection with the fewest
+    active streams. Defaults to 1. */
+#define GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS "grpc.subchannel.max_connections"
+/** Number of active streams at which a subchannel connection is considered
+    saturated. Only used when GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS is greater
+    than 1. Defaults to 100. */
+#define GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION \
+  "grpc.subchannel.streams_per_connection"
+/** Number of connections without active streams that a subchannel keeps
+    open ahead of demand, so that a burst of calls does not wait for new
+    connections. The connection that makes the subchannel READY counts, and
+    the pool never exceeds GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS. Only used
+    when GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS is greater than 1. Defaults
+    to 0. */
+#define GRPC_ARG_SUBCHANNEL_SPARE_CONNECTIONS \
+  "grpc.subchannel.spare_connections"
 /** Minimum amount of time between DNS resolutions, in ms */
 #define GRPC_ARG_DNS_MIN_TIME_BETWEEN_RESOLUTIONS_MS \
   "grpc.dns_min_time_between_resolutions_ms"
 /** The timeout used on servers for finishing handshaking on an incoming
     connection.  Defaults to 120 seconds. */
 #define GRPC_ARG_SERVER_HANDSHAKE_TIMEOUT_MS "grpc.server_handshake_timeout_ms"
+/** If non-zero, turns on admission control for calls waiting on the server
+    to be matched to a call requested by the application. Once the time such
+    calls spend waiting has stayed above this target for a whole
+    GRPC_ARG_SERVER_QUEUE_DELAY_INTERVAL_MS, calls that waited longer than the
+    target are rejected with RESOURCE_EXHAUSTED, and calls whose deadline has
+    passed are dropped instead of being handed to the application. Int valued,
+    milliseconds. Defaults to 0 (off). */
+#define GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS \
+  "grpc.server_queue_delay_target_ms"
+/** See GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS. Int valued, milliseconds.
+    Defaults to 100. */
+#define GRPC_ARG_SERVER_QUEUE_DELAY_INTERVAL_MS \
+  "grpc.server_queue_delay_interval_ms"
+/** If non-zero, calls waiting on the server to be matched to a call requested
+    by the application are matched earliest deadline first instead of in
+    arrival order. Calls with the same deadline are matched in arrival order.
+    Int valued, 0 or 1. Defaults to 0. */
+#define GRPC_ARG_SERVER_EDF_PENDING_CALLS "grpc.server_edf_pending_calls"
 /** This *should* be used for testing only.
     The caller of the secure_channel_create functions may override the target
     name used for SSL host name checking using this channel argument which is of
@@ -297,6 +367,10 @@ typedef struct {
  * grpc_resource_quota*). (use grpc_resource_quota_arg_vtable() to fetch an
  * appropriate pointer arg vtable) */
 #define GRPC_ARG_RESOURCE_QUOTA "grpc.resource_quota"
+/** Maximum number of call arenas a channel keeps for reuse by later calls
+    (default 4). Cached arenas are charged to the channel's resource quota.
+    Zero disables the pooling. */
+#define GRPC_ARG_CALL_ARENA_POOL_SIZE "grpc.call_arena_pool_size"
 /** If non-zero, expand wildcard addresses to a list of local addresses. */
 #define GRPC_ARG_EXPAND_WILDCARD_ADDRS "grpc.expand_wildcard_addrs"
 /** Service config data in JSON form.
@@ -307,6 +381,17 @@ typedef struct {
   "grpc.service_config_disable_resolution"
 /** LB policy name. */
 #define GRPC_ARG_LB_POLICY_NAME "grpc.lb_policy_name"
+/** Percentage of the addresses in a resolver update that must be READY
+ * before the round_robin, least_request or weighted_round_robin policies
+ * start sending RPCs to them, unless none of the rest can still connect.
+ * Until then, RPCs stay queued (first update) or keep using the previous
+ * addresses. Int valued, 0 to 100; 0 (the default) means one READY address
+ * is enough. */
+#define GRPC_ARG_LB_WARMUP_READY_PERCENT "grpc.lb.warmup_ready_percent"
+/** If non-zero, the client channel starts resolving and connecting as soon
+ * as it is created, rather than on the first RPC or an explicit connectivity
+ * check with try_to_connect set. Defaults to 0. */
+#define GRPC_ARG_CLIENT_CHANNEL_WARMUP "grpc.client_channel.warmup"
 /** The grpc_socket_mutator instance that set the socket options. A pointer. */
 #define GRPC_ARG_SOCKET_MUTATOR "grpc.socket_mutator"
 /** The grpc_socket_factory instance to create and bind sockets. A pointer. */
@@ -22,6 +22,8 @@
 #include <cstring>
 #include <map>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 #include <grpc/impl/codegen/compression_types.h>
 #include <grpc/impl/codegen/grpc_types.h>
@@ -525,12 +527,21 @@ class DeserializeFuncType final : public DeserializeFunc {
 
 class CallOpGenericRecvMessage {
  public:
+  CallOpGenericRecvMessage() = default;
+  CallOpGenericRecvMessage(const CallOpGenericRecvMessage&) = delete;
+  CallOpGenericRecvMessage& operator=(const CallOpGenericRecvMessage&) =
+      delete;
+  ~CallOpGenericRecvMessage() { ResetDeserializer(); }
+
   template <class R>
   void RecvMessage(R* message) {
-    // Use an explicit base class pointer to avoid resolution error in the
-    // following unique_ptr::reset for some old implementations.
-    DeserializeFunc* func = new DeserializeFuncType<R>(message);
-    deserialize_.reset(func);
+    // Every DeserializeFuncType<R> holds a single pointer, so it is built in
+    // place rather than allocated on every read.
+    static_assert(
+        sizeof(DeserializeFuncType<R>) <= sizeof(deserialize_storage_),
+        "DeserializeFuncType does not fit its inline storage");
+    ResetDeserializer();
+    deserialize_ = new (&deserialize_storage_) DeserializeFuncType<R>(message);
     message_ = message;
   }
 
@@ -589,7 +600,7 @@ class CallOpGenericRecvMessage {
     interceptor_methods->AddInterceptionHookPoint(
         experimental::InterceptionHookPoints::POST_RECV_MESSAGE);
     if (!got_message) interceptor_methods->SetRecvMessage(nullptr, nullptr);
-    deserialize_.reset();
+    ResetDeserializer();
   }
   void SetHijackingState(InterceptorBatchMethodsImpl* interceptor_methods) {
     hijacked_ = true;
@@ -608,8 +619,17 @@ class CallOpGenericRecvMessage {
     }
   }
 
+  void ResetDeserializer() {
+    if (deserialize_ == nullptr) return;
+    deserialize_->~DeserializeFunc();
+    deserialize_ = nullptr;
+  }
+
   void* message_ = nullptr;
-  std::unique_ptr<DeserializeFunc> deserialize_;
+  DeserializeFunc* deserialize_ = nullptr;  // Points into deserialize_storage_
+  typename std::aligned_storage<sizeof(DeserializeFuncType<ByteBuffer>),
+                                alignof(DeserializeFuncType<ByteBuffer>)>::type
+      deserialize_storage_;
   ByteBuffer recv_buf_;
   bool allow_not_getting_message_ = false;
   bool hijacked_ = false;
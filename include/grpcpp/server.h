@@ -173,6 +173,10 @@ class Server : public ServerInterface, private GrpcLibraryCodegen {
   ///
   /// \param sync_cq_timeout_msec The timeout to use when calling AsyncNext() on
   /// server completion queues passed via sync_server_cqs param.
+  ///
+  /// \param sync_thread_per_core If true, \a min_pollers and \a max_pollers
+  /// are ignored and each server completion queue is polled by exactly one
+  /// thread, pinned to its own core where the platform allows it.
   Server(ChannelArguments* args,
          std::shared_ptr<std::vector<std::unique_ptr<ServerCompletionQueue>>>
              sync_server_cqs,
@@ -184,7 +188,8 @@ class Server : public ServerInterface, private GrpcLibraryCodegen {
          std::vector<
              std::unique_ptr<experimental::ServerInterceptorFactoryInterface>>
              interceptor_creators = std::vector<std::unique_ptr<
-                 experimental::ServerInterceptorFactoryInterface>>());
+                 experimental::ServerInterceptorFactoryInterface>>(),
+         bool sync_thread_per_core = false);
 
   /// Start the server.
   ///
@@ -200,6 +200,17 @@ class ServerBuilder {
     return *this;
   }
 
+  /// Enable load shedding by queue delay. Once incoming calls that are
+  /// waiting to be requested by the application have waited longer than
+  /// \a target_ms for at least \a interval_ms, the server rejects them with
+  /// \a grpc::StatusCode::RESOURCE_EXHAUSTED. A \a target_ms of 0 (the
+  /// default) disables shedding.
+  ServerBuilder& SetQueueDelayTarget(int target_ms, int interval_ms = 100) {
+    queue_delay_target_ms_ = target_ms;
+    queue_delay_interval_ms_ = interval_ms;
+    return *this;
+  }
+
   /// \deprecated For backward compatibility.
   ServerBuilder& SetMaxMessageSize(int max_message_size) {
     return SetMaxReceiveMessageSize(max_message_size);
@@ -230,10 +241,17 @@ class ServerBuilder {
 
   /// Options for synchronous servers.
   enum SyncServerOption {
-    NUM_CQS,         ///< Number of completion queues.
-    MIN_POLLERS,     ///< Minimum number of polling threads.
-    MAX_POLLERS,     ///< Maximum number of polling threads.
-    CQ_TIMEOUT_MSEC  ///< Completion queue timeout in milliseconds.
+    NUM_CQS,          ///< Number of completion queues.
+    MIN_POLLERS,      ///< Minimum number of polling threads.
+    MAX_POLLERS,      ///< Maximum number of polling threads.
+    CQ_TIMEOUT_MSEC,  ///< Completion queue timeout in milliseconds.
+    /// If nonzero, use one completion queue per core, each polled by a single
+    /// thread pinned to its core, instead of NUM_CQS, MIN_POLLERS and
+    /// MAX_POLLERS. Handlers run on that thread. While it runs one, a single
+    /// overflow thread on the same core polls in its place, so handlers must
+    /// not block: once both threads are busy, every call bound to that core
+    /// waits for one of them to finish.
+    THREAD_PER_CORE
   };
 
   /// Only useful if this is a Synchronous server.
@@ -365,7 +383,11 @@ class ServerBuilder {
 
   struct SyncServerSettings {
     SyncServerSettings()
-        : num_cqs(1), min_pollers(1), max_pollers(2), cq_timeout_msec(10000) {}
+        : num_cqs(1),
+          min_pollers(1),
+          max_pollers(2),
+          cq_timeout_msec(10000),
+          thread_per_core(false) {}
 
     /// Number of server completion queues to create to listen to incoming RPCs.
     int num_cqs;
@@ -380,10 +402,16 @@ class ServerBuilder {
 
     /// The timeout for server completion queue's AsyncNext call.
     int cq_timeout_msec;
+
+    /// Whether to use one completion queue and one pinned polling thread per
+    /// core instead of num_cqs, min_pollers and max_pollers.
+    bool thread_per_core;
   };
 
   int max_receive_message_size_;
   int max_send_message_size_;
+  int queue_delay_target_ms_;
+  int queue_delay_interval_ms_;
   std::vector<std::unique_ptr<grpc::ServerBuilderOption>> options_;
   std::vector<std::unique_ptr<NamedService>> services_;
   std::vector<Port> ports_;
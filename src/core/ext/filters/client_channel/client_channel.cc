@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <set>
+#include <thread>
 
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
@@ -1638,7 +1639,8 @@ void ClientChannel::UpdateStateAndPickerLocked(
   // the refs until after we release the lock, and then unref them at
   // that point.  This includes the following:
   // - refs to subchannel wrappers in the keys of pending_subchannel_updates_
-  // - ownership of the existing picker in picker_
+  // - ownership of the picker snapshots displaced by the new one
+  std::vector<std::unique_ptr<PickerSnapshot>> stale_snapshots;
   {
     MutexLock lock(&data_plane_mu_);
     // Handle subchannel updates.
@@ -1654,9 +1656,20 @@ void ClientChannel::UpdateStateAndPickerLocked(
       // we wait until we've released the lock to clear the map.
       p.first->set_connected_subchannel_in_data_plane(std::move(p.second));
     }
-    // Swap out the picker.
-    // Note: Original value will be destroyed after the lock is released.
-    picker_.swap(picker);
+    // Publish the new picker along with the connected subchannels it may
+    // return, so that picks need not consult the subchannel wrappers.
+    auto snapshot = absl::make_unique<PickerSnapshot>();
+    snapshot->picker = std::move(picker);
+    snapshot->generation = ++picker_generation_;
+    for (SubchannelWrapper* subchannel_wrapper : subchannel_wrappers_) {
+      ConnectedSubchannel* connected_subchannel =
+          subchannel_wrapper->connected_subchannel_in_data_plane();
+      if (connected_subchannel != nullptr) {
+        snapshot->connected_subchannels.emplace(subchannel_wrapper,
+                                                connected_subchannel->Ref());
+      }
+    }
+    PublishPickerSnapshotLocked(std::move(snapshot), &stale_snapshots);
     // Re-process queued picks.
     for (LbQueuedCall* call = lb_queued_calls_; call != nullptr;
          call = call->next) {
@@ -1678,7 +1691,7 @@ grpc_error_handle ClientChannel::DoPingLocked(grpc_transport_op* op) {
   LoadBalancingPolicy::PickResult result;
   {
     MutexLock lock(&data_plane_mu_);
-    result = picker_->Pick(LoadBalancingPolicy::PickArgs());
+    result = picker_snapshot()->picker->Pick(LoadBalancingPolicy::PickArgs());
   }
   ConnectedSubchannel* connected_subchannel = nullptr;
   if (result.subchannel != nullptr) {
@@ -1810,15 +1823,46 @@ void ClientChannel::RemoveLbQueuedCall(LbQueuedCall* to_remove,
   }
 }
 
-RefCountedPtr<ConnectedSubchannel>
-ClientChannel::GetConnectedSubchannelInDataPlane(
-    SubchannelInterface* subchannel) const {
-  SubchannelWrapper* subchannel_wrapper =
-      static_cast<SubchannelWrapper*>(subchannel);
-  ConnectedSubchannel* connected_subchannel =
-      subchannel_wrapper->connected_subchannel_in_data_plane();
-  if (connected_subchannel == nullptr) return nullptr;
-  return connected_subchannel->Ref();
+void ClientChannel::PublishPickerSnapshotLocked(
+    std::unique_ptr<PickerSnapshot> snapshot,
+    std::vector<std::unique_ptr<PickerSnapshot>>* stale) {
+  const int previous = active_picker_slot_.load(std::memory_order_relaxed);
+  PickerSlot& next_slot = picker_slots_[1 - previous];
+  // Picks still reading the inactive slot are bounded by the time of one
+  // Pick() call, which never blocks.
+  while (next_slot.readers.load() != 0) {
+    std::this_thread::yield();
+  }
+  if (next_slot.snapshot != nullptr) {
+    stale->push_back(std::move(next_slot.snapshot));
+  }
+  next_slot.snapshot = std::move(snapshot);
+  active_picker_slot_.store(1 - previous);
+  // Reclaim the displaced snapshot now if nothing is reading it, rather
+  // than holding its picker until the next update.  Readers that arrive
+  // from here on see the flipped index and retry.
+  PickerSlot& previous_slot = picker_slots_[previous];
+  if (previous_slot.readers.load() == 0 && previous_slot.snapshot != nullptr) {
+    stale->push_back(std::move(previous_slot.snapshot));
+  }
+}
+
+ClientChannel::PickerSlot* ClientChannel::AcquirePickerSlot() {
+  while (true) {
+    const int index = active_picker_slot_.load();
+    PickerSlot* slot = &picker_slots_[index];
+    slot->readers.fetch_add(1);
+    // Only once registered as a reader is the slot safe from reuse; if it
+    // went inactive in the meantime, retry with the new one.
+    if (active_picker_slot_.load() == index) {
+      if (slot->snapshot == nullptr || slot->snapshot->picker == nullptr) {
+        ReleasePickerSlot(slot);
+        return nullptr;
+      }
+      return slot;
+    }
+    ReleasePickerSlot(slot);
+  }
 }
 
 void ClientChannel::TryToConnectLocked() {
@@ -2257,6 +2301,13 @@ grpc_error_handle ClientChannel::CallData::ApplyServiceConfigToCallLocked(
           *send_initial_metadata_flags &= ~GRPC_INITIAL_METADATA_WAIT_FOR_READY;
         }
       }
+      // Pass the stream weight on to the transport, which reads it when the
+      // call's initial metadata is sent.
+      if (method_params->stream_weight() != 0) {
+        call_context_[GRPC_CONTEXT_STREAM_WEIGHT].value =
+            reinterpret_cast<void*>(
+                static_cast<uintptr_t>(method_params->stream_weight()));
+      }
     }
     // Set the dynamic filter stack.
     dynamic_filters_ = chand->dynamic_filters_;
@@ -2559,6 +2610,10 @@ ClientChannel::LoadBalancedCall::~LoadBalancedCall() {
   for (size_t i = 0; i < GPR_ARRAY_SIZE(pending_batches_); ++i) {
     GPR_ASSERT(pending_batches_[i] == nullptr);
   }
+  if (polling_for_connection_) {
+    grpc_polling_entity_del_from_pollset_set(pollent_,
+                                             chand_->interested_parties_);
+  }
   if (on_call_destruction_complete_ != nullptr) {
     ExecCtx::Run(DEBUG_LOCATION, on_call_destruction_complete_,
                  GRPC_ERROR_NONE);
@@ -2818,8 +2873,22 @@ void ClientChannel::LoadBalancedCall::
 }
 
 void ClientChannel::LoadBalancedCall::CreateSubchannelCall() {
+  // If the subchannel keeps more than one connection, this picks the
+  // least loaded one.
+  bool connection_requested = false;
+  RefCountedPtr<ConnectedSubchannel> connected_subchannel =
+      connected_subchannel_->PickConnection(&connection_requested);
+  connected_subchannel_.reset();
+  // Nothing else polls for a pooled connection attempt while no calls are
+  // queued, so the calls started while it is in flight poll until they are
+  // destroyed.
+  if (connection_requested) {
+    grpc_polling_entity_add_to_pollset_set(pollent_,
+                                           chand_->interested_parties_);
+    polling_for_connection_ = true;
+  }
   SubchannelCall::Args call_args = {
-      std::move(connected_subchannel_), pollent_, path_, call_start_time_,
+      std::move(connected_subchannel), pollent_, path_, call_start_time_,
       deadline_, arena_,
       // TODO(roth): When we implement hedging support, we will probably
       // need to use a separate call context for each subchannel call.
@@ -2953,10 +3022,13 @@ const char* PickResultTypeName(
 void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
                                                      grpc_error_handle error) {
   auto* self = static_cast<LoadBalancedCall*>(arg);
-  bool pick_complete;
-  {
+  LoadBalancingPolicy::PickResult result;
+  uint64_t generation = 0;
+  bool pick_complete =
+      self->PickSubchannelWithoutLock(&error, &result, &generation);
+  if (!pick_complete) {
     MutexLock lock(&self->chand_->data_plane_mu_);
-    pick_complete = self->PickSubchannelLocked(&error);
+    pick_complete = self->PickSubchannelLocked(&error, &result, generation);
   }
   if (pick_complete) {
     PickDone(self, error);
@@ -2964,25 +3036,17 @@ void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
   }
 }
 
-bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
-    grpc_error_handle* error) {
-  GPR_ASSERT(connected_subchannel_ == nullptr);
-  GPR_ASSERT(subchannel_call_ == nullptr);
-  // Grab initial metadata.
-  auto& send_initial_metadata =
-      pending_batches_[0]->payload->send_initial_metadata;
-  grpc_metadata_batch* initial_metadata_batch =
-      send_initial_metadata.send_initial_metadata;
-  const uint32_t send_initial_metadata_flags =
-      send_initial_metadata.send_initial_metadata_flags;
-  // Perform LB pick.
+LoadBalancingPolicy::PickResult ClientChannel::LoadBalancedCall::Pick(
+    LoadBalancingPolicy::SubchannelPicker* picker) {
   LoadBalancingPolicy::PickArgs pick_args;
   pick_args.path = StringViewFromSlice(path_);
   LbCallState lb_call_state(this);
   pick_args.call_state = &lb_call_state;
-  Metadata initial_metadata(this, initial_metadata_batch);
+  Metadata initial_metadata(
+      this, pending_batches_[0]
+                ->payload->send_initial_metadata.send_initial_metadata);
   pick_args.initial_metadata = &initial_metadata;
-  auto result = chand_->picker_->Pick(pick_args);
+  auto result = picker->Pick(pick_args);
   if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
     gpr_log(
         GPR_INFO,
@@ -2990,6 +3054,70 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
         chand_, this, PickResultTypeName(result.type), result.subchannel.get(),
         grpc_error_std_string(result.error).c_str());
   }
+  return result;
+}
+
+void ClientChannel::LoadBalancedCall::OnPickComplete(
+    const PickerSnapshot& snapshot, LoadBalancingPolicy::PickResult* result,
+    grpc_error_handle* error) {
+  // Handle drops.
+  if (GPR_UNLIKELY(result->subchannel == nullptr)) {
+    result->error = grpc_error_set_int(
+        grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                               "Call dropped by load balancing policy"),
+                           GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE),
+        GRPC_ERROR_INT_LB_POLICY_DROP, 1);
+  } else {
+    // The snapshot holds the connected subchannel of every subchannel its
+    // picker can return.
+    auto it = snapshot.connected_subchannels.find(
+        static_cast<SubchannelWrapper*>(result->subchannel.get()));
+    GPR_ASSERT(it != snapshot.connected_subchannels.end());
+    connected_subchannel_ = it->second;
+  }
+  lb_recv_trailing_metadata_ready_ = result->recv_trailing_metadata_ready;
+  *error = result->error;
+}
+
+bool ClientChannel::LoadBalancedCall::PickSubchannelWithoutLock(
+    grpc_error_handle* error, LoadBalancingPolicy::PickResult* result,
+    uint64_t* generation) {
+  GPR_ASSERT(connected_subchannel_ == nullptr);
+  GPR_ASSERT(subchannel_call_ == nullptr);
+  PickerSlot* slot = chand_->AcquirePickerSlot();
+  if (slot == nullptr) return false;
+  *result = Pick(slot->snapshot->picker.get());
+  // Anything but a completed pick may involve the queued picks list, so is
+  // left to PickSubchannelLocked().  It reuses the result unless the picker
+  // has changed in the meantime, so that the picker is not asked twice.
+  const bool pick_complete =
+      result->type == LoadBalancingPolicy::PickResult::PICK_COMPLETE;
+  if (pick_complete) {
+    OnPickComplete(*slot->snapshot, result, error);
+  } else {
+    *generation = slot->snapshot->generation;
+  }
+  ReleasePickerSlot(slot);
+  return pick_complete;
+}
+
+bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
+    grpc_error_handle* error,
+    LoadBalancingPolicy::PickResult* unfinished_result, uint64_t generation) {
+  GPR_ASSERT(connected_subchannel_ == nullptr);
+  GPR_ASSERT(subchannel_call_ == nullptr);
+  const uint32_t send_initial_metadata_flags =
+      pending_batches_[0]
+          ->payload->send_initial_metadata.send_initial_metadata_flags;
+  // Perform LB pick, unless the current picker already has.
+  PickerSnapshot* snapshot = chand_->picker_snapshot();
+  LoadBalancingPolicy::PickResult result;
+  if (generation != 0 && snapshot->generation == generation) {
+    result = std::move(*unfinished_result);
+  } else {
+    if (generation != 0) GRPC_ERROR_UNREF(unfinished_result->error);
+    result = Pick(snapshot->picker.get());
+  }
   switch (result.type) {
     case LoadBalancingPolicy::PickResult::PICK_FAILED: {
       // If we're shutting down, fail all RPCs.
@@ -3022,23 +3150,7 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
       return false;
     default:  // PICK_COMPLETE
       MaybeRemoveCallFromLbQueuedCallsLocked();
-      // Handle drops.
-      if (GPR_UNLIKELY(result.subchannel == nullptr)) {
-        result.error = grpc_error_set_int(
-            grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
-                                   "Call dropped by load balancing policy"),
-                               GRPC_ERROR_INT_GRPC_STATUS,
-                               GRPC_STATUS_UNAVAILABLE),
-            GRPC_ERROR_INT_LB_POLICY_DROP, 1);
-      } else {
-        // Grab a ref to the connected subchannel while we're still
-        // holding the data plane mutex.
-        connected_subchannel_ =
-            chand_->GetConnectedSubchannelInDataPlane(result.subchannel.get());
-        GPR_ASSERT(connected_subchannel_ != nullptr);
-      }
-      lb_recv_trailing_metadata_ready_ = result.recv_trailing_metadata_ready;
-      *error = result.error;
+      OnPickComplete(*snapshot, &result, error);
       return true;
   }
 }
@@ -19,10 +19,12 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/types/optional.h"
@@ -141,6 +143,22 @@ class ClientChannel {
   class ResolverResultHandler;
   class SubchannelWrapper;
   class ClientChannelControlHelper;
+
+  // A picker together with the data plane connected subchannels of the
+  // subchannels it may return.  Immutable once published.
+  struct PickerSnapshot {
+    std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker;
+    std::map<SubchannelWrapper*, RefCountedPtr<ConnectedSubchannel>>
+        connected_subchannels;
+    // Increases with every snapshot published on the channel.
+    uint64_t generation = 0;
+  };
+
+  // One of the two slots in which the current PickerSnapshot is published.
+  struct PickerSlot {
+    std::atomic<int> readers{0};
+    std::unique_ptr<PickerSnapshot> snapshot;
+  };
   class ConnectivityWatcherAdder;
   class ConnectivityWatcherRemover;
 
@@ -265,10 +283,26 @@ class ClientChannel {
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
   void RemoveLbQueuedCall(LbQueuedCall* to_remove, grpc_polling_entity* pollent)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
-  RefCountedPtr<ConnectedSubchannel> GetConnectedSubchannelInDataPlane(
-      SubchannelInterface* subchannel) const
+  PickerSnapshot* picker_snapshot() const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_) {
+    return picker_slots_[active_picker_slot_.load(std::memory_order_relaxed)]
+        .snapshot.get();
+  }
+  // Publishes snapshot as the active picker.  Snapshots it displaces are
+  // moved to *stale, to be destroyed once the lock is released.
+  void PublishPickerSnapshotLocked(
+      std::unique_ptr<PickerSnapshot> snapshot,
+      std::vector<std::unique_ptr<PickerSnapshot>>* stale)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
 
+  // May be called without holding data_plane_mu_.  Returns the slot holding
+  // the active picker, which stays valid until ReleasePickerSlot() is
+  // called, or null if no picker has been published.
+  PickerSlot* AcquirePickerSlot();
+  static void ReleasePickerSlot(PickerSlot* slot) {
+    slot->readers.fetch_sub(1, std::memory_order_release);
+  }
+
   //
   // Fields set at construction and never modified.
   //
@@ -304,8 +338,13 @@ class ClientChannel {
   // Fields used in the data plane.  Guarded by data_plane_mu_.
   //
   mutable Mutex data_plane_mu_;
-  std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker_
-      ABSL_GUARDED_BY(data_plane_mu_);
+  // The active picker is double-buffered so that picks can run without
+  // data_plane_mu_.  A pick registers as a reader of the active slot;
+  // updates hold data_plane_mu_, fill the inactive slot once its readers
+  // have drained, and then flip active_picker_slot_.
+  PickerSlot picker_slots_[2];
+  std::atomic<int> active_picker_slot_{0};
+  uint64_t picker_generation_ ABSL_GUARDED_BY(data_plane_mu_) = 0;
   // Linked list of calls queued waiting for LB pick.
   LbQueuedCall* lb_queued_calls_ ABSL_GUARDED_BY(data_plane_mu_) = nullptr;
 
@@ -391,10 +430,25 @@ class ClientChannel::LoadBalancedCall
 
   // Invoked by channel for queued LB picks when the picker is updated.
   static void PickSubchannel(void* arg, grpc_error_handle error);
+  // Attempts the LB pick against the published picker without holding the
+  // data plane mutex.  Returns true if the pick completed, in which case
+  // the caller must invoke PickDone() with the returned error; otherwise
+  // the pick must be finished with PickSubchannelLocked(), passing it
+  // *result and *generation, the generation of the picker that returned
+  // it (0 if there was no picker).
+  bool PickSubchannelWithoutLock(grpc_error_handle* error,
+                                 LoadBalancingPolicy::PickResult* result,
+                                 uint64_t* generation);
   // Helper function for performing an LB pick while holding the data plane
   // mutex.  Returns true if the pick is complete, in which case the caller
   // must invoke PickDone() or AsyncPickDone() with the returned error.
-  bool PickSubchannelLocked(grpc_error_handle* error)
+  // If \a unfinished_result is set, it was returned by the picker of
+  // generation \a generation, and is used instead of picking again if that
+  // picker is still the current one.
+  bool PickSubchannelLocked(
+      grpc_error_handle* error,
+      LoadBalancingPolicy::PickResult* unfinished_result = nullptr,
+      uint64_t generation = 0)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_);
   // Schedules a callback to process the completed pick.  The callback
   // will not run until after this method returns.
@@ -446,6 +500,13 @@ class ClientChannel::LoadBalancedCall
   void CreateSubchannelCall();
   // Invoked when a pick is completed, on both success or failure.
   static void PickDone(void* arg, grpc_error_handle error);
+  // Runs the picker for this call.
+  LoadBalancingPolicy::PickResult Pick(
+      LoadBalancingPolicy::SubchannelPicker* picker);
+  // Records the outcome of a PICK_COMPLETE result picked from snapshot.
+  void OnPickComplete(const PickerSnapshot& snapshot,
+                      LoadBalancingPolicy::PickResult* result,
+                      grpc_error_handle* error);
   // Removes the call from the channel's list of queued picks if present.
   void MaybeRemoveCallFromLbQueuedCallsLocked()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_);
@@ -485,6 +546,8 @@ class ClientChannel::LoadBalancedCall
       ABSL_GUARDED_BY(&ClientChannel::data_plane_mu_) = nullptr;
 
   RefCountedPtr<ConnectedSubchannel> connected_subchannel_;
+  // Set if this call's pick asked the subchannel for another connection.
+  bool polling_for_connection_ = false;
   const LoadBalancingPolicy::BackendMetricData* backend_metric_data_ = nullptr;
   std::function<void(grpc_error_handle, LoadBalancingPolicy::MetadataInterface*,
                      LoadBalancingPolicy::CallState*)>
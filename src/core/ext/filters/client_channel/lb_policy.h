@@ -21,6 +21,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <functional>
 #include <iterator>
 
@@ -258,9 +259,9 @@ class LoadBalancingPolicy : public InternallyRefCounted<LoadBalancingPolicy> {
   /// updates, connectivity state notifications, etc); the latter should
   /// live in the LB policy object itself.
   ///
-  /// Currently, pickers are always accessed from within the
-  /// client_channel data plane mutex, so they do not have to be
-  /// thread-safe.
+  /// Pick() may be called concurrently from multiple threads without
+  /// the client_channel data plane mutex held, so any state it mutates
+  /// must be thread-safe.  It must not block.
   class SubchannelPicker {
    public:
     SubchannelPicker() = default;
@@ -381,7 +382,7 @@ class LoadBalancingPolicy : public InternallyRefCounted<LoadBalancingPolicy> {
 
    private:
     RefCountedPtr<LoadBalancingPolicy> parent_;
-    bool exit_idle_called_ = false;
+    std::atomic<bool> exit_idle_called_{false};
   };
 
   // A picker that returns PICK_TRANSIENT_FAILURE for all picks.
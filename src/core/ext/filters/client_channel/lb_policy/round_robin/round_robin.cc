@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+
 #include <grpc/support/alloc.h>
 
 #include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
@@ -120,6 +122,8 @@ class RoundRobin : public LoadBalancingPolicy {
       // any references to subchannels, since the subchannels'
       // pollset_sets will include the LB policy's pollset_set.
       policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+      warmup_ready_count_ =
+          (policy->warmup_ready_percent_ * num_subchannels() + 99) / 100;
     }
 
     ~RoundRobinSubchannelList() override {
@@ -144,10 +148,17 @@ class RoundRobin : public LoadBalancingPolicy {
     // subchannels in each state.
     void UpdateRoundRobinStateFromSubchannelStateCountsLocked();
 
+    // Returns true once enough subchannels have been READY for the list to
+    // be used.  See GRPC_ARG_LB_WARMUP_READY_PERCENT.  This stays true when
+    // subchannels later leave READY, so callers must also check num_ready_.
+    bool WarmedUpLocked();
+
    private:
     size_t num_ready_ = 0;
     size_t num_connecting_ = 0;
     size_t num_transient_failure_ = 0;
+    size_t warmup_ready_count_ = 0;
+    bool warmed_up_ = false;
   };
 
   class Picker : public SubchannelPicker {
@@ -160,7 +171,7 @@ class RoundRobin : public LoadBalancingPolicy {
     // Using pointer value only, no ref held -- do not dereference!
     RoundRobin* parent_;
 
-    size_t last_picked_index_;
+    std::atomic<size_t> last_picked_index_;
     absl::InlinedVector<RefCountedPtr<SubchannelInterface>, 10> subchannels_;
   };
 
@@ -176,6 +187,8 @@ class RoundRobin : public LoadBalancingPolicy {
   OrphanablePtr<RoundRobinSubchannelList> latest_pending_subchannel_list_;
   /** are we shutting down? */
   bool shutdown_ = false;
+  /** percentage of a new list that must be READY before it is used */
+  size_t warmup_ready_percent_ = 0;
 };
 
 //
@@ -201,21 +214,22 @@ RoundRobin::Picker::Picker(RoundRobin* parent,
             "[RR %p picker %p] created picker from subchannel_list=%p "
             "with %" PRIuPTR " READY subchannels; last_picked_index_=%" PRIuPTR,
             parent_, this, subchannel_list, subchannels_.size(),
-            last_picked_index_);
+            last_picked_index_.load());
   }
 }
 
 RoundRobin::PickResult RoundRobin::Picker::Pick(PickArgs /*args*/) {
-  last_picked_index_ = (last_picked_index_ + 1) % subchannels_.size();
+  const size_t index =
+      (last_picked_index_.fetch_add(1, std::memory_order_relaxed) + 1) %
+      subchannels_.size();
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_round_robin_trace)) {
     gpr_log(GPR_INFO,
             "[RR %p picker %p] returning index %" PRIuPTR ", subchannel=%p",
-            parent_, this, last_picked_index_,
-            subchannels_[last_picked_index_].get());
+            parent_, this, index, subchannels_[index].get());
   }
   PickResult result;
   result.type = PickResult::PICK_COMPLETE;
-  result.subchannel = subchannels_[last_picked_index_];
+  result.subchannel = subchannels_[index];
   return result;
 }
 
@@ -310,9 +324,10 @@ void RoundRobin::RoundRobinSubchannelList::
    * are on rule n, all previous rules were unfulfilled).
    *
    * 1) RULE: ANY subchannel is READY => policy is READY.
-   *    CHECK: subchannel_list->num_ready > 0.
+   *    CHECK: subchannel_list->num_ready > 0, and the list has warmed up.
    *
-   * 2) RULE: ANY subchannel is CONNECTING => policy is CONNECTING.
+   * 2) RULE: ANY subchannel is CONNECTING, or READY while the list is
+   *          still warming up => policy is CONNECTING.
    *    CHECK: sd->curr_connectivity_state == CONNECTING.
    *
    * 3) RULE: ALL subchannels are TRANSIENT_FAILURE => policy is
@@ -320,11 +335,11 @@ void RoundRobin::RoundRobinSubchannelList::
    *    CHECK: subchannel_list->num_transient_failures ==
    *           subchannel_list->num_subchannels.
    */
-  if (num_ready_ > 0) {
+  if (num_ready_ > 0 && WarmedUpLocked()) {
     /* 1) READY */
     p->channel_control_helper()->UpdateState(
         GRPC_CHANNEL_READY, absl::Status(), absl::make_unique<Picker>(p, this));
-  } else if (num_connecting_ > 0) {
+  } else if (num_connecting_ > 0 || num_ready_ > 0) {
     /* 2) CONNECTING */
     p->channel_control_helper()->UpdateState(
         GRPC_CHANNEL_CONNECTING, absl::Status(),
@@ -341,10 +356,20 @@ void RoundRobin::RoundRobinSubchannelList::
   }
 }
 
+bool RoundRobin::RoundRobinSubchannelList::WarmedUpLocked() {
+  if (!warmed_up_ && num_ready_ > 0) {
+    // Stop waiting once no other subchannel can still become READY.
+    const size_t num_pending =
+        num_subchannels() - num_ready_ - num_transient_failure_;
+    warmed_up_ = num_ready_ >= warmup_ready_count_ || num_pending == 0;
+  }
+  return warmed_up_;
+}
+
 void RoundRobin::RoundRobinSubchannelList::
     UpdateRoundRobinStateFromSubchannelStateCountsLocked() {
   RoundRobin* p = static_cast<RoundRobin*>(policy());
-  if (num_ready_ > 0) {
+  if (num_ready_ > 0 && WarmedUpLocked()) {
     if (p->subchannel_list_.get() != this) {
       // Promote this list to p->subchannel_list_.
       // This list must be p->latest_pending_subchannel_list_, because
@@ -436,6 +461,8 @@ void RoundRobin::UpdateLocked(UpdateArgs args) {
     gpr_log(GPR_INFO, "[RR %p] received update with %" PRIuPTR " addresses",
             this, args.addresses.size());
   }
+  warmup_ready_percent_ = grpc_channel_args_find_integer(
+      args.args, GRPC_ARG_LB_WARMUP_READY_PERCENT, {0, 0, 100});
   // Replace latest_pending_subchannel_list_.
   if (latest_pending_subchannel_list_ != nullptr) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_round_robin_trace)) {
@@ -0,0 +1,825 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** Weighted Round Robin Policy.
+ *
+ * Like round_robin, but each READY subchannel is picked in proportion to a
+ * weight derived from the backend metrics (ORCA load reports) returned in
+ * call trailers: weight = requests_per_second / cpu_utilization.
+ *
+ * A subchannel's weight is only used once it has been reporting for
+ * \a blackoutPeriod, and is discarded if no report has been received for
+ * \a weightExpirationPeriod.  Subchannels without a usable weight are
+ * given the mean weight of the others; if no subchannel has a usable
+ * weight, picks are plain round robin.  The picker is rebuilt with fresh
+ * weights every \a weightUpdatePeriod.
+ *
+ * Picks use a stride scheduler: weights are scaled so that the largest
+ * is kMaxWeight, and a shared atomic sequence walks the subchannels,
+ * accepting subchannel i in generation g iff
+ * (weight_i * g + offset_i) % kMaxWeight >= kMaxWeight - weight_i.  Every
+ * generation accepts the heaviest subchannel, so a pick needs at most one
+ * pass over the list and takes no locks. */
+
+#include <grpc/support/port_platform.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/json/json_util.h"
+#include "src/core/lib/transport/connectivity_state.h"
+#include "src/core/lib/transport/error_utils.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_lb_weighted_round_robin_trace(false, "weighted_round_robin_lb");
+
+namespace {
+
+//
+// weighted_round_robin LB policy
+//
+
+constexpr char kWeightedRoundRobin[] = "weighted_round_robin";
+
+constexpr grpc_millis kDefaultBlackoutPeriod = 10 * GPR_MS_PER_SEC;
+constexpr grpc_millis kDefaultWeightExpirationPeriod = 3 * 60 * GPR_MS_PER_SEC;
+constexpr grpc_millis kDefaultWeightUpdatePeriod = GPR_MS_PER_SEC;
+constexpr grpc_millis kMinWeightUpdatePeriod = 100;
+
+class WeightedRoundRobinConfig : public LoadBalancingPolicy::Config {
+ public:
+  WeightedRoundRobinConfig(grpc_millis blackout_period,
+                           grpc_millis weight_expiration_period,
+                           grpc_millis weight_update_period)
+      : blackout_period_(blackout_period),
+        weight_expiration_period_(weight_expiration_period),
+        weight_update_period_(weight_update_period) {}
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  grpc_millis blackout_period() const { return blackout_period_; }
+  grpc_millis weight_expiration_period() const {
+    return weight_expiration_period_;
+  }
+  grpc_millis weight_update_period() const { return weight_update_period_; }
+
+ private:
+  grpc_millis blackout_period_;
+  grpc_millis weight_expiration_period_;
+  grpc_millis weight_update_period_;
+};
+
+class WeightedRoundRobin : public LoadBalancingPolicy {
+ public:
+  explicit WeightedRoundRobin(Args args);
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ResetBackoffLocked() override;
+
+ private:
+  ~WeightedRoundRobin() override;
+
+  // Forward declarations.
+  class WeightedRoundRobinSubchannelList;
+  class AddressWeight;
+
+  // The weights by address.  Ref-counted separately from the policy, so
+  // that weights held by pickers and in-flight calls do not keep the
+  // policy itself alive.
+  class AddressWeightMap : public RefCounted<AddressWeightMap> {
+   public:
+    // Returns the weight for \a address, creating it if needed.
+    RefCountedPtr<AddressWeight> GetOrCreateWeight(
+        const ServerAddress& address);
+
+   private:
+    friend class AddressWeight;
+
+    Mutex mu_;
+    // Entries remove themselves when destroyed.
+    std::map<std::string, AddressWeight*> map_ ABSL_GUARDED_BY(mu_);
+  };
+
+  // The weight of one address, updated from the load reports of calls
+  // sent to it.  Shared by every subchannel list and picker that contains
+  // the address, so that weights survive resolver updates, and by the
+  // calls themselves.
+  class AddressWeight : public RefCounted<AddressWeight> {
+   public:
+    AddressWeight(RefCountedPtr<AddressWeightMap> map, std::string key)
+        : map_(std::move(map)), key_(std::move(key)) {}
+    ~AddressWeight() override;
+
+    // Records a load report.  Reports without both a QPS and a CPU
+    // utilization are ignored.
+    void MaybeUpdateWeight(double qps, double cpu_utilization);
+
+    // Returns the weight to use at \a now, or 0 if there is no usable
+    // weight.
+    double GetWeight(grpc_millis now, grpc_millis weight_expiration_period,
+                     grpc_millis blackout_period);
+
+   private:
+    RefCountedPtr<AddressWeightMap> map_;
+    const std::string key_;
+
+    Mutex mu_;
+    double weight_ ABSL_GUARDED_BY(mu_) = 0;
+    grpc_millis non_empty_since_ ABSL_GUARDED_BY(mu_) = GRPC_MILLIS_INF_FUTURE;
+    grpc_millis last_update_time_ ABSL_GUARDED_BY(mu_) = GRPC_MILLIS_INF_PAST;
+  };
+
+  // Data for a particular subchannel in a subchannel list.
+  // This subclass adds the following functionality:
+  // - Tracks the previous connectivity state of the subchannel, so that
+  //   we know how many subchannels are in each state.
+  // - Holds the weight of the subchannel's address.
+  class WeightedRoundRobinSubchannelData
+      : public SubchannelData<WeightedRoundRobinSubchannelList,
+                              WeightedRoundRobinSubchannelData> {
+   public:
+    WeightedRoundRobinSubchannelData(
+        SubchannelList<WeightedRoundRobinSubchannelList,
+                       WeightedRoundRobinSubchannelData>* subchannel_list,
+        const ServerAddress& address,
+        RefCountedPtr<SubchannelInterface> subchannel)
+        : SubchannelData(subchannel_list, address, std::move(subchannel)),
+          weight_(static_cast<WeightedRoundRobin*>(subchannel_list->policy())
+                      ->address_weight_map_->GetOrCreateWeight(address)) {}
+
+    grpc_connectivity_state connectivity_state() const {
+      return last_connectivity_state_;
+    }
+
+    const RefCountedPtr<AddressWeight>& weight() const { return weight_; }
+
+    // Performs connectivity state updates that need to be done both when we
+    // first start watching and when a watcher notification is received.
+    void UpdateConnectivityStateLocked(
+        grpc_connectivity_state connectivity_state);
+
+   private:
+    // Performs connectivity state updates that need to be done only
+    // after we have started watching.
+    void ProcessConnectivityChangeLocked(
+        grpc_connectivity_state connectivity_state) override;
+
+    grpc_connectivity_state last_connectivity_state_ = GRPC_CHANNEL_IDLE;
+    bool seen_failure_since_ready_ = false;
+    RefCountedPtr<AddressWeight> weight_;
+  };
+
+  // A list of subchannels.
+  class WeightedRoundRobinSubchannelList
+      : public SubchannelList<WeightedRoundRobinSubchannelList,
+                              WeightedRoundRobinSubchannelData> {
+   public:
+    WeightedRoundRobinSubchannelList(WeightedRoundRobin* policy,
+                                     TraceFlag* tracer,
+                                     ServerAddressList addresses,
+                                     const grpc_channel_args& args)
+        : SubchannelList(policy, tracer, std::move(addresses),
+                         policy->channel_control_helper(), args) {
+      // Need to maintain a ref to the LB policy as long as we maintain
+      // any references to subchannels, since the subchannels'
+      // pollset_sets will include the LB policy's pollset_set.
+      policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+      warmup_ready_count_ =
+          (policy->warmup_ready_percent_ * num_subchannels() + 99) / 100;
+    }
+
+    ~WeightedRoundRobinSubchannelList() override {
+      WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+      p->Unref(DEBUG_LOCATION, "subchannel_list");
+    }
+
+    // Starts watching the subchannels in this list.
+    void StartWatchingLocked();
+
+    // Updates the counters of subchannels in each state when a
+    // subchannel transitions from old_state to new_state.
+    void UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                                   grpc_connectivity_state new_state);
+
+    // If this subchannel list is the policy's current subchannel list,
+    // updates the policy's connectivity state based on the subchannel
+    // list's state counters.
+    void MaybeUpdateWeightedRoundRobinConnectivityStateLocked();
+
+    // Updates the policy's overall state based on the counters of
+    // subchannels in each state.
+    void UpdateWeightedRoundRobinStateFromSubchannelStateCountsLocked();
+
+    // If this is the current list and it is READY, replaces the picker
+    // with one built from the current weights.
+    void MaybeRefreshPickerLocked();
+
+    // Returns true once enough subchannels have been READY for the list to
+    // be used.  See GRPC_ARG_LB_WARMUP_READY_PERCENT.  This stays true when
+    // subchannels later leave READY, so callers must also check num_ready_.
+    bool WarmedUpLocked();
+
+   private:
+    size_t num_ready_ = 0;
+    size_t num_connecting_ = 0;
+    size_t num_transient_failure_ = 0;
+    size_t warmup_ready_count_ = 0;
+    bool warmed_up_ = false;
+  };
+
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(WeightedRoundRobin* parent,
+           WeightedRoundRobinSubchannelList* subchannel_list);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    static constexpr uint64_t kMaxWeight = 0xFFFF;
+    // Weights below this fraction of the largest are raised to it, which
+    // bounds the number of sequence steps a pick can take.
+    static constexpr double kMinWeightRatio = 0.01;
+
+    struct Endpoint {
+      RefCountedPtr<SubchannelInterface> subchannel;
+      RefCountedPtr<AddressWeight> weight;
+    };
+
+    size_t PickIndex();
+
+    // Using pointer value only, no ref held -- do not dereference!
+    WeightedRoundRobin* parent_;
+
+    absl::InlinedVector<Endpoint, 10> endpoints_;
+    absl::InlinedVector<uint64_t, 10> scaled_weights_;
+    std::atomic<uint64_t> sequence_;
+  };
+
+  void StartWeightUpdateTimerLocked();
+  static void OnWeightUpdateTimer(void* arg, grpc_error_handle error);
+  void OnWeightUpdateTimerLocked(grpc_error_handle error);
+
+  void ShutdownLocked() override;
+
+  /** current config */
+  RefCountedPtr<WeightedRoundRobinConfig> config_;
+  /** list of subchannels */
+  OrphanablePtr<WeightedRoundRobinSubchannelList> subchannel_list_;
+  /** Latest version of the subchannel list.
+   * Subchannel connectivity callbacks will only promote updated subchannel
+   * lists if they equal \a latest_pending_subchannel_list. In other words,
+   * racing callbacks that reference outdated subchannel lists won't perform any
+   * update. */
+  OrphanablePtr<WeightedRoundRobinSubchannelList>
+      latest_pending_subchannel_list_;
+  /** are we shutting down? */
+  bool shutdown_ = false;
+  /** percentage of a new list that must be READY before it is used */
+  size_t warmup_ready_percent_ = 0;
+
+  /** weights by address */
+  RefCountedPtr<AddressWeightMap> address_weight_map_ =
+      MakeRefCounted<AddressWeightMap>();
+
+  /** refreshes the picker's weights */
+  grpc_timer weight_update_timer_;
+  grpc_closure on_weight_update_timer_;
+  bool weight_update_timer_pending_ = false;
+};
+
+//
+// WeightedRoundRobin::AddressWeightMap
+//
+
+RefCountedPtr<WeightedRoundRobin::AddressWeight>
+WeightedRoundRobin::AddressWeightMap::GetOrCreateWeight(
+    const ServerAddress& address) {
+  std::string key = grpc_sockaddr_to_string(&address.address(), false);
+  RefCountedPtr<AddressWeight> result;
+  MutexLock lock(&mu_);
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    it = map_.insert({key, nullptr}).first;
+  } else {
+    result = it->second->RefIfNonZero();
+  }
+  if (result == nullptr) {
+    result = MakeRefCounted<AddressWeight>(Ref(), std::move(key));
+    it->second = result.get();
+  }
+  return result;
+}
+
+//
+// WeightedRoundRobin::AddressWeight
+//
+
+WeightedRoundRobin::AddressWeight::~AddressWeight() {
+  MutexLock lock(&map_->mu_);
+  auto it = map_->map_.find(key_);
+  if (it != map_->map_.end() && it->second == this) {
+    map_->map_.erase(it);
+  }
+}
+
+void WeightedRoundRobin::AddressWeight::MaybeUpdateWeight(
+    double qps, double cpu_utilization) {
+  if (qps <= 0 || cpu_utilization <= 0) return;
+  const double weight = qps / cpu_utilization;
+  const grpc_millis now = ExecCtx::Get()->Now();
+  MutexLock lock(&mu_);
+  if (non_empty_since_ == GRPC_MILLIS_INF_FUTURE) non_empty_since_ = now;
+  weight_ = weight;
+  last_update_time_ = now;
+}
+
+double WeightedRoundRobin::AddressWeight::GetWeight(
+    grpc_millis now, grpc_millis weight_expiration_period,
+    grpc_millis blackout_period) {
+  MutexLock lock(&mu_);
+  if (weight_ == 0) return 0;
+  // Stale weights are discarded, and the blackout period starts over when
+  // reports resume.
+  if (now - last_update_time_ >= weight_expiration_period) {
+    weight_ = 0;
+    non_empty_since_ = GRPC_MILLIS_INF_FUTURE;
+    return 0;
+  }
+  if (now - non_empty_since_ < blackout_period) return 0;
+  return weight_;
+}
+
+//
+// WeightedRoundRobin::Picker
+//
+
+WeightedRoundRobin::Picker::Picker(
+    WeightedRoundRobin* parent,
+    WeightedRoundRobinSubchannelList* subchannel_list)
+    : parent_(parent), sequence_(static_cast<uint64_t>(rand())) {
+  const WeightedRoundRobinConfig* config = parent->config_.get();
+  const grpc_millis now = ExecCtx::Get()->Now();
+  absl::InlinedVector<double, 10> weights;
+  double weight_sum = 0;
+  size_t num_weighted = 0;
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    WeightedRoundRobinSubchannelData* sd = subchannel_list->subchannel(i);
+    if (sd->connectivity_state() != GRPC_CHANNEL_READY) continue;
+    endpoints_.push_back({sd->subchannel()->Ref(), sd->weight()});
+    const double weight =
+        sd->weight()->GetWeight(now, config->weight_expiration_period(),
+                                config->blackout_period());
+    weights.push_back(weight);
+    if (weight > 0) {
+      weight_sum += weight;
+      ++num_weighted;
+    }
+  }
+  // Addresses without a usable weight get the mean of the others.  With no
+  // weights at all, every address gets the same weight.
+  const double mean = num_weighted == 0 ? 1 : weight_sum / num_weighted;
+  double max_weight = 0;
+  for (double& weight : weights) {
+    if (weight == 0) weight = mean;
+    max_weight = GPR_MAX(max_weight, weight);
+  }
+  for (double weight : weights) {
+    const double ratio = GPR_MAX(weight / max_weight, kMinWeightRatio);
+    scaled_weights_.push_back(
+        GPR_MAX(uint64_t(1), static_cast<uint64_t>(ratio * kMaxWeight + 0.5)));
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO,
+            "[WRR %p picker %p] created picker from subchannel_list=%p "
+            "with %" PRIuPTR " READY subchannels, %" PRIuPTR " weighted",
+            parent_, this, subchannel_list, endpoints_.size(), num_weighted);
+    for (size_t i = 0; i < endpoints_.size(); ++i) {
+      gpr_log(GPR_INFO,
+              "[WRR %p picker %p] subchannel %p: weight=%f scaled=%" PRIu64,
+              parent_, this, endpoints_[i].subchannel.get(), weights[i],
+              scaled_weights_[i]);
+    }
+  }
+}
+
+size_t WeightedRoundRobin::Picker::PickIndex() {
+  const uint64_t num_endpoints = endpoints_.size();
+  // Spreads the acceptance windows of equally weighted subchannels.
+  constexpr uint64_t kOffset = kMaxWeight / 2;
+  while (true) {
+    const uint64_t sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t index = sequence % num_endpoints;
+    const uint64_t generation = sequence / num_endpoints;
+    const uint64_t weight = scaled_weights_[index];
+    if ((weight * generation + index * kOffset) % kMaxWeight >=
+        kMaxWeight - weight) {
+      return static_cast<size_t>(index);
+    }
+  }
+}
+
+WeightedRoundRobin::PickResult WeightedRoundRobin::Picker::Pick(
+    PickArgs /*args*/) {
+  const Endpoint& endpoint = endpoints_[PickIndex()];
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p picker %p] returning subchannel=%p", parent_,
+            this, endpoint.subchannel.get());
+  }
+  PickResult result;
+  result.type = PickResult::PICK_COMPLETE;
+  result.subchannel = endpoint.subchannel;
+  RefCountedPtr<AddressWeight> weight = endpoint.weight;
+  result.recv_trailing_metadata_ready =
+      [weight](grpc_error_handle /*error*/, MetadataInterface* /*metadata*/,
+               CallState* call_state) {
+        const BackendMetricData* backend_metric_data =
+            call_state->GetBackendMetricData();
+        if (backend_metric_data == nullptr) return;
+        weight->MaybeUpdateWeight(
+            static_cast<double>(backend_metric_data->requests_per_second),
+            backend_metric_data->cpu_utilization);
+      };
+  return result;
+}
+
+//
+// WeightedRoundRobin
+//
+
+WeightedRoundRobin::WeightedRoundRobin(Args args)
+    : LoadBalancingPolicy(std::move(args)) {
+  GRPC_CLOSURE_INIT(&on_weight_update_timer_, OnWeightUpdateTimer, this,
+                    grpc_schedule_on_exec_ctx);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Created", this);
+  }
+}
+
+WeightedRoundRobin::~WeightedRoundRobin() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Destroying Weighted Round Robin policy", this);
+  }
+  GPR_ASSERT(subchannel_list_ == nullptr);
+  GPR_ASSERT(latest_pending_subchannel_list_ == nullptr);
+}
+
+void WeightedRoundRobin::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Shutting down", this);
+  }
+  shutdown_ = true;
+  if (weight_update_timer_pending_) {
+    grpc_timer_cancel(&weight_update_timer_);
+    weight_update_timer_pending_ = false;
+  }
+  subchannel_list_.reset();
+  latest_pending_subchannel_list_.reset();
+}
+
+void WeightedRoundRobin::ResetBackoffLocked() {
+  subchannel_list_->ResetBackoffLocked();
+  if (latest_pending_subchannel_list_ != nullptr) {
+    latest_pending_subchannel_list_->ResetBackoffLocked();
+  }
+}
+
+void WeightedRoundRobin::StartWeightUpdateTimerLocked() {
+  if (weight_update_timer_pending_ || shutdown_) return;
+  Ref(DEBUG_LOCATION, "WeightUpdateTimer").release();
+  grpc_timer_init(&weight_update_timer_,
+                  ExecCtx::Get()->Now() + config_->weight_update_period(),
+                  &on_weight_update_timer_);
+  weight_update_timer_pending_ = true;
+}
+
+void WeightedRoundRobin::OnWeightUpdateTimer(void* arg,
+                                             grpc_error_handle error) {
+  WeightedRoundRobin* self = static_cast<WeightedRoundRobin*>(arg);
+  GRPC_ERROR_REF(error);  // ref owned by lambda
+  self->work_serializer()->Run(
+      [self, error]() { self->OnWeightUpdateTimerLocked(error); },
+      DEBUG_LOCATION);
+}
+
+void WeightedRoundRobin::OnWeightUpdateTimerLocked(grpc_error_handle error) {
+  if (error == GRPC_ERROR_NONE && weight_update_timer_pending_ &&
+      !shutdown_) {
+    weight_update_timer_pending_ = false;
+    if (subchannel_list_ != nullptr) {
+      subchannel_list_->MaybeRefreshPickerLocked();
+    }
+    StartWeightUpdateTimerLocked();
+  }
+  Unref(DEBUG_LOCATION, "WeightUpdateTimer");
+  GRPC_ERROR_UNREF(error);
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelList::
+    StartWatchingLocked() {
+  if (num_subchannels() == 0) return;
+  // Check current state of each subchannel synchronously, since any
+  // subchannel already used by some other channel may have a non-IDLE
+  // state.
+  for (size_t i = 0; i < num_subchannels(); ++i) {
+    grpc_connectivity_state state =
+        subchannel(i)->CheckConnectivityStateLocked();
+    if (state != GRPC_CHANNEL_IDLE) {
+      subchannel(i)->UpdateConnectivityStateLocked(state);
+    }
+  }
+  // Start connectivity watch for each subchannel.
+  for (size_t i = 0; i < num_subchannels(); i++) {
+    if (subchannel(i)->subchannel() != nullptr) {
+      subchannel(i)->StartConnectivityWatchLocked();
+      subchannel(i)->subchannel()->AttemptToConnect();
+    }
+  }
+  // Now set the LB policy's state based on the subchannels' states.
+  UpdateWeightedRoundRobinStateFromSubchannelStateCountsLocked();
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelList::
+    UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                              grpc_connectivity_state new_state) {
+  GPR_ASSERT(old_state != GRPC_CHANNEL_SHUTDOWN);
+  GPR_ASSERT(new_state != GRPC_CHANNEL_SHUTDOWN);
+  if (old_state == GRPC_CHANNEL_READY) {
+    GPR_ASSERT(num_ready_ > 0);
+    --num_ready_;
+  } else if (old_state == GRPC_CHANNEL_CONNECTING) {
+    GPR_ASSERT(num_connecting_ > 0);
+    --num_connecting_;
+  } else if (old_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    GPR_ASSERT(num_transient_failure_ > 0);
+    --num_transient_failure_;
+  }
+  if (new_state == GRPC_CHANNEL_READY) {
+    ++num_ready_;
+  } else if (new_state == GRPC_CHANNEL_CONNECTING) {
+    ++num_connecting_;
+  } else if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    ++num_transient_failure_;
+  }
+}
+
+// Sets the policy's connectivity state and generates a new picker based
+// on the current subchannel list.  Follows the same aggregation rules as
+// round_robin.
+void WeightedRoundRobin::WeightedRoundRobinSubchannelList::
+    MaybeUpdateWeightedRoundRobinConnectivityStateLocked() {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  // Only set connectivity state if this is the current subchannel list.
+  if (p->subchannel_list_.get() != this) return;
+  if (num_ready_ > 0 && WarmedUpLocked()) {
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_READY, absl::Status(), absl::make_unique<Picker>(p, this));
+  } else if (num_connecting_ > 0 || num_ready_ > 0) {
+    // Still connecting, or READY but still warming up.
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_CONNECTING, absl::Status(),
+        absl::make_unique<QueuePicker>(p->Ref(DEBUG_LOCATION, "QueuePicker")));
+  } else if (num_transient_failure_ == num_subchannels()) {
+    grpc_error_handle error =
+        grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                               "connections to all backends failing"),
+                           GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE);
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, grpc_error_to_absl_status(error),
+        absl::make_unique<TransientFailurePicker>(error));
+  }
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelList::
+    MaybeRefreshPickerLocked() {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  if (p->subchannel_list_.get() != this || num_ready_ == 0 ||
+      !WarmedUpLocked()) {
+    return;
+  }
+  p->channel_control_helper()->UpdateState(
+      GRPC_CHANNEL_READY, absl::Status(), absl::make_unique<Picker>(p, this));
+}
+
+bool WeightedRoundRobin::WeightedRoundRobinSubchannelList::WarmedUpLocked() {
+  if (!warmed_up_ && num_ready_ > 0) {
+    // Stop waiting once no other subchannel can still become READY.
+    const size_t num_pending =
+        num_subchannels() - num_ready_ - num_transient_failure_;
+    warmed_up_ = num_ready_ >= warmup_ready_count_ || num_pending == 0;
+  }
+  return warmed_up_;
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelList::
+    UpdateWeightedRoundRobinStateFromSubchannelStateCountsLocked() {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  if (num_ready_ > 0 && WarmedUpLocked()) {
+    if (p->subchannel_list_.get() != this) {
+      // Promote this list to p->subchannel_list_.
+      // This list must be p->latest_pending_subchannel_list_, because
+      // any previous update would have been shut down already and
+      // therefore we would not be receiving a notification for them.
+      GPR_ASSERT(p->latest_pending_subchannel_list_.get() == this);
+      GPR_ASSERT(!shutting_down());
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+        const size_t old_num_subchannels =
+            p->subchannel_list_ != nullptr
+                ? p->subchannel_list_->num_subchannels()
+                : 0;
+        gpr_log(GPR_INFO,
+                "[WRR %p] phasing out subchannel list %p (size %" PRIuPTR
+                ") in favor of %p (size %" PRIuPTR ")",
+                p, p->subchannel_list_.get(), old_num_subchannels, this,
+                num_subchannels());
+      }
+      p->subchannel_list_ = std::move(p->latest_pending_subchannel_list_);
+    }
+  }
+  // Update the policy's connectivity state if needed.
+  MaybeUpdateWeightedRoundRobinConnectivityStateLocked();
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelData::
+    UpdateConnectivityStateLocked(grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(
+        GPR_INFO,
+        "[WRR %p] connectivity changed for subchannel %p, subchannel_list %p "
+        "(index %" PRIuPTR " of %" PRIuPTR "): prev_state=%s new_state=%s",
+        p, subchannel(), subchannel_list(), Index(),
+        subchannel_list()->num_subchannels(),
+        ConnectivityStateName(last_connectivity_state_),
+        ConnectivityStateName(connectivity_state));
+  }
+  // Once we see a failure, report TRANSIENT_FAILURE and ignore subsequent
+  // state changes until we go back into state READY.
+  if (!seen_failure_since_ready_) {
+    if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      seen_failure_since_ready_ = true;
+    }
+    subchannel_list()->UpdateStateCountersLocked(last_connectivity_state_,
+                                                 connectivity_state);
+  } else {
+    if (connectivity_state == GRPC_CHANNEL_READY) {
+      seen_failure_since_ready_ = false;
+      subchannel_list()->UpdateStateCountersLocked(
+          GRPC_CHANNEL_TRANSIENT_FAILURE, connectivity_state);
+    }
+  }
+  // Record last seen connectivity state.
+  last_connectivity_state_ = connectivity_state;
+}
+
+void WeightedRoundRobin::WeightedRoundRobinSubchannelData::
+    ProcessConnectivityChangeLocked(
+        grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  GPR_ASSERT(subchannel() != nullptr);
+  // If the new state is TRANSIENT_FAILURE, re-resolve and attempt to
+  // reconnect.  Only done once we've started watching; see round_robin.
+  if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+      gpr_log(GPR_INFO,
+              "[WRR %p] Subchannel %p has gone into TRANSIENT_FAILURE. "
+              "Requesting re-resolution",
+              p, subchannel());
+    }
+    p->channel_control_helper()->RequestReresolution();
+    subchannel()->AttemptToConnect();
+  }
+  // Update state counters.
+  UpdateConnectivityStateLocked(connectivity_state);
+  // Update overall state and renew notification.
+  subchannel_list()
+      ->UpdateWeightedRoundRobinStateFromSubchannelStateCountsLocked();
+}
+
+void WeightedRoundRobin::UpdateLocked(UpdateArgs args) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] received update with %" PRIuPTR " addresses",
+            this, args.addresses.size());
+  }
+  warmup_ready_percent_ = grpc_channel_args_find_integer(
+      args.args, GRPC_ARG_LB_WARMUP_READY_PERCENT, {0, 0, 100});
+  config_ = std::move(args.config);
+  // Replace latest_pending_subchannel_list_.
+  if (latest_pending_subchannel_list_ != nullptr) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_round_robin_trace)) {
+      gpr_log(GPR_INFO,
+              "[WRR %p] Shutting down previous pending subchannel list %p",
+              this, latest_pending_subchannel_list_.get());
+    }
+  }
+  latest_pending_subchannel_list_ =
+      MakeOrphanable<WeightedRoundRobinSubchannelList>(
+          this, &grpc_lb_weighted_round_robin_trace, std::move(args.addresses),
+          *args.args);
+  if (latest_pending_subchannel_list_->num_subchannels() == 0) {
+    // If the new list is empty, immediately promote the new list to the
+    // current list and transition to TRANSIENT_FAILURE.
+    grpc_error_handle error =
+        grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING("Empty update"),
+                           GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE);
+    channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, grpc_error_to_absl_status(error),
+        absl::make_unique<TransientFailurePicker>(error));
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+  } else if (subchannel_list_ == nullptr) {
+    // If there is no current list, immediately promote the new list to
+    // the current list and start watching it.
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+    subchannel_list_->StartWatchingLocked();
+  } else {
+    // Start watching the pending list.  It will get swapped into the
+    // current list when it reports READY.
+    latest_pending_subchannel_list_->StartWatchingLocked();
+  }
+  StartWeightUpdateTimerLocked();
+}
+
+//
+// factory
+//
+
+class WeightedRoundRobinFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<WeightedRoundRobin>(std::move(args));
+  }
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    GPR_DEBUG_ASSERT(error != nullptr && *error == GRPC_ERROR_NONE);
+    grpc_millis blackout_period = kDefaultBlackoutPeriod;
+    grpc_millis weight_expiration_period = kDefaultWeightExpirationPeriod;
+    grpc_millis weight_update_period = kDefaultWeightUpdatePeriod;
+    std::vector<grpc_error_handle> error_list;
+    if (json.type() == Json::Type::OBJECT) {
+      ParseJsonObjectFieldAsDuration(json.object_value(), "blackoutPeriod",
+                                     &blackout_period, &error_list,
+                                     /*required=*/false);
+      ParseJsonObjectFieldAsDuration(
+          json.object_value(), "weightExpirationPeriod",
+          &weight_expiration_period, &error_list, /*required=*/false);
+      ParseJsonObjectFieldAsDuration(json.object_value(), "weightUpdatePeriod",
+                                     &weight_update_period, &error_list,
+                                     /*required=*/false);
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+          "weighted_round_robin LB policy config", &error_list);
+      return nullptr;
+    }
+    weight_update_period =
+        GPR_MAX(weight_update_period, kMinWeightUpdatePeriod);
+    return MakeRefCounted<WeightedRoundRobinConfig>(
+        blackout_period, weight_expiration_period, weight_update_period);
+  }
+};
+
+}  // namespace
+
+}  // namespace grpc_core
+
+void grpc_lb_policy_weighted_round_robin_init() {
+  grpc_core::LoadBalancingPolicyRegistry::Builder::
+      RegisterLoadBalancingPolicyFactory(
+          absl::make_unique<grpc_core::WeightedRoundRobinFactory>());
+}
+
+void grpc_lb_policy_weighted_round_robin_shutdown() {}
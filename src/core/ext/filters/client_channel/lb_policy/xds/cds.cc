@@ -72,7 +72,8 @@ class CdsLb : public LoadBalancingPolicy {
     ClusterWatcher(RefCountedPtr<CdsLb> parent, std::string name)
         : parent_(std::move(parent)), name_(std::move(name)) {}
 
-    void OnClusterChanged(XdsApi::CdsUpdate cluster_data) override {
+    void OnClusterChanged(
+        std::shared_ptr<const XdsApi::CdsUpdate> cluster_data) override {
       new Notifier(parent_, name_, std::move(cluster_data));
     }
     void OnError(grpc_error_handle error) override {
@@ -84,7 +85,7 @@ class CdsLb : public LoadBalancingPolicy {
     class Notifier {
      public:
       Notifier(RefCountedPtr<CdsLb> parent, std::string name,
-               XdsApi::CdsUpdate update);
+               std::shared_ptr<const XdsApi::CdsUpdate> update);
       Notifier(RefCountedPtr<CdsLb> parent, std::string name,
                grpc_error_handle error);
       explicit Notifier(RefCountedPtr<CdsLb> parent, std::string name);
@@ -98,7 +99,7 @@ class CdsLb : public LoadBalancingPolicy {
       RefCountedPtr<CdsLb> parent_;
       std::string name_;
       grpc_closure closure_;
-      XdsApi::CdsUpdate update_;
+      std::shared_ptr<const XdsApi::CdsUpdate> update_;
       Type type_;
     };
 
@@ -110,8 +111,9 @@ class CdsLb : public LoadBalancingPolicy {
     // Pointer to watcher, to be used when cancelling.
     // Not owned, so do not dereference.
     ClusterWatcher* watcher = nullptr;
-    // Most recent update obtained from this watcher.
-    absl::optional<XdsApi::CdsUpdate> update;
+    // Most recent update obtained from this watcher.  Shared with the
+    // XdsClient cache.
+    std::shared_ptr<const XdsApi::CdsUpdate> update;
   };
 
   // Delegating helper to be passed to child policy.
@@ -138,7 +140,7 @@ class CdsLb : public LoadBalancingPolicy {
       const std::string& name, Json::Array* discovery_mechanisms,
       std::set<std::string>* clusters_needed);
   void OnClusterChanged(const std::string& name,
-                        XdsApi::CdsUpdate cluster_data);
+                        std::shared_ptr<const XdsApi::CdsUpdate> cluster_data);
   void OnError(const std::string& name, grpc_error_handle error);
   void OnResourceDoesNotExist(const std::string& name);
 
@@ -178,9 +180,9 @@ class CdsLb : public LoadBalancingPolicy {
 // CdsLb::ClusterWatcher::Notifier
 //
 
-CdsLb::ClusterWatcher::Notifier::Notifier(RefCountedPtr<CdsLb> parent,
-                                          std::string name,
-                                          XdsApi::CdsUpdate update)
+CdsLb::ClusterWatcher::Notifier::Notifier(
+    RefCountedPtr<CdsLb> parent, std::string name,
+    std::shared_ptr<const XdsApi::CdsUpdate> update)
     : parent_(std::move(parent)),
       name_(std::move(name)),
       update_(std::move(update)),
@@ -379,7 +381,7 @@ bool CdsLb::GenerateDiscoveryMechanismForCluster(
     return false;
   }
   // Don't have the update we need yet.
-  if (!state.update.has_value()) return false;
+  if (state.update == nullptr) return false;
   // For AGGREGATE clusters, recursively expand to child clusters.
   if (state.update->cluster_type == XdsApi::CdsUpdate::ClusterType::AGGREGATE) {
     bool missing_cluster = false;
@@ -420,13 +422,15 @@ bool CdsLb::GenerateDiscoveryMechanismForCluster(
   return true;
 }
 
-void CdsLb::OnClusterChanged(const std::string& name,
-                             XdsApi::CdsUpdate cluster_data) {
+void CdsLb::OnClusterChanged(
+    const std::string& name,
+    std::shared_ptr<const XdsApi::CdsUpdate> cluster_data) {
   if (GRPC_TRACE_FLAG_ENABLED(grpc_cds_lb_trace)) {
     gpr_log(
         GPR_INFO,
         "[cdslb %p] received CDS update for cluster %s from xds client %p: %s",
-        this, name.c_str(), xds_client_.get(), cluster_data.ToString().c_str());
+        this, name.c_str(), xds_client_.get(),
+        cluster_data->ToString().c_str());
   }
   // Store the update in the map if we are still interested in watching this
   // cluster (i.e., it is not cancelled already).
@@ -437,7 +441,7 @@ void CdsLb::OnClusterChanged(const std::string& name,
   it->second.update = cluster_data;
   // Take care of integration with new certificate code.
   grpc_error_handle error = GRPC_ERROR_NONE;
-  error = UpdateXdsCertificateProvider(name, it->second.update.value());
+  error = UpdateXdsCertificateProvider(name, *it->second.update);
   if (error != GRPC_ERROR_NONE) {
     return OnError(name, error);
   }
@@ -451,9 +455,9 @@ void CdsLb::OnClusterChanged(const std::string& name,
           config_->cluster(), &discovery_mechanisms, &clusters_needed)) {
     // Construct config for child policy.
     Json::Object xds_lb_policy;
-    if (cluster_data.lb_policy == "RING_HASH") {
+    if (cluster_data->lb_policy == "RING_HASH") {
       std::string hash_function;
-      switch (cluster_data.hash_function) {
+      switch (cluster_data->hash_function) {
         case XdsApi::CdsUpdate::HashFunction::XX_HASH:
           hash_function = "XX_HASH";
           break;
@@ -465,8 +469,8 @@ void CdsLb::OnClusterChanged(const std::string& name,
           break;
       }
       xds_lb_policy["RING_HASH"] = Json::Object{
-          {"min_ring_size", cluster_data.min_ring_size},
-          {"max_ring_size", cluster_data.max_ring_size},
+          {"min_ring_size", cluster_data->min_ring_size},
+          {"max_ring_size", cluster_data->max_ring_size},
           {"hash_function", hash_function},
       };
     } else {
@@ -19,6 +19,9 @@
 #include <inttypes.h>
 #include <limits.h>
 
+#include <algorithm>
+#include <memory>
+
 #include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 
@@ -182,7 +185,8 @@ class XdsClusterResolverLb : public LoadBalancingPolicy {
       ~EndpointWatcher() override {
         discovery_mechanism_.reset(DEBUG_LOCATION, "EndpointWatcher");
       }
-      void OnEndpointChanged(XdsApi::EdsUpdate update) override {
+      void OnEndpointChanged(
+          std::shared_ptr<const XdsApi::EdsUpdate> update) override {
         new Notifier(discovery_mechanism_, std::move(update));
       }
       void OnError(grpc_error_handle error) override {
@@ -196,7 +200,7 @@ class XdsClusterResolverLb : public LoadBalancingPolicy {
       class Notifier {
        public:
         Notifier(RefCountedPtr<EdsDiscoveryMechanism> discovery_mechanism,
-                 XdsApi::EdsUpdate update);
+                 std::shared_ptr<const XdsApi::EdsUpdate> update);
         Notifier(RefCountedPtr<EdsDiscoveryMechanism> discovery_mechanism,
                  grpc_error_handle error);
         explicit Notifier(
@@ -211,7 +215,7 @@ class XdsClusterResolverLb : public LoadBalancingPolicy {
 
         RefCountedPtr<EdsDiscoveryMechanism> discovery_mechanism_;
         grpc_closure closure_;
-        XdsApi::EdsUpdate update_;
+        std::shared_ptr<const XdsApi::EdsUpdate> update_;
         Type type_;
       };
 
@@ -271,7 +275,9 @@ class XdsClusterResolverLb : public LoadBalancingPolicy {
     RefCountedPtr<XdsApi::EdsUpdate::DropConfig> drop_config;
     // Populated only when an update has been delivered by the mechanism
     // but has not yet been applied to the LB policy's combined priority_list_.
-    absl::optional<XdsApi::EdsUpdate::PriorityList> pending_priority_list;
+    // This is the snapshot shared with the XdsClient cache; the priorities
+    // are only copied when building the combined list.
+    std::shared_ptr<const XdsApi::EdsUpdate> pending_update;
   };
 
   class Helper : public ChannelControlHelper {
@@ -303,7 +309,8 @@ class XdsClusterResolverLb : public LoadBalancingPolicy {
 
   void ShutdownLocked() override;
 
-  void OnEndpointChanged(size_t index, XdsApi::EdsUpdate update);
+  void OnEndpointChanged(size_t index,
+                         std::shared_ptr<const XdsApi::EdsUpdate> update);
   void OnError(size_t index, grpc_error_handle error);
   void OnResourceDoesNotExist(size_t index);
 
@@ -419,7 +426,7 @@ void XdsClusterResolverLb::EdsDiscoveryMechanism::Orphan() {
 XdsClusterResolverLb::EdsDiscoveryMechanism::EndpointWatcher::Notifier::
     Notifier(RefCountedPtr<XdsClusterResolverLb::EdsDiscoveryMechanism>
                  discovery_mechanism,
-             XdsApi::EdsUpdate update)
+             std::shared_ptr<const XdsApi::EdsUpdate> update)
     : discovery_mechanism_(std::move(discovery_mechanism)),
       update_(std::move(update)),
       type_(kUpdate) {
@@ -529,14 +536,14 @@ void XdsClusterResolverLb::LogicalDNSDiscoveryMechanism::Orphan() {
 void XdsClusterResolverLb::LogicalDNSDiscoveryMechanism::ResolverResultHandler::
     ReturnResult(Resolver::Result result) {
   // convert result to eds update
-  XdsApi::EdsUpdate update;
+  auto update = std::make_shared<XdsApi::EdsUpdate>();
   XdsApi::EdsUpdate::Priority::Locality locality;
   locality.name = MakeRefCounted<XdsLocalityName>("", "", "");
   locality.lb_weight = 1;
   locality.endpoints = std::move(result.addresses);
   XdsApi::EdsUpdate::Priority priority;
   priority.localities.emplace(locality.name.get(), std::move(locality));
-  update.priorities.emplace_back(std::move(priority));
+  update->priorities.emplace_back(std::move(priority));
   discovery_mechanism_->parent()->OnEndpointChanged(
       discovery_mechanism_->index(), std::move(update));
 }
@@ -675,8 +682,8 @@ void XdsClusterResolverLb::ExitIdleLocked() {
   if (child_policy_ != nullptr) child_policy_->ExitIdleLocked();
 }
 
-void XdsClusterResolverLb::OnEndpointChanged(size_t index,
-                                             XdsApi::EdsUpdate update) {
+void XdsClusterResolverLb::OnEndpointChanged(
+    size_t index, std::shared_ptr<const XdsApi::EdsUpdate> update) {
   if (shutting_down_) return;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_xds_cluster_resolver_trace)) {
     gpr_log(GPR_INFO,
@@ -684,14 +691,8 @@ void XdsClusterResolverLb::OnEndpointChanged(size_t index,
             " for discovery mechanism %" PRIuPTR "",
             this, index);
   }
-  // We need at least one priority for each discovery mechanism, just so that we
-  // have a child in which to create the xds_cluster_impl policy.  This ensures
-  // that we properly handle the case of a discovery mechanism dropping 100% of
-  // calls, the OnError() case, and the OnResourceDoesNotExist() case.
-  if (update.priorities.empty()) update.priorities.emplace_back();
-  discovery_mechanisms_[index].drop_config = std::move(update.drop_config);
-  discovery_mechanisms_[index].pending_priority_list =
-      std::move(update.priorities);
+  discovery_mechanisms_[index].drop_config = update->drop_config;
+  discovery_mechanisms_[index].pending_update = std::move(update);
   discovery_mechanisms_[index].first_update_received = true;
   // If any discovery mechanism has not received its first update,
   // wait until that happens before creating the child policy.
@@ -712,13 +713,20 @@ void XdsClusterResolverLb::OnEndpointChanged(size_t index,
     // If the mechanism has a pending update, use that.
     // Otherwise, use the priorities that it previously contributed to the
     // combined list.
-    if (mechanism.pending_priority_list.has_value()) {
-      priority_list.insert(priority_list.end(),
-                           mechanism.pending_priority_list->begin(),
-                           mechanism.pending_priority_list->end());
+    if (mechanism.pending_update != nullptr) {
+      const XdsApi::EdsUpdate::PriorityList& priorities =
+          mechanism.pending_update->priorities;
+      priority_list.insert(priority_list.end(), priorities.begin(),
+                           priorities.end());
+      // We need at least one priority for each discovery mechanism, just so
+      // that we have a child in which to create the xds_cluster_impl policy.
+      // This ensures that we properly handle the case of a discovery
+      // mechanism dropping 100% of calls, the OnError() case, and the
+      // OnResourceDoesNotExist() case.
+      if (priorities.empty()) priority_list.emplace_back();
       priority_index += mechanism.num_priorities;
-      mechanism.num_priorities = mechanism.pending_priority_list->size();
-      mechanism.pending_priority_list.reset();
+      mechanism.num_priorities = std::max<size_t>(priorities.size(), 1);
+      mechanism.pending_update.reset();
     } else {
       priority_list.insert(
           priority_list.end(), priority_list_.begin() + priority_index,
@@ -740,7 +748,7 @@ void XdsClusterResolverLb::OnError(size_t index, grpc_error_handle error) {
   if (!discovery_mechanisms_[index].first_update_received) {
     // Call OnEndpointChanged with an empty update just like
     // OnResourceDoesNotExist.
-    OnEndpointChanged(index, XdsApi::EdsUpdate());
+    OnEndpointChanged(index, std::make_shared<const XdsApi::EdsUpdate>());
   }
 }
 
@@ -751,7 +759,7 @@ void XdsClusterResolverLb::OnResourceDoesNotExist(size_t index) {
           this, index);
   if (shutting_down_) return;
   // Call OnEndpointChanged with an empty update.
-  OnEndpointChanged(index, XdsApi::EdsUpdate());
+  OnEndpointChanged(index, std::make_shared<const XdsApi::EdsUpdate>());
 }
 
 //
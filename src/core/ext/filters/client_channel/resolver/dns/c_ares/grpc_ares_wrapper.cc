@@ -26,6 +26,11 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -34,6 +39,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/sync.h>
 #include <grpc/support/time.h>
 
 #include <address_sorting/address_sorting.h>
@@ -41,11 +47,15 @@
 #include "src/core/lib/address_utils/parse_address.h"
 #include "src/core/lib/address_utils/sockaddr_utils.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 #include "src/core/lib/iomgr/nameser.h"
+#include "src/core/lib/iomgr/pollset_set.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/transport/authority_override.h"
 
@@ -57,7 +67,20 @@ grpc_core::TraceFlag grpc_trace_cares_address_sorting(false,
 
 grpc_core::TraceFlag grpc_trace_cares_resolver(false, "cares_resolver");
 
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_dns_ares_cache_ttl_ms, 0,
+    "How long the result of a DNS lookup is reused for later lookups of the "
+    "same name, in milliseconds. 0 (the default) turns off caching, so that "
+    "only concurrent lookups of the same name share a query.");
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_dns_ares_negative_cache_ttl_ms, 1000,
+    "How long a DNS lookup that found that the name does not exist is reused "
+    "for later lookups of the same name, in milliseconds. Never longer than "
+    "grpc_dns_ares_cache_ttl_ms.");
+
 typedef struct grpc_ares_ev_driver grpc_ares_ev_driver;
+struct grpc_ares_cache_entry;
 
 struct grpc_ares_request {
   /** indicates the DNS server to use, if specified */
@@ -78,6 +101,16 @@ struct grpc_ares_request {
 
   /** the errors explaining query failures, appended to in query callbacks */
   grpc_error_handle error;
+  /** whether a query failed without an answer from the DNS server, e.g. on a
+      timeout, in which case the result is not cached */
+  bool transient_failure;
+
+  /** the cache entry whose query this request is waiting on, if any; guarded
+      by g_cache_mu */
+  grpc_ares_cache_entry* cache_entry;
+  /** the pollset_set of the caller, linked to the cache entry's pollset_set
+      while waiting on its query */
+  grpc_pollset_set* interested_parties;
 };
 
 typedef struct fd_node {
@@ -654,6 +687,12 @@ static void destroy_hostbyname_request_locked(
   delete hr;
 }
 
+/* Returns true if \a status is an answer from the DNS server that the name or
+   record does not exist, as opposed to a failure to get an answer. */
+static bool is_negative_answer(int status) {
+  return status == ARES_ENOTFOUND || status == ARES_ENODATA;
+}
+
 static void on_hostbyname_done_locked(void* arg, int status, int /*timeouts*/,
                                       struct hostent* hostent) {
   grpc_ares_hostbyname_request* hr =
@@ -720,6 +759,7 @@ static void on_hostbyname_done_locked(void* arg, int status, int /*timeouts*/,
         hr->qtype, hr->host, hr->is_balancer, ares_strerror(status));
     GRPC_CARES_TRACE_LOG("request:%p on_hostbyname_done_locked: %s", r,
                          error_msg.c_str());
+    if (!is_negative_answer(status)) r->transient_failure = true;
     grpc_error_handle error =
         GRPC_ERROR_CREATE_FROM_COPIED_STRING(error_msg.c_str());
     r->error = grpc_error_add_child(error, r->error);
@@ -765,6 +805,7 @@ static void on_srv_query_done_locked(void* arg, int status, int /*timeouts*/,
         ares_strerror(status));
     GRPC_CARES_TRACE_LOG("request:%p on_srv_query_done_locked: %s", r,
                          error_msg.c_str());
+    if (!is_negative_answer(status)) r->transient_failure = true;
     grpc_error_handle error =
         GRPC_ERROR_CREATE_FROM_COPIED_STRING(error_msg.c_str());
     r->error = grpc_error_add_child(error, r->error);
@@ -826,6 +867,7 @@ fail:
   error = GRPC_ERROR_CREATE_FROM_COPIED_STRING(error_msg.c_str());
   GRPC_CARES_TRACE_LOG("request:%p on_txt_done_locked %s", r,
                        error_msg.c_str());
+  if (!is_negative_answer(status)) r->transient_failure = true;
   r->error = grpc_error_add_child(error, r->error);
 }
 
@@ -1057,13 +1099,269 @@ static bool grpc_ares_maybe_resolve_localhost_manually_locked(
 }
 #endif /* GRPC_ARES_RESOLVE_LOCALHOST_MANUALLY */
 
+/*
+ * Cache of DNS lookups
+ *
+ * Lookups are keyed by everything that affects their result. A lookup of a
+ * key that is already being resolved waits on that query instead of issuing
+ * its own, and a completed result is reused by later lookups until it
+ * expires. Each query runs on its own work_serializer and pollset_set, so
+ * that it does not depend on the channel that started it; the pollset_sets of
+ * the requests waiting on it are linked to the query's to drive its I/O.
+ */
+
+struct grpc_ares_cache_entry
+    : public grpc_core::RefCounted<grpc_ares_cache_entry> {
+  explicit grpc_ares_cache_entry(std::string cache_key)
+      : key(std::move(cache_key)),
+        pollset_set(grpc_pollset_set_create()),
+        work_serializer(std::make_shared<grpc_core::WorkSerializer>()) {}
+
+  ~grpc_ares_cache_entry() override {
+    gpr_free(service_config_json);
+    GRPC_ERROR_UNREF(error);
+  }
+
+  const std::string key;
+  /** the query in progress, or null once it has completed */
+  grpc_ares_request* query = nullptr;
+  /** pollset_set and work_serializer that the query runs on */
+  grpc_pollset_set* pollset_set;
+  const std::shared_ptr<grpc_core::WorkSerializer> work_serializer;
+  /** invoked when the query completes */
+  grpc_closure on_query_done;
+  /** requests waiting on the query */
+  std::vector<grpc_ares_request*> waiters;
+  /** result of the query, sorted once for all the requests */
+  std::unique_ptr<ServerAddressList> addresses;
+  std::unique_ptr<ServerAddressList> balancer_addresses;
+  char* service_config_json = nullptr;
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  /** time after which the result is no longer reused */
+  grpc_millis expiration = 0;
+};
+
+static gpr_once g_cache_once = GPR_ONCE_INIT;
+static gpr_mu g_cache_mu;
+/* Holds a ref to each entry; a query in progress holds another one. */
+static std::map<std::string, grpc_core::RefCountedPtr<grpc_ares_cache_entry>>*
+    g_cache;
+
+static void init_cache() {
+  gpr_mu_init(&g_cache_mu);
+  g_cache = new std::map<std::string,
+                         grpc_core::RefCountedPtr<grpc_ares_cache_entry>>();
+}
+
+/* Removes \a entry from g_cache, if it is still there. g_cache_mu must be
+   held. */
+static void cache_erase(grpc_ares_cache_entry* entry) {
+  auto it = g_cache->find(entry->key);
+  if (it != g_cache->end() && it->second.get() == entry) g_cache->erase(it);
+}
+
+/* Hands the result of \a entry to \a r. g_cache_mu must be held. */
+static void cache_entry_deliver(grpc_ares_cache_entry* entry,
+                                grpc_ares_request* r) {
+  if (entry->addresses != nullptr) {
+    *r->addresses_out =
+        absl::make_unique<ServerAddressList>(*entry->addresses);
+  }
+  if (r->balancer_addresses_out != nullptr &&
+      entry->balancer_addresses != nullptr) {
+    *r->balancer_addresses_out =
+        absl::make_unique<ServerAddressList>(*entry->balancer_addresses);
+  }
+  if (r->service_config_json_out != nullptr &&
+      entry->service_config_json != nullptr) {
+    *r->service_config_json_out = gpr_strdup(entry->service_config_json);
+  }
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, r->on_done,
+                          GRPC_ERROR_REF(entry->error));
+}
+
+/* Stops \a r from waiting on the query of \a entry. g_cache_mu must be
+   held. */
+static void cache_entry_remove_waiter(grpc_ares_cache_entry* entry,
+                                      grpc_ares_request* r) {
+  if (r->interested_parties != nullptr) {
+    grpc_pollset_set_del_pollset_set(r->interested_parties,
+                                     entry->pollset_set);
+  }
+  r->cache_entry = nullptr;
+}
+
+static void on_cache_query_done(void* arg, grpc_error_handle error) {
+  grpc_ares_cache_entry* entry = static_cast<grpc_ares_cache_entry*>(arg);
+  gpr_mu_lock(&g_cache_mu);
+  GRPC_CARES_TRACE_LOG("request:%p query for \"%s\" done: %s", entry->query,
+                       entry->key.c_str(),
+                       grpc_error_std_string(error).c_str());
+  const bool cacheable = !entry->query->transient_failure;
+  gpr_free(entry->query);
+  entry->query = nullptr;
+  entry->error = GRPC_ERROR_REF(error);
+  int32_t ttl_ms = GPR_GLOBAL_CONFIG_GET(grpc_dns_ares_cache_ttl_ms);
+  if (error != GRPC_ERROR_NONE) {
+    ttl_ms = GPR_MIN(
+        ttl_ms, GPR_GLOBAL_CONFIG_GET(grpc_dns_ares_negative_cache_ttl_ms));
+  }
+  if (cacheable && ttl_ms > 0) {
+    entry->expiration = grpc_core::ExecCtx::Get()->Now() + ttl_ms;
+  } else {
+    cache_erase(entry);
+  }
+  for (grpc_ares_request* r : entry->waiters) {
+    cache_entry_remove_waiter(entry, r);
+    cache_entry_deliver(entry, r);
+  }
+  entry->waiters.clear();
+  grpc_pollset_set* pollset_set = entry->pollset_set;
+  entry->pollset_set = nullptr;
+  gpr_mu_unlock(&g_cache_mu);
+  grpc_pollset_set_destroy(pollset_set);
+  entry->Unref();
+}
+
+/* Resolves \a name for \a r, through the cache. */
+static void grpc_dns_lookup_ares_cached_locked(
+    grpc_ares_request* r, const char* dns_server, const char* name,
+    const char* default_port, grpc_pollset_set* interested_parties,
+    int query_timeout_ms) {
+  gpr_once_init(&g_cache_once, init_cache);
+  std::string key = absl::StrFormat(
+      "%s %s %s%s %d%d %d", dns_server == nullptr ? "" : dns_server, name,
+      default_port == nullptr ? "-" : "+",
+      default_port == nullptr ? "" : default_port,
+      r->balancer_addresses_out != nullptr,
+      r->service_config_json_out != nullptr, query_timeout_ms);
+  grpc_core::RefCountedPtr<grpc_ares_cache_entry> new_entry;
+  gpr_mu_lock(&g_cache_mu);
+  auto it = g_cache->find(key);
+  if (it != g_cache->end() && it->second->query == nullptr &&
+      it->second->expiration <= grpc_core::ExecCtx::Get()->Now()) {
+    g_cache->erase(it);
+    it = g_cache->end();
+  }
+  grpc_ares_cache_entry* entry;
+  if (it != g_cache->end()) {
+    entry = it->second.get();
+    if (entry->query == nullptr) {
+      GRPC_CARES_TRACE_LOG("request:%p using cached result for \"%s\"", r,
+                           key.c_str());
+      cache_entry_deliver(entry, r);
+      gpr_mu_unlock(&g_cache_mu);
+      return;
+    }
+    GRPC_CARES_TRACE_LOG("request:%p waiting on query %p for \"%s\"", r,
+                         entry->query, key.c_str());
+  } else {
+    new_entry = grpc_core::MakeRefCounted<grpc_ares_cache_entry>(key);
+    entry = new_entry.get();
+    (*g_cache)[key] = entry->Ref();
+    grpc_ares_request* query =
+        static_cast<grpc_ares_request*>(gpr_zalloc(sizeof(grpc_ares_request)));
+    query->error = GRPC_ERROR_NONE;
+    GRPC_CLOSURE_INIT(&entry->on_query_done, on_cache_query_done, entry,
+                      grpc_schedule_on_exec_ctx);
+    query->on_done = &entry->on_query_done;
+    query->addresses_out = &entry->addresses;
+    if (r->balancer_addresses_out != nullptr) {
+      query->balancer_addresses_out = &entry->balancer_addresses;
+    }
+    if (r->service_config_json_out != nullptr) {
+      query->service_config_json_out = &entry->service_config_json;
+    }
+    entry->query = query;
+    GRPC_CARES_TRACE_LOG("request:%p starting query %p for \"%s\"", r, query,
+                         key.c_str());
+  }
+  r->cache_entry = entry;
+  r->interested_parties = interested_parties;
+  entry->waiters.push_back(r);
+  if (interested_parties != nullptr) {
+    grpc_pollset_set_add_pollset_set(interested_parties, entry->pollset_set);
+  }
+  grpc_ares_request* query = entry->query;
+  gpr_mu_unlock(&g_cache_mu);
+  if (new_entry == nullptr) return;
+  // The ref held by new_entry is released in on_cache_query_done().
+  new_entry.release();
+  const std::string dns_server_str = dns_server == nullptr ? "" : dns_server;
+  const std::string name_str = name;
+  const bool has_default_port = default_port != nullptr;
+  const std::string default_port_str = has_default_port ? default_port : "";
+  grpc_pollset_set* pollset_set = entry->pollset_set;
+  std::shared_ptr<grpc_core::WorkSerializer> work_serializer =
+      entry->work_serializer;
+  work_serializer->Run(
+      [query, dns_server_str, name_str, has_default_port, default_port_str,
+       pollset_set, query_timeout_ms, work_serializer]() {
+        grpc_dns_lookup_ares_continue_after_check_localhost_and_ip_literals_locked(
+            query, dns_server_str.c_str(), name_str.c_str(),
+            has_default_port ? default_port_str.c_str() : nullptr,
+            pollset_set, query_timeout_ms, work_serializer);
+      },
+      DEBUG_LOCATION);
+}
+
+/* Stops \a r from waiting on its cache entry's query, and cancels the query
+   if no other request is waiting on it. Returns false if \a r is not waiting
+   on a query. */
+static bool grpc_cancel_ares_request_cached_locked(grpc_ares_request* r) {
+  gpr_once_init(&g_cache_once, init_cache);
+  gpr_mu_lock(&g_cache_mu);
+  grpc_ares_cache_entry* entry = r->cache_entry;
+  if (entry == nullptr) {
+    gpr_mu_unlock(&g_cache_mu);
+    return false;
+  }
+  entry->waiters.erase(
+      std::find(entry->waiters.begin(), entry->waiters.end(), r));
+  cache_entry_remove_waiter(entry, r);
+  grpc_core::ExecCtx::Run(
+      DEBUG_LOCATION, r->on_done,
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("DNS request cancelled"));
+  grpc_core::RefCountedPtr<grpc_ares_cache_entry> unwanted_entry;
+  if (entry->waiters.empty()) {
+    // Nobody wants the result anymore. Keep later lookups from waiting on
+    // the query, and shut it down.
+    cache_erase(entry);
+    unwanted_entry = entry->Ref();
+  }
+  gpr_mu_unlock(&g_cache_mu);
+  if (unwanted_entry != nullptr) {
+    GRPC_CARES_TRACE_LOG("request:%p cancelling unwanted query for \"%s\"", r,
+                         unwanted_entry->key.c_str());
+    unwanted_entry->work_serializer->Run(
+        [unwanted_entry]() {
+          gpr_mu_lock(&g_cache_mu);
+          grpc_ares_request* query = unwanted_entry->query;
+          if (query != nullptr && query->ev_driver != nullptr) {
+            grpc_ares_ev_driver_shutdown_locked(query->ev_driver);
+          }
+          gpr_mu_unlock(&g_cache_mu);
+        },
+        DEBUG_LOCATION);
+  }
+  return true;
+}
+
+/* Drops all completed results from the cache. */
+static void grpc_ares_cache_flush() {
+  gpr_once_init(&g_cache_once, init_cache);
+  gpr_mu_lock(&g_cache_mu);
+  g_cache->clear();
+  gpr_mu_unlock(&g_cache_mu);
+}
+
 static grpc_ares_request* grpc_dns_lookup_ares_locked_impl(
     const char* dns_server, const char* name, const char* default_port,
     grpc_pollset_set* interested_parties, grpc_closure* on_done,
     std::unique_ptr<grpc_core::ServerAddressList>* addrs,
     std::unique_ptr<grpc_core::ServerAddressList>* balancer_addrs,
     char** service_config_json, int query_timeout_ms,
-    std::shared_ptr<grpc_core::WorkSerializer> work_serializer) {
+    std::shared_ptr<grpc_core::WorkSerializer> /*work_serializer*/) {
   grpc_ares_request* r =
       static_cast<grpc_ares_request*>(gpr_zalloc(sizeof(grpc_ares_request)));
   r->ev_driver = nullptr;
@@ -1095,10 +1393,10 @@ static grpc_ares_request* grpc_dns_lookup_ares_locked_impl(
     r->balancer_addresses_out = nullptr;
     r->service_config_json_out = nullptr;
   }
-  // Look up name using c-ares lib.
-  grpc_dns_lookup_ares_continue_after_check_localhost_and_ip_literals_locked(
-      r, dns_server, name, default_port, interested_parties, query_timeout_ms,
-      std::move(work_serializer));
+  // Look up name using c-ares lib, sharing the query and its result with
+  // other lookups of the same name.
+  grpc_dns_lookup_ares_cached_locked(r, dns_server, name, default_port,
+                                     interested_parties, query_timeout_ms);
   return r;
 }
 
@@ -1113,6 +1411,7 @@ grpc_ares_request* (*grpc_dns_lookup_ares_locked)(
 
 static void grpc_cancel_ares_request_locked_impl(grpc_ares_request* r) {
   GPR_ASSERT(r != nullptr);
+  if (grpc_cancel_ares_request_cached_locked(r)) return;
   if (r->ev_driver != nullptr) {
     grpc_ares_ev_driver_shutdown_locked(r->ev_driver);
   }
@@ -1135,10 +1434,13 @@ grpc_error_handle grpc_ares_init(void) {
   return GRPC_ERROR_NONE;
 }
 
-void grpc_ares_cleanup(void) { ares_library_cleanup(); }
+void grpc_ares_cleanup(void) {
+  grpc_ares_cache_flush();
+  ares_library_cleanup();
+}
 #else
 grpc_error_handle grpc_ares_init(void) { return GRPC_ERROR_NONE; }
-void grpc_ares_cleanup(void) {}
+void grpc_ares_cleanup(void) { grpc_ares_cache_flush(); }
 #endif  // GPR_WINDOWS
 
 /*
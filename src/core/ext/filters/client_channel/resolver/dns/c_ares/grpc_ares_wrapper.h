@@ -24,6 +24,7 @@
 #include <ares.h>
 
 #include "src/core/ext/filters/client_channel/server_address.h"
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/iomgr/polling_entity.h"
 #include "src/core/lib/iomgr/resolve_address.h"
@@ -31,6 +32,13 @@
 
 #define GRPC_DNS_ARES_DEFAULT_QUERY_TIMEOUT_MS 120000
 
+/* How long the results of grpc_dns_lookup_ares_locked() are shared with later
+   lookups of the same name, for lookups that found the name and for lookups
+   that found it does not exist.  Caching is off by default; concurrent
+   lookups of the same name share a single query regardless. */
+GPR_GLOBAL_CONFIG_DECLARE_INT32(grpc_dns_ares_cache_ttl_ms);
+GPR_GLOBAL_CONFIG_DECLARE_INT32(grpc_dns_ares_negative_cache_ttl_ms);
+
 extern grpc_core::TraceFlag grpc_trace_cares_address_sorting;
 
 extern grpc_core::TraceFlag grpc_trace_cares_resolver;
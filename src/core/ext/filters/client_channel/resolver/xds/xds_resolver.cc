@@ -31,6 +31,7 @@
 #include "src/core/ext/xds/xds_channel_args.h"
 #include "src/core/ext/xds/xds_client.h"
 #include "src/core/ext/xds/xds_http_filters.h"
+#include "src/core/ext/xds/xds_route_matcher.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
@@ -196,6 +197,7 @@ class XdsResolver : public Resolver {
 
     RefCountedPtr<XdsResolver> resolver_;
     RouteTable route_table_;
+    std::unique_ptr<XdsRouteMatcher> route_matcher_;
     std::map<absl::string_view, RefCountedPtr<ClusterState>> clusters_;
     std::vector<const grpc_channel_filter*> filters_;
     grpc_error_handle filter_error_ = GRPC_ERROR_NONE;
@@ -341,6 +343,12 @@ XdsResolver::XdsConfigSelector::XdsConfigSelector(
   // moving the entry in a reallocation will cause the string_view to point to
   // invalid data.
   route_table_.reserve(resolver_->current_virtual_host_.routes.size());
+  std::vector<const StringMatcher*> path_matchers;
+  path_matchers.reserve(resolver_->current_virtual_host_.routes.size());
+  for (auto& route : resolver_->current_virtual_host_.routes) {
+    path_matchers.push_back(&route.matchers.path_matcher);
+  }
+  route_matcher_ = absl::make_unique<XdsRouteMatcher>(path_matchers);
   for (auto& route : resolver_->current_virtual_host_.routes) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_resolver_trace)) {
       gpr_log(GPR_INFO, "[xds_resolver %p] XdsConfigSelector %p: route: %s",
@@ -588,12 +596,13 @@ bool UnderFraction(const uint32_t fraction_per_million) {
 
 ConfigSelector::CallConfig XdsResolver::XdsConfigSelector::GetCallConfig(
     GetCallConfigArgs args) {
-  for (const auto& entry : route_table_) {
-    // Path matching.
-    if (!entry.route.matchers.path_matcher.Match(
-            StringViewFromSlice(*args.path))) {
-      continue;
-    }
+  // Path matching.
+  std::vector<size_t> scratch;
+  const std::vector<size_t>& path_matched_routes =
+      route_matcher_->MatchingRoutes(StringViewFromSlice(*args.path),
+                                     &scratch);
+  for (size_t route_index : path_matched_routes) {
+    const auto& entry = route_table_[route_index];
     // Header Matching.
     if (!HeadersMatch(entry.route.matchers.header_matchers,
                       args.initial_metadata)) {
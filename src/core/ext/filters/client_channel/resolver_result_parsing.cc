@@ -177,11 +177,19 @@ ClientChannelServiceConfigParser::ParsePerMethodParams(
   grpc_millis timeout = 0;
   ParseJsonObjectFieldAsDuration(json.object_value(), "timeout", &timeout,
                                  &error_list, false);
+  // Parse streamWeight.
+  uint32_t stream_weight = 0;
+  if (ParseJsonObjectField(json.object_value(), "streamWeight", &stream_weight,
+                           &error_list, false) &&
+      stream_weight == 0) {
+    error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:streamWeight error:must be greater than 0"));
+  }
   // Return result.
   *error = GRPC_ERROR_CREATE_FROM_VECTOR("Client channel parser", &error_list);
   if (*error == GRPC_ERROR_NONE) {
-    return absl::make_unique<ClientChannelMethodParsedConfig>(timeout,
-                                                              wait_for_ready);
+    return absl::make_unique<ClientChannelMethodParsedConfig>(
+        timeout, wait_for_ready, stream_weight);
   }
   return nullptr;
 }
@@ -67,16 +67,24 @@ class ClientChannelMethodParsedConfig
     : public ServiceConfigParser::ParsedConfig {
  public:
   ClientChannelMethodParsedConfig(grpc_millis timeout,
-                                  const absl::optional<bool>& wait_for_ready)
-      : timeout_(timeout), wait_for_ready_(wait_for_ready) {}
+                                  const absl::optional<bool>& wait_for_ready,
+                                  uint32_t stream_weight = 0)
+      : timeout_(timeout),
+        wait_for_ready_(wait_for_ready),
+        stream_weight_(stream_weight) {}
 
   grpc_millis timeout() const { return timeout_; }
 
   absl::optional<bool> wait_for_ready() const { return wait_for_ready_; }
 
+  // Relative share of the connection's outgoing bandwidth for the call's
+  // stream (see GRPC_CONTEXT_STREAM_WEIGHT), or 0 if not set.
+  uint32_t stream_weight() const { return stream_weight_; }
+
  private:
   grpc_millis timeout_ = 0;
   absl::optional<bool> wait_for_ready_;
+  uint32_t stream_weight_ = 0;
 };
 
 class ClientChannelServiceConfigParser : public ServiceConfigParser::Parser {
@@ -54,6 +54,7 @@
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/transport/error_utils.h"
 #include "src/core/lib/transport/status_metadata.h"
+#include "src/core/lib/transport/transport.h"
 #include "src/core/lib/uri/uri_parser.h"
 
 // Strong and weak refs.
@@ -126,6 +127,124 @@ size_t ConnectedSubchannel::GetInitialCallSizeEstimate() const {
          channel_stack_->call_stack_size;
 }
 
+void ConnectedSubchannel::EnableConnectionPool(
+    WeakRefCountedPtr<Subchannel> subchannel, size_t max_connections,
+    size_t streams_per_connection, size_t spare_connections) {
+  MutexLock lock(&pool_mu_);
+  pooled_ = true;
+  subchannel_ = std::move(subchannel);
+  max_connections_ = max_connections;
+  streams_per_connection_ = streams_per_connection;
+  spare_connections_ = spare_connections;
+}
+
+bool ConnectedSubchannel::CanGrowLocked() {
+  return pool_.size() + 1 < max_connections_ && subchannel_ != nullptr &&
+         !growing_ && ExecCtx::Get()->Now() >= next_growth_time_;
+}
+
+size_t ConnectedSubchannel::IdleConnectionsLocked() {
+  size_t idle = active_streams_.load(std::memory_order_relaxed) == 0;
+  for (const auto& connection : pool_) {
+    idle += connection->active_streams_.load(std::memory_order_relaxed) == 0;
+  }
+  return idle;
+}
+
+RefCountedPtr<ConnectedSubchannel> ConnectedSubchannel::PickConnection(
+    bool* connection_requested) {
+  if (!pooled_) return Ref();
+  RefCountedPtr<ConnectedSubchannel> picked;
+  WeakRefCountedPtr<Subchannel> subchannel_to_grow;
+  bool growing;
+  {
+    MutexLock lock(&pool_mu_);
+    ConnectedSubchannel* best = this;
+    size_t best_streams = active_streams_.load(std::memory_order_relaxed);
+    for (const auto& connection : pool_) {
+      const size_t streams =
+          connection->active_streams_.load(std::memory_order_relaxed);
+      if (streams < best_streams) {
+        best = connection.get();
+        best_streams = streams;
+      }
+    }
+    picked = best->Ref();
+    // Ask for another connection if every connection is saturated, or if
+    // this call takes one of the last spare connections.
+    const size_t idle_after_pick =
+        IdleConnectionsLocked() - (best_streams == 0 ? 1 : 0);
+    if ((best_streams >= streams_per_connection_ ||
+         idle_after_pick < spare_connections_) &&
+        CanGrowLocked()) {
+      growing_ = true;
+      subchannel_to_grow = subchannel_;
+    }
+    growing = growing_;
+  }
+  if (subchannel_to_grow != nullptr) {
+    subchannel_to_grow->AttemptAdditionalConnection();
+  }
+  if (connection_requested != nullptr) *connection_requested = growing;
+  return picked;
+}
+
+bool ConnectedSubchannel::ShouldAddSpareConnection() {
+  MutexLock lock(&pool_mu_);
+  if (!pooled_ || IdleConnectionsLocked() >= spare_connections_ ||
+      !CanGrowLocked()) {
+    return false;
+  }
+  growing_ = true;
+  return true;
+}
+
+void ConnectedSubchannel::StreamStarted() {
+  if (pooled_) active_streams_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConnectedSubchannel::StreamFinished() {
+  if (pooled_) active_streams_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void ConnectedSubchannel::AddPooledConnection(
+    RefCountedPtr<ConnectedSubchannel> connection, uint64_t id) {
+  connection->pooled_ = true;
+  connection->pool_id_ = id;
+  MutexLock lock(&pool_mu_);
+  growing_ = false;
+  if (subchannel_ == nullptr) return;
+  pool_.push_back(std::move(connection));
+}
+
+void ConnectedSubchannel::PooledConnectionAttemptFailed() {
+  // Don't retry on every call while the backend refuses connections.
+  constexpr grpc_millis kRetryDelayMs = 1000;
+  MutexLock lock(&pool_mu_);
+  growing_ = false;
+  next_growth_time_ = ExecCtx::Get()->Now() + kRetryDelayMs;
+}
+
+void ConnectedSubchannel::RemovePooledConnection(uint64_t id) {
+  RefCountedPtr<ConnectedSubchannel> removed;
+  MutexLock lock(&pool_mu_);
+  for (auto it = pool_.begin(); it != pool_.end(); ++it) {
+    if ((*it)->pool_id_ == id) {
+      removed = std::move(*it);
+      pool_.erase(it);
+      break;
+    }
+  }
+}
+
+void ConnectedSubchannel::ShutdownConnectionPool() {
+  std::vector<RefCountedPtr<ConnectedSubchannel>> pool;
+  WeakRefCountedPtr<Subchannel> subchannel;
+  MutexLock lock(&pool_mu_);
+  pool.swap(pool_);
+  subchannel = std::move(subchannel_);
+}
+
 //
 // SubchannelCall
 //
@@ -142,6 +261,7 @@ RefCountedPtr<SubchannelCall> SubchannelCall::Create(Args args,
 SubchannelCall::SubchannelCall(Args args, grpc_error_handle* error)
     : connected_subchannel_(std::move(args.connected_subchannel)),
       deadline_(args.deadline) {
+  connected_subchannel_->StreamStarted();
   grpc_call_stack* callstk = SUBCHANNEL_CALL_TO_CALL_STACK(this);
   const grpc_call_element_args call_args = {
       callstk,           /* call_stack */
@@ -220,6 +340,7 @@ void SubchannelCall::Destroy(void* arg, grpc_error_handle /*error*/) {
   // call arena.
   grpc_call_stack_destroy(SUBCHANNEL_CALL_TO_CALL_STACK(self), nullptr,
                           after_call_stack_destroy);
+  connected_subchannel->StreamFinished();
   // Automatically reset connected_subchannel. This should be after destroying
   // the call stack, because destroying call stack needs access to the channel
   // stack.
@@ -326,6 +447,7 @@ class Subchannel::ConnectedSubchannelStateWatcher
                     c->connected_subchannel_.get(), c,
                     ConnectivityStateName(new_state));
           }
+          c->connected_subchannel_->ShutdownConnectionPool();
           c->connected_subchannel_.reset();
           if (c->channelz_node() != nullptr) {
             c->channelz_node()->SetChildSocket(nullptr);
@@ -357,6 +479,54 @@ class Subchannel::ConnectedSubchannelStateWatcher
   WeakRefCountedPtr<Subchannel> subchannel_;
 };
 
+//
+// Subchannel::PooledConnectionStateWatcher
+//
+
+// Removes an additional pooled connection from the pool when it fails.
+// Unlike the connected subchannel itself, losing a pooled connection does
+// not change the subchannel's connectivity state.
+class Subchannel::PooledConnectionStateWatcher
+    : public AsyncConnectivityStateWatcherInterface {
+ public:
+  PooledConnectionStateWatcher(WeakRefCountedPtr<Subchannel> c, uint64_t id)
+      : subchannel_(std::move(c)), id_(id) {}
+
+  ~PooledConnectionStateWatcher() override {
+    subchannel_.reset(DEBUG_LOCATION, "pooled_state_watcher");
+  }
+
+ private:
+  void OnConnectivityStateChange(grpc_connectivity_state new_state,
+                                 const absl::Status& status) override {
+    if (new_state != GRPC_CHANNEL_TRANSIENT_FAILURE &&
+        new_state != GRPC_CHANNEL_SHUTDOWN) {
+      return;
+    }
+    Subchannel* c = subchannel_.get();
+    MutexLock lock(&c->mu_);
+    if (grpc_trace_subchannel.enabled()) {
+      gpr_log(GPR_INFO,
+              "Pooled connection %" PRIu64 " of subchannel %p has gone into "
+              "%s.",
+              id_, c, ConnectivityStateName(new_state));
+    }
+    if (c->connected_subchannel_ != nullptr) {
+      c->connected_subchannel_->RemovePooledConnection(id_);
+      if (!c->disconnected_) c->MaybeAddSpareConnectionLocked();
+    }
+    // A GOAWAY with too_many_pings must slow down keepalive on every
+    // connection, not just on the one that received it.
+    if (!c->disconnected_ &&
+        status.GetPayload(kKeepaliveThrottlingKey).has_value()) {
+      c->ReportKeepaliveThrottlingLocked(status);
+    }
+  }
+
+  WeakRefCountedPtr<Subchannel> subchannel_;
+  const uint64_t id_;
+};
+
 // Asynchronously notifies the \a watcher of a change in the connectvity state
 // of \a subchannel to the current \a state. Deletes itself when done.
 class Subchannel::AsyncWatcherNotifierLocked {
@@ -482,6 +652,11 @@ class Subchannel::HealthWatcherMap::HealthWatcher
     }
   }
 
+  void ReportStatusLocked(const absl::Status& status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(subchannel_->mu_) {
+    watcher_list_.NotifyLocked(subchannel_.get(), state_, status);
+  }
+
   void Orphan() override {
     watcher_list_.Clear();
     health_check_client_.reset();
@@ -558,6 +733,13 @@ void Subchannel::HealthWatcherMap::NotifyLocked(grpc_connectivity_state state,
   }
 }
 
+void Subchannel::HealthWatcherMap::ReportStatusLocked(
+    const absl::Status& status) {
+  for (const auto& p : map_) {
+    p.second->ReportStatusLocked(status);
+  }
+}
+
 grpc_connectivity_state
 Subchannel::HealthWatcherMap::CheckConnectivityStateLocked(
     Subchannel* subchannel, const std::string& health_check_service_name) {
@@ -677,6 +859,12 @@ Subchannel::Subchannel(SubchannelKey key,
       GPR_ARRAY_SIZE(keys_to_remove), &new_arg, 1);
   gpr_free(new_arg.value.string);
   if (new_args != nullptr) grpc_channel_args_destroy(new_args);
+  max_connections_ = grpc_channel_args_find_integer(
+      args_, GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, {1, 1, INT_MAX});
+  streams_per_connection_ = grpc_channel_args_find_integer(
+      args_, GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION, {100, 1, INT_MAX});
+  spare_connections_ = grpc_channel_args_find_integer(
+      args_, GRPC_ARG_SUBCHANNEL_SPARE_CONNECTIONS, {0, 0, INT_MAX});
   GRPC_CLOSURE_INIT(&on_connecting_finished_, OnConnectingFinished, this,
                     grpc_schedule_on_exec_ctx);
   const grpc_arg* arg = grpc_channel_args_find(args_, GRPC_ARG_ENABLE_CHANNELZ);
@@ -821,6 +1009,33 @@ void Subchannel::AttemptToConnect() {
   MaybeStartConnectingLocked();
 }
 
+void Subchannel::AttemptAdditionalConnection() {
+  MutexLock lock(&mu_);
+  AttemptAdditionalConnectionLocked();
+}
+
+void Subchannel::AttemptAdditionalConnectionLocked() {
+  if (disconnected_ || connecting_ || connected_subchannel_ == nullptr) {
+    return;
+  }
+  connecting_ = true;
+  connecting_pooled_ = true;
+  WeakRef(DEBUG_LOCATION, "connecting")
+      .release();  // ref held by pending connect
+  SubchannelConnector::Args args;
+  args.interested_parties = pollset_set_;
+  args.deadline = min_connect_timeout_ms_ + ExecCtx::Get()->Now();
+  args.channel_args = args_;
+  connector_->Connect(args, &connecting_result_, &on_connecting_finished_);
+}
+
+void Subchannel::MaybeAddSpareConnectionLocked() {
+  if (connecting_ || connected_subchannel_ == nullptr) return;
+  if (connected_subchannel_->ShouldAddSpareConnection()) {
+    AttemptAdditionalConnectionLocked();
+  }
+}
+
 void Subchannel::ResetBackoff() {
   MutexLock lock(&mu_);
   backoff_.Reset();
@@ -844,6 +1059,9 @@ void Subchannel::Orphan() {
   GPR_ASSERT(!disconnected_);
   disconnected_ = true;
   connector_.reset();
+  if (connected_subchannel_ != nullptr) {
+    connected_subchannel_->ShutdownConnectionPool();
+  }
   connected_subchannel_.reset();
   health_watcher_map_.ShutdownLocked();
 }
@@ -927,6 +1145,13 @@ void Subchannel::SetConnectivityStateLocked(grpc_connectivity_state state,
   health_watcher_map_.NotifyLocked(state, status);
 }
 
+void Subchannel::ReportKeepaliveThrottlingLocked(const absl::Status& status) {
+  // Notify non-health watchers.
+  watcher_list_.NotifyLocked(this, state_, status);
+  // Notify health watchers.
+  health_watcher_map_.ReportStatusLocked(status);
+}
+
 void Subchannel::MaybeStartConnectingLocked() {
   if (disconnected_) {
     // Don't try to connect if we're already disconnected.
@@ -1005,14 +1230,25 @@ void Subchannel::OnConnectingFinished(void* arg, grpc_error_handle error) {
   {
     MutexLock lock(&c->mu_);
     c->connecting_ = false;
-    if (c->connecting_result_.transport != nullptr &&
-        c->PublishTransportLocked()) {
+    const bool pooled = c->connecting_pooled_;
+    c->connecting_pooled_ = false;
+    if (pooled && c->connected_subchannel_ != nullptr) {
+      c->PublishPooledTransportLocked();
+    } else if (c->connecting_result_.transport != nullptr &&
+               c->PublishTransportLocked()) {
       // Do nothing, transport was published.
     } else if (!c->disconnected_) {
       gpr_log(GPR_INFO, "Connect failed: %s",
               grpc_error_std_string(error).c_str());
-      c->SetConnectivityStateLocked(GRPC_CHANNEL_TRANSIENT_FAILURE,
-                                    grpc_error_to_absl_status(error));
+      if (pooled) {
+        // The connection this attempt was meant to supplement was lost
+        // while it was in flight, and any reconnection request made in
+        // the meantime was dropped, so reconnect now.
+        c->MaybeStartConnectingLocked();
+      } else {
+        c->SetConnectivityStateLocked(GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                      grpc_error_to_absl_status(error));
+      }
     }
   }
   grpc_channel_args_destroy(delete_channel_args);
@@ -1029,7 +1265,8 @@ void ConnectionDestroy(void* arg, grpc_error_handle /*error*/) {
 
 }  // namespace
 
-bool Subchannel::PublishTransportLocked() {
+RefCountedPtr<ConnectedSubchannel> Subchannel::CreateConnectedSubchannelLocked(
+    RefCountedPtr<channelz::SocketNode>* socket) {
   // Construct channel stack.
   grpc_channel_stack_builder* builder = grpc_channel_stack_builder_create();
   grpc_channel_stack_builder_set_channel_arguments(
@@ -1038,7 +1275,7 @@ bool Subchannel::PublishTransportLocked() {
                                            connecting_result_.transport);
   if (!grpc_channel_init_create_stack(builder, GRPC_CLIENT_SUBCHANNEL)) {
     grpc_channel_stack_builder_destroy(builder);
-    return false;
+    return nullptr;
   }
   grpc_channel_stack* stk;
   grpc_error_handle error = grpc_channel_stack_builder_finish(
@@ -1049,19 +1286,31 @@ bool Subchannel::PublishTransportLocked() {
     gpr_log(GPR_ERROR, "error initializing subchannel stack: %s",
             grpc_error_std_string(error).c_str());
     GRPC_ERROR_UNREF(error);
-    return false;
+    return nullptr;
   }
-  RefCountedPtr<channelz::SocketNode> socket =
-      std::move(connecting_result_.socket_node);
+  *socket = std::move(connecting_result_.socket_node);
   connecting_result_.Reset();
   if (disconnected_) {
     grpc_channel_stack_destroy(stk);
     gpr_free(stk);
-    return false;
+    return nullptr;
   }
-  // Publish.
-  connected_subchannel_.reset(
+  return RefCountedPtr<ConnectedSubchannel>(
       new ConnectedSubchannel(stk, args_, channelz_node_));
+}
+
+bool Subchannel::PublishTransportLocked() {
+  RefCountedPtr<channelz::SocketNode> socket;
+  RefCountedPtr<ConnectedSubchannel> connected_subchannel =
+      CreateConnectedSubchannelLocked(&socket);
+  if (connected_subchannel == nullptr) return false;
+  if (max_connections_ > 1) {
+    connected_subchannel->EnableConnectionPool(
+        WeakRef(DEBUG_LOCATION, "connection_pool"), max_connections_,
+        streams_per_connection_, spare_connections_);
+  }
+  // Publish.
+  connected_subchannel_ = std::move(connected_subchannel);
   gpr_log(GPR_INFO, "New connected subchannel at %p for subchannel %p",
           connected_subchannel_.get(), this);
   if (channelz_node_ != nullptr) {
@@ -1073,7 +1322,33 @@ bool Subchannel::PublishTransportLocked() {
                         WeakRef(DEBUG_LOCATION, "state_watcher")));
   // Report initial state.
   SetConnectivityStateLocked(GRPC_CHANNEL_READY, absl::Status());
+  MaybeAddSpareConnectionLocked();
   return true;
 }
 
+void Subchannel::PublishPooledTransportLocked() {
+  RefCountedPtr<channelz::SocketNode> socket;
+  RefCountedPtr<ConnectedSubchannel> connection;
+  if (connecting_result_.transport != nullptr) {
+    connection = CreateConnectedSubchannelLocked(&socket);
+  }
+  if (connection == nullptr) {
+    connected_subchannel_->PooledConnectionAttemptFailed();
+    return;
+  }
+  // Channelz only tracks the socket of the connected subchannel itself.
+  const uint64_t id = ++next_pooled_connection_id_;
+  if (grpc_trace_subchannel.enabled()) {
+    gpr_log(GPR_INFO,
+            "New pooled connection %" PRIu64 " at %p for subchannel %p", id,
+            connection.get(), this);
+  }
+  connection->StartWatch(pollset_set_,
+                         MakeOrphanable<PooledConnectionStateWatcher>(
+                             WeakRef(DEBUG_LOCATION, "pooled_state_watcher"),
+                             id));
+  connected_subchannel_->AddPooledConnection(std::move(connection), id);
+  MaybeAddSpareConnectionLocked();
+}
+
 }  // namespace grpc_core
@@ -21,7 +21,9 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <deque>
+#include <vector>
 
 #include "src/core/ext/filters/client_channel/client_channel_channelz.h"
 #include "src/core/ext/filters/client_channel/connector.h"
@@ -44,6 +46,7 @@
 
 namespace grpc_core {
 
+class Subchannel;
 class SubchannelCall;
 
 class ConnectedSubchannel : public RefCounted<ConnectedSubchannel> {
@@ -66,12 +69,82 @@ class ConnectedSubchannel : public RefCounted<ConnectedSubchannel> {
 
   size_t GetInitialCallSizeEstimate() const;
 
+  // Connection pooling.  When the owning subchannel is allowed more than
+  // one connection, the connection it publishes keeps the additional
+  // connections to the same address, and each call is started on the
+  // pooled connection with the fewest active streams.
+
+  // Turns this connection into the head of a pool of up to
+  // \a max_connections connections.  Once every connection carries
+  // \a streams_per_connection active streams, or fewer than
+  // \a spare_connections connections carry none, \a subchannel is asked
+  // to open another one.  Must be called before the connection is
+  // published.
+  void EnableConnectionPool(WeakRefCountedPtr<Subchannel> subchannel,
+                            size_t max_connections,
+                            size_t streams_per_connection,
+                            size_t spare_connections);
+
+  // Returns the connection with the fewest active streams on which to
+  // start a new call.  Returns this connection if pooling is not enabled.
+  // Sets *connection_requested if an attempt to open another connection is
+  // in flight, whether or not this pick asked for it; the caller should
+  // then poll on behalf of the connection attempt for as long as it can.
+  RefCountedPtr<ConnectedSubchannel> PickConnection(
+      bool* connection_requested = nullptr);
+
+  // Returns true if fewer than spare_connections connections carry no
+  // streams and the pool may grow.  The caller must then open another
+  // connection and report the outcome as for PickConnection().
+  bool ShouldAddSpareConnection();
+
+  // Track the number of active streams on a pooled connection.  Called by
+  // SubchannelCall.
+  void StreamStarted();
+  void StreamFinished();
+
+  // Called by the subchannel when an additional connection attempt
+  // finishes.  \a id identifies the connection to
+  // RemovePooledConnection().
+  void AddPooledConnection(RefCountedPtr<ConnectedSubchannel> connection,
+                           uint64_t id);
+  void PooledConnectionAttemptFailed();
+
+  // Called by the subchannel when a pooled connection is lost.
+  void RemovePooledConnection(uint64_t id);
+
+  // Drops all pooled connections and stops asking for new ones.
+  void ShutdownConnectionPool();
+
  private:
   grpc_channel_stack* channel_stack_;
   grpc_channel_args* args_;
   // ref counted pointer to the channelz node in this connected subchannel's
   // owning subchannel.
   RefCountedPtr<channelz::SubchannelNode> channelz_subchannel_;
+
+  // Set for every connection that belongs to a pool.  Written before the
+  // connection is visible to the data plane.
+  bool pooled_ = false;
+  uint64_t pool_id_ = 0;
+  std::atomic<size_t> active_streams_{0};
+
+  // Pool state, only used on the connection published by the subchannel.
+  Mutex pool_mu_;
+  WeakRefCountedPtr<Subchannel> subchannel_ ABSL_GUARDED_BY(pool_mu_);
+  std::vector<RefCountedPtr<ConnectedSubchannel>> pool_
+      ABSL_GUARDED_BY(pool_mu_);
+  size_t max_connections_ = 1;
+  size_t streams_per_connection_ = 0;
+  size_t spare_connections_ = 0;
+  // True while an additional connection attempt is in flight.
+  bool growing_ ABSL_GUARDED_BY(pool_mu_) = false;
+  // Earliest time at which another connection may be requested after a
+  // failed attempt.
+  grpc_millis next_growth_time_ ABSL_GUARDED_BY(pool_mu_) = 0;
+
+  bool CanGrowLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_mu_);
+  size_t IdleConnectionsLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_mu_);
 };
 
 // Implements the interface of RefCounted<>.
@@ -246,6 +319,11 @@ class Subchannel : public DualRefCounted<Subchannel> {
   // Attempt to connect to the backend.  Has no effect if already connected.
   void AttemptToConnect() ABSL_LOCKS_EXCLUDED(mu_);
 
+  // Opens an additional connection for the connection pool, if the
+  // subchannel is READY and no other connection attempt is in flight.
+  // The result is delivered to the published ConnectedSubchannel.
+  void AttemptAdditionalConnection() ABSL_LOCKS_EXCLUDED(mu_);
+
   // Resets the connection backoff of the subchannel.
   // TODO(roth): Move connection backoff out of subchannels and up into LB
   // policy code (probably by adding a SubchannelGroup between
@@ -318,6 +396,10 @@ class Subchannel : public DualRefCounted<Subchannel> {
     void NotifyLocked(grpc_connectivity_state state, const absl::Status& status)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&Subchannel::mu_);
 
+    // Reports \a status to the watchers without changing their state.
+    void ReportStatusLocked(const absl::Status& status)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&Subchannel::mu_);
+
     grpc_connectivity_state CheckConnectivityStateLocked(
         Subchannel* subchannel, const std::string& health_check_service_name)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&Subchannel::mu_);
@@ -331,6 +413,7 @@ class Subchannel : public DualRefCounted<Subchannel> {
   };
 
   class ConnectedSubchannelStateWatcher;
+  class PooledConnectionStateWatcher;
 
   class AsyncWatcherNotifierLocked;
 
@@ -339,6 +422,13 @@ class Subchannel : public DualRefCounted<Subchannel> {
                                   const absl::Status& status)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Passes a keepalive throttling payload in \a status on to the watchers
+  // without changing the subchannel's connectivity state, so that the
+  // channel throttles keepalive when a pooled connection gets a GOAWAY
+  // just as it does for the connected subchannel.
+  void ReportKeepaliveThrottlingLocked(const absl::Status& status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Methods for connection.
   void MaybeStartConnectingLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   static void OnRetryAlarm(void* arg, grpc_error_handle error)
@@ -347,6 +437,14 @@ class Subchannel : public DualRefCounted<Subchannel> {
   static void OnConnectingFinished(void* arg, grpc_error_handle error)
       ABSL_LOCKS_EXCLUDED(mu_);
   bool PublishTransportLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  RefCountedPtr<ConnectedSubchannel> CreateConnectedSubchannelLocked(
+      RefCountedPtr<channelz::SocketNode>* socket)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void PublishPooledTransportLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void AttemptAdditionalConnectionLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Opens another connection if the pool is short of spare connections.
+  void MaybeAddSpareConnectionLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   // The subchannel pool this subchannel is in.
   RefCountedPtr<SubchannelPoolInterface> subchannel_pool_;
@@ -371,6 +469,8 @@ class Subchannel : public DualRefCounted<Subchannel> {
   // Active connection, or null.
   RefCountedPtr<ConnectedSubchannel> connected_subchannel_ ABSL_GUARDED_BY(mu_);
   bool connecting_ ABSL_GUARDED_BY(mu_) = false;
+  // True if the attempt in flight is for an additional pooled connection.
+  bool connecting_pooled_ ABSL_GUARDED_BY(mu_) = false;
   bool disconnected_ ABSL_GUARDED_BY(mu_) = false;
 
   // Connectivity state tracking.
@@ -395,6 +495,13 @@ class Subchannel : public DualRefCounted<Subchannel> {
   bool retry_immediately_ ABSL_GUARDED_BY(mu_) = false;
   // Keepalive time period (-1 for unset)
   int keepalive_time_ ABSL_GUARDED_BY(mu_) = -1;
+
+  // Connection pool limits, from channel args.
+  size_t max_connections_ = 1;
+  size_t streams_per_connection_ = 0;
+  size_t spare_connections_ = 0;
+  // Identifies pooled connections to their state watchers.
+  uint64_t next_pooled_connection_id_ ABSL_GUARDED_BY(mu_) = 0;
 };
 
 }  // namespace grpc_core
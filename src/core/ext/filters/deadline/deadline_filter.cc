@@ -381,6 +381,13 @@ static bool maybe_add_deadline_filter(grpc_channel_stack_builder* builder,
 }
 
 void grpc_deadline_filter_init(void) {
+  grpc_channel_filter_register_handled_ops(
+      &grpc_client_deadline_filter,
+      GRPC_STREAM_OP_CANCEL_STREAM | GRPC_STREAM_OP_RECV_TRAILING_METADATA);
+  grpc_channel_filter_register_handled_ops(
+      &grpc_server_deadline_filter, GRPC_STREAM_OP_CANCEL_STREAM |
+                                        GRPC_STREAM_OP_RECV_INITIAL_METADATA |
+                                        GRPC_STREAM_OP_RECV_TRAILING_METADATA);
   grpc_channel_init_register_stage(
       GRPC_CLIENT_DIRECT_CHANNEL, GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
       maybe_add_deadline_filter,
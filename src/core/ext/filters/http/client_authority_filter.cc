@@ -148,6 +148,8 @@ static bool add_client_authority_filter(grpc_channel_stack_builder* builder,
 }
 
 void grpc_client_authority_filter_init(void) {
+  grpc_channel_filter_register_handled_ops(
+      &grpc_client_authority_filter, GRPC_STREAM_OP_SEND_INITIAL_METADATA);
   grpc_channel_init_register_stage(
       GRPC_CLIENT_SUBCHANNEL, INT_MAX, add_client_authority_filter,
       const_cast<grpc_channel_filter*>(&grpc_client_authority_filter));
@@ -73,6 +73,18 @@ static bool maybe_add_required_filter(grpc_channel_stack_builder* builder,
 }
 
 void grpc_http_filters_init(void) {
+  grpc_channel_filter_register_handled_ops(
+      &grpc_http_client_filter, GRPC_STREAM_OP_SEND_INITIAL_METADATA |
+                                    GRPC_STREAM_OP_RECV_INITIAL_METADATA |
+                                    GRPC_STREAM_OP_RECV_TRAILING_METADATA);
+  grpc_channel_filter_register_handled_ops(
+      &grpc_http_server_filter,
+      GRPC_STREAM_OP_ALL &
+          ~(GRPC_STREAM_OP_SEND_MESSAGE | GRPC_STREAM_OP_CANCEL_STREAM));
+  grpc_channel_filter_register_handled_ops(
+      &grpc_core::MessageDecompressFilter,
+      GRPC_STREAM_OP_RECV_INITIAL_METADATA | GRPC_STREAM_OP_RECV_MESSAGE |
+          GRPC_STREAM_OP_RECV_TRAILING_METADATA);
   grpc_channel_init_register_stage(
       GRPC_CLIENT_SUBCHANNEL, GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
       maybe_add_optional_filter<false>, &compress_filter);
@@ -388,6 +388,10 @@ static bool maybe_add_message_size_filter(grpc_channel_stack_builder* builder,
 }
 
 void grpc_message_size_filter_init(void) {
+  grpc_channel_filter_register_handled_ops(
+      &grpc_message_size_filter, GRPC_STREAM_OP_SEND_MESSAGE |
+                                     GRPC_STREAM_OP_RECV_MESSAGE |
+                                     GRPC_STREAM_OP_RECV_TRAILING_METADATA);
   grpc_channel_init_register_stage(
       GRPC_CLIENT_SUBCHANNEL, GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
       maybe_add_message_size_filter_subchannel, nullptr);
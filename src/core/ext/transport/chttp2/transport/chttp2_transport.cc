@@ -60,6 +60,9 @@
 #define DEFAULT_CONNECTION_WINDOW_TARGET (1024 * 1024)
 #define MAX_WINDOW 0x7fffffffu
 #define MAX_WRITE_BUFFER_SIZE (64 * 1024 * 1024)
+#define DEFAULT_TARGET_WRITE_SIZE (1024 * 1024)
+#define MIN_TARGET_WRITE_SIZE (16 * 1024)
+#define MAX_STREAM_WRITE_WEIGHT 256u
 #define DEFAULT_MAX_HEADER_LIST_SIZE (8 * 1024)
 
 #define DEFAULT_CLIENT_KEEPALIVE_TIME_MS INT_MAX
@@ -284,6 +287,15 @@ static bool read_channel_args(grpc_chttp2_transport* t,
         grpc_chttp2_hpack_compressor_set_max_usable_size(
             &t->hpack_compressor, static_cast<uint32_t>(value));
       }
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_HPACK_ENCODER_EXACT_INDEX)) {
+      if (grpc_channel_arg_get_bool(&channel_args->args[i], false)) {
+        grpc_chttp2_hpack_compressor_enable_exact_index(&t->hpack_compressor);
+      }
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_STREAM_MEMORY_BUDGET)) {
+      t->stream_memory_budget =
+          grpc_channel_arg_get_integer(&channel_args->args[i], {0, 0, INT_MAX});
     } else if (0 == strcmp(channel_args->args[i].key,
                            GRPC_ARG_HTTP2_MAX_PINGS_WITHOUT_DATA)) {
       t->ping_policy.max_pings_without_data = grpc_channel_arg_get_integer(
@@ -306,6 +318,28 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                            GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE)) {
       t->write_buffer_size = static_cast<uint32_t>(grpc_channel_arg_get_integer(
           &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_TARGET_WRITE_SIZE)) {
+      t->target_write_size =
+          static_cast<uint32_t>(grpc_channel_arg_get_integer(
+              &channel_args->args[i],
+              {DEFAULT_TARGET_WRITE_SIZE, MIN_TARGET_WRITE_SIZE,
+               MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_ADAPTIVE_WRITE_SIZE)) {
+      t->adaptive_write_size =
+          grpc_channel_arg_get_bool(&channel_args->args[i], false);
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_STREAM_SCHEDULER)) {
+      const char* value = grpc_channel_arg_get_string(&channel_args->args[i]);
+      if (value == nullptr || 0 == strcmp(value, "drr")) {
+        t->stream_scheduler = GRPC_CHTTP2_STREAM_SCHEDULER_DRR;
+      } else if (0 == strcmp(value, "fifo")) {
+        t->stream_scheduler = GRPC_CHTTP2_STREAM_SCHEDULER_FIFO;
+      } else {
+        gpr_log(GPR_ERROR, "%s: unknown stream scheduler '%s', using drr",
+                GRPC_ARG_HTTP2_STREAM_SCHEDULER, value);
+      }
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
       enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
@@ -513,6 +547,9 @@ grpc_chttp2_transport::grpc_chttp2_transport(
     flow_control.Init<grpc_core::chttp2::TransportFlowControlDisabled>(this);
     enable_bdp = false;
   }
+  // Adaptive write sizing follows the BDP estimate, which is only updated
+  // while BDP probing is on.
+  if (!enable_bdp) adaptive_write_size = false;
 
   // No pings allowed before receiving a header or data frame.
   ping_state.pings_before_data_required = 0;
@@ -1417,6 +1454,17 @@ static void perform_stream_op_locked(void* stream_op,
     GPR_ASSERT(s->send_initial_metadata_finished == nullptr);
     on_complete->next_data.scratch |= CLOSURE_BARRIER_MAY_COVER_WRITE;
 
+    if (s->context != nullptr) {
+      const uintptr_t weight = reinterpret_cast<uintptr_t>(
+          static_cast<grpc_call_context_element*>(s->context)
+              [GRPC_CONTEXT_STREAM_WEIGHT]
+                  .value);
+      if (weight != 0) {
+        s->write_weight = static_cast<uint32_t>(
+            GPR_MIN(weight, MAX_STREAM_WRITE_WEIGHT));
+      }
+    }
+
     // Identify stream compression
     if (op_payload->send_initial_metadata.send_initial_metadata->idx.named
                 .content_encoding == nullptr ||
@@ -187,7 +187,8 @@ TransportFlowControl::TransportFlowControl(const grpc_chttp2_transport* t,
                           .set_min_control_value(-1)
                           .set_max_control_value(25)
                           .set_integral_range(10)),
-      last_pid_update_(grpc_core::ExecCtx::Get()->Now()) {}
+      last_pid_update_(grpc_core::ExecCtx::Get()->Now()),
+      stream_memory_budget_(t->stream_memory_budget) {}
 
 uint32_t TransportFlowControl::MaybeSendUpdate(bool writing_anyway) {
   FlowControlTrace trace("t updt sent", this, nullptr);
@@ -217,7 +218,24 @@ grpc_error_handle TransportFlowControl::ValidateRecvData(
 
 StreamFlowControl::StreamFlowControl(TransportFlowControl* tfc,
                                      const grpc_chttp2_stream* s)
-    : tfc_(tfc), s_(s) {}
+    : tfc_(tfc), s_(s), last_rate_sample_(grpc_core::ExecCtx::Get()->Now()) {
+  if (tfc_->stream_memory_budget_enabled()) tfc_->AddBudgetedStream();
+}
+
+void StreamFlowControl::UpdateConsumptionRate(int64_t received_bytes) {
+  bytes_since_rate_sample_ += received_bytes;
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+  // Sample at most every 100ms, smoothing over the previous samples.
+  const grpc_millis kRateSamplePeriod = 100;
+  if (now - last_rate_sample_ < kRateSamplePeriod) return;
+  const double dt = static_cast<double>(now - last_rate_sample_) * 1e-3;
+  const double rate = 0.5 * consumption_rate_ +
+                      0.5 * static_cast<double>(bytes_since_rate_sample_) / dt;
+  tfc_->UpdateBudgetedStreamRate(consumption_rate_, rate);
+  consumption_rate_ = rate;
+  bytes_since_rate_sample_ = 0;
+  last_rate_sample_ = now;
+}
 
 grpc_error_handle StreamFlowControl::RecvData(int64_t incoming_frame_size) {
   FlowControlTrace trace("  data recv", tfc_, this);
@@ -259,6 +277,9 @@ grpc_error_handle StreamFlowControl::RecvData(int64_t incoming_frame_size) {
   UpdateAnnouncedWindowDelta(tfc_, -incoming_frame_size);
   local_window_delta_ -= incoming_frame_size;
   tfc_->CommitRecvData(incoming_frame_size);
+  if (tfc_->stream_memory_budget_enabled()) {
+    UpdateConsumptionRate(incoming_frame_size);
+  }
   return GRPC_ERROR_NONE;
 }
 
@@ -297,6 +318,19 @@ void StreamFlowControl::IncomingByteStreamUpdate(size_t max_size_hint,
 
   /* add some small lookahead to keep pipelines flowing */
   GPR_DEBUG_ASSERT(max_recv_bytes <= kMaxWindowUpdateSize - sent_init_window);
+  if (tfc_->stream_memory_budget_enabled()) {
+    /* open the window no further than this stream's share of the budget; the
+       share may be below the initial window, but is never zero, so the stream
+       always makes progress */
+    UpdateConsumptionRate(0);
+    const int64_t target_delta =
+        GPR_MIN(static_cast<int64_t>(max_recv_bytes),
+                tfc_->StreamWindowCap(consumption_rate_) - sent_init_window);
+    if (local_window_delta_ < target_delta) {
+      local_window_delta_ = target_delta;
+    }
+    return;
+  }
   if (local_window_delta_ < max_recv_bytes) {
     uint32_t add_max_recv_bytes =
         static_cast<uint32_t>(max_recv_bytes - local_window_delta_);
@@ -304,15 +338,16 @@ void StreamFlowControl::IncomingByteStreamUpdate(size_t max_size_hint,
   }
 }
 
+static const double kLowMemPressure = 0.1;
+static const double kZeroTarget = 22;
+static const double kHighMemPressure = 0.8;
+static const double kMaxMemPressure = 0.9;
+
 // Take in a target and modifies it based on the memory pressure of the system
 static double AdjustForMemoryPressure(grpc_resource_quota* quota,
                                       double target) {
   // do not increase window under heavy memory pressure.
   double memory_pressure = grpc_resource_quota_get_memory_pressure(quota);
-  static const double kLowMemPressure = 0.1;
-  static const double kZeroTarget = 22;
-  static const double kHighMemPressure = 0.8;
-  static const double kMaxMemPressure = 0.9;
   if (memory_pressure < kLowMemPressure && target < kZeroTarget) {
     target = (target - kZeroTarget) * memory_pressure / kLowMemPressure +
              kZeroTarget;
@@ -329,6 +364,30 @@ double TransportFlowControl::TargetLogBdp() {
       1 + log2(bdp_estimator_.EstimateBdp()));
 }
 
+int64_t TransportFlowControl::EffectiveStreamMemoryBudget() const {
+  // Shrink the budget linearly towards zero between high and max pressure.
+  double memory_pressure = grpc_resource_quota_get_memory_pressure(
+      grpc_resource_user_quota(grpc_endpoint_get_resource_user(t_->ep)));
+  double budget = static_cast<double>(stream_memory_budget_);
+  if (memory_pressure > kHighMemPressure) {
+    budget *= 1 - GPR_MIN(1, (memory_pressure - kHighMemPressure) /
+                                 (kMaxMemPressure - kHighMemPressure));
+  }
+  return static_cast<int64_t>(budget);
+}
+
+int64_t TransportFlowControl::StreamWindowCap(double rate) const {
+  // Streams that have consumed nothing yet still get an equal share of the
+  // floor, so new streams are not starved by established fast ones.
+  const double kStreamRateFloor = 4096;
+  const double streams = static_cast<double>(GPR_MAX(budgeted_streams_, 1));
+  const double total_rate =
+      GPR_MAX(total_stream_rate_, 0) + streams * kStreamRateFloor;
+  const double share = static_cast<double>(EffectiveStreamMemoryBudget()) *
+                       (rate + kStreamRateFloor) / total_rate;
+  return static_cast<int64_t> GPR_CLAMP(share, kMinStreamWindow, kMaxWindow);
+}
+
 double TransportFlowControl::SmoothLogBdp(double value) {
   grpc_millis now = grpc_core::ExecCtx::Get()->Now();
   double bdp_error = value - pid_controller_.last_control_value();
@@ -368,6 +427,14 @@ FlowControlAction TransportFlowControl::PeriodicUpdate() {
     // Though initial window 'could' drop to 0, we keep the floor at 128
     target_initial_window_size_ =
         static_cast<int32_t> GPR_CLAMP(target, 128, INT32_MAX);
+    if (stream_memory_budget_enabled()) {
+      // Every stream may fill the initial window before the application
+      // reads, so keep their sum within the budget.
+      target_initial_window_size_ = GPR_MIN(
+          target_initial_window_size_,
+          GPR_MAX(kMinStreamWindow, EffectiveStreamMemoryBudget() /
+                                        GPR_MAX(budgeted_streams_, 1)));
+    }
 
     action.set_send_initial_window_update(
         DeltaUrgency(target_initial_window_size_,
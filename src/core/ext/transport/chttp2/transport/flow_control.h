@@ -47,6 +47,8 @@ static constexpr uint32_t kDefaultWindow = 65535;
 static constexpr int64_t kMaxWindow = static_cast<int64_t>((1u << 31) - 1);
 // TODO(ncteisen): Tune this
 static constexpr uint32_t kFrameSize = 1024 * 1024;
+// Smallest window a stream is left with when sharing a stream memory budget.
+static constexpr int64_t kMinStreamWindow = 4096;
 
 class TransportFlowControl;
 class StreamFlowControl;
@@ -295,11 +297,31 @@ class TransportFlowControl final : public TransportFlowControlBase {
     remote_window_ = 1024 * 1024 * 1024;
   }
 
+  // Bookkeeping for the streams sharing GRPC_ARG_HTTP2_STREAM_MEMORY_BUDGET.
+  // Rates are the bytes/sec each stream has recently been consuming.
+  bool stream_memory_budget_enabled() const {
+    return stream_memory_budget_ > 0;
+  }
+  void AddBudgetedStream() { ++budgeted_streams_; }
+  void RemoveBudgetedStream(double rate) {
+    --budgeted_streams_;
+    total_stream_rate_ -= rate;
+  }
+  void UpdateBudgetedStreamRate(double old_rate, double new_rate) {
+    total_stream_rate_ += new_rate - old_rate;
+  }
+
+  // The largest window a stream consuming \a rate bytes/sec may be given: its
+  // rate-weighted share of the budget, never less than kMinStreamWindow.
+  int64_t StreamWindowCap(double rate) const;
+
  private:
   double TargetLogBdp();
   double SmoothLogBdp(double value);
   FlowControlAction::Urgency DeltaUrgency(int64_t value,
                                           grpc_chttp2_setting_id setting_id);
+  // The stream memory budget after adjusting for memory pressure.
+  int64_t EffectiveStreamMemoryBudget() const;
 
   FlowControlAction UpdateAction(FlowControlAction action) {
     if (announced_window_ < target_window() / 2) {
@@ -330,6 +352,11 @@ class TransportFlowControl final : public TransportFlowControlBase {
   /* pid controller */
   grpc_core::PidController pid_controller_;
   grpc_millis last_pid_update_ = 0;
+
+  /* memory budget shared by all streams, or 0 if streams are unbudgeted */
+  const int64_t stream_memory_budget_;
+  int64_t budgeted_streams_ = 0;
+  double total_stream_rate_ = 0;
 };
 
 // Fat interface with all methods a stream flow control implementation needs
@@ -411,6 +438,9 @@ class StreamFlowControl final : public StreamFlowControlBase {
   StreamFlowControl(TransportFlowControl* tfc, const grpc_chttp2_stream* s);
   ~StreamFlowControl() override {
     tfc_->PreUpdateAnnouncedWindowOverIncomingWindow(announced_window_delta_);
+    if (tfc_->stream_memory_budget_enabled()) {
+      tfc_->RemoveBudgetedStream(consumption_rate_);
+    }
   }
 
   FlowControlAction UpdateAction(FlowControlAction action) override;
@@ -459,6 +489,15 @@ class StreamFlowControl final : public StreamFlowControlBase {
   TransportFlowControl* const tfc_;
   const grpc_chttp2_stream* const s_;
 
+  /* recent bytes/sec received by this stream; under flow control this can
+     only run ahead of the application by one window, so it tracks how fast
+     the application is consuming */
+  double consumption_rate_ = 0;
+  int64_t bytes_since_rate_sample_ = 0;
+  grpc_millis last_rate_sample_;
+
+  void UpdateConsumptionRate(int64_t received_bytes);
+
   void UpdateAnnouncedWindowDelta(TransportFlowControl* tfc, int64_t change) {
     tfc->PreUpdateAnnouncedWindowOverIncomingWindow(announced_window_delta_);
     announced_window_delta_ += change;
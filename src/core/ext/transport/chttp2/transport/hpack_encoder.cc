@@ -23,6 +23,9 @@
 #include <assert.h>
 #include <string.h>
 
+#include <deque>
+#include <unordered_map>
+
 /* This is here for grpc_is_binary_header
  * TODO(murgatroid99): Remove this
  */
@@ -257,8 +260,195 @@ static bool CanAddToHashtable(grpc_chttp2_hpack_compressor* hpack_compressor,
       hpack_compressor->filter_elems_sum / ONE_ON_ADD_PROBABILITY;
   return can_add;
 }
+
+static uint32_t mdelem_hash(grpc_mdelem elem) {
+  return GRPC_MDELEM_STORAGE(elem) == GRPC_MDELEM_STORAGE_INTERNED
+             ? reinterpret_cast<grpc_core::InternedMetadata*>(
+                   GRPC_MDELEM_DATA(elem))
+                   ->hash()
+             : reinterpret_cast<grpc_core::StaticMetadata*>(
+                   GRPC_MDELEM_DATA(elem))
+                   ->hash();
+}
 } /* namespace */
 
+namespace grpc_core {
+
+/* Exact-index mode for the hpack encoder.
+
+   The cuckoo tables above can only remember GRPC_CHTTP2_HPACKC_NUM_VALUES
+   elems and keys, and forget entries that are still in the decoder's table
+   whenever two values collide; the popularity filter likewise shares one
+   counter between every elem with the same hash fragment. With many distinct
+   headers both effects show up as literals that could have been indexed.
+
+   This index instead mirrors the decoder table entry for entry: every add is
+   appended to entries_ (in hpack index order) and every eviction pops the
+   oldest, so a lookup hit is always a live decoder entry. Admission follows
+   TinyLFU: a count-min sketch estimates how often each elem/key has been seen
+   recently, and when adding a new entry would evict one, it is only added if
+   it has been seen more often than the entry it would displace. Finally,
+   base64+huffman encoded binary values of frequent elems are cached so that
+   sending the same binary header as a literal does not re-encode it. */
+class HpackEncoderExactIndex {
+ public:
+  HpackEncoderExactIndex() {
+    memset(sketch_, 0, sizeof(sketch_));
+    memset(wire_cache_, 0, sizeof(wire_cache_));
+  }
+
+  ~HpackEncoderExactIndex() {
+    while (!entries_.empty()) {
+      Evict(entries_.front().index);
+    }
+    for (size_t i = 0; i < kWireCacheSize; i++) {
+      if (wire_cache_[i].elem.payload != 0) {
+        GRPC_MDELEM_UNREF(wire_cache_[i].elem);
+        grpc_slice_unref_internal(wire_cache_[i].wire);
+      }
+    }
+  }
+
+  HpackEncoderExactIndex(const HpackEncoderExactIndex&) = delete;
+  HpackEncoderExactIndex& operator=(const HpackEncoderExactIndex&) = delete;
+
+  /* hpack index of elem in the decoder table, or 0 if it is not there */
+  HpackEncoderIndex LookupElem(grpc_mdelem elem) const {
+    auto it = elems_.find(elem.payload);
+    return it == elems_.end() ? 0 : it->second;
+  }
+
+  /* hpack index of the newest decoder table entry with this key, or 0 */
+  HpackEncoderIndex LookupKey(const grpc_slice_refcount* key) const {
+    auto it = keys_.find(key);
+    return it == keys_.end() ? 0 : it->second;
+  }
+
+  void AddElem(grpc_mdelem elem, HpackEncoderIndex index, uint32_t hash) {
+    GPR_DEBUG_ASSERT(GRPC_MDELEM_IS_INTERNED(elem));
+    GPR_DEBUG_ASSERT(entries_.empty() || entries_.back().index < index);
+    entries_.push_back({index, GRPC_MDELEM_REF(elem), nullptr, hash});
+    elems_[elem.payload] = index;
+    keys_[GRPC_MDKEY(elem).refcount] = index;
+  }
+
+  void AddKey(grpc_slice_refcount* key, HpackEncoderIndex index,
+              uint32_t hash) {
+    GPR_DEBUG_ASSERT(entries_.empty() || entries_.back().index < index);
+    key->Ref();
+    entries_.push_back({index, {0}, key, hash});
+    keys_[key] = index;
+  }
+
+  /* the decoder dropped the entry at index, which must be the oldest one */
+  void Evict(HpackEncoderIndex index) {
+    GPR_ASSERT(!entries_.empty() && entries_.front().index == index);
+    const Entry entry = entries_.front();
+    entries_.pop_front();
+    grpc_slice_refcount* key = entry.key;
+    if (entry.elem.payload != 0) {
+      auto it = elems_.find(entry.elem.payload);
+      if (it != elems_.end() && it->second == index) elems_.erase(it);
+      key = GRPC_MDKEY(entry.elem).refcount;
+    }
+    auto it = keys_.find(key);
+    if (it != keys_.end() && it->second == index) keys_.erase(it);
+    if (entry.elem.payload != 0) {
+      GRPC_MDELEM_UNREF(entry.elem);
+    } else {
+      entry.key->Unref();
+    }
+  }
+
+  void RecordAccess(uint32_t hash) {
+    for (int row = 0; row < kSketchRows; row++) {
+      uint8_t* counter = &sketch_[row][SketchSlot(hash, row)];
+      if (*counter < kMaxFilterValue) ++*counter;
+    }
+    if (++sketch_additions_ == kSketchSampleSize) {
+      /* age: halve everything so that the sketch tracks recent popularity */
+      for (int row = 0; row < kSketchRows; row++) {
+        for (size_t i = 0; i < kSketchWidth; i++) {
+          sketch_[row][i] /= 2;
+        }
+      }
+      sketch_additions_ = 0;
+    }
+  }
+
+  /* should an entry with this hash be added to the decoder table, given
+     whether adding it will push older entries out? */
+  bool Admit(uint32_t hash, bool needs_eviction) const {
+    if (!needs_eviction || entries_.empty()) return true;
+    return EstimateFrequency(hash) >
+           EstimateFrequency(entries_.front().hash);
+  }
+
+  /* base64+huffman encoding of elem's value, served from the cache when
+     elem was encoded recently */
+  grpc_slice Base64WireValue(grpc_mdelem elem) {
+    const uint32_t hash = mdelem_hash(elem);
+    WireCacheEntry& entry = wire_cache_[hash % kWireCacheSize];
+    if (entry.elem.payload == elem.payload) {
+      return grpc_slice_ref_internal(entry.wire);
+    }
+    grpc_slice wire =
+        grpc_chttp2_base64_encode_and_huffman_compress(GRPC_MDVALUE(elem));
+    if (EstimateFrequency(hash) >= kMinWireCacheFrequency) {
+      if (entry.elem.payload != 0) {
+        GRPC_MDELEM_UNREF(entry.elem);
+        grpc_slice_unref_internal(entry.wire);
+      }
+      entry.elem = GRPC_MDELEM_REF(elem);
+      entry.wire = grpc_slice_ref_internal(wire);
+    }
+    return wire;
+  }
+
+ private:
+  static constexpr int kSketchRows = 4;
+  static constexpr size_t kSketchWidth = 256;
+  static constexpr uint32_t kSketchSampleSize = 10 * kSketchWidth;
+  static constexpr size_t kWireCacheSize = 64;
+  static constexpr uint8_t kMinWireCacheFrequency = 2;
+
+  struct Entry {
+    HpackEncoderIndex index;
+    /* exactly one of elem and key is set; the entry holds a ref to it */
+    grpc_mdelem elem;
+    grpc_slice_refcount* key;
+    uint32_t hash;
+  };
+
+  struct WireCacheEntry {
+    grpc_mdelem elem;
+    grpc_slice wire;
+  };
+
+  static size_t SketchSlot(uint32_t hash, int row) {
+    static const uint32_t kSeeds[kSketchRows] = {0x9e3779b1u, 0x85ebca77u,
+                                                 0xc2b2ae3du, 0x27d4eb2fu};
+    return (hash * kSeeds[row]) >> 24;
+  }
+
+  uint8_t EstimateFrequency(uint32_t hash) const {
+    uint8_t estimate = kMaxFilterValue;
+    for (int row = 0; row < kSketchRows; row++) {
+      estimate = GPR_MIN(estimate, sketch_[row][SketchSlot(hash, row)]);
+    }
+    return estimate;
+  }
+
+  std::deque<Entry> entries_;
+  std::unordered_map<uintptr_t, HpackEncoderIndex> elems_;
+  std::unordered_map<const grpc_slice_refcount*, HpackEncoderIndex> keys_;
+  uint8_t sketch_[kSketchRows][kSketchWidth];
+  uint32_t sketch_additions_ = 0;
+  WireCacheEntry wire_cache_[kWireCacheSize];
+};
+
+}  // namespace grpc_core
+
 struct framer_state {
   int is_first_frame;
   /* number of bytes in 'output' when we started the frame - used to calculate
@@ -396,6 +586,9 @@ static void evict_entry(grpc_chttp2_hpack_compressor* c) {
       c->table_size -
       c->table_elem_size[c->tail_remote_index % c->cap_table_elems]);
   c->table_elems--;
+  if (c->exact_index != nullptr) {
+    c->exact_index->Evict(c->tail_remote_index);
+  }
 }
 
 // Reserve space in table for the new element, evict entries if needed.
@@ -489,7 +682,8 @@ struct wire_value {
 };
 
 template <bool mdkey_definitely_interned>
-static wire_value get_wire_value(grpc_mdelem elem, bool true_binary_enabled) {
+static wire_value get_wire_value(grpc_chttp2_hpack_compressor* c,
+                                 grpc_mdelem elem, bool true_binary_enabled) {
   const bool is_bin_hdr =
       mdkey_definitely_interned
           ? grpc_is_refcounted_slice_binary_header(GRPC_MDKEY(elem))
@@ -501,6 +695,9 @@ static wire_value get_wire_value(grpc_mdelem elem, bool true_binary_enabled) {
       return wire_value(0x00, true, grpc_slice_ref_internal(value));
     } else {
       GRPC_STATS_INC_HPACK_SEND_BINARY_BASE64();
+      if (c->exact_index != nullptr && GRPC_MDELEM_IS_INTERNED(elem)) {
+        return wire_value(0x80, false, c->exact_index->Base64WireValue(elem));
+      }
       return wire_value(0x80, false,
                         grpc_chttp2_base64_encode_and_huffman_compress(value));
     }
@@ -523,7 +720,7 @@ enum class EmitLitHdrVType { INC_IDX_V, NO_IDX_V };
 }  // namespace
 
 template <EmitLitHdrType type>
-static void emit_lithdr(grpc_chttp2_hpack_compressor* /*c*/, uint32_t key_index,
+static void emit_lithdr(grpc_chttp2_hpack_compressor* c, uint32_t key_index,
                         grpc_mdelem elem, framer_state* st) {
   switch (type) {
     case EmitLitHdrType::INC_IDX:
@@ -537,7 +734,7 @@ static void emit_lithdr(grpc_chttp2_hpack_compressor* /*c*/, uint32_t key_index,
                                ? GRPC_CHTTP2_VARINT_LENGTH(key_index, 2)
                                : GRPC_CHTTP2_VARINT_LENGTH(key_index, 4);
   const wire_value value =
-      get_wire_value<true>(elem, st->use_true_binary_metadata);
+      get_wire_value<true>(c, elem, st->use_true_binary_metadata);
   const uint32_t len_val = wire_value_length(value);
   const uint32_t len_val_len = GRPC_CHTTP2_VARINT_LENGTH(len_val, 1);
   GPR_DEBUG_ASSERT(len_pfx + len_val_len < GRPC_SLICE_INLINED_SIZE);
@@ -561,7 +758,7 @@ static void emit_lithdr(grpc_chttp2_hpack_compressor* /*c*/, uint32_t key_index,
 }
 
 template <EmitLitHdrVType type>
-static void emit_lithdr_v(grpc_chttp2_hpack_compressor* /*c*/, grpc_mdelem elem,
+static void emit_lithdr_v(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
                           framer_state* st) {
   switch (type) {
     case EmitLitHdrVType::INC_IDX_V:
@@ -576,8 +773,8 @@ static void emit_lithdr_v(grpc_chttp2_hpack_compressor* /*c*/, grpc_mdelem elem,
       static_cast<uint32_t>(GRPC_SLICE_LENGTH(GRPC_MDKEY(elem)));
   const wire_value value =
       type == EmitLitHdrVType::INC_IDX_V
-          ? get_wire_value<true>(elem, st->use_true_binary_metadata)
-          : get_wire_value<false>(elem, st->use_true_binary_metadata);
+          ? get_wire_value<true>(c, elem, st->use_true_binary_metadata)
+          : get_wire_value<false>(c, elem, st->use_true_binary_metadata);
   const uint32_t len_val = wire_value_length(value);
   const uint32_t len_key_len = GRPC_CHTTP2_VARINT_LENGTH(len_key, 1);
   const uint32_t len_val_len = GRPC_CHTTP2_VARINT_LENGTH(len_val, 1);
@@ -640,13 +837,7 @@ struct EmitIndexedStatus {
 static EmitIndexedStatus maybe_emit_indexed(grpc_chttp2_hpack_compressor* c,
                                             grpc_mdelem elem,
                                             framer_state* st) {
-  const uint32_t elem_hash =
-      GRPC_MDELEM_STORAGE(elem) == GRPC_MDELEM_STORAGE_INTERNED
-          ? reinterpret_cast<grpc_core::InternedMetadata*>(
-                GRPC_MDELEM_DATA(elem))
-                ->hash()
-          : reinterpret_cast<grpc_core::StaticMetadata*>(GRPC_MDELEM_DATA(elem))
-                ->hash();
+  const uint32_t elem_hash = mdelem_hash(elem);
   /* Update filter to see if we can perhaps add this elem. */
   const uint32_t popularity_hash = UpdateHashtablePopularity(c, elem_hash);
   /* is this elem currently in the decoders table? */
@@ -674,6 +865,66 @@ static void emit_maybe_add(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
   }
 }
 
+/* encode an interned-key mdelem using c->exact_index */
+static void hpack_enc_exact(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
+                            bool elem_interned, framer_state* st) {
+  grpc_core::HpackEncoderExactIndex* index = c->exact_index;
+  const grpc_slice& elem_key = GRPC_MDKEY(elem);
+  /* is this elem currently in the decoders table? */
+  uint32_t elem_hash = 0;
+  if (elem_interned) {
+    elem_hash = mdelem_hash(elem);
+    index->RecordAccess(elem_hash);
+    const HpackEncoderIndex elem_index = index->LookupElem(elem);
+    if (elem_index > c->tail_remote_index) {
+      emit_indexed(c, dynidx(c, elem_index), st);
+      return;
+    }
+  }
+  const size_t decoder_space_usage =
+      grpc_chttp2_get_size_in_hpack_table(elem, st->use_true_binary_metadata);
+  const bool decoder_space_available =
+      decoder_space_usage < kMaxDecoderSpaceUsage;
+  const bool needs_eviction =
+      c->table_size + decoder_space_usage > c->max_table_size;
+  const bool should_add_elem = elem_interned && decoder_space_available &&
+                               index->Admit(elem_hash, needs_eviction);
+  /* no hits for the elem... maybe there's a key? */
+  const HpackEncoderIndex key_index = index->LookupKey(elem_key.refcount);
+  if (key_index > c->tail_remote_index) {
+    if (should_add_elem) {
+      emit_lithdr<EmitLitHdrType::INC_IDX>(c, dynidx(c, key_index), elem, st);
+      const uint32_t new_index =
+          prepare_space_for_new_elem(c, decoder_space_usage);
+      if (new_index != 0) index->AddElem(elem, new_index, elem_hash);
+    } else {
+      emit_lithdr<EmitLitHdrType::NO_IDX>(c, dynidx(c, key_index), elem, st);
+    }
+    return;
+  }
+  /* no elem, key in the table... fall back to literal emission */
+  uint32_t key_hash = 0;
+  bool should_add_key = false;
+  if (!elem_interned && decoder_space_available) {
+    key_hash = elem_key.refcount->Hash(elem_key);
+    index->RecordAccess(key_hash);
+    should_add_key = index->Admit(key_hash, needs_eviction);
+  }
+  if (should_add_elem || should_add_key) {
+    emit_lithdr_v<EmitLitHdrVType::INC_IDX_V>(c, elem, st);
+  } else {
+    emit_lithdr_v<EmitLitHdrVType::NO_IDX_V>(c, elem, st);
+    return;
+  }
+  const uint32_t new_index = prepare_space_for_new_elem(c, decoder_space_usage);
+  if (new_index == 0) return;
+  if (should_add_elem) {
+    index->AddElem(elem, new_index, elem_hash);
+  } else {
+    index->AddKey(elem_key.refcount, new_index, key_hash);
+  }
+}
+
 /* encode an mdelem */
 static void hpack_enc(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
                       framer_state* st) {
@@ -703,6 +954,10 @@ static void hpack_enc(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
     emit_lithdr_v<EmitLitHdrVType::NO_IDX_V>(c, elem, st);
     return;
   }
+  if (c->exact_index != nullptr) {
+    hpack_enc_exact(c, elem, elem_interned, st);
+    return;
+  }
   /* Interned metadata => maybe already indexed. */
   const EmitIndexedStatus ret =
       elem_interned ? maybe_emit_indexed(c, elem, st) : EmitIndexedStatus();
@@ -777,9 +1032,18 @@ void grpc_chttp2_hpack_compressor_destroy(grpc_chttp2_hpack_compressor* c) {
     }
     GRPC_MDELEM_UNREF(GetEntry<grpc_mdelem>(c->elem_table.entries, i));
   }
+  delete c->exact_index;
   gpr_free(c->table_elem_size);
 }
 
+void grpc_chttp2_hpack_compressor_enable_exact_index(
+    grpc_chttp2_hpack_compressor* c) {
+  GPR_ASSERT(c->table_elems == 0);
+  if (c->exact_index == nullptr) {
+    c->exact_index = new grpc_core::HpackEncoderExactIndex();
+  }
+}
+
 void grpc_chttp2_hpack_compressor_set_max_usable_size(
     grpc_chttp2_hpack_compressor* c, uint32_t max_table_size) {
   c->max_usable_size = max_table_size;
@@ -38,6 +38,10 @@
 
 extern grpc_core::TraceFlag grpc_http_trace;
 
+namespace grpc_core {
+class HpackEncoderExactIndex;
+}  // namespace grpc_core
+
 struct grpc_chttp2_hpack_compressor {
   uint32_t max_table_size;
   uint32_t max_table_elems;
@@ -81,10 +85,20 @@ struct grpc_chttp2_hpack_compressor {
       uint32_t index;
     } entries[GRPC_CHTTP2_HPACKC_NUM_VALUES];
   } key_table; /* Key table management */
+
+  /* if non-null, replaces the filter and entry tables above with an exact
+     index of the decoder table, frequency-based admission and a cache of
+     encoded binary values (see
+     grpc_chttp2_hpack_compressor_enable_exact_index) */
+  grpc_core::HpackEncoderExactIndex* exact_index;
 };
 
 void grpc_chttp2_hpack_compressor_init(grpc_chttp2_hpack_compressor* c);
 void grpc_chttp2_hpack_compressor_destroy(grpc_chttp2_hpack_compressor* c);
+/* Switch the compressor to exact-index mode. Must be called before anything
+   has been encoded with it. */
+void grpc_chttp2_hpack_compressor_enable_exact_index(
+    grpc_chttp2_hpack_compressor* c);
 void grpc_chttp2_hpack_compressor_set_max_table_size(
     grpc_chttp2_hpack_compressor* c, uint32_t max_table_size);
 void grpc_chttp2_hpack_compressor_set_max_usable_size(
@@ -719,7 +719,11 @@ static grpc_error_handle parse_begin(grpc_chttp2_hpack_parser* p,
     return GRPC_ERROR_NONE;
   }
 
-  return first_byte_action[first_byte_lut[*cur]](p, cur, end);
+  const uint8_t type = first_byte_lut[*cur];
+  if (p->recording_indexed_prefix && type != INDEXED_FIELD) {
+    p->recording_indexed_prefix = 0;
+  }
+  return first_byte_action[type](p, cur, end);
 }
 
 /* stream dependency and prioritization data: we just skip it */
@@ -787,6 +791,21 @@ on_invalid_hpack_idx(grpc_chttp2_hpack_parser* p) {
       GRPC_ERROR_INT_SIZE, static_cast<intptr_t>(p->table.num_ents));
 }
 
+/* remember a single byte indexed field at the start of the current header
+   block (see begin_header_block) */
+static void record_indexed_prefix(grpc_chttp2_hpack_parser* p,
+                                  grpc_mdelem md) {
+  if (p->indexed_prefix_length == GRPC_CHTTP2_HPACK_PARSER_MAX_INDEXED_PREFIX) {
+    p->recording_indexed_prefix = 0;
+    return;
+  }
+  GPR_DEBUG_ASSERT(p->index < 0x7f);
+  p->indexed_prefix[p->indexed_prefix_length] =
+      static_cast<uint8_t>(0x80 | p->index);
+  p->indexed_prefix_md[p->indexed_prefix_length] = md;
+  p->indexed_prefix_length++;
+}
+
 /* emit an indexed field; jumps to begin the next field on completion */
 static grpc_error_handle finish_indexed_field(grpc_chttp2_hpack_parser* p,
                                               const uint8_t* cur,
@@ -796,6 +815,9 @@ static grpc_error_handle finish_indexed_field(grpc_chttp2_hpack_parser* p,
     return on_invalid_hpack_idx(p);
   }
   GRPC_STATS_INC_HPACK_RECV_INDEXED();
+  if (p->recording_indexed_prefix) {
+    record_indexed_prefix(p, md);
+  }
   grpc_error_handle err = on_hdr<false>(p, md);
   if (GPR_UNLIKELY(err != GRPC_ERROR_NONE)) return err;
   return parse_begin(p, cur, end);
@@ -1658,6 +1680,9 @@ void grpc_chttp2_hpack_parser_init(grpc_chttp2_hpack_parser* p) {
 #endif
   p->dynamic_table_update_allowed = 2;
   p->last_error = GRPC_ERROR_NONE;
+  p->indexed_prefix_length = 0;
+  p->recording_indexed_prefix = 0;
+  p->indexed_prefix_table_version = 0;
 }
 
 void grpc_chttp2_hpack_parser_set_has_priority(grpc_chttp2_hpack_parser* p) {
@@ -1674,6 +1699,37 @@ void grpc_chttp2_hpack_parser_destroy(grpc_chttp2_hpack_parser* p) {
   gpr_free(p->value.data.copied.str);
 }
 
+/* Called at the start of each header block. Peers tend to send the same
+   headers in the same order on every request, so once the dynamic table has
+   settled most blocks begin with the same run of indexed fields. If this block
+   begins with the run recorded from an earlier one and the table has not
+   changed since, emit the recorded elements without going through the state
+   machine; otherwise record this block's run for next time. */
+static grpc_error_handle begin_header_block(grpc_chttp2_hpack_parser* p,
+                                            const uint8_t** cur,
+                                            const uint8_t* end) {
+  const size_t length = p->indexed_prefix_length;
+  if (length > 0 && p->table.version == p->indexed_prefix_table_version &&
+      static_cast<size_t>(end - *cur) >= length &&
+      0 == memcmp(*cur, p->indexed_prefix, length)) {
+    p->dynamic_table_update_allowed = 0;
+    *cur += length;
+    for (size_t i = 0; i < length; i++) {
+      GRPC_STATS_INC_HPACK_RECV_INDEXED();
+      grpc_error_handle err =
+          on_hdr<false>(p, GRPC_MDELEM_REF(p->indexed_prefix_md[i]));
+      if (GPR_UNLIKELY(err != GRPC_ERROR_NONE)) return err;
+    }
+    return GRPC_ERROR_NONE;
+  }
+  /* indexed fields don't change the table, so the version at the start of the
+     block is also the one the recorded elements are valid for */
+  p->indexed_prefix_length = 0;
+  p->recording_indexed_prefix = 1;
+  p->indexed_prefix_table_version = p->table.version;
+  return GRPC_ERROR_NONE;
+}
+
 grpc_error_handle grpc_chttp2_hpack_parser_parse(grpc_chttp2_hpack_parser* p,
                                                  const grpc_slice& slice) {
 /* max number of bytes to parse at a time... limits call stack depth on
@@ -1683,6 +1739,11 @@ grpc_error_handle grpc_chttp2_hpack_parser_parse(grpc_chttp2_hpack_parser* p,
   const uint8_t* start = GRPC_SLICE_START_PTR(slice);
   const uint8_t* end = GRPC_SLICE_END_PTR(slice);
   grpc_error_handle error = GRPC_ERROR_NONE;
+  /* dynamic_table_update_allowed is only 2 before the first field of a block */
+  if (p->dynamic_table_update_allowed == 2 && p->state == parse_begin &&
+      start != end) {
+    error = begin_header_block(p, &start, end);
+  }
   while (start != end && error == GRPC_ERROR_NONE) {
     const uint8_t* target = start + GPR_MIN(MAX_PARSE_LENGTH, end - start);
     error = p->state(p, start, target);
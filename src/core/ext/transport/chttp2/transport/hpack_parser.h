@@ -27,6 +27,9 @@
 #include "src/core/ext/transport/chttp2/transport/hpack_table.h"
 #include "src/core/lib/transport/metadata.h"
 
+/* longest run of leading indexed fields remembered across header blocks */
+#define GRPC_CHTTP2_HPACK_PARSER_MAX_INDEXED_PREFIX 32
+
 typedef struct grpc_chttp2_hpack_parser grpc_chttp2_hpack_parser;
 
 typedef grpc_error_handle (*grpc_chttp2_hpack_parser_state)(
@@ -94,6 +97,17 @@ struct grpc_chttp2_hpack_parser {
   uint8_t is_eof;
   uint32_t base64_buffer;
 
+  /* the run of single byte indexed fields that started the last header block
+     parsed the slow way, and the elements they resolved to at
+     indexed_prefix_table_version: a block starting with the same bytes while
+     the table is unchanged decodes to the same elements */
+  uint8_t indexed_prefix[GRPC_CHTTP2_HPACK_PARSER_MAX_INDEXED_PREFIX];
+  grpc_mdelem indexed_prefix_md[GRPC_CHTTP2_HPACK_PARSER_MAX_INDEXED_PREFIX];
+  uint8_t indexed_prefix_length;
+  /* are we still inside the leading indexed fields of the current block? */
+  uint8_t recording_indexed_prefix;
+  uint32_t indexed_prefix_table_version;
+
   /* hpack table */
   grpc_chttp2_hptbl table;
 };
@@ -83,6 +83,7 @@ static void evict1(grpc_chttp2_hptbl* tbl) {
   tbl->mem_used -= static_cast<uint32_t>(elem_bytes);
   tbl->first_ent = ((tbl->first_ent + 1) % tbl->cap_entries);
   tbl->num_ents--;
+  tbl->version++;
   GRPC_MDELEM_UNREF(first_ent);
 }
 
@@ -191,6 +192,7 @@ grpc_error_handle grpc_chttp2_hptbl_add(grpc_chttp2_hptbl* tbl,
   /* update accounting values */
   tbl->num_ents++;
   tbl->mem_used += static_cast<uint32_t>(elem_bytes);
+  tbl->version++;
   return GRPC_ERROR_NONE;
 }
 
@@ -84,6 +84,9 @@ struct grpc_chttp2_hptbl {
      what hpack specifies, in order to simplify table management a little...
      meaning lookups need to SUBTRACT from the end position */
   grpc_mdelem* ents = nullptr;
+  /* bumped whenever an entry is added or evicted: while it is unchanged, every
+     hpack index resolves to the same element as before */
+  uint32_t version = 0;
 };
 
 void grpc_chttp2_hptbl_destroy(grpc_chttp2_hptbl* tbl);
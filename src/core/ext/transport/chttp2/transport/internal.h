@@ -194,6 +194,14 @@ typedef enum {
   GRPC_NUM_SETTING_SETS
 } grpc_chttp2_setting_set;
 
+/* How writable streams share each write */
+typedef enum {
+  /* each stream in turn flushes all the data flow control allows */
+  GRPC_CHTTP2_STREAM_SCHEDULER_FIFO,
+  /* streams take turns flushing a weighted quantum: deficit round robin */
+  GRPC_CHTTP2_STREAM_SCHEDULER_DRR,
+} grpc_chttp2_stream_scheduler;
+
 typedef enum {
   GRPC_CHTTP2_NO_GOAWAY_SEND,
   GRPC_CHTTP2_GOAWAY_SEND_SCHEDULED,
@@ -356,6 +364,18 @@ struct grpc_chttp2_transport {
    */
   uint32_t write_buffer_size = grpc_core::chttp2::kDefaultWindow;
 
+  /** receive window budget shared by all streams, or 0 if unbudgeted */
+  int64_t stream_memory_budget = 0;
+
+  /** upper bound on the bytes gathered into outbuf by one write */
+  uint32_t target_write_size = 1024 * 1024;
+  /** should writes be sized from the bdp estimate (capped by
+   * target_write_size)? */
+  bool adaptive_write_size = false;
+  /** how writable streams share each write */
+  grpc_chttp2_stream_scheduler stream_scheduler =
+      GRPC_CHTTP2_STREAM_SCHEDULER_DRR;
+
   /** Set to a grpc_error object if a goaway frame is received. By default, set
    * to GRPC_ERROR_NONE */
   grpc_error_handle goaway_error = GRPC_ERROR_NONE;
@@ -549,6 +569,10 @@ struct grpc_chttp2_stream {
   int64_t next_message_end_offset;
   int64_t flow_controlled_bytes_written = 0;
   int64_t flow_controlled_bytes_flowed = 0;
+  /** relative share of each write this stream gets under the drr scheduler */
+  uint32_t write_weight = 1;
+  /** bytes this stream may still send in the current drr round */
+  int64_t write_deficit = 0;
   grpc_closure complete_fetch_locked;
   grpc_closure* fetching_send_message_finished = nullptr;
 
@@ -188,8 +188,18 @@ static void report_stall(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
 }
 
 /* How many bytes would we like to put on the wire during a single syscall */
-static uint32_t target_write_size(grpc_chttp2_transport* /*t*/) {
-  return 1024 * 1024;
+static uint32_t target_write_size(grpc_chttp2_transport* t) {
+  if (!t->adaptive_write_size) return t->target_write_size;
+  grpc_core::BdpEstimator* bdp_est = t->flow_control->bdp_estimator();
+  // Two bandwidth-delay products keep the pipe full across a write completion
+  // without letting one write sit in front of everything else on a slow link.
+  // Never go below one max-sized frame so that a single DATA frame always fits.
+  const int64_t max_size = t->target_write_size;
+  const int64_t min_size = GPR_MIN(
+      max_size,
+      t->settings[GRPC_PEER_SETTINGS][GRPC_CHTTP2_SETTINGS_MAX_FRAME_SIZE]);
+  return static_cast<uint32_t>(
+      GPR_CLAMP(2 * bdp_est->EstimateBdp(), min_size, max_size));
 }
 
 // Returns true if initial_metadata contains only default headers.
@@ -333,13 +343,30 @@ class DataSendContext {
                                     [GRPC_CHTTP2_SETTINGS_INITIAL_WINDOW_SIZE]);
   }
 
-  uint32_t max_outgoing() const {
+  uint32_t max_flow_controlled_outgoing() const {
     return static_cast<uint32_t> GPR_MIN(
         t_->settings[GRPC_PEER_SETTINGS][GRPC_CHTTP2_SETTINGS_MAX_FRAME_SIZE],
         GPR_MIN(stream_remote_window(), t_->flow_control->remote_window()));
   }
 
-  bool AnyOutgoing() const { return max_outgoing() > 0; }
+  uint32_t max_outgoing() const {
+    if (t_->stream_scheduler != GRPC_CHTTP2_STREAM_SCHEDULER_DRR) {
+      return max_flow_controlled_outgoing();
+    }
+    return static_cast<uint32_t> GPR_MAX(
+        0, GPR_MIN(static_cast<int64_t>(max_flow_controlled_outgoing()),
+                   s_->write_deficit));
+  }
+
+  // Start this stream's drr turn: it may send one frame per unit of weight.
+  void AddQuantum() {
+    if (t_->stream_scheduler != GRPC_CHTTP2_STREAM_SCHEDULER_DRR) return;
+    s_->write_deficit +=
+        static_cast<int64_t>(s_->write_weight) *
+        t_->settings[GRPC_PEER_SETTINGS][GRPC_CHTTP2_SETTINGS_MAX_FRAME_SIZE];
+  }
+
+  bool AnyOutgoing() const { return max_flow_controlled_outgoing() > 0; }
 
   void FlushUncompressedBytes() {
     uint32_t send_bytes = static_cast<uint32_t> GPR_MIN(
@@ -351,6 +378,7 @@ class DataSendContext {
     grpc_chttp2_encode_data(s_->id, &s_->flow_controlled_buffer, send_bytes,
                             is_last_frame_, &s_->stats.outgoing, &t_->outbuf);
     s_->flow_control->SentData(send_bytes);
+    s_->write_deficit -= send_bytes;
     s_->sending_bytes += send_bytes;
   }
 
@@ -386,6 +414,7 @@ class DataSendContext {
     grpc_chttp2_encode_data(s_->id, &s_->compressed_data_buffer, send_bytes,
                             is_last_frame_, &s_->stats.outgoing, &t_->outbuf);
     s_->flow_control->SentData(send_bytes);
+    s_->write_deficit -= send_bytes;
     if (s_->compressed_data_buffer.length == 0) {
       s_->sending_bytes += s_->uncompressed_data_size;
     }
@@ -431,7 +460,10 @@ class DataSendContext {
 class StreamWriteContext {
  public:
   StreamWriteContext(WriteContext* write_context, grpc_chttp2_stream* s)
-      : write_context_(write_context), t_(write_context->transport()), s_(s) {
+      : write_context_(write_context),
+        t_(write_context->transport()),
+        s_(s),
+        first_turn_(!s->included[GRPC_CHTTP2_LIST_WRITING]) {
     GRPC_CHTTP2_IF_TRACING(
         gpr_log(GPR_INFO, "W:%p %s[%d] im-(sent,send)=(%d,%d) announce=%d", t_,
                 t_->is_client ? "CLIENT" : "SERVER", s->id,
@@ -521,6 +553,7 @@ class StreamWriteContext {
       return;  // early out: nothing to do
     }
 
+    data_send_context.AddQuantum();
     if (s_->stream_compression_method ==
         GRPC_STREAM_COMPRESSION_IDENTITY_COMPRESS) {
       while (s_->flow_controlled_buffer.length > 0 &&
@@ -546,10 +579,15 @@ class StreamWriteContext {
     stream_became_writable_ = true;
     if (s_->flow_controlled_buffer.length > 0 ||
         compressed_data_buffer_len() > 0) {
+      // Whatever is left goes to the back of the line, so that every other
+      // writable stream gets its turn first.
       GRPC_CHTTP2_STREAM_REF(s_, "chttp2_writing:fork");
       grpc_chttp2_list_add_writable_stream(t_, s_);
+    } else {
+      // Idle streams do not bank credit for later rounds.
+      s_->write_deficit = 0;
     }
-    write_context_->IncMessageWrites();
+    if (first_turn_) write_context_->IncMessageWrites();
   }
 
   void FlushTrailingMetadata() {
@@ -590,6 +628,10 @@ class StreamWriteContext {
 
   bool stream_became_writable() { return stream_became_writable_; }
 
+  // A stream with more data than its drr quantum takes several turns in one
+  // write. Per-write bookkeeping is only done on the first of them.
+  bool first_turn() const { return first_turn_; }
+
  private:
   void ConvertInitialMetadataToTrailingMetadata() {
     GRPC_CHTTP2_IF_TRACING(
@@ -629,6 +671,7 @@ class StreamWriteContext {
   WriteContext* const write_context_;
   grpc_chttp2_transport* const t_;
   grpc_chttp2_stream* const s_;
+  const bool first_turn_;
   bool stream_became_writable_ = false;
   grpc_mdelem* extra_headers_for_trailing_metadata_[2];
   size_t num_extra_headers_for_trailing_metadata_ = 0;
@@ -659,7 +702,8 @@ grpc_chttp2_begin_write_result grpc_chttp2_begin_write(
     if (t->outbuf.length > orig_len) {
       /* Add this stream to the list of the contexts to be traced at TCP */
       s->byte_counter += t->outbuf.length - orig_len;
-      if (s->traced && grpc_endpoint_can_track_err(t->ep)) {
+      if (s->traced && stream_ctx.first_turn() &&
+          grpc_endpoint_can_track_err(t->ep)) {
         grpc_core::ContextList::Append(&t->cl, s);
       }
     }
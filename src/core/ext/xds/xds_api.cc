@@ -84,6 +84,8 @@
 #include "upb/text_encode.h"
 #include "upb/upb.h"
 #include "upb/upb.hpp"
+#define XXH_INLINE_ALL
+#include "xxhash.h"
 
 #include <grpc/impl/codegen/log.h>
 #include <grpc/support/alloc.h>
@@ -1044,6 +1046,30 @@ grpc_slice SerializeDiscoveryRequest(
   return grpc_slice_from_copied_buffer(output, output_length);
 }
 
+void MaybeLogDeltaDiscoveryRequest(
+    const EncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryRequest* request) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(request, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] constructed delta ADS request: %s",
+            context.client, buf);
+  }
+}
+
+grpc_slice SerializeDeltaDiscoveryRequest(
+    const EncodingContext& context,
+    envoy_service_discovery_v3_DeltaDiscoveryRequest* request) {
+  size_t output_length;
+  char* output = envoy_service_discovery_v3_DeltaDiscoveryRequest_serialize(
+      request, context.arena, &output_length);
+  return grpc_slice_from_copied_buffer(output, output_length);
+}
+
 absl::string_view TypeUrlExternalToInternal(bool use_v3,
                                             const std::string& type_url) {
   if (!use_v3) {
@@ -1124,6 +1150,68 @@ grpc_slice XdsApi::CreateAdsRequest(
   return SerializeDiscoveryRequest(context, request);
 }
 
+grpc_slice XdsApi::CreateDeltaAdsRequest(
+    const XdsBootstrap::XdsServer& server, const std::string& type_url,
+    const std::set<absl::string_view>& resource_names_subscribe,
+    const std::set<absl::string_view>& resource_names_unsubscribe,
+    const std::map<absl::string_view, absl::string_view>&
+        initial_resource_versions,
+    const std::string& nonce, grpc_error_handle error, bool populate_node) {
+  upb::Arena arena;
+  const EncodingContext context = {client_, tracer_, symtab_.ptr(), arena.ptr(),
+                                   server.ShouldUseV3()};
+  // Create a request.
+  envoy_service_discovery_v3_DeltaDiscoveryRequest* request =
+      envoy_service_discovery_v3_DeltaDiscoveryRequest_new(arena.ptr());
+  // Set type_url.
+  absl::string_view real_type_url =
+      TypeUrlExternalToInternal(server.ShouldUseV3(), type_url);
+  envoy_service_discovery_v3_DeltaDiscoveryRequest_set_type_url(
+      request, StdStringToUpbString(real_type_url));
+  // Set nonce.
+  if (!nonce.empty()) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_set_response_nonce(
+        request, StdStringToUpbString(nonce));
+  }
+  // Set error_detail if it's a NACK.
+  std::string error_string_storage;
+  if (error != GRPC_ERROR_NONE) {
+    google_rpc_Status* error_detail =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_error_detail(
+            request, arena.ptr());
+    google_rpc_Status_set_code(error_detail, GRPC_STATUS_INVALID_ARGUMENT);
+    error_string_storage = grpc_error_std_string(error);
+    upb_strview error_description = StdStringToUpbString(error_string_storage);
+    google_rpc_Status_set_message(error_detail, error_description);
+    GRPC_ERROR_UNREF(error);
+  }
+  // Populate node.
+  if (populate_node) {
+    envoy_config_core_v3_Node* node_msg =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_node(
+            request, arena.ptr());
+    PopulateNode(context, node_, build_version_, user_agent_name_, node_msg);
+  }
+  // Add the subscription changes.
+  for (const auto& resource_name : resource_names_subscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_subscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  for (const auto& resource_name : resource_names_unsubscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_unsubscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  // Tell the server which versions we already have, so that it does not
+  // re-send them on a new stream.
+  for (const auto& p : initial_resource_versions) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_initial_resource_versions_set(
+        request, StdStringToUpbString(p.first), StdStringToUpbString(p.second),
+        arena.ptr());
+  }
+  MaybeLogDeltaDiscoveryRequest(context, request);
+  return SerializeDeltaDiscoveryRequest(context, request);
+}
+
 namespace {
 
 void MaybeLogDiscoveryResponse(
@@ -1140,6 +1228,21 @@ void MaybeLogDiscoveryResponse(
   }
 }
 
+void MaybeLogDeltaDiscoveryResponse(
+    const EncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryResponse* response) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryResponse_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(response, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] received delta response: %s",
+            context.client, buf);
+  }
+}
+
 void MaybeLogHttpConnectionManager(
     const EncodingContext& context,
     const envoy_extensions_filters_network_http_connection_manager_v3_HttpConnectionManager*
@@ -2496,17 +2599,61 @@ grpc_error_handle LdsResponseParseServer(
   return GRPC_ERROR_NONE;
 }
 
+uint64_t ResourceHash(upb_strview encoded, bool is_v2) {
+  return XXH64(encoded.data, encoded.size, is_v2 ? 1 : 0);
+}
+
+// If a resource with the serialized bytes \a encoded was validated
+// earlier, adds the cached result to \a update_map and returns true.
+template <typename ResourceDataType>
+bool MaybeUseCachedResource(
+    const XdsApi::ParsedResourceCache<ResourceDataType>& cache, uint64_t hash,
+    upb_strview encoded, const std::set<absl::string_view>& expected_names,
+    absl::string_view name_description,
+    std::map<std::string, ResourceDataType>* update_map,
+    std::set<std::string>* resource_names_failed,
+    std::vector<grpc_error_handle>* errors) {
+  const std::string* name;
+  const ResourceDataType* data =
+      cache.Find(hash, UpbStringToAbsl(encoded), &name);
+  if (data == nullptr) return false;
+  // Ignore unexpected resources.
+  if (expected_names.find(*name) == expected_names.end()) return true;
+  // Fail on duplicate resources.
+  if (!update_map->emplace(*name, *data).second) {
+    errors->push_back(GRPC_ERROR_CREATE_FROM_COPIED_STRING(
+        absl::StrCat("duplicate ", name_description, " \"", *name, "\"")
+            .c_str()));
+    resource_names_failed->insert(*name);
+  }
+  return true;
+}
+
+// Adds the resources that were parsed and passed validation to \a cache.
+template <typename ResourceDataType>
+void UpdateResourceCache(
+    const std::vector<std::pair<std::string, uint64_t>>& parsed,
+    const std::map<std::string, ResourceDataType>& update_map,
+    const std::set<std::string>& resource_names_failed,
+    XdsApi::ParsedResourceCache<ResourceDataType>* cache) {
+  for (const auto& p : parsed) {
+    if (resource_names_failed.find(p.first) != resource_names_failed.end()) {
+      continue;
+    }
+    cache->Add(p.second, p.first, update_map.at(p.first));
+  }
+}
+
 grpc_error_handle LdsResponseParse(
     const EncodingContext& context,
-    const envoy_service_discovery_v3_DiscoveryResponse* response,
+    const google_protobuf_Any* const* resources, size_t size,
     const std::set<absl::string_view>& expected_listener_names,
+    XdsApi::ParsedResourceCache<XdsApi::LdsResourceData>* cache,
     XdsApi::LdsUpdateMap* lds_update_map,
     std::set<std::string>* resource_names_failed) {
   std::vector<grpc_error_handle> errors;
-  // Get the resources from the response.
-  size_t size;
-  const google_protobuf_Any* const* resources =
-      envoy_service_discovery_v3_DiscoveryResponse_resources(response, &size);
+  cache->RetainOnly(expected_listener_names);
+  std::vector<std::pair<std::string, uint64_t>> parsed;
   for (size_t i = 0; i < size; ++i) {
     // Check the type_url of the resource.
     absl::string_view type_url =
@@ -2518,9 +2665,16 @@ grpc_error_handle LdsResponseParse(
               .c_str()));
       continue;
     }
-    // Decode the listener.
     const upb_strview encoded_listener =
         google_protobuf_Any_value(resources[i]);
+    const uint64_t hash = ResourceHash(encoded_listener, is_v2);
+    if (MaybeUseCachedResource(*cache, hash, encoded_listener,
+                               expected_listener_names, "listener name",
+                               lds_update_map, resource_names_failed,
+                               &errors)) {
+      continue;
+    }
+    // Decode the listener.
     const envoy_config_listener_v3_Listener* listener =
         envoy_config_listener_v3_Listener_parse(
             encoded_listener.data, encoded_listener.size, context.arena);
@@ -2548,6 +2702,7 @@ grpc_error_handle LdsResponseParse(
     // Serialize into JSON and store it in the LdsUpdateMap
     XdsApi::LdsResourceData& lds_resource_data =
         (*lds_update_map)[listener_name];
+    parsed.emplace_back(listener_name, hash);
     XdsApi::LdsUpdate& lds_update = lds_resource_data.resource;
     lds_resource_data.serialized_proto = UpbStringToStdString(encoded_listener);
     // Check whether it's a client or server listener.
@@ -2585,20 +2740,20 @@ grpc_error_handle LdsResponseParse(
       resource_names_failed->insert(listener_name);
     }
   }
+  UpdateResourceCache(parsed, *lds_update_map, *resource_names_failed, cache);
   return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing LDS response", &errors);
 }
 
 grpc_error_handle RdsResponseParse(
     const EncodingContext& context,
-    const envoy_service_discovery_v3_DiscoveryResponse* response,
+    const google_protobuf_Any* const* resources, size_t size,
     const std::set<absl::string_view>& expected_route_configuration_names,
+    XdsApi::ParsedResourceCache<XdsApi::RdsResourceData>* cache,
     XdsApi::RdsUpdateMap* rds_update_map,
     std::set<std::string>* resource_names_failed) {
   std::vector<grpc_error_handle> errors;
-  // Get the resources from the response.
-  size_t size;
-  const google_protobuf_Any* const* resources =
-      envoy_service_discovery_v3_DiscoveryResponse_resources(response, &size);
+  cache->RetainOnly(expected_route_configuration_names);
+  std::vector<std::pair<std::string, uint64_t>> parsed;
   for (size_t i = 0; i < size; ++i) {
     // Check the type_url of the resource.
     absl::string_view type_url =
@@ -2609,9 +2764,16 @@ grpc_error_handle RdsResponseParse(
               .c_str()));
       continue;
     }
-    // Decode the route_config.
     const upb_strview encoded_route_config =
         google_protobuf_Any_value(resources[i]);
+    const uint64_t hash = ResourceHash(encoded_route_config, false);
+    if (MaybeUseCachedResource(*cache, hash, encoded_route_config,
+                               expected_route_configuration_names,
+                               "route config name", rds_update_map,
+                               resource_names_failed, &errors)) {
+      continue;
+    }
+    // Decode the route_config.
     const envoy_config_route_v3_RouteConfiguration* route_config =
         envoy_config_route_v3_RouteConfiguration_parse(
             encoded_route_config.data, encoded_route_config.size,
@@ -2641,6 +2803,7 @@ grpc_error_handle RdsResponseParse(
     // Serialize into JSON and store it in the RdsUpdateMap
     XdsApi::RdsResourceData& rds_resource_data =
         (*rds_update_map)[route_config_name];
+    parsed.emplace_back(route_config_name, hash);
     XdsApi::RdsUpdate& rds_update = rds_resource_data.resource;
     rds_resource_data.serialized_proto =
         UpbStringToStdString(encoded_route_config);
@@ -2655,20 +2818,20 @@ grpc_error_handle RdsResponseParse(
       resource_names_failed->insert(route_config_name);
     }
   }
+  UpdateResourceCache(parsed, *rds_update_map, *resource_names_failed, cache);
   return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing RDS response", &errors);
 }
 
 grpc_error_handle CdsResponseParse(
     const EncodingContext& context,
-    const envoy_service_discovery_v3_DiscoveryResponse* response,
+    const google_protobuf_Any* const* resources, size_t size,
     const std::set<absl::string_view>& expected_cluster_names,
+    XdsApi::ParsedResourceCache<XdsApi::CdsResourceData>* cache,
     XdsApi::CdsUpdateMap* cds_update_map,
     std::set<std::string>* resource_names_failed) {
   std::vector<grpc_error_handle> errors;
-  // Get the resources from the response.
-  size_t size;
-  const google_protobuf_Any* const* resources =
-      envoy_service_discovery_v3_DiscoveryResponse_resources(response, &size);
+  cache->RetainOnly(expected_cluster_names);
+  std::vector<std::pair<std::string, uint64_t>> parsed;
   // Parse all the resources in the CDS response.
   for (size_t i = 0; i < size; ++i) {
     // Check the type_url of the resource.
@@ -2680,8 +2843,15 @@ grpc_error_handle CdsResponseParse(
               .c_str()));
       continue;
     }
-    // Decode the cluster.
     const upb_strview encoded_cluster = google_protobuf_Any_value(resources[i]);
+    const uint64_t hash = ResourceHash(encoded_cluster, false);
+    if (MaybeUseCachedResource(*cache, hash, encoded_cluster,
+                               expected_cluster_names, "resource name",
+                               cds_update_map, resource_names_failed,
+                               &errors)) {
+      continue;
+    }
+    // Decode the cluster.
     const envoy_config_cluster_v3_Cluster* cluster =
         envoy_config_cluster_v3_Cluster_parse(
             encoded_cluster.data, encoded_cluster.size, context.arena);
@@ -2710,6 +2880,7 @@ grpc_error_handle CdsResponseParse(
     // Serialize into JSON and store it in the CdsUpdateMap
     XdsApi::CdsResourceData& cds_resource_data =
         (*cds_update_map)[cluster_name];
+    parsed.emplace_back(cluster_name, hash);
     XdsApi::CdsUpdate& cds_update = cds_resource_data.resource;
     cds_resource_data.serialized_proto = UpbStringToStdString(encoded_cluster);
     // Check the cluster_discovery_type.
@@ -2988,6 +3159,7 @@ grpc_error_handle CdsResponseParse(
       }
     }
   }
+  UpdateResourceCache(parsed, *cds_update_map, *resource_names_failed, cache);
   return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing CDS response", &errors);
 }
 
@@ -3109,15 +3281,14 @@ grpc_error_handle DropParseAndAppend(
 
 grpc_error_handle EdsResponseParse(
     const EncodingContext& context,
-    const envoy_service_discovery_v3_DiscoveryResponse* response,
+    const google_protobuf_Any* const* resources, size_t size,
     const std::set<absl::string_view>& expected_eds_service_names,
+    XdsApi::ParsedResourceCache<XdsApi::EdsResourceData>* cache,
     XdsApi::EdsUpdateMap* eds_update_map,
     std::set<std::string>* resource_names_failed) {
   std::vector<grpc_error_handle> errors;
-  // Get the resources from the response.
-  size_t size;
-  const google_protobuf_Any* const* resources =
-      envoy_service_discovery_v3_DiscoveryResponse_resources(response, &size);
+  cache->RetainOnly(expected_eds_service_names);
+  std::vector<std::pair<std::string, uint64_t>> parsed;
   for (size_t i = 0; i < size; ++i) {
     // Check the type_url of the resource.
     absl::string_view type_url =
@@ -3128,9 +3299,16 @@ grpc_error_handle EdsResponseParse(
               .c_str()));
       continue;
     }
-    // Get the cluster_load_assignment.
     upb_strview encoded_cluster_load_assignment =
         google_protobuf_Any_value(resources[i]);
+    const uint64_t hash = ResourceHash(encoded_cluster_load_assignment, false);
+    if (MaybeUseCachedResource(*cache, hash, encoded_cluster_load_assignment,
+                               expected_eds_service_names, "resource name",
+                               eds_update_map, resource_names_failed,
+                               &errors)) {
+      continue;
+    }
+    // Get the cluster_load_assignment.
     envoy_config_endpoint_v3_ClusterLoadAssignment* cluster_load_assignment =
         envoy_config_endpoint_v3_ClusterLoadAssignment_parse(
             encoded_cluster_load_assignment.data,
@@ -3162,6 +3340,7 @@ grpc_error_handle EdsResponseParse(
     // Serialize into JSON and store it in the EdsUpdateMap
     XdsApi::EdsResourceData& eds_resource_data =
         (*eds_update_map)[eds_service_name];
+    parsed.emplace_back(eds_service_name, hash);
     XdsApi::EdsUpdate& eds_update = eds_resource_data.resource;
     eds_resource_data.serialized_proto =
         UpbStringToStdString(encoded_cluster_load_assignment);
@@ -3230,6 +3409,7 @@ grpc_error_handle EdsResponseParse(
       }
     }
   }
+  UpdateResourceCache(parsed, *eds_update_map, *resource_names_failed, cache);
   return GRPC_ERROR_CREATE_FROM_VECTOR("errors parsing EDS response", &errors);
 }
 
@@ -3255,8 +3435,74 @@ void MoveUpdatesToFailedSet(UpdateMap* update_map,
   update_map->clear();
 }
 
+// Parses \a resources, which were received in a response of type
+// result->type_url, into \a result.
+void ParseResources(
+    const EncodingContext& context, const google_protobuf_Any* const* resources,
+    size_t size, const std::set<absl::string_view>& expected_listener_names,
+    const std::set<absl::string_view>& expected_route_configuration_names,
+    const std::set<absl::string_view>& expected_cluster_names,
+    const std::set<absl::string_view>& expected_eds_service_names,
+    XdsApi::ParsedResourceCache<XdsApi::LdsResourceData>* lds_cache,
+    XdsApi::ParsedResourceCache<XdsApi::RdsResourceData>* rds_cache,
+    XdsApi::ParsedResourceCache<XdsApi::CdsResourceData>* cds_cache,
+    XdsApi::ParsedResourceCache<XdsApi::EdsResourceData>* eds_cache,
+    XdsApi::AdsParseResult* result) {
+  if (IsLds(result->type_url)) {
+    result->parse_error =
+        LdsResponseParse(context, resources, size, expected_listener_names,
+                         lds_cache, &result->lds_update_map,
+                         &result->resource_names_failed);
+    if (result->parse_error != GRPC_ERROR_NONE) {
+      MoveUpdatesToFailedSet(&result->lds_update_map,
+                             &result->resource_names_failed);
+    }
+  } else if (IsRds(result->type_url)) {
+    result->parse_error = RdsResponseParse(
+        context, resources, size, expected_route_configuration_names,
+        rds_cache, &result->rds_update_map, &result->resource_names_failed);
+    if (result->parse_error != GRPC_ERROR_NONE) {
+      MoveUpdatesToFailedSet(&result->rds_update_map,
+                             &result->resource_names_failed);
+    }
+  } else if (IsCds(result->type_url)) {
+    result->parse_error =
+        CdsResponseParse(context, resources, size, expected_cluster_names,
+                         cds_cache, &result->cds_update_map,
+                         &result->resource_names_failed);
+    if (result->parse_error != GRPC_ERROR_NONE) {
+      MoveUpdatesToFailedSet(&result->cds_update_map,
+                             &result->resource_names_failed);
+    }
+  } else if (IsEds(result->type_url)) {
+    result->parse_error =
+        EdsResponseParse(context, resources, size, expected_eds_service_names,
+                         eds_cache, &result->eds_update_map,
+                         &result->resource_names_failed);
+    if (result->parse_error != GRPC_ERROR_NONE) {
+      MoveUpdatesToFailedSet(&result->eds_update_map,
+                             &result->resource_names_failed);
+    }
+  }
+}
+
 }  // namespace
 
+void XdsApi::MaybeResetResourceCaches() {
+  // Resources validated under a different set of experimental features
+  // can't be reused.
+  const uint64_t resource_cache_seed =
+      (XdsSecurityEnabled() ? 1 : 0) | (XdsRingHashEnabled() ? 2 : 0) |
+      (XdsAggregateAndLogicalDnsClusterEnabled() ? 4 : 0);
+  if (resource_cache_seed != resource_cache_seed_) {
+    resource_cache_seed_ = resource_cache_seed;
+    lds_resource_cache_.Clear();
+    rds_resource_cache_.Clear();
+    cds_resource_cache_.Clear();
+    eds_resource_cache_.Clear();
+  }
+}
+
 XdsApi::AdsParseResult XdsApi::ParseAdsResponse(
     const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
     const std::set<absl::string_view>& expected_listener_names,
@@ -3267,6 +3513,7 @@ XdsApi::AdsParseResult XdsApi::ParseAdsResponse(
   upb::Arena arena;
   const EncodingContext context = {client_, tracer_, symtab_.ptr(), arena.ptr(),
                                    server.ShouldUseV3()};
+  MaybeResetResourceCaches();
   // Decode the response.
   const envoy_service_discovery_v3_DiscoveryResponse* response =
       envoy_service_discovery_v3_DiscoveryResponse_parse(
@@ -3287,39 +3534,83 @@ XdsApi::AdsParseResult XdsApi::ParseAdsResponse(
   result.nonce = UpbStringToStdString(
       envoy_service_discovery_v3_DiscoveryResponse_nonce(response));
   // Parse the response according to the resource type.
-  if (IsLds(result.type_url)) {
-    result.parse_error =
-        LdsResponseParse(context, response, expected_listener_names,
-                         &result.lds_update_map, &result.resource_names_failed);
-    if (result.parse_error != GRPC_ERROR_NONE) {
-      MoveUpdatesToFailedSet(&result.lds_update_map,
-                             &result.resource_names_failed);
-    }
-  } else if (IsRds(result.type_url)) {
-    result.parse_error =
-        RdsResponseParse(context, response, expected_route_configuration_names,
-                         &result.rds_update_map, &result.resource_names_failed);
-    if (result.parse_error != GRPC_ERROR_NONE) {
-      MoveUpdatesToFailedSet(&result.rds_update_map,
-                             &result.resource_names_failed);
-    }
-  } else if (IsCds(result.type_url)) {
-    result.parse_error =
-        CdsResponseParse(context, response, expected_cluster_names,
-                         &result.cds_update_map, &result.resource_names_failed);
-    if (result.parse_error != GRPC_ERROR_NONE) {
-      MoveUpdatesToFailedSet(&result.cds_update_map,
-                             &result.resource_names_failed);
+  size_t size;
+  const google_protobuf_Any* const* resources =
+      envoy_service_discovery_v3_DiscoveryResponse_resources(response, &size);
+  ParseResources(context, resources, size, expected_listener_names,
+                 expected_route_configuration_names, expected_cluster_names,
+                 expected_eds_service_names, &lds_resource_cache_,
+                 &rds_resource_cache_, &cds_resource_cache_,
+                 &eds_resource_cache_, &result);
+  return result;
+}
+
+XdsApi::AdsParseResult XdsApi::ParseDeltaAdsResponse(
+    const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
+    const std::set<absl::string_view>& expected_listener_names,
+    const std::set<absl::string_view>& expected_route_configuration_names,
+    const std::set<absl::string_view>& expected_cluster_names,
+    const std::set<absl::string_view>& expected_eds_service_names) {
+  AdsParseResult result;
+  upb::Arena arena;
+  const EncodingContext context = {client_, tracer_, symtab_.ptr(), arena.ptr(),
+                                   server.ShouldUseV3()};
+  MaybeResetResourceCaches();
+  // Decode the response.
+  const envoy_service_discovery_v3_DeltaDiscoveryResponse* response =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_parse(
+          reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(encoded_response)),
+          GRPC_SLICE_LENGTH(encoded_response), arena.ptr());
+  // If decoding fails, output an empty type_url and return.
+  if (response == nullptr) {
+    result.parse_error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "Can't decode DeltaDiscoveryResponse.");
+    return result;
+  }
+  MaybeLogDeltaDiscoveryResponse(context, response);
+  // Record the type_url, the system_version_info, and the nonce of the
+  // response.
+  result.type_url = TypeUrlInternalToExternal(UpbStringToAbsl(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_type_url(response)));
+  result.version = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_system_version_info(
+          response));
+  result.nonce = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_nonce(response));
+  // Unwrap the resources, recording their individual versions.
+  size_t size;
+  const envoy_service_discovery_v3_Resource* const* delta_resources =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_resources(response,
+                                                                  &size);
+  std::vector<const google_protobuf_Any*> resources;
+  resources.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    if (!envoy_service_discovery_v3_Resource_has_resource(
+            delta_resources[i])) {
+      continue;
     }
-  } else if (IsEds(result.type_url)) {
-    result.parse_error =
-        EdsResponseParse(context, response, expected_eds_service_names,
-                         &result.eds_update_map, &result.resource_names_failed);
-    if (result.parse_error != GRPC_ERROR_NONE) {
-      MoveUpdatesToFailedSet(&result.eds_update_map,
-                             &result.resource_names_failed);
+    resources.push_back(
+        envoy_service_discovery_v3_Resource_resource(delta_resources[i]));
+    std::string name = UpbStringToStdString(
+        envoy_service_discovery_v3_Resource_name(delta_resources[i]));
+    if (!name.empty()) {
+      result.resource_versions[std::move(name)] = UpbStringToStdString(
+          envoy_service_discovery_v3_Resource_version(delta_resources[i]));
     }
   }
+  const upb_strview* removed_resources =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_removed_resources(
+          response, &size);
+  for (size_t i = 0; i < size; ++i) {
+    result.removed_resource_names.insert(
+        UpbStringToStdString(removed_resources[i]));
+  }
+  // Parse the response according to the resource type.
+  ParseResources(context, resources.data(), resources.size(),
+                 expected_listener_names, expected_route_configuration_names,
+                 expected_cluster_names, expected_eds_service_names,
+                 &lds_resource_cache_, &rds_resource_cache_,
+                 &cds_resource_cache_, &eds_resource_cache_, &result);
   return result;
 }
 
@@ -23,7 +23,9 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <set>
+#include <string>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
@@ -601,6 +603,77 @@ class XdsApi {
                     ResourceMetadata::ClientResourceStatus::NACKED,
                 "");
 
+  // Remembers the most recently validated version of each resource, so
+  // that a resource the server sends again unchanged is neither decoded
+  // nor validated a second time.  Entries are found by a hash of the
+  // resource's serialized bytes and then compared byte for byte.
+  template <typename ResourceDataType>
+  class ParsedResourceCache {
+   public:
+    // Returns the cached resource with serialized bytes \a serialized,
+    // setting \a name to its name, or null if there is none.
+    const ResourceDataType* Find(uint64_t hash, absl::string_view serialized,
+                                 const std::string** name) const {
+      auto it = names_by_hash_.find(hash);
+      if (it == names_by_hash_.end()) return nullptr;
+      auto entry_it = entries_.find(it->second);
+      if (entry_it == entries_.end() ||
+          entry_it->second.data.serialized_proto != serialized) {
+        return nullptr;
+      }
+      *name = &entry_it->first;
+      return &entry_it->second.data;
+    }
+
+    // Records \a data as the current version of resource \a name.
+    void Add(uint64_t hash, const std::string& name,
+             const ResourceDataType& data) {
+      auto it = entries_.find(name);
+      if (it == entries_.end()) {
+        it = entries_.emplace(name, Entry{hash, data}).first;
+      } else {
+        EraseHash(it);
+        it->second = Entry{hash, data};
+      }
+      names_by_hash_[hash] = name;
+    }
+
+    // Drops the resources whose names are not in \a names.
+    void RetainOnly(const std::set<absl::string_view>& names) {
+      for (auto it = entries_.begin(); it != entries_.end();) {
+        if (names.find(it->first) == names.end()) {
+          EraseHash(it);
+          it = entries_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    void Clear() {
+      entries_.clear();
+      names_by_hash_.clear();
+    }
+
+    size_t size() const { return entries_.size(); }
+
+   private:
+    struct Entry {
+      uint64_t hash;
+      ResourceDataType data;
+    };
+
+    void EraseHash(typename std::map<std::string, Entry>::iterator it) {
+      auto hash_it = names_by_hash_.find(it->second.hash);
+      if (hash_it != names_by_hash_.end() && hash_it->second == it->first) {
+        names_by_hash_.erase(hash_it);
+      }
+    }
+
+    std::map<std::string /*resource_name*/, Entry> entries_;
+    std::map<uint64_t /*hash*/, std::string /*resource_name*/> names_by_hash_;
+  };
+
   // If the response can't be parsed at the top level, the resulting
   // type_url will be empty.
   // If there is any other type of validation error, the parse_error
@@ -618,6 +691,10 @@ class XdsApi {
     CdsUpdateMap cds_update_map;
     EdsUpdateMap eds_update_map;
     std::set<std::string> resource_names_failed;
+    // Only populated for delta responses.
+    std::map<std::string /*resource_name*/, std::string /*version*/>
+        resource_versions;
+    std::set<std::string> removed_resource_names;
   };
 
   XdsApi(XdsClient* client, TraceFlag* tracer, const XdsBootstrap::Node* node);
@@ -631,6 +708,18 @@ class XdsApi {
                               const std::string& nonce, grpc_error_handle error,
                               bool populate_node);
 
+  // Creates a delta ADS request.  \a resource_names_subscribe and
+  // \a resource_names_unsubscribe are relative to what was previously
+  // requested on the stream.
+  // Takes ownership of \a error.
+  grpc_slice CreateDeltaAdsRequest(
+      const XdsBootstrap::XdsServer& server, const std::string& type_url,
+      const std::set<absl::string_view>& resource_names_subscribe,
+      const std::set<absl::string_view>& resource_names_unsubscribe,
+      const std::map<absl::string_view, absl::string_view>&
+          initial_resource_versions,
+      const std::string& nonce, grpc_error_handle error, bool populate_node);
+
   // Parses an ADS response.
   AdsParseResult ParseAdsResponse(
       const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
@@ -639,6 +728,16 @@ class XdsApi {
       const std::set<absl::string_view>& expected_cluster_names,
       const std::set<absl::string_view>& expected_eds_service_names);
 
+  // Parses a delta ADS response.  Only the resources that changed are
+  // present in the update maps; removed resources are listed in
+  // removed_resource_names.
+  AdsParseResult ParseDeltaAdsResponse(
+      const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
+      const std::set<absl::string_view>& expected_listener_names,
+      const std::set<absl::string_view>& expected_route_configuration_names,
+      const std::set<absl::string_view>& expected_cluster_names,
+      const std::set<absl::string_view>& expected_eds_service_names);
+
   // Creates an initial LRS request.
   grpc_slice CreateLrsInitialRequest(const XdsBootstrap::XdsServer& server);
 
@@ -658,12 +757,22 @@ class XdsApi {
       const ResourceTypeMetadataMap& resource_type_metadata_map);
 
  private:
+  void MaybeResetResourceCaches();
+
   XdsClient* client_;
   TraceFlag* tracer_;
   const XdsBootstrap::Node* node_;  // Do not own.
   upb::SymbolTable symtab_;
   const std::string build_version_;
   const std::string user_agent_name_;
+  // Validated resources, by type.  The hash seed covers the experimental
+  // features that change how resources validate; the caches are cleared
+  // when it changes.
+  uint64_t resource_cache_seed_ = 0;
+  ParsedResourceCache<LdsResourceData> lds_resource_cache_;
+  ParsedResourceCache<RdsResourceData> rds_resource_cache_;
+  ParsedResourceCache<CdsResourceData> cds_resource_cache_;
+  ParsedResourceCache<EdsResourceData> eds_resource_cache_;
 };
 
 }  // namespace grpc_core
@@ -76,6 +76,12 @@ bool XdsBootstrap::XdsServer::ShouldUseV3() const {
   return server_features.find("xds_v3") != server_features.end();
 }
 
+bool XdsBootstrap::XdsServer::ShouldUseDelta() const {
+  // The delta protocol only exists in v3.
+  return ShouldUseV3() &&
+         server_features.find("xds_delta") != server_features.end();
+}
+
 //
 // XdsBootstrap
 //
@@ -285,7 +291,8 @@ grpc_error_handle XdsBootstrap::ParseServerFeaturesArray(Json* json,
   for (size_t i = 0; i < json->mutable_array()->size(); ++i) {
     Json& child = json->mutable_array()->at(i);
     if (child.type() == Json::Type::STRING &&
-        child.string_value() == "xds_v3") {
+        (child.string_value() == "xds_v3" ||
+         child.string_value() == "xds_delta")) {
       server->server_features.insert(std::move(*child.mutable_string_value()));
     }
   }
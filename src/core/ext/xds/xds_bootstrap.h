@@ -65,6 +65,7 @@ class XdsBootstrap {
     std::set<std::string> server_features;
 
     bool ShouldUseV3() const;
+    bool ShouldUseDelta() const;
   };
 
   // Creates bootstrap object from json_string.
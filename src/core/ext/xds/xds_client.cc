@@ -257,8 +257,44 @@ class XdsClient::ChannelState::AdsCallState
     // Subscribed resources of this type.
     std::map<std::string /* name */, OrphanablePtr<ResourceState>>
         subscribed_resources;
+
+    // Delta only: whether a request for this type has been sent on this
+    // stream, and the resource names the server was told about.
+    bool sent_request = false;
+    std::set<std::string> requested_resource_names;
   };
 
+  bool delta() const { return chand()->server_.ShouldUseDelta(); }
+
+  // Invokes \a f with the XdsClient resource map for \a type_url.
+  // Since the maps have different types, \a f must be a functor with a
+  // templated call operator.
+  template <typename F>
+  void WithResourceMapLocked(const std::string& type_url, F f)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_) {
+    if (type_url == XdsApi::kLdsTypeUrl) {
+      f(&xds_client()->listener_map_);
+    } else if (type_url == XdsApi::kRdsTypeUrl) {
+      f(&xds_client()->route_config_map_);
+    } else if (type_url == XdsApi::kCdsTypeUrl) {
+      f(&xds_client()->cluster_map_);
+    } else if (type_url == XdsApi::kEdsTypeUrl) {
+      f(&xds_client()->endpoint_map_);
+    }
+  }
+
+  bool HasCachedResourceLocked(const std::string& type_url,
+                               const std::string& name)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  std::map<absl::string_view, absl::string_view> CachedResourceVersionsLocked(
+      const std::string& type_url,
+      const std::set<absl::string_view>& resource_names)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  grpc_slice CreateDeltaRequestLocked(const std::string& type_url,
+                                      const std::set<absl::string_view>&
+                                          resource_names)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
   void SendMessageLocked(const std::string& type_url)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
@@ -274,6 +310,14 @@ class XdsClient::ChannelState::AdsCallState
   void AcceptEdsUpdateLocked(std::string version, grpc_millis update_time,
                              XdsApi::EdsUpdateMap eds_update_map)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  // Delta only.
+  void AcceptDeltaResourceVersionsLocked(
+      const std::string& type_url,
+      const std::map<std::string, std::string>& resource_versions)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  void AcceptRemovedResourcesLocked(const std::string& type_url,
+                                    const std::set<std::string>& names)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
   static void OnRequestSent(void* arg, grpc_error_handle error);
   void OnRequestSentLocked(grpc_error_handle error)
@@ -692,10 +736,18 @@ XdsClient::ChannelState::AdsCallState::AdsCallState(
   // the polling entities from client_channel.
   GPR_ASSERT(xds_client() != nullptr);
   // Create a call with the specified method name.
-  const auto& method =
-      chand()->server_.ShouldUseV3()
-          ? GRPC_MDSTR_SLASH_ENVOY_DOT_SERVICE_DOT_DISCOVERY_DOT_V3_DOT_AGGREGATEDDISCOVERYSERVICE_SLASH_STREAMAGGREGATEDRESOURCES
-          : GRPC_MDSTR_SLASH_ENVOY_DOT_SERVICE_DOT_DISCOVERY_DOT_V2_DOT_AGGREGATEDDISCOVERYSERVICE_SLASH_STREAMAGGREGATEDRESOURCES;
+  grpc_slice method;
+  if (delta()) {
+    method = grpc_slice_from_static_string(
+        "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+        "DeltaAggregatedResources");
+  } else if (chand()->server_.ShouldUseV3()) {
+    method =
+        GRPC_MDSTR_SLASH_ENVOY_DOT_SERVICE_DOT_DISCOVERY_DOT_V3_DOT_AGGREGATEDDISCOVERYSERVICE_SLASH_STREAMAGGREGATEDRESOURCES;
+  } else {
+    method =
+        GRPC_MDSTR_SLASH_ENVOY_DOT_SERVICE_DOT_DISCOVERY_DOT_V2_DOT_AGGREGATEDDISCOVERYSERVICE_SLASH_STREAMAGGREGATEDRESOURCES;
+  }
   call_ = grpc_channel_create_pollset_set_call(
       chand()->channel_, nullptr, GRPC_PROPAGATE_DEFAULTS,
       xds_client()->interested_parties_, method, nullptr,
@@ -814,10 +866,14 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
   grpc_slice request_payload_slice;
   std::set<absl::string_view> resource_names =
       ResourceNamesForRequest(type_url);
-  request_payload_slice = xds_client()->api_.CreateAdsRequest(
-      chand()->server_, type_url, resource_names,
-      xds_client()->resource_version_map_[type_url], state.nonce,
-      GRPC_ERROR_REF(state.error), !sent_initial_message_);
+  if (delta()) {
+    request_payload_slice = CreateDeltaRequestLocked(type_url, resource_names);
+  } else {
+    request_payload_slice = xds_client()->api_.CreateAdsRequest(
+        chand()->server_, type_url, resource_names,
+        xds_client()->resource_version_map_[type_url], state.nonce,
+        GRPC_ERROR_REF(state.error), !sent_initial_message_);
+  }
   if (type_url != XdsApi::kLdsTypeUrl && type_url != XdsApi::kRdsTypeUrl &&
       type_url != XdsApi::kCdsTypeUrl && type_url != XdsApi::kEdsTypeUrl) {
     state_map_.erase(type_url);
@@ -834,6 +890,8 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
   }
   GRPC_ERROR_UNREF(state.error);
   state.error = GRPC_ERROR_NONE;
+  // In delta, the nonce is only sent to ACK or NACK the response carrying it.
+  if (delta()) state.nonce.clear();
   // Create message payload.
   send_message_payload_ =
       grpc_raw_byte_buffer_create(&request_payload_slice, 1);
@@ -860,8 +918,12 @@ void XdsClient::ChannelState::AdsCallState::SubscribeLocked(
     const std::string& type_url, const std::string& name) {
   auto& state = state_map_[type_url].subscribed_resources[name];
   if (state == nullptr) {
+    // In delta, the server will not re-send a resource we already have,
+    // so only wait for the ones that are not cached.
     state = MakeOrphanable<ResourceState>(
-        type_url, name, !xds_client()->resource_version_map_[type_url].empty());
+        type_url, name,
+        delta() ? HasCachedResourceLocked(type_url, name)
+                : !xds_client()->resource_version_map_[type_url].empty());
     SendMessageLocked(type_url);
   }
 }
@@ -882,6 +944,140 @@ bool XdsClient::ChannelState::AdsCallState::HasSubscribedResources() const {
 
 namespace {
 
+// Functors for AdsCallState::WithResourceMapLocked().
+
+template <typename T>
+bool HasUpdate(const absl::optional<T>& update) {
+  return update.has_value();
+}
+
+template <typename T>
+bool HasUpdate(const std::shared_ptr<T>& update) {
+  return update != nullptr;
+}
+
+struct HasCachedResource {
+  template <typename ResourceMap>
+  void operator()(ResourceMap* resource_map) const {
+    auto it = resource_map->find(name);
+    *cached = it != resource_map->end() && HasUpdate(it->second.update);
+  }
+
+  const std::string& name;
+  bool* cached;
+};
+
+struct CollectCachedResourceVersions {
+  template <typename ResourceMap>
+  void operator()(ResourceMap* resource_map) const {
+    for (absl::string_view name : resource_names) {
+      auto it = resource_map->find(std::string(name));
+      if (it == resource_map->end() || !HasUpdate(it->second.update) ||
+          it->second.meta.version.empty()) {
+        continue;
+      }
+      (*versions)[name] = it->second.meta.version;
+    }
+  }
+
+  const std::set<absl::string_view>& resource_names;
+  std::map<absl::string_view, absl::string_view>* versions;
+};
+
+struct SetResourceVersions {
+  template <typename ResourceMap>
+  void operator()(ResourceMap* resource_map) const {
+    for (const auto& p : resource_versions) {
+      auto it = resource_map->find(p.first);
+      if (it == resource_map->end() || !HasUpdate(it->second.update)) {
+        continue;
+      }
+      it->second.meta.version = p.second;
+    }
+  }
+
+  const std::map<std::string, std::string>& resource_versions;
+};
+
+struct RemoveResources {
+  template <typename ResourceMap>
+  void operator()(ResourceMap* resource_map) const {
+    for (const std::string& name : names) {
+      auto it = resource_map->find(name);
+      if (it == resource_map->end() || !HasUpdate(it->second.update)) {
+        continue;
+      }
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+        gpr_log(GPR_INFO, "[xds_client %p] resource {type=%s name=%s} removed",
+                xds_client, type_url.c_str(), name.c_str());
+      }
+      it->second.update.reset();
+      for (const auto& w : it->second.watchers) {
+        w.first->OnResourceDoesNotExist();
+      }
+    }
+  }
+
+  XdsClient* xds_client;
+  const std::string& type_url;
+  const std::set<std::string>& names;
+};
+
+}  // namespace
+
+bool XdsClient::ChannelState::AdsCallState::HasCachedResourceLocked(
+    const std::string& type_url, const std::string& name) {
+  bool cached = false;
+  WithResourceMapLocked(type_url, HasCachedResource{name, &cached});
+  return cached;
+}
+
+std::map<absl::string_view, absl::string_view>
+XdsClient::ChannelState::AdsCallState::CachedResourceVersionsLocked(
+    const std::string& type_url,
+    const std::set<absl::string_view>& resource_names) {
+  std::map<absl::string_view, absl::string_view> versions;
+  WithResourceMapLocked(
+      type_url, CollectCachedResourceVersions{resource_names, &versions});
+  return versions;
+}
+
+grpc_slice XdsClient::ChannelState::AdsCallState::CreateDeltaRequestLocked(
+    const std::string& type_url,
+    const std::set<absl::string_view>& resource_names) {
+  auto& state = state_map_[type_url];
+  // Only send the changes to the subscription since the last request.
+  std::set<absl::string_view> subscribe;
+  for (absl::string_view name : resource_names) {
+    if (state.requested_resource_names.find(std::string(name)) ==
+        state.requested_resource_names.end()) {
+      subscribe.insert(name);
+    }
+  }
+  std::set<absl::string_view> unsubscribe;
+  for (const std::string& name : state.requested_resource_names) {
+    if (resource_names.find(name) == resource_names.end()) {
+      unsubscribe.insert(name);
+    }
+  }
+  // On a new stream, tell the server which versions we already have.
+  std::map<absl::string_view, absl::string_view> initial_resource_versions;
+  if (!state.sent_request) {
+    initial_resource_versions =
+        CachedResourceVersionsLocked(type_url, subscribe);
+  }
+  grpc_slice request = xds_client()->api_.CreateDeltaAdsRequest(
+      chand()->server_, type_url, subscribe, unsubscribe,
+      initial_resource_versions, state.nonce, GRPC_ERROR_REF(state.error),
+      !sent_initial_message_);
+  state.sent_request = true;
+  state.requested_resource_names =
+      std::set<std::string>(resource_names.begin(), resource_names.end());
+  return request;
+}
+
+namespace {
+
 // Build a resource metadata struct for ADS result accepting methods and CSDS.
 XdsApi::ResourceMetadata CreateResourceMetadataAcked(
     std::string serialized_proto, std::string version,
@@ -921,10 +1117,12 @@ void XdsClient::ChannelState::AdsCallState::AcceptLdsUpdateLocked(
       rds_resource_names_seen.insert(
           lds_update.http_connection_manager.route_config_name);
     }
-    // Ignore identical update.
+    // Ignore identical update.  Comparing the serialized bytes first
+    // avoids a deep comparison for resources the server re-sent unchanged.
     ListenerState& listener_state = xds_client()->listener_map_[listener_name];
     if (listener_state.update.has_value() &&
-        *listener_state.update == lds_update) {
+        (listener_state.meta.serialized_proto == p.second.serialized_proto ||
+         *listener_state.update == lds_update)) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
         gpr_log(GPR_INFO,
                 "[xds_client %p] LDS update for %s identical to current, "
@@ -942,6 +1140,9 @@ void XdsClient::ChannelState::AdsCallState::AcceptLdsUpdateLocked(
       p.first->OnListenerChanged(*listener_state.update);
     }
   }
+  // A delta update only carries the resources that changed; removals are
+  // sent explicitly.
+  if (delta()) return;
   // For any subscribed resource that is not present in the update,
   // remove it from the cache and notify watchers that it does not exist.
   for (const auto& p : lds_state.subscribed_resources) {
@@ -1003,7 +1204,9 @@ void XdsClient::ChannelState::AdsCallState::AcceptRdsUpdateLocked(
         xds_client()->route_config_map_[route_config_name];
     // Ignore identical update.
     if (route_config_state.update.has_value() &&
-        *route_config_state.update == rds_update) {
+        (route_config_state.meta.serialized_proto ==
+             p.second.serialized_proto ||
+         *route_config_state.update == rds_update)) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
         gpr_log(GPR_INFO,
                 "[xds_client %p] RDS resource identical to current, ignoring",
@@ -1048,8 +1251,9 @@ void XdsClient::ChannelState::AdsCallState::AcceptCdsUpdateLocked(
                                        : cds_update.eds_service_name);
     // Ignore identical update.
     ClusterState& cluster_state = xds_client()->cluster_map_[cluster_name];
-    if (cluster_state.update.has_value() &&
-        *cluster_state.update == cds_update) {
+    if (cluster_state.update != nullptr &&
+        (cluster_state.meta.serialized_proto == p.second.serialized_proto ||
+         *cluster_state.update == cds_update)) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
         gpr_log(GPR_INFO,
                 "[xds_client %p] CDS update identical to current, ignoring.",
@@ -1057,15 +1261,19 @@ void XdsClient::ChannelState::AdsCallState::AcceptCdsUpdateLocked(
       }
       continue;
     }
-    // Update the cluster state.
-    cluster_state.update = std::move(cds_update);
+    // Update the cluster state.  Watchers share the new snapshot.
+    cluster_state.update =
+        std::make_shared<const XdsApi::CdsUpdate>(std::move(cds_update));
     cluster_state.meta = CreateResourceMetadataAcked(
         std::move(p.second.serialized_proto), version, update_time);
     // Notify all watchers.
     for (const auto& p : cluster_state.watchers) {
-      p.first->OnClusterChanged(cluster_state.update.value());
+      p.first->OnClusterChanged(cluster_state.update);
     }
   }
+  // A delta update only carries the resources that changed; removals are
+  // sent explicitly.
+  if (delta()) return;
   // For any subscribed resource that is not present in the update,
   // remove it from the cache and notify watchers that it does not exist.
   for (const auto& p : cds_state.subscribed_resources) {
@@ -1078,7 +1286,7 @@ void XdsClient::ChannelState::AdsCallState::AcceptCdsUpdateLocked(
       // request the new resource, so its absence from the response does not
       // necessarily indicate that the resource does not exist.
       // For that case, we rely on the request timeout instead.
-      if (!cluster_state.update.has_value()) continue;
+      if (cluster_state.update == nullptr) continue;
       cluster_state.update.reset();
       for (const auto& p : cluster_state.watchers) {
         p.first->OnResourceDoesNotExist();
@@ -1125,8 +1333,9 @@ void XdsClient::ChannelState::AdsCallState::AcceptEdsUpdateLocked(
     EndpointState& endpoint_state =
         xds_client()->endpoint_map_[eds_service_name];
     // Ignore identical update.
-    if (endpoint_state.update.has_value() &&
-        *endpoint_state.update == eds_update) {
+    if (endpoint_state.update != nullptr &&
+        (endpoint_state.meta.serialized_proto == p.second.serialized_proto ||
+         *endpoint_state.update == eds_update)) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
         gpr_log(GPR_INFO,
                 "[xds_client %p] EDS update identical to current, ignoring.",
@@ -1134,17 +1343,30 @@ void XdsClient::ChannelState::AdsCallState::AcceptEdsUpdateLocked(
       }
       continue;
     }
-    // Update the cluster state.
-    endpoint_state.update = std::move(eds_update);
+    // Update the cluster state.  Watchers share the new snapshot.
+    endpoint_state.update =
+        std::make_shared<const XdsApi::EdsUpdate>(std::move(eds_update));
     endpoint_state.meta = CreateResourceMetadataAcked(
         std::move(p.second.serialized_proto), version, update_time);
     // Notify all watchers.
     for (const auto& p : endpoint_state.watchers) {
-      p.first->OnEndpointChanged(endpoint_state.update.value());
+      p.first->OnEndpointChanged(endpoint_state.update);
     }
   }
 }
 
+void XdsClient::ChannelState::AdsCallState::AcceptDeltaResourceVersionsLocked(
+    const std::string& type_url,
+    const std::map<std::string, std::string>& resource_versions) {
+  WithResourceMapLocked(type_url, SetResourceVersions{resource_versions});
+}
+
+void XdsClient::ChannelState::AdsCallState::AcceptRemovedResourcesLocked(
+    const std::string& type_url, const std::set<std::string>& names) {
+  WithResourceMapLocked(type_url,
+                        RemoveResources{xds_client(), type_url, names});
+}
+
 void XdsClient::ChannelState::AdsCallState::OnRequestSent(
     void* arg, grpc_error_handle error) {
   AdsCallState* ads_calld = static_cast<AdsCallState*>(arg);
@@ -1203,12 +1425,19 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
   grpc_byte_buffer_destroy(recv_message_payload_);
   recv_message_payload_ = nullptr;
   // Parse and validate the response.
-  XdsApi::AdsParseResult result = xds_client()->api_.ParseAdsResponse(
-      chand()->server_, response_slice,
-      ResourceNamesForRequest(XdsApi::kLdsTypeUrl),
-      ResourceNamesForRequest(XdsApi::kRdsTypeUrl),
-      ResourceNamesForRequest(XdsApi::kCdsTypeUrl),
-      ResourceNamesForRequest(XdsApi::kEdsTypeUrl));
+  XdsApi::AdsParseResult result =
+      delta() ? xds_client()->api_.ParseDeltaAdsResponse(
+                    chand()->server_, response_slice,
+                    ResourceNamesForRequest(XdsApi::kLdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kRdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kCdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kEdsTypeUrl))
+              : xds_client()->api_.ParseAdsResponse(
+                    chand()->server_, response_slice,
+                    ResourceNamesForRequest(XdsApi::kLdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kRdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kCdsTypeUrl),
+                    ResourceNamesForRequest(XdsApi::kEdsTypeUrl));
   grpc_slice_unref_internal(response_slice);
   if (result.type_url.empty()) {
     // Ignore unparsable response.
@@ -1251,6 +1480,12 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
         AcceptEdsUpdateLocked(result.version, update_time,
                               std::move(result.eds_update_map));
       }
+      if (delta()) {
+        AcceptDeltaResourceVersionsLocked(result.type_url,
+                                          result.resource_versions);
+        AcceptRemovedResourcesLocked(result.type_url,
+                                     result.removed_resource_names);
+      }
       xds_client()->resource_version_map_[result.type_url] =
           std::move(result.version);
       // ACK the update.
@@ -1955,12 +2190,12 @@ void XdsClient::WatchClusterData(
   cluster_state.watchers[w] = std::move(watcher);
   // If we've already received a CDS update, notify the new watcher
   // immediately.
-  if (cluster_state.update.has_value()) {
+  if (cluster_state.update != nullptr) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
       gpr_log(GPR_INFO, "[xds_client %p] returning cached cluster data for %s",
               this, cluster_name_str.c_str());
     }
-    w->OnClusterChanged(cluster_state.update.value());
+    w->OnClusterChanged(cluster_state.update);
   }
   chand_->SubscribeLocked(XdsApi::kCdsTypeUrl, cluster_name_str);
 }
@@ -1993,12 +2228,12 @@ void XdsClient::WatchEndpointData(
   endpoint_state.watchers[w] = std::move(watcher);
   // If we've already received an EDS update, notify the new watcher
   // immediately.
-  if (endpoint_state.update.has_value()) {
+  if (endpoint_state.update != nullptr) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
       gpr_log(GPR_INFO, "[xds_client %p] returning cached endpoint data for %s",
               this, eds_service_name_str.c_str());
     }
-    w->OnEndpointChanged(endpoint_state.update.value());
+    w->OnEndpointChanged(endpoint_state.update);
   }
   chand_->SubscribeLocked(XdsApi::kEdsTypeUrl, eds_service_name_str);
 }
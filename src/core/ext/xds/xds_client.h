@@ -19,6 +19,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -62,19 +63,25 @@ class XdsClient : public DualRefCounted<XdsClient> {
   };
 
   // Cluster data watcher interface.  Implemented by callers.
+  // The update is an immutable snapshot shared by all watchers of the
+  // cluster; callers that need to modify it must make their own copy.
   class ClusterWatcherInterface {
    public:
     virtual ~ClusterWatcherInterface() = default;
-    virtual void OnClusterChanged(XdsApi::CdsUpdate cluster_data) = 0;
+    virtual void OnClusterChanged(
+        std::shared_ptr<const XdsApi::CdsUpdate> cluster_data) = 0;
     virtual void OnError(grpc_error_handle error) = 0;
     virtual void OnResourceDoesNotExist() = 0;
   };
 
   // Endpoint data watcher interface.  Implemented by callers.
+  // The update is an immutable snapshot shared by all watchers of the
+  // resource; callers that need to modify it must make their own copy.
   class EndpointWatcherInterface {
    public:
     virtual ~EndpointWatcherInterface() = default;
-    virtual void OnEndpointChanged(XdsApi::EdsUpdate update) = 0;
+    virtual void OnEndpointChanged(
+        std::shared_ptr<const XdsApi::EdsUpdate> update) = 0;
     virtual void OnError(grpc_error_handle error) = 0;
     virtual void OnResourceDoesNotExist() = 0;
   };
@@ -288,8 +295,8 @@ class XdsClient : public DualRefCounted<XdsClient> {
   struct ClusterState {
     std::map<ClusterWatcherInterface*, std::unique_ptr<ClusterWatcherInterface>>
         watchers;
-    // The latest data seen from CDS.
-    absl::optional<XdsApi::CdsUpdate> update;
+    // The latest data seen from CDS.  Shared with the watchers.
+    std::shared_ptr<const XdsApi::CdsUpdate> update;
     XdsApi::ResourceMetadata meta;
   };
 
@@ -297,8 +304,8 @@ class XdsClient : public DualRefCounted<XdsClient> {
     std::map<EndpointWatcherInterface*,
              std::unique_ptr<EndpointWatcherInterface>>
         watchers;
-    // The latest data seen from EDS.
-    absl::optional<XdsApi::EdsUpdate> update;
+    // The latest data seen from EDS.  Shared with the watchers.
+    std::shared_ptr<const XdsApi::EdsUpdate> update;
     XdsApi::ResourceMetadata meta;
   };
 
@@ -0,0 +1,142 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/xds/xds_route_matcher.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+namespace grpc_core {
+
+constexpr size_t XdsRouteMatcher::kMaxCachedPaths;
+
+XdsRouteMatcher::XdsRouteMatcher(
+    const std::vector<const StringMatcher*>& path_matchers,
+    const RE2::Options& regex_options) {
+  std::vector<std::pair<size_t, const StringMatcher*>> regexes;
+  for (size_t i = 0; i < path_matchers.size(); ++i) {
+    const StringMatcher& matcher = *path_matchers[i];
+    if (!matcher.case_sensitive()) {
+      other_routes_.emplace_back(i, matcher);
+      continue;
+    }
+    switch (matcher.type()) {
+      case StringMatcher::Type::kExact:
+        exact_routes_[matcher.string_matcher()].push_back(i);
+        break;
+      case StringMatcher::Type::kPrefix:
+        prefix_routes_[matcher.string_matcher()].push_back(i);
+        break;
+      case StringMatcher::Type::kSafeRegex:
+        regexes.emplace_back(i, &matcher);
+        break;
+      default:
+        other_routes_.emplace_back(i, matcher);
+    }
+  }
+  for (const auto& p : prefix_routes_) {
+    prefix_lengths_.push_back(p.first.size());
+  }
+  std::sort(prefix_lengths_.begin(), prefix_lengths_.end());
+  prefix_lengths_.erase(
+      std::unique(prefix_lengths_.begin(), prefix_lengths_.end()),
+      prefix_lengths_.end());
+  if (regexes.empty()) return;
+  // StringMatcher::Match() uses RE2::FullMatch(), so anchor at both ends.
+  regex_set_ = absl::make_unique<RE2::Set>(regex_options, RE2::ANCHOR_BOTH);
+  for (const auto& p : regexes) {
+    if (regex_set_->Add(p.second->regex_matcher()->pattern(), nullptr) < 0) {
+      regex_set_.reset();
+      break;
+    }
+    regex_routes_.emplace_back(p.first, *p.second);
+  }
+  if (regex_set_ == nullptr || !regex_set_->Compile()) {
+    // Fall back to evaluating each regex on its own.
+    regex_set_.reset();
+    regex_routes_.clear();
+    for (const auto& p : regexes) {
+      other_routes_.emplace_back(p.first, *p.second);
+    }
+  }
+}
+
+const std::vector<size_t>& XdsRouteMatcher::MatchingRoutes(
+    absl::string_view path, std::vector<size_t>* scratch) {
+  const uint64_t hash = XXH64(path.data(), path.size(), 0);
+  {
+    MutexLock lock(&mu_);
+    auto it = cache_.find(hash);
+    if (it != cache_.end() && it->second.path == path) {
+      return it->second.routes;
+    }
+  }
+  if (!MatchUncached(path, scratch)) return *scratch;
+  MutexLock lock(&mu_);
+  if (cache_.size() >= kMaxCachedPaths) return *scratch;
+  // Entries are never removed, so references to them stay valid.  On a
+  // hash collision, the existing entry is kept.
+  auto result = cache_.emplace(hash, CacheEntry());
+  if (!result.second) return *scratch;
+  result.first->second.path = std::string(path);
+  result.first->second.routes = *scratch;
+  return result.first->second.routes;
+}
+
+bool XdsRouteMatcher::MatchUncached(absl::string_view path,
+                                    std::vector<size_t>* routes) const {
+  routes->clear();
+  auto it = exact_routes_.find(std::string(path));
+  if (it != exact_routes_.end()) {
+    routes->insert(routes->end(), it->second.begin(), it->second.end());
+  }
+  for (size_t length : prefix_lengths_) {
+    if (length > path.size()) break;
+    it = prefix_routes_.find(std::string(path.substr(0, length)));
+    if (it != prefix_routes_.end()) {
+      routes->insert(routes->end(), it->second.begin(), it->second.end());
+    }
+  }
+  bool cacheable = true;
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(re2::StringPiece(path.data(), path.size()),
+                          &matches, &error_info)) {
+      for (int index : matches) routes->push_back(regex_routes_[index].first);
+    } else if (error_info.kind == RE2::Set::kOutOfMemory) {
+      // The DFA ran out of memory, so the set's "no match" cannot be
+      // trusted.  Evaluate each regex on its own instead, and leave the
+      // result out of the cache.
+      for (const auto& p : regex_routes_) {
+        if (p.second.Match(path)) routes->push_back(p.first);
+      }
+      cacheable = false;
+    }
+  }
+  for (const auto& p : other_routes_) {
+    if (p.second.Match(path)) routes->push_back(p.first);
+  }
+  std::sort(routes->begin(), routes->end());
+  return cacheable;
+}
+
+}  // namespace grpc_core
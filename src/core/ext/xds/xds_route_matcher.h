@@ -0,0 +1,95 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_XDS_XDS_ROUTE_MATCHER_H
+#define GRPC_CORE_EXT_XDS_XDS_ROUTE_MATCHER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/matchers/matchers.h"
+
+namespace grpc_core {
+
+// Path matching for an xDS route table, compiled once per route
+// configuration instead of evaluating every route's path matcher on every
+// call.
+//
+// Case-sensitive exact and prefix matchers are indexed by path, and
+// case-sensitive regexes are combined into a single RE2::Set.  All other
+// path matchers are evaluated one by one.  Since the result depends only on
+// the path, it is cached per path.
+class XdsRouteMatcher {
+ public:
+  // Maximum number of distinct paths whose results are cached.  Once the
+  // cache is full, new paths are matched without being cached.
+  static constexpr size_t kMaxCachedPaths = 1000;
+
+  // path_matchers[i] is the path matcher of route i.  \a regex_options are
+  // used to build the combined regex set; tests lower max_mem so that the
+  // set cannot be built and the regexes are evaluated one by one.
+  explicit XdsRouteMatcher(
+      const std::vector<const StringMatcher*>& path_matchers,
+      const RE2::Options& regex_options = RE2::Options());
+
+  XdsRouteMatcher(const XdsRouteMatcher&) = delete;
+  XdsRouteMatcher& operator=(const XdsRouteMatcher&) = delete;
+
+  // Returns the indexes, in increasing order, of the routes whose path
+  // matcher matches \a path.  If the result is not cached, it is stored in
+  // \a scratch, and the returned reference is only valid as long as
+  // \a scratch is.
+  const std::vector<size_t>& MatchingRoutes(absl::string_view path,
+                                            std::vector<size_t>* scratch);
+
+ private:
+  struct CacheEntry {
+    std::string path;
+    std::vector<size_t> routes;
+  };
+
+  // Returns false if the result must not be cached, because the regex set
+  // ran out of memory and the regexes were evaluated one by one instead.
+  bool MatchUncached(absl::string_view path, std::vector<size_t>* routes) const;
+
+  std::map<std::string, std::vector<size_t>> exact_routes_;
+  std::map<std::string, std::vector<size_t>> prefix_routes_;
+  // Distinct lengths of the keys in prefix_routes_, in increasing order.
+  std::vector<size_t> prefix_lengths_;
+  std::unique_ptr<RE2::Set> regex_set_;
+  // Route index and path matcher for each regex in regex_set_.  The matchers
+  // are only used when the set runs out of memory.
+  std::vector<std::pair<size_t, StringMatcher>> regex_routes_;
+  std::vector<std::pair<size_t, StringMatcher>> other_routes_;
+
+  Mutex mu_;
+  // Keyed by the XXH64 hash of the path.
+  std::unordered_map<uint64_t, CacheEntry> cache_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_EXT_XDS_XDS_ROUTE_MATCHER_H */
@@ -21,6 +21,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include "src/core/lib/channel/channel_stack.h"
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gpr/alloc.h"
 
 #include <stdlib.h>
@@ -28,6 +29,41 @@
 
 grpc_core::TraceFlag grpc_trace_channel(false, "channel");
 
+namespace {
+
+struct HandledOps {
+  const grpc_channel_filter* filter;
+  uint8_t ops;
+};
+
+// Registered during plugin initialization only, so no locking is needed.
+constexpr size_t kMaxFiltersWithHandledOps = 32;
+HandledOps g_handled_ops[kMaxFiltersWithHandledOps];
+size_t g_num_handled_ops;
+
+uint8_t handled_ops_for_filter(const grpc_channel_filter* filter) {
+  if (filter->start_transport_stream_op_batch == grpc_call_next_op) return 0;
+  for (size_t i = 0; i < g_num_handled_ops; i++) {
+    if (g_handled_ops[i].filter == filter) return g_handled_ops[i].ops;
+  }
+  return GRPC_STREAM_OP_ALL;
+}
+
+}  // namespace
+
+void grpc_channel_filter_register_handled_ops(const grpc_channel_filter* filter,
+                                              uint8_t handled_ops) {
+  // Plugins are initialized again by every grpc_init() after a shutdown.
+  for (size_t i = 0; i < g_num_handled_ops; i++) {
+    if (g_handled_ops[i].filter == filter) {
+      g_handled_ops[i].ops = handled_ops;
+      return;
+    }
+  }
+  GPR_ASSERT(g_num_handled_ops < kMaxFiltersWithHandledOps);
+  g_handled_ops[g_num_handled_ops++] = {filter, handled_ops};
+}
+
 /* Memory layouts.
 
    Channel stack is laid out as: {
@@ -119,6 +155,9 @@ grpc_error_handle grpc_channel_stack_init(
               GPR_ROUND_UP_TO_ALIGNMENT_SIZE(filter_count *
                                              sizeof(grpc_channel_element));
 
+  const bool skip_passthrough_filters = grpc_channel_args_find_bool(
+      channel_args, GRPC_ARG_SKIP_PASSTHROUGH_FILTERS, false);
+
   /* init per-filter data */
   grpc_error_handle first_error = GRPC_ERROR_NONE;
   for (i = 0; i < filter_count; i++) {
@@ -129,6 +168,11 @@ grpc_error_handle grpc_channel_stack_init(
     args.is_last = i == (filter_count - 1);
     elems[i].filter = filters[i];
     elems[i].channel_data = user_data;
+    // The last element must take every batch: grpc_call_next_op relies on it
+    // to stop.
+    elems[i].handled_ops = skip_passthrough_filters && !args.is_last
+                               ? handled_ops_for_filter(filters[i])
+                               : GRPC_STREAM_OP_ALL;
     grpc_error_handle error =
         elems[i].filter->init_channel_elem(&elems[i], &args);
     if (error != GRPC_ERROR_NONE) {
@@ -184,6 +228,7 @@ grpc_error_handle grpc_call_stack_init(
     call_elems[i].filter = channel_elems[i].filter;
     call_elems[i].channel_data = channel_elems[i].channel_data;
     call_elems[i].call_data = user_data;
+    call_elems[i].handled_ops = channel_elems[i].handled_ops;
     user_data +=
         GPR_ROUND_UP_TO_ALIGNMENT_SIZE(call_elems[i].filter->sizeof_call_data);
   }
@@ -236,6 +281,8 @@ void grpc_call_stack_destroy(grpc_call_stack* stack,
 void grpc_call_next_op(grpc_call_element* elem,
                        grpc_transport_stream_op_batch* op) {
   grpc_call_element* next_elem = elem + 1;
+  const uint8_t ops = grpc_transport_stream_op_batch_ops(op);
+  while ((next_elem->handled_ops & ops) == 0) ++next_elem;
   GRPC_CALL_LOG_OP(GPR_INFO, next_elem, op);
   next_elem->filter->start_transport_stream_op_batch(next_elem, op);
 }
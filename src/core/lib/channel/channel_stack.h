@@ -166,6 +166,9 @@ struct grpc_channel_filter {
 struct grpc_channel_element {
   const grpc_channel_filter* filter;
   void* channel_data;
+  /* The GRPC_STREAM_OP_* bits this element acts on (see
+     grpc_channel_filter_register_handled_ops) */
+  uint8_t handled_ops;
 };
 
 /* A call_element tracks its filter, the filter requested memory within
@@ -175,8 +178,56 @@ struct grpc_call_element {
   const grpc_channel_filter* filter;
   void* channel_data;
   void* call_data;
+  /* Copied from the channel element, so that grpc_call_next_op can skip this
+     element without touching the filter */
+  uint8_t handled_ops;
 };
 
+/* Bits for the ops a grpc_transport_stream_op_batch can carry */
+#define GRPC_STREAM_OP_SEND_INITIAL_METADATA 0x01
+#define GRPC_STREAM_OP_SEND_TRAILING_METADATA 0x02
+#define GRPC_STREAM_OP_SEND_MESSAGE 0x04
+#define GRPC_STREAM_OP_RECV_INITIAL_METADATA 0x08
+#define GRPC_STREAM_OP_RECV_MESSAGE 0x10
+#define GRPC_STREAM_OP_RECV_TRAILING_METADATA 0x20
+#define GRPC_STREAM_OP_CANCEL_STREAM 0x40
+#define GRPC_STREAM_OP_ALL 0x7f
+
+/* Return the GRPC_STREAM_OP_* bits for the ops in \a batch. A batch with no
+   ops is reported as carrying all of them, so that no filter is skipped. */
+inline uint8_t grpc_transport_stream_op_batch_ops(
+    const grpc_transport_stream_op_batch* batch) {
+  uint8_t ops = 0;
+  if (batch->send_initial_metadata) {
+    ops |= GRPC_STREAM_OP_SEND_INITIAL_METADATA;
+  }
+  if (batch->send_trailing_metadata) {
+    ops |= GRPC_STREAM_OP_SEND_TRAILING_METADATA;
+  }
+  if (batch->send_message) ops |= GRPC_STREAM_OP_SEND_MESSAGE;
+  if (batch->recv_initial_metadata) {
+    ops |= GRPC_STREAM_OP_RECV_INITIAL_METADATA;
+  }
+  if (batch->recv_message) ops |= GRPC_STREAM_OP_RECV_MESSAGE;
+  if (batch->recv_trailing_metadata) {
+    ops |= GRPC_STREAM_OP_RECV_TRAILING_METADATA;
+  }
+  if (batch->cancel_stream) ops |= GRPC_STREAM_OP_CANCEL_STREAM;
+  return ops == 0 ? GRPC_STREAM_OP_ALL : ops;
+}
+
+/* Declare that \a filter only acts on the ops in \a handled_ops (a mask of
+   GRPC_STREAM_OP_* bits): its start_transport_stream_op_batch passes any batch
+   carrying none of them to the next element unchanged, so grpc_call_next_op
+   may jump over it.
+   Filters whose start_transport_stream_op_batch is grpc_call_next_op need not
+   register; filters that never register are never skipped.  Skipping only
+   happens on channels with GRPC_ARG_SKIP_PASSTHROUGH_FILTERS set.
+   Like grpc_channel_init_register_stage, this must be called during plugin
+   initialization. */
+void grpc_channel_filter_register_handled_ops(const grpc_channel_filter* filter,
+                                              uint8_t handled_ops);
+
 /* A channel stack tracks a set of related filters for one channel, and
    guarantees they live within a single malloc() allocation */
 struct grpc_channel_stack {
@@ -280,7 +331,8 @@ void grpc_call_stack_destroy(grpc_call_stack* stack,
  * at all. Does nothing. */
 void grpc_call_stack_ignore_set_pollset_or_pollset_set(
     grpc_call_element* elem, grpc_polling_entity* pollent);
-/* Call the next operation in a call stack */
+/* Call the next operation in a call stack, skipping the elements that do not
+   act on any of the ops in \a op */
 void grpc_call_next_op(grpc_call_element* elem,
                        grpc_transport_stream_op_batch* op);
 /* Call the next operation (depending on call directionality) in a channel
@@ -38,6 +38,12 @@ typedef enum {
   /// Holds a pointer to ServiceConfigCallData associated with this call.
   GRPC_CONTEXT_SERVICE_CONFIG_CALL_DATA,
 
+  /// Value is a uintptr_t relative write weight for the call's stream, stored
+  /// directly in the pointer (zero means unset). Set by the client channel
+  /// from the method's "streamWeight" service config field, and consulted by
+  /// transports that share outgoing bandwidth between streams by weight.
+  GRPC_CONTEXT_STREAM_WEIGHT,
+
   GRPC_CONTEXT_COUNT
 } grpc_context_index;
 
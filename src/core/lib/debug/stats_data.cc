@@ -28,6 +28,8 @@
 const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "client_calls_created",
     "server_calls_created",
+    "call_arena_pool_hits",
+    "call_arena_pool_misses",
     "cqs_created",
     "client_channels_created",
     "client_subchannels_created",
@@ -113,6 +115,9 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "call_combiner_locks_scheduled_items",
     "call_combiner_set_notify_on_cancel",
     "call_combiner_cancelled",
+    "call_combiner_contended_starts",
+    "call_combiner_inline_executions",
+    "call_combiner_inline_depth_exceeded",
     "executor_scheduled_short_items",
     "executor_scheduled_long_items",
     "executor_scheduled_to_self",
@@ -121,13 +126,20 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "executor_push_retries",
     "server_requested_calls",
     "server_slowpath_requests_queued",
+    "server_queue_delay_shed_calls",
+    "server_expired_pending_calls",
     "cq_ev_queue_trylock_failures",
     "cq_ev_queue_trylock_successes",
     "cq_ev_queue_transient_pop_failures",
+    "work_serializer_items_queued",
+    "work_serializer_drain_batches",
 };
 const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of client side calls created by this process",
     "Number of server side calls created by this process",
+    "Number of calls whose arena was reused from their channel's arena pool",
+    "Number of calls that had to allocate a new arena because their "
+    "channel's arena pool was empty",
     "Number of completion queues created",
     "Number of client channels created",
     "Number of client subchannels created",
@@ -233,6 +245,10 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of items scheduled against call combiner locks",
     "Number of times a cancellation callback was set on a call combiner",
     "Number of times a call combiner was cancelled",
+    "Number of closures that found their call combiner busy and were queued",
+    "Number of closures run inline by an idle call combiner",
+    "Number of closures scheduled instead of run inline because the call "
+    "combiner inline depth limit was reached",
     "Number of finite runtime closures scheduled against the executor (gRPC "
     "thread pool)",
     "Number of potentially infinite runtime closures scheduled against the "
@@ -245,12 +261,18 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "How many calls were requested (not necessarily received) by the server",
     "How many times was the server slow path taken (indicates too few "
     "outstanding requests)",
+    "How many pending calls were rejected because the server's queue delay "
+    "stayed above its target",
+    "How many pending calls were dropped because their deadline passed before "
+    "they were matched",
     "Number of lock (trylock) acquisition failures on completion queue event "
     "queue. High value here indicates high contention on completion queues",
     "Number of lock (trylock) acquisition successes on completion queue event "
     "queue.",
     "Number of times NULL was popped out of completion queue's event queue "
     "even though the event queue was not empty",
+    "Number of callbacks that found their work serializer busy and were queued",
+    "Number of batches of queued callbacks run by work serializers",
 };
 const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "call_initial_size",
@@ -266,6 +288,7 @@ const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "http2_send_trailing_metadata_per_write",
     "http2_send_flowctl_per_write",
     "server_cqs_checked",
+    "work_serializer_queue_depth",
 };
 const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     "Initial size of the grpc_call arena created at call start",
@@ -283,6 +306,7 @@ const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     // NOLINTNEXTLINE(bugprone-suspicious-missing-comma)
     "How many completion queues were checked looking for a CQ that had "
     "requested the incoming call",
+    "Number of queued callbacks run by a work serializer in one drain batch",
 };
 const int grpc_stats_table_0[65] = {
     0,      1,      2,      3,      4,     5,     7,     9,     11,    14,
@@ -662,17 +686,42 @@ void grpc_stats_inc_server_cqs_checked(int value) {
       GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
       grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_8, 8));
 }
-const int grpc_stats_histo_buckets[13] = {64, 128, 64, 64, 64, 64, 64,
-                                          64, 64,  64, 64, 64, 8};
-const int grpc_stats_histo_start[13] = {0,   64,  192, 256, 320, 384, 448,
-                                        512, 576, 640, 704, 768, 832};
-const int* const grpc_stats_histo_bucket_boundaries[13] = {
+void grpc_stats_inc_work_serializer_queue_depth(int value) {
+  value = GPR_CLAMP(value, 0, 262144);
+  if (value < 6) {
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH,
+                             value);
+    return;
+  }
+  union {
+    double dbl;
+    uint64_t uint;
+  } _val, _bkt;
+  _val.dbl = value;
+  if (_val.uint < 4651092515166879744ull) {
+    int bucket =
+        grpc_stats_table_1[((_val.uint - 4618441417868443648ull) >> 49)] + 6;
+    _bkt.dbl = grpc_stats_table_0[bucket];
+    bucket -= (_val.uint < _bkt.uint);
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH,
+                             bucket);
+    return;
+  }
+  GRPC_STATS_INC_HISTOGRAM(
+      GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH,
+      grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_0, 64));
+}
+const int grpc_stats_histo_buckets[14] = {64, 128, 64, 64, 64, 64, 64,
+                                          64, 64,  64, 64, 64, 8,  64};
+const int grpc_stats_histo_start[14] = {0,   64,  192, 256, 320, 384, 448,
+                                        512, 576, 640, 704, 768, 832, 840};
+const int* const grpc_stats_histo_bucket_boundaries[14] = {
     grpc_stats_table_0, grpc_stats_table_2, grpc_stats_table_4,
     grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_4,
     grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_6,
     grpc_stats_table_6, grpc_stats_table_6, grpc_stats_table_6,
-    grpc_stats_table_8};
-void (*const grpc_stats_inc_histogram[13])(int x) = {
+    grpc_stats_table_8, grpc_stats_table_0};
+void (*const grpc_stats_inc_histogram[14])(int x) = {
     grpc_stats_inc_call_initial_size,
     grpc_stats_inc_poll_events_returned,
     grpc_stats_inc_tcp_write_size,
@@ -685,4 +734,5 @@ void (*const grpc_stats_inc_histogram[13])(int x) = {
     grpc_stats_inc_http2_send_message_per_write,
     grpc_stats_inc_http2_send_trailing_metadata_per_write,
     grpc_stats_inc_http2_send_flowctl_per_write,
-    grpc_stats_inc_server_cqs_checked};
+    grpc_stats_inc_server_cqs_checked,
+    grpc_stats_inc_work_serializer_queue_depth};
@@ -29,6 +29,8 @@
 typedef enum {
   GRPC_STATS_COUNTER_CLIENT_CALLS_CREATED,
   GRPC_STATS_COUNTER_SERVER_CALLS_CREATED,
+  GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS,
+  GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES,
   GRPC_STATS_COUNTER_CQS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_CHANNELS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_SUBCHANNELS_CREATED,
@@ -114,6 +116,9 @@ typedef enum {
   GRPC_STATS_COUNTER_CALL_COMBINER_LOCKS_SCHEDULED_ITEMS,
   GRPC_STATS_COUNTER_CALL_COMBINER_SET_NOTIFY_ON_CANCEL,
   GRPC_STATS_COUNTER_CALL_COMBINER_CANCELLED,
+  GRPC_STATS_COUNTER_CALL_COMBINER_CONTENDED_STARTS,
+  GRPC_STATS_COUNTER_CALL_COMBINER_INLINE_EXECUTIONS,
+  GRPC_STATS_COUNTER_CALL_COMBINER_INLINE_DEPTH_EXCEEDED,
   GRPC_STATS_COUNTER_EXECUTOR_SCHEDULED_SHORT_ITEMS,
   GRPC_STATS_COUNTER_EXECUTOR_SCHEDULED_LONG_ITEMS,
   GRPC_STATS_COUNTER_EXECUTOR_SCHEDULED_TO_SELF,
@@ -122,9 +127,13 @@ typedef enum {
   GRPC_STATS_COUNTER_EXECUTOR_PUSH_RETRIES,
   GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS,
   GRPC_STATS_COUNTER_SERVER_SLOWPATH_REQUESTS_QUEUED,
+  GRPC_STATS_COUNTER_SERVER_QUEUE_DELAY_SHED_CALLS,
+  GRPC_STATS_COUNTER_SERVER_EXPIRED_PENDING_CALLS,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES,
+  GRPC_STATS_COUNTER_WORK_SERIALIZER_ITEMS_QUEUED,
+  GRPC_STATS_COUNTER_WORK_SERIALIZER_DRAIN_BATCHES,
   GRPC_STATS_COUNTER_COUNT
 } grpc_stats_counters;
 extern const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT];
@@ -143,6 +152,7 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_TRAILING_METADATA_PER_WRITE,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
+  GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH,
   GRPC_STATS_HISTOGRAM_COUNT
 } grpc_stats_histograms;
 extern const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT];
@@ -174,13 +184,19 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE_BUCKETS = 64,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_FIRST_SLOT = 832,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_BUCKETS = 8,
-  GRPC_STATS_HISTOGRAM_BUCKETS = 840
+  GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH_FIRST_SLOT = 840,
+  GRPC_STATS_HISTOGRAM_WORK_SERIALIZER_QUEUE_DEPTH_BUCKETS = 64,
+  GRPC_STATS_HISTOGRAM_BUCKETS = 904
 } grpc_stats_histogram_constants;
 #if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_CALLS_CREATED)
 #define GRPC_STATS_INC_SERVER_CALLS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_CALLS_CREATED)
+#define GRPC_STATS_INC_CALL_ARENA_POOL_HITS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS)
+#define GRPC_STATS_INC_CALL_ARENA_POOL_MISSES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES)
 #define GRPC_STATS_INC_CQS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQS_CREATED)
 #define GRPC_STATS_INC_CLIENT_CHANNELS_CREATED() \
@@ -373,6 +389,13 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_COMBINER_SET_NOTIFY_ON_CANCEL)
 #define GRPC_STATS_INC_CALL_COMBINER_CANCELLED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_COMBINER_CANCELLED)
+#define GRPC_STATS_INC_CALL_COMBINER_CONTENDED_STARTS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_COMBINER_CONTENDED_STARTS)
+#define GRPC_STATS_INC_CALL_COMBINER_INLINE_EXECUTIONS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_COMBINER_INLINE_EXECUTIONS)
+#define GRPC_STATS_INC_CALL_COMBINER_INLINE_DEPTH_EXCEEDED() \
+  GRPC_STATS_INC_COUNTER(                                    \
+      GRPC_STATS_COUNTER_CALL_COMBINER_INLINE_DEPTH_EXCEEDED)
 #define GRPC_STATS_INC_EXECUTOR_SCHEDULED_SHORT_ITEMS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_SCHEDULED_SHORT_ITEMS)
 #define GRPC_STATS_INC_EXECUTOR_SCHEDULED_LONG_ITEMS() \
@@ -389,12 +412,20 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS)
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_SLOWPATH_REQUESTS_QUEUED)
+#define GRPC_STATS_INC_SERVER_QUEUE_DELAY_SHED_CALLS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_QUEUE_DELAY_SHED_CALLS)
+#define GRPC_STATS_INC_SERVER_EXPIRED_PENDING_CALLS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_EXPIRED_PENDING_CALLS)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES)
+#define GRPC_STATS_INC_WORK_SERIALIZER_ITEMS_QUEUED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_WORK_SERIALIZER_ITEMS_QUEUED)
+#define GRPC_STATS_INC_WORK_SERIALIZER_DRAIN_BATCHES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_WORK_SERIALIZER_DRAIN_BATCHES)
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value) \
   grpc_stats_inc_call_initial_size((int)(value))
 void grpc_stats_inc_call_initial_size(int value);
@@ -434,9 +465,14 @@ void grpc_stats_inc_http2_send_flowctl_per_write(int value);
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value) \
   grpc_stats_inc_server_cqs_checked((int)(value))
 void grpc_stats_inc_server_cqs_checked(int value);
+#define GRPC_STATS_INC_WORK_SERIALIZER_QUEUE_DEPTH(value) \
+  grpc_stats_inc_work_serializer_queue_depth((int)(value))
+void grpc_stats_inc_work_serializer_queue_depth(int value);
 #else
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED()
 #define GRPC_STATS_INC_SERVER_CALLS_CREATED()
+#define GRPC_STATS_INC_CALL_ARENA_POOL_HITS()
+#define GRPC_STATS_INC_CALL_ARENA_POOL_MISSES()
 #define GRPC_STATS_INC_CQS_CREATED()
 #define GRPC_STATS_INC_CLIENT_CHANNELS_CREATED()
 #define GRPC_STATS_INC_CLIENT_SUBCHANNELS_CREATED()
@@ -522,6 +558,9 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_CALL_COMBINER_LOCKS_SCHEDULED_ITEMS()
 #define GRPC_STATS_INC_CALL_COMBINER_SET_NOTIFY_ON_CANCEL()
 #define GRPC_STATS_INC_CALL_COMBINER_CANCELLED()
+#define GRPC_STATS_INC_CALL_COMBINER_CONTENDED_STARTS()
+#define GRPC_STATS_INC_CALL_COMBINER_INLINE_EXECUTIONS()
+#define GRPC_STATS_INC_CALL_COMBINER_INLINE_DEPTH_EXCEEDED()
 #define GRPC_STATS_INC_EXECUTOR_SCHEDULED_SHORT_ITEMS()
 #define GRPC_STATS_INC_EXECUTOR_SCHEDULED_LONG_ITEMS()
 #define GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF()
@@ -530,9 +569,13 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES()
 #define GRPC_STATS_INC_SERVER_REQUESTED_CALLS()
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED()
+#define GRPC_STATS_INC_SERVER_QUEUE_DELAY_SHED_CALLS()
+#define GRPC_STATS_INC_SERVER_EXPIRED_PENDING_CALLS()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES()
+#define GRPC_STATS_INC_WORK_SERIALIZER_ITEMS_QUEUED()
+#define GRPC_STATS_INC_WORK_SERIALIZER_DRAIN_BATCHES()
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value)
 #define GRPC_STATS_INC_POLL_EVENTS_RETURNED(value)
 #define GRPC_STATS_INC_TCP_WRITE_SIZE(value)
@@ -546,10 +589,11 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_HTTP2_SEND_TRAILING_METADATA_PER_WRITE(value)
 #define GRPC_STATS_INC_HTTP2_SEND_FLOWCTL_PER_WRITE(value)
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value)
+#define GRPC_STATS_INC_WORK_SERIALIZER_QUEUE_DEPTH(value)
 #endif /* defined(GRPC_COLLECT_STATS) || !defined(NDEBUG) */
-extern const int grpc_stats_histo_buckets[13];
-extern const int grpc_stats_histo_start[13];
-extern const int* const grpc_stats_histo_bucket_boundaries[13];
-extern void (*const grpc_stats_inc_histogram[13])(int x);
+extern const int grpc_stats_histo_buckets[14];
+extern const int grpc_stats_histo_start[14];
+extern const int* const grpc_stats_histo_bucket_boundaries[14];
+extern void (*const grpc_stats_inc_histogram[14])(int x);
 
 #endif /* GRPC_CORE_LIB_DEBUG_STATS_DATA_H */
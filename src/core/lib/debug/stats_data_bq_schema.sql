@@ -1,5 +1,7 @@
 client_calls_created_per_iteration:FLOAT,
 server_calls_created_per_iteration:FLOAT,
+call_arena_pool_hits_per_iteration:FLOAT,
+call_arena_pool_misses_per_iteration:FLOAT,
 cqs_created_per_iteration:FLOAT,
 client_channels_created_per_iteration:FLOAT,
 client_subchannels_created_per_iteration:FLOAT,
@@ -85,6 +87,9 @@ call_combiner_locks_initiated_per_iteration:FLOAT,
 call_combiner_locks_scheduled_items_per_iteration:FLOAT,
 call_combiner_set_notify_on_cancel_per_iteration:FLOAT,
 call_combiner_cancelled_per_iteration:FLOAT,
+call_combiner_contended_starts_per_iteration:FLOAT,
+call_combiner_inline_executions_per_iteration:FLOAT,
+call_combiner_inline_depth_exceeded_per_iteration:FLOAT,
 executor_scheduled_short_items_per_iteration:FLOAT,
 executor_scheduled_long_items_per_iteration:FLOAT,
 executor_scheduled_to_self_per_iteration:FLOAT,
@@ -93,6 +98,10 @@ executor_queue_drained_per_iteration:FLOAT,
 executor_push_retries_per_iteration:FLOAT,
 server_requested_calls_per_iteration:FLOAT,
 server_slowpath_requests_queued_per_iteration:FLOAT,
+server_queue_delay_shed_calls_per_iteration:FLOAT,
+server_expired_pending_calls_per_iteration:FLOAT,
 cq_ev_queue_trylock_failures_per_iteration:FLOAT,
 cq_ev_queue_trylock_successes_per_iteration:FLOAT,
-cq_ev_queue_transient_pop_failures_per_iteration:FLOAT
+cq_ev_queue_transient_pop_failures_per_iteration:FLOAT,
+work_serializer_items_queued_per_iteration:FLOAT,
+work_serializer_drain_batches_per_iteration:FLOAT
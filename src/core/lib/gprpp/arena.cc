@@ -50,7 +50,9 @@ void* ArenaStorage(size_t initial_size) {
 
 namespace grpc_core {
 
-Arena::~Arena() {
+Arena::~Arena() { FreeZones(); }
+
+void Arena::FreeZones() {
   Zone* z = last_zone_;
   while (z) {
     Zone* prev_z = z->prev;
@@ -58,6 +60,7 @@ Arena::~Arena() {
     gpr_free_aligned(z);
     z = prev_z;
   }
+  last_zone_ = nullptr;
 }
 
 Arena* Arena::Create(size_t initial_size) {
@@ -81,6 +84,13 @@ size_t Arena::Destroy() {
   return size;
 }
 
+size_t Arena::Reset() {
+  size_t size = total_used_.Load(MemoryOrder::RELAXED);
+  FreeZones();
+  total_used_.Store(0, MemoryOrder::RELAXED);
+  return size;
+}
+
 void* Arena::AllocZone(size_t size) {
   // If the allocation isn't able to end in the initial zone, create a new
   // zone for this allocation, and any unused space in the initial zone is
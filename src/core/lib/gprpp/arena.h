@@ -54,6 +54,13 @@ class Arena {
 
   // Destroy an arena, returning the total number of bytes allocated.
   size_t Destroy();
+  // Free everything allocated from the arena beyond its initial zone and make
+  // the whole initial zone available again, so that the arena can be reused
+  // instead of destroyed and recreated. Returns the total number of bytes that
+  // had been allocated, as Destroy() does.
+  size_t Reset();
+  // The number of bytes Alloc() can hand out before allocating more zones.
+  size_t initial_zone_size() const { return initial_zone_size_; }
   // Allocate \a size bytes from the arena.
   void* Alloc(size_t size) {
     static constexpr size_t base_size =
@@ -102,6 +109,7 @@ class Arena {
   ~Arena();
 
   void* AllocZone(size_t size);
+  void FreeZones();
 
   // Keep track of the total used size. We use this in our call sizing
   // hysteresis.
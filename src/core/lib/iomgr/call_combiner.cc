@@ -32,6 +32,10 @@ DebugOnlyTraceFlag grpc_call_combiner_trace(false, "call_combiner");
 
 namespace {
 
+// Maximum number of closures StartInline() runs nested on one thread before
+// falling back to scheduling them on the ExecCtx, to bound stack growth.
+constexpr int kMaxInlineDepth = 4;
+
 grpc_error_handle DecodeCancelStateError(gpr_atm cancel_state) {
   if (cancel_state & 1) {
     return reinterpret_cast<grpc_error_handle>(cancel_state &
@@ -101,6 +105,16 @@ void CallCombiner::ScheduleClosure(grpc_closure* closure,
 #endif
 }
 
+void CallCombiner::RunClosure(grpc_closure* closure,
+                              grpc_error_handle error) {
+#ifdef GRPC_TSAN_ENABLED
+  original_closure_ = closure;
+  Closure::Run(DEBUG_LOCATION, &tsan_closure_, error);
+#else
+  Closure::Run(DEBUG_LOCATION, closure, error);
+#endif
+}
+
 #ifndef NDEBUG
 #define DEBUG_ARGS const char *file, int line,
 #define DEBUG_FMT_STR "%s:%d: "
@@ -111,16 +125,7 @@ void CallCombiner::ScheduleClosure(grpc_closure* closure,
 #define DEBUG_FMT_ARGS
 #endif
 
-void CallCombiner::Start(grpc_closure* closure, grpc_error_handle error,
-                         DEBUG_ARGS const char* reason) {
-  GPR_TIMER_SCOPE("CallCombiner::Start", 0);
-  if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
-    gpr_log(GPR_INFO,
-            "==> CallCombiner::Start() [%p] closure=%p [" DEBUG_FMT_STR
-            "%s] error=%s",
-            this, closure DEBUG_FMT_ARGS, reason,
-            grpc_error_std_string(error).c_str());
-  }
+bool CallCombiner::Enter(grpc_closure* closure, grpc_error_handle error) {
   size_t prev_size =
       static_cast<size_t>(gpr_atm_full_fetch_add(&size_, (gpr_atm)1));
   if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
@@ -134,17 +139,60 @@ void CallCombiner::Start(grpc_closure* closure, grpc_error_handle error,
     if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
       gpr_log(GPR_INFO, "  EXECUTING IMMEDIATELY");
     }
+    return true;
+  }
+  GRPC_STATS_INC_CALL_COMBINER_CONTENDED_STARTS();
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
+    gpr_log(GPR_INFO, "  QUEUING");
+  }
+  // Queue was not empty, so add closure to queue.
+  closure->error_data.error = error;
+  queue_.Push(
+      reinterpret_cast<MultiProducerSingleConsumerQueue::Node*>(closure));
+  return false;
+}
+
+void CallCombiner::Start(grpc_closure* closure, grpc_error_handle error,
+                         DEBUG_ARGS const char* reason) {
+  GPR_TIMER_SCOPE("CallCombiner::Start", 0);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
+    gpr_log(GPR_INFO,
+            "==> CallCombiner::Start() [%p] closure=%p [" DEBUG_FMT_STR
+            "%s] error=%s",
+            this, closure DEBUG_FMT_ARGS, reason,
+            grpc_error_std_string(error).c_str());
+  }
+  if (Enter(closure, error)) {
     // Queue was empty, so execute this closure immediately.
     ScheduleClosure(closure, error);
-  } else {
+  }
+}
+
+void CallCombiner::StartInline(grpc_closure* closure, grpc_error_handle error,
+                               DEBUG_ARGS const char* reason) {
+  GPR_TIMER_SCOPE("CallCombiner::StartInline", 0);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
+    gpr_log(GPR_INFO,
+            "==> CallCombiner::StartInline() [%p] closure=%p [" DEBUG_FMT_STR
+            "%s] error=%s",
+            this, closure DEBUG_FMT_ARGS, reason,
+            grpc_error_std_string(error).c_str());
+  }
+  if (!Enter(closure, error)) return;
+  int* depth = ExecCtx::Get()->call_combiner_inline_depth();
+  if (*depth >= kMaxInlineDepth) {
+    GRPC_STATS_INC_CALL_COMBINER_INLINE_DEPTH_EXCEEDED();
     if (GRPC_TRACE_FLAG_ENABLED(grpc_call_combiner_trace)) {
-      gpr_log(GPR_INFO, "  QUEUING");
+      gpr_log(GPR_INFO, "  inline depth %d reached; scheduling", *depth);
     }
-    // Queue was not empty, so add closure to queue.
-    closure->error_data.error = error;
-    queue_.Push(
-        reinterpret_cast<MultiProducerSingleConsumerQueue::Node*>(closure));
+    ScheduleClosure(closure, error);
+    return;
   }
+  GRPC_STATS_INC_CALL_COMBINER_INLINE_EXECUTIONS();
+  ++*depth;
+  // The closure may destroy the call, and with it this call combiner.
+  RunClosure(closure, error);
+  --*depth;
 }
 
 void CallCombiner::Stop(DEBUG_ARGS const char* reason) {
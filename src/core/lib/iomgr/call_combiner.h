@@ -55,21 +55,40 @@ class CallCombiner {
 #ifndef NDEBUG
 #define GRPC_CALL_COMBINER_START(call_combiner, closure, error, reason) \
   (call_combiner)->Start((closure), (error), __FILE__, __LINE__, (reason))
+#define GRPC_CALL_COMBINER_START_INLINE(call_combiner, closure, error, \
+                                        reason)                        \
+  (call_combiner)->StartInline((closure), (error), __FILE__, __LINE__, \
+                               (reason))
 #define GRPC_CALL_COMBINER_STOP(call_combiner, reason) \
   (call_combiner)->Stop(__FILE__, __LINE__, (reason))
   /// Starts processing \a closure.
   void Start(grpc_closure* closure, grpc_error_handle error, const char* file,
              int line, const char* reason);
+  /// Like Start(), but if the call combiner is idle, runs \a closure
+  /// before returning instead of scheduling it on the ExecCtx.  Only for
+  /// callers that hold no locks and do nothing after the call.  Nesting is
+  /// bounded; past the bound, \a closure is scheduled as with Start().
+  void StartInline(grpc_closure* closure, grpc_error_handle error,
+                   const char* file, int line, const char* reason);
   /// Yields the call combiner to the next closure in the queue, if any.
   void Stop(const char* file, int line, const char* reason);
 #else
 #define GRPC_CALL_COMBINER_START(call_combiner, closure, error, reason) \
   (call_combiner)->Start((closure), (error), (reason))
+#define GRPC_CALL_COMBINER_START_INLINE(call_combiner, closure, error, \
+                                        reason)                        \
+  (call_combiner)->StartInline((closure), (error), (reason))
 #define GRPC_CALL_COMBINER_STOP(call_combiner, reason) \
   (call_combiner)->Stop((reason))
   /// Starts processing \a closure.
   void Start(grpc_closure* closure, grpc_error_handle error,
              const char* reason);
+  /// Like Start(), but if the call combiner is idle, runs \a closure
+  /// before returning instead of scheduling it on the ExecCtx.  Only for
+  /// callers that hold no locks and do nothing after the call.  Nesting is
+  /// bounded; past the bound, \a closure is scheduled as with Start().
+  void StartInline(grpc_closure* closure, grpc_error_handle error,
+                   const char* reason);
   /// Yields the call combiner to the next closure in the queue, if any.
   void Stop(const char* reason);
 #endif
@@ -101,7 +120,12 @@ class CallCombiner {
   void Cancel(grpc_error_handle error);
 
  private:
+  // Accounts for \a closure entering the call combiner.  Returns true if the
+  // call combiner was idle, in which case the caller must run \a closure;
+  // otherwise \a closure has been queued.
+  bool Enter(grpc_closure* closure, grpc_error_handle error);
   void ScheduleClosure(grpc_closure* closure, grpc_error_handle error);
+  void RunClosure(grpc_closure* closure, grpc_error_handle error);
 #ifdef GRPC_TSAN_ENABLED
   static void TsanClosure(void* arg, grpc_error_handle error);
 #endif
@@ -151,6 +151,10 @@ class ExecCtx {
   /** Only to be used by grpc-combiner code */
   CombinerData* combiner_data() { return &combiner_data_; }
 
+  /** Number of call combiner closures currently running inline on this
+      exec_ctx: only to be used by call combiner code */
+  int* call_combiner_inline_depth() { return &call_combiner_inline_depth_; }
+
   /** Return pointer to grpc_closure_list */
   grpc_closure_list* closure_list() { return &closure_list_; }
 
@@ -244,6 +248,7 @@ class ExecCtx {
 
   grpc_closure_list closure_list_ = GRPC_CLOSURE_LIST_INIT;
   CombinerData combiner_data_ = {nullptr, nullptr};
+  int call_combiner_inline_depth_ = 0;
   uintptr_t flags_;
 
   unsigned starting_cpu_ = std::numeric_limits<unsigned>::max();
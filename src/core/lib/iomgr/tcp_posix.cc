@@ -75,6 +75,15 @@
 #define SENDMSG_FLAGS 0
 #endif
 
+// Hint to the kernel that more data immediately follows this sendmsg so that
+// the tail of a partial flush is coalesced with the next chunk instead of
+// going out as a short segment.
+#ifdef MSG_MORE
+#define SENDMSG_MORE_FLAG MSG_MORE
+#else
+#define SENDMSG_MORE_FLAG 0
+#endif
+
 // TCP zero copy sendmsg flag.
 // NB: We define this here as a fallback in case we're using an older set of
 // library headers that has not defined MSG_ZEROCOPY. Since this constant is
@@ -941,7 +950,6 @@ ssize_t tcp_send(int fd, const struct msghdr* msg, int additional_flags = 0) {
   GPR_TIMER_SCOPE("sendmsg", 1);
   ssize_t sent_length;
   do {
-    /* TODO(klempner): Cork if this is a partial write */
     GRPC_STATS_INC_SYSCALL_WRITE();
     sent_length = sendmsg(fd, msg, SENDMSG_FLAGS | additional_flags);
   } while (sent_length < 0 && errno == EINTR);
@@ -1446,6 +1454,10 @@ static bool tcp_flush(grpc_tcp* tcp, grpc_error_handle* error) {
       tcp->outgoing_byte_idx = 0;
     }
     GPR_ASSERT(iov_size > 0);
+    // If the iovec limit split this flush, the next sendmsg follows right away.
+    const int more_flags = outgoing_slice_idx != tcp->outgoing_buffer->count
+                               ? SENDMSG_MORE_FLAG
+                               : 0;
 
     msg.msg_name = nullptr;
     msg.msg_namelen = 0;
@@ -1455,7 +1467,8 @@ static bool tcp_flush(grpc_tcp* tcp, grpc_error_handle* error) {
     bool tried_sending_message = false;
     if (tcp->outgoing_buffer_arg != nullptr) {
       if (!tcp->ts_capable ||
-          !tcp_write_with_timestamps(tcp, &msg, sending_length, &sent_length)) {
+          !tcp_write_with_timestamps(tcp, &msg, sending_length, &sent_length,
+                                     more_flags)) {
         /* We could not set socket options to collect Fathom timestamps.
          * Fallback on writing without timestamps. */
         tcp->ts_capable = false;
@@ -1471,7 +1484,7 @@ static bool tcp_flush(grpc_tcp* tcp, grpc_error_handle* error) {
       GRPC_STATS_INC_TCP_WRITE_SIZE(sending_length);
       GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(iov_size);
 
-      sent_length = tcp_send(tcp->fd, &msg);
+      sent_length = tcp_send(tcp->fd, &msg, more_flags);
     }
 
     if (sent_length < 0) {
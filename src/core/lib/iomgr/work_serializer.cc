@@ -20,6 +20,8 @@
 
 #include "src/core/lib/iomgr/work_serializer.h"
 
+#include "src/core/lib/debug/stats.h"
+
 namespace grpc_core {
 
 DebugOnlyTraceFlag grpc_work_serializer_trace(false, "work_serializer");
@@ -75,6 +77,10 @@ void WorkSerializer::WorkSerializerImpl::Run(
     if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
       gpr_log(GPR_INFO, "  Scheduling on queue : item %p", cb_wrapper);
     }
+    // Callers are not required to hold an ExecCtx, which the stats need.
+    if (ExecCtx::Get() != nullptr) {
+      GRPC_STATS_INC_WORK_SERIALIZER_ITEMS_QUEUED();
+    }
     queue_.Push(&cb_wrapper->mpscq_node);
   }
 }
@@ -96,47 +102,65 @@ void WorkSerializer::WorkSerializerImpl::Orphan() {
 // execute all the scheduled callback. This is called from within
 // WorkSerializer::Run() after executing a callback immediately, and hence size_
 // is at least 1.
+// Callbacks are run in batches: every callback already visible on the queue is
+// run before the executed callbacks are subtracted from size_ in a single
+// atomic operation, rather than one per callback. A callback that orphans the
+// work serializer cannot destroy it mid-batch, since size_ still accounts for
+// the callbacks of the current batch.
 void WorkSerializer::WorkSerializerImpl::DrainQueue() {
+  // The callback executed by WorkSerializer::Run().
+  size_t executed = 1;
   while (true) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
       gpr_log(GPR_INFO, "WorkSerializer::DrainQueue() %p", this);
     }
-    size_t prev_size = size_.FetchSub(1);
-    GPR_DEBUG_ASSERT(prev_size >= 1);
+    size_t prev_size = size_.FetchSub(executed);
+    GPR_DEBUG_ASSERT(prev_size >= executed);
     // It is possible that while draining the queue, one of the callbacks ended
     // up orphaning the work serializer. In that case, delete the object.
-    if (prev_size == 1) {
+    if (prev_size == executed) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
         gpr_log(GPR_INFO, "  Queue Drained. Destroying");
       }
       delete this;
       return;
     }
-    if (prev_size == 2) {
+    if (prev_size == executed + 1) {
       if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
         gpr_log(GPR_INFO, "  Queue Drained");
       }
       return;
     }
-    // There is at least one callback on the queue. Pop the callback from the
-    // queue and execute it.
-    CallbackWrapper* cb_wrapper = nullptr;
-    bool empty_unused;
-    while ((cb_wrapper = reinterpret_cast<CallbackWrapper*>(
-                queue_.PopAndCheckEnd(&empty_unused))) == nullptr) {
-      // This can happen either due to a race condition within the mpscq
-      // implementation or because of a race with Run()
+    // There is at least one callback on the queue. Pop and execute callbacks
+    // until the queue runs dry.
+    executed = 0;
+    while (true) {
+      bool empty_unused;
+      CallbackWrapper* cb_wrapper = reinterpret_cast<CallbackWrapper*>(
+          queue_.PopAndCheckEnd(&empty_unused));
+      if (cb_wrapper == nullptr) {
+        // Account for the batch run so far before looking at the queue again.
+        if (executed > 0) break;
+        // This can happen either due to a race condition within the mpscq
+        // implementation or because of a race with Run()
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
+          gpr_log(GPR_INFO, "  Queue returned nullptr, trying again");
+        }
+        continue;
+      }
       if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
-        gpr_log(GPR_INFO, "  Queue returned nullptr, trying again");
+        gpr_log(GPR_INFO, "  Running item %p : callback scheduled at [%s:%d]",
+                cb_wrapper, cb_wrapper->location.file(),
+                cb_wrapper->location.line());
       }
+      cb_wrapper->callback();
+      delete cb_wrapper;
+      ++executed;
     }
-    if (GRPC_TRACE_FLAG_ENABLED(grpc_work_serializer_trace)) {
-      gpr_log(GPR_INFO, "  Running item %p : callback scheduled at [%s:%d]",
-              cb_wrapper, cb_wrapper->location.file(),
-              cb_wrapper->location.line());
+    if (ExecCtx::Get() != nullptr) {
+      GRPC_STATS_INC_WORK_SERIALIZER_DRAIN_BATCHES();
+      GRPC_STATS_INC_WORK_SERIALIZER_QUEUE_DEPTH(executed);
     }
-    cb_wrapper->callback();
-    delete cb_wrapper;
   }
 }
 
@@ -286,7 +286,7 @@ grpc_core::TraceFlag grpc_compression_trace(false, "compression");
 
 static void execute_batch(grpc_call* call,
                           grpc_transport_stream_op_batch* batch,
-                          grpc_closure* start_batch_closure);
+                          grpc_closure* start_batch_closure, bool run_inline);
 
 static void cancel_with_status(grpc_call* c, grpc_status_code status,
                                const char* description);
@@ -356,7 +356,8 @@ grpc_error_handle grpc_call_create(const grpc_call_create_args* args,
       call_and_stack_size + (args->parent ? sizeof(child_call) : 0);
 
   std::pair<grpc_core::Arena*, void*> arena_with_call =
-      grpc_core::Arena::CreateWithAlloc(initial_size, call_alloc_size);
+      grpc_channel_create_call_arena(args->channel, initial_size,
+                                     call_alloc_size);
   arena = arena_with_call.first;
   call = new (arena_with_call.second) grpc_call(arena, *args);
   *out_call = call;
@@ -530,7 +531,7 @@ static void release_call(void* call, grpc_error_handle /*error*/) {
   grpc_channel* channel = c->channel;
   grpc_core::Arena* arena = c->arena;
   c->~grpc_call();
-  grpc_channel_update_call_size_estimate(channel, arena->Destroy());
+  grpc_channel_destroy_call_arena(channel, arena);
   GRPC_CHANNEL_INTERNAL_UNREF(channel, "call");
 }
 
@@ -640,15 +641,22 @@ static void execute_batch_in_call_combiner(void* arg,
 }
 
 // start_batch_closure points to a caller-allocated closure to be used
-// for entering the call combiner.
+// for entering the call combiner.  If run_inline is true and the call
+// combiner is idle, the batch is sent down the stack before returning;
+// callers must then hold no locks.
 static void execute_batch(grpc_call* call,
                           grpc_transport_stream_op_batch* batch,
-                          grpc_closure* start_batch_closure) {
+                          grpc_closure* start_batch_closure, bool run_inline) {
   batch->handler_private.extra_arg = call;
   GRPC_CLOSURE_INIT(start_batch_closure, execute_batch_in_call_combiner, batch,
                     grpc_schedule_on_exec_ctx);
-  GRPC_CALL_COMBINER_START(&call->call_combiner, start_batch_closure,
-                           GRPC_ERROR_NONE, "executing batch");
+  if (run_inline) {
+    GRPC_CALL_COMBINER_START_INLINE(&call->call_combiner, start_batch_closure,
+                                    GRPC_ERROR_NONE, "executing batch");
+  } else {
+    GRPC_CALL_COMBINER_START(&call->call_combiner, start_batch_closure,
+                             GRPC_ERROR_NONE, "executing batch");
+  }
 }
 
 char* grpc_call_get_peer(grpc_call* call) {
@@ -717,7 +725,7 @@ static void cancel_with_error(grpc_call* c, grpc_error_handle error) {
       grpc_make_transport_stream_op(&state->finish_batch);
   op->cancel_stream = true;
   op->payload->cancel_stream.cancel_error = error;
-  execute_batch(c, op, &state->start_batch);
+  execute_batch(c, op, &state->start_batch, false);
 }
 
 void grpc_call_cancel_internal(grpc_call* call) {
@@ -1934,7 +1942,10 @@ static grpc_call_error call_start_batch(grpc_call* call, const grpc_op* ops,
   }
 
   gpr_atm_rel_store(&call->any_ops_sent_atm, 1);
-  execute_batch(call, stream_op, &bctl->start_batch);
+  // Batches started through the public API come straight from the
+  // application, which holds no core locks; internal callers of
+  // grpc_call_start_batch_and_execute() may.
+  execute_batch(call, stream_op, &bctl->start_batch, !is_notify_tag_closure);
 
 done:
   return error;
@@ -54,6 +54,9 @@
  *  (OK, Cancelled, Unknown). */
 #define NUM_CACHED_STATUS_ELEMS 3
 
+/** Default for GRPC_ARG_CALL_ARENA_POOL_SIZE */
+#define DEFAULT_CALL_ARENA_POOL_SIZE 4
+
 static void destroy_channel(void* arg, grpc_error_handle error);
 
 grpc_channel* grpc_channel_create_with_builder(
@@ -96,6 +99,7 @@ grpc_channel* grpc_channel_create_with_builder(
       (gpr_atm)CHANNEL_STACK_FROM_CHANNEL(channel)->call_stack_size +
           grpc_call_get_initial_size_estimate());
 
+  int arena_pool_size = DEFAULT_CALL_ARENA_POOL_SIZE;
   grpc_compression_options_init(&channel->compression_options);
   for (size_t i = 0; i < args->num_args; i++) {
     if (0 ==
@@ -119,6 +123,9 @@ grpc_channel* grpc_channel_create_with_builder(
       channel->compression_options.enabled_algorithms_bitset =
           static_cast<uint32_t>(args->args[i].value.integer) |
           0x1; /* always support no compression */
+    } else if (0 == strcmp(args->args[i].key, GRPC_ARG_CALL_ARENA_POOL_SIZE)) {
+      arena_pool_size = grpc_channel_arg_get_integer(
+          &args->args[i], {DEFAULT_CALL_ARENA_POOL_SIZE, 0, INT_MAX});
     } else if (0 == strcmp(args->args[i].key, GRPC_ARG_CHANNELZ_CHANNEL_NODE)) {
       if (args->args[i].type == GRPC_ARG_POINTER) {
         GPR_ASSERT(args->args[i].value.pointer.p != nullptr);
@@ -132,6 +139,9 @@ grpc_channel* grpc_channel_create_with_builder(
     }
   }
 
+  channel->arena_pool.Init(static_cast<size_t>(arena_pool_size),
+                           resource_user);
+
   grpc_channel_args_destroy(args);
   return channel;
 }
@@ -277,6 +287,14 @@ grpc_channel* grpc_channel_create(const char* target,
       grpc_channel_create_with_builder(builder, channel_stack_type, error);
   if (channel == nullptr) {
     grpc_shutdown();  // Since we won't call destroy_channel().
+  } else if (channel_stack_type == GRPC_CLIENT_CHANNEL &&
+             grpc_channel_args_find_bool(
+                 input_args, GRPC_ARG_CLIENT_CHANNEL_WARMUP, false)) {
+    // Leave IDLE right away, so that resolution and connection
+    // establishment overlap with the application's startup.  This must wait
+    // until the whole stack is built: if a filter fails to initialize, the
+    // stack is destroyed along with the client channel.
+    grpc_channel_check_connectivity_state(channel, /*try_to_connect=*/1);
   }
   return channel;
 }
@@ -316,6 +334,80 @@ void grpc_channel_update_call_size_estimate(grpc_channel* channel,
   }
 }
 
+std::pair<grpc_core::Arena*, void*> grpc_channel_create_call_arena(
+    grpc_channel* channel, size_t initial_size, size_t alloc_size) {
+  grpc_core::Arena* arena = channel->arena_pool->Get(initial_size);
+  if (arena == nullptr) {
+    GRPC_STATS_INC_CALL_ARENA_POOL_MISSES();
+    return grpc_core::Arena::CreateWithAlloc(initial_size, alloc_size);
+  }
+  GRPC_STATS_INC_CALL_ARENA_POOL_HITS();
+  return std::make_pair(arena, arena->Alloc(alloc_size));
+}
+
+void grpc_channel_destroy_call_arena(grpc_channel* channel,
+                                     grpc_core::Arena* arena) {
+  size_t size_estimate = grpc_channel_get_call_size_estimate(channel);
+  grpc_channel_update_call_size_estimate(
+      channel, channel->arena_pool->Put(arena, size_estimate));
+}
+
+namespace grpc_core {
+
+CallArenaPool::CallArenaPool(size_t max_size, grpc_resource_user* resource_user)
+    : max_size_(max_size), resource_user_(resource_user) {
+  arenas_.reserve(max_size);
+}
+
+CallArenaPool::~CallArenaPool() {
+  for (Arena* arena : arenas_) {
+    if (resource_user_ != nullptr) {
+      grpc_resource_user_free(resource_user_, arena->initial_zone_size());
+    }
+    arena->Destroy();
+  }
+}
+
+Arena* CallArenaPool::Get(size_t initial_size) {
+  Arena* arena;
+  {
+    MutexLock lock(&mu_);
+    if (arenas_.empty()) return nullptr;
+    arena = arenas_.back();
+    arenas_.pop_back();
+  }
+  if (resource_user_ != nullptr) {
+    grpc_resource_user_free(resource_user_, arena->initial_zone_size());
+  }
+  // The estimate has grown since this arena was cached: calls would spill out
+  // of it, so make a bigger one instead.
+  if (arena->initial_zone_size() < initial_size) {
+    arena->Destroy();
+    return nullptr;
+  }
+  return arena;
+}
+
+size_t CallArenaPool::Put(Arena* arena, size_t size_estimate) {
+  const size_t used = arena->Reset();
+  const size_t capacity = arena->initial_zone_size();
+  // Do not keep arenas that are too small for the next calls, nor ones much
+  // bigger than they need now that the estimate has shrunk.
+  if (capacity >= size_estimate && capacity <= 2 * size_estimate) {
+    MutexLock lock(&mu_);
+    if (arenas_.size() < max_size_ &&
+        (resource_user_ == nullptr ||
+         grpc_resource_user_safe_alloc(resource_user_, capacity))) {
+      arenas_.push_back(arena);
+      return used;
+    }
+  }
+  arena->Destroy();
+  return used;
+}
+
+}  // namespace grpc_core
+
 char* grpc_channel_get_target(grpc_channel* channel) {
   GRPC_API_TRACE("grpc_channel_get_target(channel=%p)", 1, (channel));
   return gpr_strdup(channel->target);
@@ -507,6 +599,7 @@ static void destroy_channel(void* arg, grpc_error_handle /*error*/) {
   }
   grpc_channel_stack_destroy(CHANNEL_STACK_FROM_CHANNEL(channel));
   channel->registration_table.Destroy();
+  channel->arena_pool.Destroy();
   if (channel->resource_user != nullptr) {
     grpc_resource_user_free(channel->resource_user,
                             GRPC_RESOURCE_QUOTA_CHANNEL_SIZE);
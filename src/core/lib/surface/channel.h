@@ -22,10 +22,12 @@
 #include <grpc/support/port_platform.h>
 
 #include <map>
+#include <vector>
 
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/channel/channel_stack_builder.h"
 #include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/gprpp/arena.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/surface/channel_stack_type.h"
 #include "src/core/lib/transport/metadata.h"
@@ -68,6 +70,18 @@ grpc_core::channelz::ChannelNode* grpc_channel_get_channelz_node(
 size_t grpc_channel_get_call_size_estimate(grpc_channel* channel);
 void grpc_channel_update_call_size_estimate(grpc_channel* channel, size_t size);
 
+/** Return an arena for a new call on \a channel, with \a initial_size bytes in
+    its first zone and the first \a alloc_size of them already allocated.
+    The arena is taken from the channel's arena pool when it holds one. */
+std::pair<grpc_core::Arena*, void*> grpc_channel_create_call_arena(
+    grpc_channel* channel, size_t initial_size, size_t alloc_size);
+/** Give back the arena of a finished call on \a channel, either to the
+    channel's arena pool or to the allocator, and update the channel's call
+    size estimate from it. Must be called before the call's channel ref is
+    released. */
+void grpc_channel_destroy_call_arena(grpc_channel* channel,
+                                     grpc_core::Arena* arena);
+
 namespace grpc_core {
 
 struct RegisteredCall {
@@ -100,6 +114,30 @@ struct CallRegistrationTable {
   int method_registration_attempts ABSL_GUARDED_BY(mu) = 0;
 };
 
+// Keeps the arenas of finished calls so that later calls on the same channel
+// can reuse them rather than allocate and free a new one each time. Cached
+// arenas are charged to the channel's resource user, if it has one.
+class CallArenaPool {
+ public:
+  CallArenaPool(size_t max_size, grpc_resource_user* resource_user);
+  ~CallArenaPool();
+
+  // Returns a cached arena with at least initial_size bytes in its first zone,
+  // or nullptr if there is none.
+  Arena* Get(size_t initial_size);
+  // Resets the arena of a finished call and caches it, unless the pool is full,
+  // the quota is exhausted, or the arena is not sized for calls of about
+  // size_estimate bytes, in which case the arena is destroyed. Returns the
+  // number of bytes the call had allocated from it.
+  size_t Put(Arena* arena, size_t size_estimate);
+
+ private:
+  const size_t max_size_;
+  grpc_resource_user* const resource_user_;
+  Mutex mu_;
+  std::vector<Arena*> arenas_ ABSL_GUARDED_BY(mu_);
+};
+
 }  // namespace grpc_core
 
 struct grpc_channel {
@@ -116,6 +154,7 @@ struct grpc_channel {
   //              a separate manual construction for each field.
   grpc_core::ManualConstructor<grpc_core::CallRegistrationTable>
       registration_table;
+  grpc_core::ManualConstructor<grpc_core::CallArenaPool> arena_pool;
   grpc_core::RefCountedPtr<grpc_core::channelz::ChannelNode> channelz_node;
 
   char* target;
@@ -133,6 +133,8 @@ struct Server::RegisteredMethod {
   const uint32_t flags;
   // One request matcher per method.
   std::unique_ptr<RequestMatcherInterface> matcher;
+  // Set when matcher is an allocating matcher; not owned.
+  AllocatingRequestMatcherRegistered* allocating_matcher = nullptr;
 };
 
 //
@@ -191,10 +193,30 @@ class Server::RequestMatcherInterface {
 // application to explicitly request RPCs and then matching those to incoming
 // RPCs, along with a slow path by which incoming RPCs are put on a locked
 // pending list if they aren't able to be matched to an application request.
+//
+// The pending list is sharded by completion queue, each shard with its own
+// lock, so that the slow path does not serialize all completion queues on
+// mu_call_.  A call is queued on the shard of the completion queue it arrived
+// on, and a request peeks at the head of every non-empty shard and takes the
+// oldest call (or the one with the earliest deadline), so pending calls are
+// matched in arrival (or deadline) order across the whole server.  To make
+// sure that no call is left pending while a request is available, each side
+// makes itself visible before looking at the other: a request is pushed and
+// counted before the shards are inspected, and a call is added to its shard and
+// counted before the request queues are inspected again.  The counts are
+// sequentially consistent, so at least one side sees the other, and empty
+// shards and request queues are skipped without taking a lock.  A call and a
+// request are only ever taken together, under the lock of the call's shard, so
+// each call is matched exactly once.
 class Server::RealRequestMatcher : public RequestMatcherInterface {
  public:
   explicit RealRequestMatcher(Server* server)
-      : server_(server), requests_per_cq_(server->cqs_.size()) {}
+      : server_(server), requests_per_cq_(server->cqs_.size()) {
+    for (size_t i = 0; i < requests_per_cq_.size(); i++) {
+      pending_shards_.push_back(
+          absl::make_unique<PendingShard>(server->edf_pending_calls_));
+    }
+  }
 
   ~RealRequestMatcher() override {
     for (LockedMultiProducerSingleConsumerQueue& queue : requests_per_cq_) {
@@ -203,11 +225,15 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
   }
 
   void ZombifyPending() override {
-    while (!pending_.empty()) {
-      CallData* calld = pending_.front();
-      calld->SetState(CallData::CallState::ZOMBIED);
-      calld->KillZombie();
-      pending_.pop();
+    for (const auto& shard : pending_shards_) {
+      MutexLock lock(&shard->mu);
+      while (!shard->pending.empty()) {
+        CallData* calld = shard->pending.front().calld;
+        calld->SetState(CallData::CallState::ZOMBIED);
+        calld->KillZombie();
+        shard->pending.pop();
+        shard->num_pending.FetchSub(1);
+      }
     }
   }
 
@@ -216,6 +242,7 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
       RequestedCall* rc;
       while ((rc = reinterpret_cast<RequestedCall*>(
                   requests_per_cq_[i].Pop())) != nullptr) {
+        pending_shards_[i]->num_requests.FetchSub(1);
         server_->FailCall(i, rc, GRPC_ERROR_REF(error));
       }
     }
@@ -228,47 +255,16 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
 
   void RequestCallWithPossiblePublish(size_t request_queue_index,
                                       RequestedCall* call) override {
-    if (requests_per_cq_[request_queue_index].Push(&call->mpscq_node)) {
-      /* this was the first queued request: we need to lock and start
-         matching calls */
-      struct PendingCall {
-        RequestedCall* rc = nullptr;
-        CallData* calld;
-      };
-      auto pop_next_pending = [this, request_queue_index] {
-        PendingCall pending_call;
-        {
-          MutexLock lock(&server_->mu_call_);
-          if (!pending_.empty()) {
-            pending_call.rc = reinterpret_cast<RequestedCall*>(
-                requests_per_cq_[request_queue_index].Pop());
-            if (pending_call.rc != nullptr) {
-              pending_call.calld = pending_.front();
-              pending_.pop();
-            }
-          }
-        }
-        return pending_call;
-      };
-      while (true) {
-        PendingCall next_pending = pop_next_pending();
-        if (next_pending.rc == nullptr) break;
-        if (!next_pending.calld->MaybeActivate()) {
-          // Zombied Call
-          next_pending.calld->KillZombie();
-        } else {
-          next_pending.calld->Publish(request_queue_index, next_pending.rc);
-        }
-      }
-    }
+    requests_per_cq_[request_queue_index].Push(&call->mpscq_node);
+    pending_shards_[request_queue_index]->num_requests.FetchAdd(1);
+    MatchPending(request_queue_index);
   }
 
   void MatchOrQueue(size_t start_request_queue_index,
                     CallData* calld) override {
     for (size_t i = 0; i < requests_per_cq_.size(); i++) {
       size_t cq_idx = (start_request_queue_index + i) % requests_per_cq_.size();
-      RequestedCall* rc =
-          reinterpret_cast<RequestedCall*>(requests_per_cq_[cq_idx].TryPop());
+      RequestedCall* rc = PopRequest(cq_idx, /*try_pop=*/true);
       if (rc != nullptr) {
         GRPC_STATS_INC_SERVER_CQS_CHECKED(i);
         calld->SetState(CallData::CallState::ACTIVATED);
@@ -278,61 +274,283 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
     }
     // No cq to take the request found; queue it on the slow list.
     GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED();
-    // We need to ensure that all the queues are empty.  We do this under
-    // the server mu_call_ lock to ensure that if something is added to
-    // an empty request queue, it will block until the call is actually
-    // added to the pending list.
-    RequestedCall* rc = nullptr;
-    size_t cq_idx = 0;
-    size_t loop_count;
+    PendingShard* shard =
+        pending_shards_[start_request_queue_index % pending_shards_.size()]
+            .get();
+    std::vector<ShedCall> shed;
     {
-      MutexLock lock(&server_->mu_call_);
-      for (loop_count = 0; loop_count < requests_per_cq_.size(); loop_count++) {
-        cq_idx =
-            (start_request_queue_index + loop_count) % requests_per_cq_.size();
-        rc = reinterpret_cast<RequestedCall*>(requests_per_cq_[cq_idx].Pop());
-        if (rc != nullptr) {
-          break;
+      MutexLock lock(&shard->mu);
+      ShedPendingLocked(shard, &shed);
+      calld->SetState(CallData::CallState::PENDING);
+      shard->pending.push(
+          {calld, ExecCtx::Get()->Now(), calld->deadline(),
+           next_pending_seq_.FetchAdd(1, MemoryOrder::RELAXED)});
+      shard->num_pending.FetchAdd(1);
+    }
+    RejectShedCalls(&shed);
+    // A request that was queued after the loop above looked at its queue may
+    // have inspected this shard before the call was added to it, so look at
+    // every request queue again.
+    for (size_t i = 0; i < requests_per_cq_.size(); i++) {
+      size_t cq_idx = (start_request_queue_index + i) % requests_per_cq_.size();
+      if (!MatchPending(cq_idx, i + requests_per_cq_.size())) break;
+    }
+  }
+
+  Server* server() const override { return server_; }
+
+ private:
+  struct QueuedCall {
+    CallData* calld;
+    grpc_millis queued_time;
+    grpc_millis deadline;
+    // Arrival order across all shards.
+    uint64_t seq;
+  };
+
+  // The calls waiting for an application request: either a FIFO queue or,
+  // for earliest-deadline-first matching, a priority queue ordered by
+  // deadline, with ties broken by arrival order.
+  class PendingQueue {
+   public:
+    explicit PendingQueue(bool earliest_deadline_first)
+        : earliest_deadline_first_(earliest_deadline_first) {}
+
+    bool empty() const {
+      return earliest_deadline_first_ ? by_deadline_.empty() : fifo_.empty();
+    }
+
+    const QueuedCall& front() const {
+      return earliest_deadline_first_ ? by_deadline_.top() : fifo_.front();
+    }
+
+    void push(QueuedCall call) {
+      if (earliest_deadline_first_) {
+        by_deadline_.push(call);
+      } else {
+        fifo_.push(call);
+      }
+    }
+
+    void pop() {
+      if (earliest_deadline_first_) {
+        by_deadline_.pop();
+      } else {
+        fifo_.pop();
+      }
+    }
+
+   private:
+    struct LaterDeadline {
+      bool operator()(const QueuedCall& a, const QueuedCall& b) const {
+        if (a.deadline != b.deadline) return a.deadline > b.deadline;
+        return a.seq > b.seq;
+      }
+    };
+
+    const bool earliest_deadline_first_;
+    std::queue<QueuedCall> fifo_;
+    std::priority_queue<QueuedCall, std::vector<QueuedCall>, LaterDeadline>
+        by_deadline_;
+  };
+
+  struct PendingShard {
+    explicit PendingShard(bool earliest_deadline_first)
+        : pending(earliest_deadline_first) {}
+
+    Mutex mu;
+    PendingQueue pending ABSL_GUARDED_BY(mu);
+    // The number of calls in pending, updated under mu.
+    Atomic<intptr_t> num_pending{0};
+    // The number of requests queued on the matching entry of
+    // requests_per_cq_.  It is incremented after a request is pushed, so it
+    // can briefly be lower than the number of requests in the queue (or even
+    // negative); the thread pushing a request that is not counted yet looks
+    // for pending calls once it has counted it.
+    Atomic<intptr_t> num_requests{0};
+    // When the queue delay is above target, the time at which shedding
+    // starts if it does not drop below target first.
+    grpc_millis overload_time ABSL_GUARDED_BY(mu) = GRPC_MILLIS_INF_FUTURE;
+  };
+
+  struct ShedCall {
+    CallData* calld;
+    bool expired;
+  };
+
+  RequestedCall* PopRequest(size_t cq_idx, bool try_pop) {
+    Atomic<intptr_t>& num_requests = pending_shards_[cq_idx]->num_requests;
+    if (num_requests.Load(MemoryOrder::SEQ_CST) <= 0) return nullptr;
+    RequestedCall* rc = reinterpret_cast<RequestedCall*>(
+        try_pop ? requests_per_cq_[cq_idx].TryPop()
+                : requests_per_cq_[cq_idx].Pop());
+    if (rc != nullptr) num_requests.FetchSub(1);
+    return rc;
+  }
+
+  // Returns the shard whose head should be matched next: the one holding the
+  // oldest call or, with earliest-deadline-first matching, the call with the
+  // earliest deadline.  Returns nullptr if every shard is empty.
+  PendingShard* NextShard() {
+    if (pending_shards_.size() == 1) {
+      PendingShard* shard = pending_shards_[0].get();
+      return shard->num_pending.Load(MemoryOrder::SEQ_CST) > 0 ? shard
+                                                               : nullptr;
+    }
+    PendingShard* next = nullptr;
+    grpc_millis next_deadline = GRPC_MILLIS_INF_FUTURE;
+    uint64_t next_seq = 0;
+    for (const auto& shard : pending_shards_) {
+      if (shard->num_pending.Load(MemoryOrder::SEQ_CST) <= 0) continue;
+      MutexLock lock(&shard->mu);
+      if (shard->pending.empty()) continue;
+      const QueuedCall& head = shard->pending.front();
+      bool before;
+      if (next == nullptr) {
+        before = true;
+      } else if (server_->edf_pending_calls_ &&
+                 head.deadline != next_deadline) {
+        before = head.deadline < next_deadline;
+      } else {
+        before = head.seq < next_seq;
+      }
+      if (before) {
+        next = shard.get();
+        next_deadline = head.deadline;
+        next_seq = head.seq;
+      }
+    }
+    return next;
+  }
+
+  // Matches pending calls to requests queued on \a cq_idx, taking them from
+  // the shard chosen by NextShard(), until either runs out.  Returns true if
+  // the request queue ran out first (or at the same time), false if the
+  // pending calls did.  A non-zero \a cqs_checked is the number of request
+  // queues a call that just went through the slow path has looked at, and is
+  // recorded for each call matched.
+  bool MatchPending(size_t cq_idx, size_t cqs_checked = 0) {
+    std::vector<ShedCall> shed;
+    while (true) {
+      if (pending_shards_[cq_idx]->num_requests.Load(MemoryOrder::SEQ_CST) <=
+          0) {
+        return true;
+      }
+      PendingShard* shard = NextShard();
+      if (shard == nullptr) return false;
+      RequestedCall* rc = nullptr;
+      CallData* calld = nullptr;
+      bool shard_empty;
+      {
+        MutexLock lock(&shard->mu);
+        ShedPendingLocked(shard, &shed);
+        shard_empty = shard->pending.empty();
+        if (!shard_empty) {
+          rc = PopRequest(cq_idx, /*try_pop=*/false);
+          if (rc != nullptr) {
+            calld = shard->pending.front().calld;
+            shard->pending.pop();
+            shard->num_pending.FetchSub(1);
+          }
         }
       }
-      if (rc == nullptr) {
-        calld->SetState(CallData::CallState::PENDING);
-        pending_.push(calld);
-        return;
+      RejectShedCalls(&shed);
+      // The shard was drained since it was chosen; look at the others.
+      if (shard_empty) continue;
+      if (rc == nullptr) return true;
+      if (!calld->MaybeActivate()) {
+        // Zombied Call
+        calld->KillZombie();
+      } else {
+        if (cqs_checked > 0) GRPC_STATS_INC_SERVER_CQS_CHECKED(cqs_checked);
+        calld->Publish(cq_idx, rc);
       }
     }
-    GRPC_STATS_INC_SERVER_CQS_CHECKED(loop_count + requests_per_cq_.size());
-    calld->SetState(CallData::CallState::ACTIVATED);
-    calld->Publish(cq_idx, rc);
   }
 
-  Server* server() const override { return server_; }
+  // Returns true if pending calls should be shed, given that the call at
+  // the head of \a shard has waited for \a delay.  As in CoDel, shedding
+  // starts only once the delay has stayed above the target for a whole
+  // interval, so that short bursts are absorbed by the queue.
+  bool QueueDelayExceededLocked(PendingShard* shard, grpc_millis delay,
+                                grpc_millis now)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    if (delay < server_->queue_delay_target_) {
+      shard->overload_time = GRPC_MILLIS_INF_FUTURE;
+      return false;
+    }
+    if (shard->overload_time == GRPC_MILLIS_INF_FUTURE) {
+      shard->overload_time = now + server_->queue_delay_interval_;
+      return false;
+    }
+    return now >= shard->overload_time;
+  }
+
+  // When admission control is on (see GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS),
+  // removes from the head of \a shard the calls whose deadline has passed
+  // and, while the server is overloaded, the calls that have waited longer
+  // than the queue delay target.  The removed calls are appended to \a shed
+  // and must be passed to RejectShedCalls() once the shard's lock is
+  // released.  With earliest-deadline-first matching, the head is the call
+  // with the earliest deadline rather than the oldest one.
+  void ShedPendingLocked(PendingShard* shard, std::vector<ShedCall>* shed)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard->mu) {
+    if (server_->queue_delay_target_ == 0 || shard->pending.empty()) return;
+    const grpc_millis now = ExecCtx::Get()->Now();
+    while (!shard->pending.empty()) {
+      const QueuedCall& queued = shard->pending.front();
+      if (queued.calld->deadline() <= now) {
+        shed->push_back({queued.calld, true});
+      } else if (QueueDelayExceededLocked(shard, now - queued.queued_time,
+                                          now)) {
+        shed->push_back({queued.calld, false});
+      } else {
+        break;
+      }
+      shard->pending.pop();
+      shard->num_pending.FetchSub(1);
+    }
+    if (shard->pending.empty()) shard->overload_time = GRPC_MILLIS_INF_FUTURE;
+  }
+
+  static void RejectShedCalls(std::vector<ShedCall>* shed) {
+    for (const ShedCall& call : *shed) {
+      if (!call.calld->MaybeActivate()) {
+        // Zombied Call
+        call.calld->KillZombie();
+      } else if (call.expired) {
+        GRPC_STATS_INC_SERVER_EXPIRED_PENDING_CALLS();
+        call.calld->Reject(GRPC_STATUS_DEADLINE_EXCEEDED,
+                           "Deadline exceeded while queued");
+      } else {
+        GRPC_STATS_INC_SERVER_QUEUE_DELAY_SHED_CALLS();
+        call.calld->Reject(GRPC_STATUS_RESOURCE_EXHAUSTED,
+                           "Server queue delay above target");
+      }
+    }
+    shed->clear();
+  }
 
- private:
   Server* const server_;
-  std::queue<CallData*> pending_;
   std::vector<LockedMultiProducerSingleConsumerQueue> requests_per_cq_;
+  // One shard per entry of requests_per_cq_.
+  std::vector<std::unique_ptr<PendingShard>> pending_shards_;
+  // The seq of the next call to be queued on any shard.
+  Atomic<uint64_t> next_pending_seq_{0};
 };
 
 // AllocatingRequestMatchers don't allow the application to request an RPC in
 // advance or queue up any incoming RPC for later match. Instead, MatchOrQueue
-// will call out to an allocation function passed in at the construction of the
-// object. These request matchers are designed for the C++ callback API, so they
-// only support 1 completion queue (passed in at the constructor). They are also
-// used for the sync API.
+// will call out to an allocation function registered for a completion queue.
+// These request matchers are designed for the C++ callback API, which uses a
+// single completion queue. They are also used for the sync API, which may
+// register one allocator per completion queue; a call is then handed to the
+// allocator of the completion queue its channel is bound to, so that every
+// connection keeps affinity to one queue.
 class Server::AllocatingRequestMatcherBase : public RequestMatcherInterface {
  public:
-  AllocatingRequestMatcherBase(Server* server, grpc_completion_queue* cq)
-      : server_(server), cq_(cq) {
-    size_t idx;
-    for (idx = 0; idx < server->cqs_.size(); idx++) {
-      if (server->cqs_[idx] == cq) {
-        break;
-      }
-    }
-    GPR_ASSERT(idx < server->cqs_.size());
-    cq_idx_ = idx;
-  }
+  explicit AllocatingRequestMatcherBase(Server* server)
+      : server_(server), has_allocator_(server->cqs_.size(), false) {}
 
   void ZombifyPending() override {}
 
@@ -349,16 +567,37 @@ class Server::AllocatingRequestMatcherBase : public RequestMatcherInterface {
 
   Server* server() const override { return server_; }
 
-  // Supply the completion queue related to this request matcher
-  grpc_completion_queue* cq() const { return cq_; }
+ protected:
+  // Records that an allocator is registered for \a cq and returns the
+  // completion queue's index relative to the server.
+  size_t AddCq(grpc_completion_queue* cq) {
+    size_t idx;
+    for (idx = 0; idx < server_->cqs_.size(); idx++) {
+      if (server_->cqs_[idx] == cq) {
+        break;
+      }
+    }
+    GPR_ASSERT(idx < server_->cqs_.size());
+    if (!has_allocator_[idx]) {
+      has_allocator_[idx] = true;
+      allocator_cqs_.push_back(idx);
+    }
+    return idx;
+  }
 
-  // Supply the completion queue's index relative to the server.
-  size_t cq_idx() const { return cq_idx_; }
+  // Returns the index of the completion queue whose allocator should serve a
+  // call that arrived on a channel bound to the completion queue at \a cq_idx.
+  // Channels bound to a queue without an allocator are spread over the queues
+  // that have one.
+  size_t SelectCq(size_t cq_idx) const {
+    if (has_allocator_[cq_idx]) return cq_idx;
+    return allocator_cqs_[cq_idx % allocator_cqs_.size()];
+  }
 
  private:
   Server* const server_;
-  grpc_completion_queue* const cq_;
-  size_t cq_idx_;
+  std::vector<bool> has_allocator_;
+  std::vector<size_t> allocator_cqs_;
 };
 
 // An allocating request matcher for non-registered methods (used for generic
@@ -366,23 +605,33 @@ class Server::AllocatingRequestMatcherBase : public RequestMatcherInterface {
 class Server::AllocatingRequestMatcherBatch
     : public AllocatingRequestMatcherBase {
  public:
-  AllocatingRequestMatcherBatch(Server* server, grpc_completion_queue* cq,
-                                std::function<BatchCallAllocation()> allocator)
-      : AllocatingRequestMatcherBase(server, cq),
-        allocator_(std::move(allocator)) {}
+  explicit AllocatingRequestMatcherBatch(Server* server)
+      : AllocatingRequestMatcherBase(server),
+        allocators_(server->cqs_.size()) {}
 
-  void MatchOrQueue(size_t /*start_request_queue_index*/,
+  void AddAllocator(
+      grpc_completion_queue* cq,
+      std::function<BatchCallAllocation(grpc_call*)> allocator) {
+    allocators_[AddCq(cq)] = std::move(allocator);
+  }
+
+  void MatchOrQueue(size_t start_request_queue_index,
                     CallData* calld) override {
     if (server()->ShutdownRefOnRequest()) {
-      BatchCallAllocation call_info = allocator_();
+      const size_t cq_idx = SelectCq(start_request_queue_index);
+      BatchCallAllocation call_info = allocators_[cq_idx](calld->call());
       GPR_ASSERT(server()->ValidateServerRequest(
-                     cq(), static_cast<void*>(call_info.tag), nullptr,
-                     nullptr) == GRPC_CALL_OK);
-      RequestedCall* rc = new RequestedCall(
-          static_cast<void*>(call_info.tag), call_info.cq, call_info.call,
-          call_info.initial_metadata, call_info.details);
+                     server()->cqs_[cq_idx], static_cast<void*>(call_info.tag),
+                     nullptr, nullptr) == GRPC_CALL_OK);
+      // The request is published right away, so it can live on the call.
+      RequestedCall* rc =
+          grpc_call_get_arena(calld->call())
+              ->New<RequestedCall>(static_cast<void*>(call_info.tag),
+                                   call_info.cq, call_info.call,
+                                   call_info.initial_metadata,
+                                   call_info.details);
       calld->SetState(CallData::CallState::ACTIVATED);
-      calld->Publish(cq_idx(), rc);
+      calld->Publish(cq_idx, rc, /*rc_in_arena=*/true);
     } else {
       calld->FailCallCreation();
     }
@@ -390,33 +639,44 @@ class Server::AllocatingRequestMatcherBatch
   }
 
  private:
-  std::function<BatchCallAllocation()> allocator_;
+  // Indexed by the completion queue's index relative to the server.
+  std::vector<std::function<BatchCallAllocation(grpc_call*)>> allocators_;
 };
 
 // An allocating request matcher for registered methods.
 class Server::AllocatingRequestMatcherRegistered
     : public AllocatingRequestMatcherBase {
  public:
-  AllocatingRequestMatcherRegistered(
-      Server* server, grpc_completion_queue* cq, RegisteredMethod* rm,
-      std::function<RegisteredCallAllocation()> allocator)
-      : AllocatingRequestMatcherBase(server, cq),
+  AllocatingRequestMatcherRegistered(Server* server, RegisteredMethod* rm)
+      : AllocatingRequestMatcherBase(server),
         registered_method_(rm),
-        allocator_(std::move(allocator)) {}
+        allocators_(server->cqs_.size()) {}
+
+  void AddAllocator(
+      grpc_completion_queue* cq,
+      std::function<RegisteredCallAllocation(grpc_call*)> allocator) {
+    allocators_[AddCq(cq)] = std::move(allocator);
+  }
 
-  void MatchOrQueue(size_t /*start_request_queue_index*/,
+  void MatchOrQueue(size_t start_request_queue_index,
                     CallData* calld) override {
     if (server()->ShutdownRefOnRequest()) {
-      RegisteredCallAllocation call_info = allocator_();
+      const size_t cq_idx = SelectCq(start_request_queue_index);
+      RegisteredCallAllocation call_info =
+          allocators_[cq_idx](calld->call());
       GPR_ASSERT(server()->ValidateServerRequest(
-                     cq(), call_info.tag, call_info.optional_payload,
+                     server()->cqs_[cq_idx], call_info.tag,
+                     call_info.optional_payload,
                      registered_method_) == GRPC_CALL_OK);
+      // The request is published right away, so it can live on the call.
       RequestedCall* rc =
-          new RequestedCall(call_info.tag, call_info.cq, call_info.call,
-                            call_info.initial_metadata, registered_method_,
-                            call_info.deadline, call_info.optional_payload);
+          grpc_call_get_arena(calld->call())
+              ->New<RequestedCall>(call_info.tag, call_info.cq, call_info.call,
+                                   call_info.initial_metadata,
+                                   registered_method_, call_info.deadline,
+                                   call_info.optional_payload);
       calld->SetState(CallData::CallState::ACTIVATED);
-      calld->Publish(cq_idx(), rc);
+      calld->Publish(cq_idx, rc, /*rc_in_arena=*/true);
     } else {
       calld->FailCallCreation();
     }
@@ -425,7 +685,8 @@ class Server::AllocatingRequestMatcherRegistered
 
  private:
   RegisteredMethod* const registered_method_;
-  std::function<RegisteredCallAllocation()> allocator_;
+  // Indexed by the completion queue's index relative to the server.
+  std::vector<std::function<RegisteredCallAllocation(grpc_call*)>> allocators_;
 };
 
 //
@@ -546,7 +807,13 @@ RefCountedPtr<channelz::ServerNode> CreateChannelzNode(
 Server::Server(const grpc_channel_args* args)
     : channel_args_(grpc_channel_args_copy(args)),
       default_resource_user_(CreateDefaultResourceUser(args)),
-      channelz_node_(CreateChannelzNode(args)) {}
+      channelz_node_(CreateChannelzNode(args)),
+      edf_pending_calls_(grpc_channel_args_find_bool(
+          args, GRPC_ARG_SERVER_EDF_PENDING_CALLS, false)),
+      queue_delay_target_(grpc_channel_args_find_integer(
+          args, GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS, {0, 0, INT_MAX})),
+      queue_delay_interval_(grpc_channel_args_find_integer(
+          args, GRPC_ARG_SERVER_QUEUE_DELAY_INTERVAL_MS, {100, 1, INT_MAX})) {}
 
 Server::~Server() {
   grpc_channel_args_destroy(channel_args_);
@@ -651,18 +918,29 @@ bool Server::HasOpenConnections() {
 
 void Server::SetRegisteredMethodAllocator(
     grpc_completion_queue* cq, void* method_tag,
-    std::function<RegisteredCallAllocation()> allocator) {
+    std::function<RegisteredCallAllocation(grpc_call*)> allocator) {
   RegisteredMethod* rm = static_cast<RegisteredMethod*>(method_tag);
-  rm->matcher = absl::make_unique<AllocatingRequestMatcherRegistered>(
-      this, cq, rm, std::move(allocator));
+  // A method served from several completion queues gets one matcher holding
+  // an allocator per queue.
+  if (rm->allocating_matcher == nullptr) {
+    auto matcher = absl::make_unique<AllocatingRequestMatcherRegistered>(
+        this, rm);
+    rm->allocating_matcher = matcher.get();
+    rm->matcher = std::move(matcher);
+  }
+  rm->allocating_matcher->AddAllocator(cq, std::move(allocator));
 }
 
 void Server::SetBatchMethodAllocator(
-    grpc_completion_queue* cq, std::function<BatchCallAllocation()> allocator) {
-  GPR_DEBUG_ASSERT(unregistered_request_matcher_ == nullptr);
-  unregistered_request_matcher_ =
-      absl::make_unique<AllocatingRequestMatcherBatch>(this, cq,
-                                                       std::move(allocator));
+    grpc_completion_queue* cq,
+    std::function<BatchCallAllocation(grpc_call*)> allocator) {
+  if (unregistered_allocating_matcher_ == nullptr) {
+    GPR_DEBUG_ASSERT(unregistered_request_matcher_ == nullptr);
+    auto matcher = absl::make_unique<AllocatingRequestMatcherBatch>(this);
+    unregistered_allocating_matcher_ = matcher.get();
+    unregistered_request_matcher_ = std::move(matcher);
+  }
+  unregistered_allocating_matcher_->AddAllocator(cq, std::move(allocator));
 }
 
 void Server::RegisterCompletionQueue(grpc_completion_queue* cq) {
@@ -712,6 +990,10 @@ void Server::DoneRequestEvent(void* req, grpc_cq_completion* /*c*/) {
   delete static_cast<RequestedCall*>(req);
 }
 
+void Server::DoneArenaRequestEvent(void* req, grpc_cq_completion* /*c*/) {
+  static_cast<RequestedCall*>(req)->~RequestedCall();
+}
+
 void Server::FailCall(size_t cq_idx, RequestedCall* rc,
                       grpc_error_handle error) {
   *rc->call = nullptr;
@@ -1258,7 +1540,8 @@ void Server::CallData::Start(grpc_call_element* elem) {
                                     &recv_initial_metadata_batch_complete_);
 }
 
-void Server::CallData::Publish(size_t cq_idx, RequestedCall* rc) {
+void Server::CallData::Publish(size_t cq_idx, RequestedCall* rc,
+                               bool rc_in_arena) {
   grpc_call_set_completion_queue(call_, rc->cq_bound_to_call);
   *rc->call = call_;
   cq_new_ = server_->cqs_[cq_idx];
@@ -1284,7 +1567,9 @@ void Server::CallData::Publish(size_t cq_idx, RequestedCall* rc) {
     default:
       GPR_UNREACHABLE_CODE(return );
   }
-  grpc_cq_end_op(cq_new_, rc->tag, GRPC_ERROR_NONE, Server::DoneRequestEvent,
+  grpc_cq_end_op(cq_new_, rc->tag, GRPC_ERROR_NONE,
+                 rc_in_arena ? Server::DoneArenaRequestEvent
+                             : Server::DoneRequestEvent,
                  rc, &rc->completion, true);
 }
 
@@ -1316,6 +1601,13 @@ void Server::CallData::KillZombie() {
   ExecCtx::Run(DEBUG_LOCATION, &kill_zombie_closure_, GRPC_ERROR_NONE);
 }
 
+void Server::CallData::Reject(grpc_status_code status,
+                              const char* description) {
+  state_.Store(CallState::ZOMBIED, MemoryOrder::RELAXED);
+  grpc_call_cancel_with_status(call_, status, description, nullptr);
+  KillZombie();
+}
+
 void Server::CallData::StartNewRpc(grpc_call_element* elem) {
   auto* chand = static_cast<ChannelData*>(elem->channel_data);
   if (server_->ShutdownCalled()) {
@@ -137,12 +137,15 @@ class Server : public InternallyRefCounted<Server> {
   void RegisterCompletionQueue(grpc_completion_queue* cq);
 
   // Functions to specify that a specific registered method or the unregistered
-  // collection should use a specific allocator for request matching.
+  // collection should use a specific allocator for request matching. The
+  // allocator is passed the new call, so that it can allocate from the call's
+  // arena anything that the call outlives.
   void SetRegisteredMethodAllocator(
       grpc_completion_queue* cq, void* method_tag,
-      std::function<RegisteredCallAllocation()> allocator);
-  void SetBatchMethodAllocator(grpc_completion_queue* cq,
-                               std::function<BatchCallAllocation()> allocator);
+      std::function<RegisteredCallAllocation(grpc_call*)> allocator);
+  void SetBatchMethodAllocator(
+      grpc_completion_queue* cq,
+      std::function<BatchCallAllocation(grpc_call*)> allocator);
 
   RegisteredMethod* RegisterMethod(
       const char* method, const char* host,
@@ -256,13 +259,21 @@ class Server : public InternallyRefCounted<Server> {
     bool MaybeActivate();
 
     // Publishes an incoming call to the application after it has been
-    // matched.
-    void Publish(size_t cq_idx, RequestedCall* rc);
+    // matched. \a rc_in_arena is true when \a rc was allocated from the
+    // call's arena rather than with new.
+    void Publish(size_t cq_idx, RequestedCall* rc, bool rc_in_arena = false);
 
     void KillZombie();
 
+    // Fails a call that was activated but will not be published, sending
+    // \a status to the client.
+    void Reject(grpc_status_code status, const char* description);
+
     void FailCallCreation();
 
+    grpc_call* call() const { return call_; }
+    grpc_millis deadline() const { return deadline_; }
+
     // Filter vtable functions.
     static grpc_error_handle InitCallElement(
         grpc_call_element* elem, const grpc_call_element_args* args);
@@ -345,6 +356,7 @@ class Server : public InternallyRefCounted<Server> {
   }
 
   static void DoneRequestEvent(void* req, grpc_cq_completion* completion);
+  static void DoneArenaRequestEvent(void* req, grpc_cq_completion* completion);
 
   void FailCall(size_t cq_idx, RequestedCall* rc, grpc_error_handle error);
   grpc_call_error QueueRequestedCall(size_t cq_idx, RequestedCall* rc);
@@ -401,6 +413,12 @@ class Server : public InternallyRefCounted<Server> {
   grpc_resource_user* default_resource_user_ = nullptr;
   RefCountedPtr<channelz::ServerNode> channelz_node_;
   std::unique_ptr<grpc_server_config_fetcher> config_fetcher_;
+  // If true, pending calls are matched earliest deadline first.
+  const bool edf_pending_calls_;
+  // Pending calls are shed once their queue delay has stayed above
+  // queue_delay_target_ for queue_delay_interval_.  0 disables shedding.
+  const grpc_millis queue_delay_target_;
+  const grpc_millis queue_delay_interval_;
 
   std::vector<grpc_completion_queue*> cqs_;
   std::vector<grpc_pollset*> pollsets_;
@@ -425,6 +443,8 @@ class Server : public InternallyRefCounted<Server> {
 
   // Request matcher for unregistered methods.
   std::unique_ptr<RequestMatcherInterface> unregistered_request_matcher_;
+  // Set when unregistered_request_matcher_ is an allocating matcher.
+  AllocatingRequestMatcherBatch* unregistered_allocating_matcher_ = nullptr;
 
   // The shutdown refs counter tracks whether or not shutdown has been called
   // and whether there are any AllocatingRequestMatcher requests that have been
@@ -0,0 +1,197 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/cpp/server/bounded_thread_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/tls.h"
+
+namespace grpc {
+
+// The pool whose thread is running on the current thread, if any.
+GPR_TLS_DECL(g_current_pool);
+
+namespace {
+
+// Number of times an idle thread polls the queue before parking.
+constexpr int kSpinsBeforeParking = 64;
+
+gpr_once g_tls_once = GPR_ONCE_INIT;
+
+void InitTls() { gpr_tls_init(&g_current_pool); }
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+  size_t power = 1;
+  while (power < n) power <<= 1;
+  return power;
+}
+
+}  // namespace
+
+BoundedThreadPool::TaskQueue::TaskQueue(size_t size)
+    : mask_(RoundUpToPowerOfTwo(std::max<size_t>(size, 2)) - 1),
+      slots_(new Slot[mask_ + 1]) {
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool BoundedThreadPool::TaskQueue::TryPush(
+    const std::function<void()>& callback) {
+  size_t pos = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot* slot = &slots_[pos & mask_];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        slot->callback = callback;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the callback pushed one lap ago: full.
+      return false;
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool BoundedThreadPool::TaskQueue::TryPop(std::function<void()>* callback) {
+  size_t pos = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot* slot = &slots_[pos & mask_];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1,
+                                      std::memory_order_relaxed)) {
+        *callback = std::move(slot->callback);
+        slot->callback = nullptr;
+        slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      // Nothing has been pushed to this slot yet: empty.
+      return false;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+BoundedThreadPool::BoundedThreadPool(int num_threads, size_t queue_size)
+    : queue_(queue_size) {
+  gpr_once_init(&g_tls_once, InitTls);
+  num_threads = std::max(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    threads_.emplace_back(
+        "grpcpp_bounded_pool",
+        [](void* pool) { static_cast<BoundedThreadPool*>(pool)->ThreadFunc(); },
+        this);
+    threads_.back().Start();
+  }
+}
+
+BoundedThreadPool::~BoundedThreadPool() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_.store(true);
+    thread_cv_.SignalAll();
+  }
+  // Threads only exit once they find the queue empty, so all the callbacks
+  // already added get to run.
+  for (auto& thd : threads_) {
+    thd.Join();
+  }
+}
+
+void BoundedThreadPool::ThreadFunc() {
+  gpr_tls_set(&g_current_pool, reinterpret_cast<intptr_t>(this));
+  std::function<void()> callback;
+  for (;;) {
+    bool found = false;
+    for (int i = 0; i < kSpinsBeforeParking && !found; i++) {
+      found = queue_.TryPop(&callback);
+      if (!found) std::this_thread::yield();
+    }
+    if (!found) {
+      grpc_core::MutexLock lock(&mu_);
+      parked_threads_.fetch_add(1);
+      // Pairs with the fence in WakeThread(): either this thread sees the
+      // callback that was just pushed, or the producer sees it parked.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!(found = queue_.TryPop(&callback)) && !shutdown_.load()) {
+        thread_cv_.Wait(&mu_);
+      }
+      parked_threads_.fetch_sub(1);
+      if (!found) break;
+    }
+    WakeProducer();
+    callback();
+    callback = nullptr;
+  }
+  gpr_tls_set(&g_current_pool, 0);
+}
+
+void BoundedThreadPool::WakeThread() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked_threads_.load(std::memory_order_relaxed) > 0) {
+    grpc_core::MutexLock lock(&mu_);
+    thread_cv_.Signal();
+  }
+}
+
+void BoundedThreadPool::WakeProducer() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (blocked_producers_.load(std::memory_order_relaxed) > 0) {
+    grpc_core::MutexLock lock(&mu_);
+    producer_cv_.Signal();
+  }
+}
+
+void BoundedThreadPool::Add(const std::function<void()>& callback) {
+  if (!queue_.TryPush(callback)) {
+    if (gpr_tls_get(&g_current_pool) == reinterpret_cast<intptr_t>(this)) {
+      // Waiting for a free slot here could leave no thread to make one.
+      callback();
+      return;
+    }
+    // Backpressure: wait for a thread to take a callback off the queue.
+    grpc_core::MutexLock lock(&mu_);
+    blocked_producers_.fetch_add(1);
+    // Pairs with the fence in WakeProducer().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!queue_.TryPush(callback)) {
+      producer_cv_.Wait(&mu_);
+    }
+    blocked_producers_.fetch_sub(1);
+  }
+  WakeThread();
+}
+
+}  // namespace grpc
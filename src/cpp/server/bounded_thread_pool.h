@@ -0,0 +1,94 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_INTERNAL_CPP_BOUNDED_THREAD_POOL_H
+#define GRPC_INTERNAL_CPP_BOUNDED_THREAD_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <grpcpp/support/config.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/cpp/server/thread_pool_interface.h"
+
+namespace grpc {
+
+// A thread pool with a fixed number of threads, started up front and reused
+// for its whole lifetime, and a bounded lock-free task queue.
+//
+// Idle threads spin on the queue for a short while before parking, so that
+// bursts of callbacks are picked up without a wakeup. When the queue is full,
+// Add() blocks until a thread frees a slot. Add() calls made from one of the
+// pool's own threads run the callback inline instead, so that a saturated pool
+// cannot deadlock on itself.
+class BoundedThreadPool final : public ThreadPoolInterface {
+ public:
+  // queue_size is rounded up to a power of two.
+  BoundedThreadPool(int num_threads, size_t queue_size);
+  ~BoundedThreadPool() override;
+
+  void Add(const std::function<void()>& callback) override;
+
+ private:
+  // Bounded multi-producer multi-consumer ring buffer. Each slot carries a
+  // sequence number telling producers and consumers whose turn it is, so that
+  // pushes and pops only contend on the head and tail counters.
+  class TaskQueue {
+   public:
+    explicit TaskQueue(size_t size);
+
+    bool TryPush(const std::function<void()>& callback);
+    bool TryPop(std::function<void()>* callback);
+
+   private:
+    struct Slot {
+      std::atomic<size_t> sequence;
+      std::function<void()> callback;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> head_{0};  // Next slot to pop.
+    std::atomic<size_t> tail_{0};  // Next slot to push.
+  };
+
+  void ThreadFunc();
+  // Wakes one parked thread, if any.
+  void WakeThread();
+  // Wakes one producer blocked in Add(), if any.
+  void WakeProducer();
+
+  TaskQueue queue_;
+  std::vector<grpc_core::Thread> threads_;
+
+  // Protects the parking of threads and producers; the counters are also read
+  // without it to skip taking the lock when nobody is parked.
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar thread_cv_;
+  grpc_core::CondVar producer_cv_;
+  std::atomic<int> parked_threads_{0};
+  std::atomic<int> blocked_producers_{0};
+  std::atomic<bool> shutdown_{false};
+};
+
+}  // namespace grpc
+
+#endif  // GRPC_INTERNAL_CPP_BOUNDED_THREAD_POOL_H
@@ -16,18 +16,36 @@
  *
  */
 
+#include <string.h>
+
 #include <grpc/support/cpu.h>
 
+#include "src/core/lib/gprpp/global_config.h"
+#include "src/cpp/server/bounded_thread_pool.h"
 #include "src/cpp/server/dynamic_thread_pool.h"
 
 #ifndef GRPC_CUSTOM_DEFAULT_THREAD_POOL
 
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_cpp_thread_pool, "dynamic",
+    "Thread pool returned by CreateDefaultThreadPool(): 'dynamic' adds threads "
+    "whenever all of them are busy, 'bounded' keeps one thread per core and "
+    "makes callers wait when its task queue is full.")
+
 namespace grpc {
 namespace {
 
+// Callbacks that may be queued per thread of a bounded pool before Add()
+// blocks.
+constexpr size_t kBoundedPoolQueueSizePerThread = 64;
+
 ThreadPoolInterface* CreateDefaultThreadPoolImpl() {
   int cores = gpr_cpu_num_cores();
   if (!cores) cores = 4;
+  grpc_core::UniquePtr<char> pool = GPR_GLOBAL_CONFIG_GET(grpc_cpp_thread_pool);
+  if (strcmp(pool.get(), "bounded") == 0) {
+    return new BoundedThreadPool(cores, cores * kBoundedPoolQueueSizePerThread);
+  }
   return new DynamicThreadPool(cores);
 }
 
@@ -46,6 +46,8 @@ static void do_plugin_list_init(void) {
 ServerBuilder::ServerBuilder()
     : max_receive_message_size_(INT_MIN),
       max_send_message_size_(INT_MIN),
+      queue_delay_target_ms_(0),
+      queue_delay_interval_ms_(100),
       sync_server_settings_(SyncServerSettings()),
       resource_quota_(nullptr) {
   gpr_once_init(&once_init_plugin_list, do_plugin_list_init);
@@ -170,6 +172,9 @@ ServerBuilder& ServerBuilder::SetSyncServerOption(
     case CQ_TIMEOUT_MSEC:
       sync_server_settings_.cq_timeout_msec = val;
       break;
+    case THREAD_PER_CORE:
+      sync_server_settings_.thread_per_core = val != 0;
+      break;
   }
   return *this;
 }
@@ -231,6 +236,11 @@ ChannelArguments ServerBuilder::BuildChannelArgs() {
   if (max_send_message_size_ >= -1) {
     args.SetInt(GRPC_ARG_MAX_SEND_MESSAGE_LENGTH, max_send_message_size_);
   }
+  if (queue_delay_target_ms_ > 0) {
+    args.SetInt(GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS, queue_delay_target_ms_);
+    args.SetInt(GRPC_ARG_SERVER_QUEUE_DELAY_INTERVAL_MS,
+                queue_delay_interval_ms_);
+  }
   for (const auto& option : options_) {
     option->UpdateArguments(&args);
     option->UpdatePlugins(&plugins_);
@@ -314,6 +324,12 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
   const bool is_hybrid_server = has_sync_methods && has_frequently_polled_cqs;
 
   if (has_sync_methods) {
+    if (sync_server_settings_.thread_per_core) {
+      sync_server_settings_.num_cqs = static_cast<int>(gpr_cpu_num_cores());
+      sync_server_settings_.min_pollers = 1;
+      sync_server_settings_.max_pollers = 1;
+    }
+
     grpc_cq_polling_type polling_type =
         is_hybrid_server ? GRPC_CQ_NON_POLLING : GRPC_CQ_DEFAULT_POLLING;
 
@@ -331,10 +347,11 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
     // This is a Sync server
     gpr_log(GPR_INFO,
             "Synchronous server. Num CQs: %d, Min pollers: %d, Max Pollers: "
-            "%d, CQ timeout (msec): %d",
+            "%d, CQ timeout (msec): %d, Thread per core: %d",
             sync_server_settings_.num_cqs, sync_server_settings_.min_pollers,
             sync_server_settings_.max_pollers,
-            sync_server_settings_.cq_timeout_msec);
+            sync_server_settings_.cq_timeout_msec,
+            sync_server_settings_.thread_per_core);
   }
 
   if (has_callback_methods) {
@@ -345,7 +362,7 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
       &args, sync_server_cqs, sync_server_settings_.min_pollers,
       sync_server_settings_.max_pollers, sync_server_settings_.cq_timeout_msec,
       std::move(acceptors_), server_config_fetcher_, resource_quota_,
-      std::move(interceptor_creators_)));
+      std::move(interceptor_creators_), sync_server_settings_.thread_per_core));
 
   ServerInitializer* initializer = server->initializer();
 
@@ -522,11 +522,42 @@ class Server::CallbackRequest final
       std::is_base_of<grpc::CallbackServerContext, ServerContextType>::value,
       "ServerContextType must be derived from CallbackServerContext");
 
+  // Requests are allocated on the arena of the call they are matched with,
+  // which they keep a ref to until they are destroyed.
+  static void Create(Server* server, grpc::internal::RpcServiceMethod* method,
+                     grpc::CompletionQueue* cq, grpc_call* call,
+                     grpc_core::Server::RegisteredCallAllocation* data) {
+    grpc_call_ref(call);
+    new (grpc_call_arena_alloc(call, sizeof(CallbackRequest)))
+        CallbackRequest(server, method, cq, call, data);
+  }
+
+  static void Create(Server* server, grpc::CompletionQueue* cq,
+                     grpc_call* call,
+                     grpc_core::Server::BatchCallAllocation* data) {
+    grpc_call_ref(call);
+    new (grpc_call_arena_alloc(call, sizeof(CallbackRequest)))
+        CallbackRequest(server, cq, call, data);
+  }
+
+  // Destroys the request and then drops its ref to the call, which may free
+  // the arena holding it.
+  static void Destroy(CallbackRequest* req) {
+    grpc_call* call = req->arena_call_;
+    req->~CallbackRequest();
+    grpc_call_unref(call);
+  }
+
+  // Needs specialization to account for different processing of metadata
+  // in generic API
+  bool FinalizeResult(void** tag, bool* status) override;
+
+ private:
   // For codegen services, the value of method represents the defined
   // characteristics of the method being requested. For generic services, method
   // is nullptr since these services don't have pre-defined methods.
   CallbackRequest(Server* server, grpc::internal::RpcServiceMethod* method,
-                  grpc::CompletionQueue* cq,
+                  grpc::CompletionQueue* cq, grpc_call* call,
                   grpc_core::Server::RegisteredCallAllocation* data)
       : server_(server),
         method_(method),
@@ -534,6 +565,7 @@ class Server::CallbackRequest final
                                  grpc::internal::RpcMethod::NORMAL_RPC ||
                              method->method_type() ==
                                  grpc::internal::RpcMethod::SERVER_STREAMING),
+        arena_call_(call),
         cq_(cq),
         tag_(this),
         ctx_(server_->context_allocator() != nullptr
@@ -546,12 +578,14 @@ class Server::CallbackRequest final
 
   // For generic services, method is nullptr since these services don't have
   // pre-defined methods.
-  CallbackRequest(Server* server, grpc::CompletionQueue* cq,
+  CallbackRequest(Server* server, grpc::CompletionQueue* cq, grpc_call* call,
                   grpc_core::Server::BatchCallAllocation* data)
       : server_(server),
         method_(nullptr),
         has_request_payload_(false),
-        call_details_(new grpc_call_details),
+        call_details_(static_cast<grpc_call_details*>(
+            grpc_call_arena_alloc(call, sizeof(grpc_call_details)))),
+        arena_call_(call),
         cq_(cq),
         tag_(this),
         ctx_(server_->context_allocator() != nullptr
@@ -564,7 +598,6 @@ class Server::CallbackRequest final
   }
 
   ~CallbackRequest() override {
-    delete call_details_;
     grpc_metadata_array_destroy(&request_metadata_);
     if (has_request_payload_ && request_payload_) {
       grpc_byte_buffer_destroy(request_payload_);
@@ -575,11 +608,6 @@ class Server::CallbackRequest final
     server_->UnrefWithPossibleNotify();
   }
 
-  // Needs specialization to account for different processing of metadata
-  // in generic API
-  bool FinalizeResult(void** tag, bool* status) override;
-
- private:
   // method_name needs to be specialized between named method and generic
   const char* method_name() const;
 
@@ -619,7 +647,7 @@ class Server::CallbackRequest final
       if (!ok) {
         // The call has been shutdown.
         // Delete its contents to free up the request.
-        delete req_;
+        Destroy(req_);
         return;
       }
 
@@ -677,7 +705,7 @@ class Server::CallbackRequest final
                           : req_->server_->generic_handler_.get();
       handler->RunHandler(grpc::internal::MethodHandler::HandlerParameter(
           call_, req_->ctx_, req_->request_, req_->request_status_,
-          req_->handler_data_, [this] { delete req_; }));
+          req_->handler_data_, [this] { Destroy(req_); }));
     }
   };
 
@@ -705,6 +733,8 @@ class Server::CallbackRequest final
   void* handler_data_ = nullptr;
   grpc::Status request_status_;
   grpc_call_details* const call_details_ = nullptr;
+  // The call whose arena holds this request.
+  grpc_call* const arena_call_;
   grpc_call* call_;
   gpr_timespec deadline_;
   grpc_metadata_array request_metadata_;
@@ -799,7 +829,7 @@ class Server::SyncRequestThreadManager : public grpc::ThreadManager {
 
   void AddSyncMethod(grpc::internal::RpcServiceMethod* method, void* tag) {
     server_->server()->core_server->SetRegisteredMethodAllocator(
-        server_cq_->cq(), tag, [this, method] {
+        server_cq_->cq(), tag, [this, method](grpc_call* /*call*/) {
           grpc_core::Server::RegisteredCallAllocation result;
           new SyncRequest(server_, method, &result);
           return result;
@@ -813,7 +843,7 @@ class Server::SyncRequestThreadManager : public grpc::ThreadManager {
           "unknown", grpc::internal::RpcMethod::BIDI_STREAMING,
           new grpc::internal::UnknownMethodHandler(kUnknownRpcMethod));
       server_->server()->core_server->SetBatchMethodAllocator(
-          server_cq_->cq(), [this] {
+          server_cq_->cq(), [this](grpc_call* /*call*/) {
             grpc_core::Server::BatchCallAllocation result;
             new SyncRequest(server_, unknown_method_.get(), &result);
             return result;
@@ -865,7 +895,8 @@ Server::Server(
     grpc_resource_quota* server_rq,
     std::vector<
         std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>>
-        interceptor_creators)
+        interceptor_creators,
+    bool sync_thread_per_core)
     : acceptors_(std::move(acceptors)),
       interceptor_creators_(std::move(interceptor_creators)),
       max_receive_message_size_(INT_MIN),
@@ -894,6 +925,10 @@ Server::Server(
       sync_req_mgrs_.emplace_back(new SyncRequestThreadManager(
           this, it.get(), global_callbacks_, server_rq, min_pollers,
           max_pollers, sync_cq_timeout_msec));
+      if (sync_thread_per_core) {
+        sync_req_mgrs_.back()->UseFixedPinnedThread(
+            static_cast<int>(sync_req_mgrs_.size() - 1));
+      }
     }
 
     if (default_rq_created) {
@@ -1038,10 +1073,11 @@ bool Server::RegisterService(const std::string* addr, grpc::Service* service) {
       grpc::internal::RpcServiceMethod* method_value = method.get();
       grpc::CompletionQueue* cq = CallbackCQ();
       server_->core_server->SetRegisteredMethodAllocator(
-          cq->cq(), method_registration_tag, [this, cq, method_value] {
+          cq->cq(), method_registration_tag,
+          [this, cq, method_value](grpc_call* call) {
             grpc_core::Server::RegisteredCallAllocation result;
-            new CallbackRequest<grpc::CallbackServerContext>(this, method_value,
-                                                             cq, &result);
+            CallbackRequest<grpc::CallbackServerContext>::Create(
+                this, method_value, cq, call, &result);
             return result;
           });
     }
@@ -1078,11 +1114,13 @@ void Server::RegisterCallbackGenericService(
   generic_handler_.reset(service->Handler());
 
   grpc::CompletionQueue* cq = CallbackCQ();
-  server_->core_server->SetBatchMethodAllocator(cq->cq(), [this, cq] {
-    grpc_core::Server::BatchCallAllocation result;
-    new CallbackRequest<grpc::GenericCallbackServerContext>(this, cq, &result);
-    return result;
-  });
+  server_->core_server->SetBatchMethodAllocator(
+      cq->cq(), [this, cq](grpc_call* call) {
+        grpc_core::Server::BatchCallAllocation result;
+        CallbackRequest<grpc::GenericCallbackServerContext>::Create(
+            this, cq, call, &result);
+        return result;
+      });
 }
 
 int Server::AddListeningPort(const std::string& addr,
@@ -1180,7 +1218,9 @@ void Server::Start(grpc::ServerCompletionQueue** cqs, size_t num_cqs) {
       !has_async_generic_service_ && !has_callback_generic_service_;
 
   if (unknown_rpc_needed && !sync_req_mgrs_.empty()) {
-    sync_req_mgrs_[0]->AddUnknownSyncMethod();
+    for (const auto& value : sync_req_mgrs_) {
+      value->AddUnknownSyncMethod();
+    }
     unknown_rpc_needed = false;
   }
 
@@ -20,12 +20,43 @@
 
 #include <climits>
 
+#ifdef GPR_LINUX
+#include <sched.h>
+#endif
+
 #include <grpc/support/log.h>
 #include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 
 namespace grpc {
 
+namespace {
+
+// Pins the calling thread to the cpu_index-th CPU of the set this process is
+// allowed to run on. Best effort: does nothing where affinity is unsupported.
+void PinCurrentThread(int cpu_index) {
+#ifdef GPR_LINUX
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+  int target = cpu_index % CPU_COUNT(&allowed);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed) || target-- > 0) continue;
+    cpu_set_t pinned;
+    CPU_ZERO(&pinned);
+    CPU_SET(cpu, &pinned);
+    if (sched_setaffinity(0, sizeof(pinned), &pinned) != 0) {
+      gpr_log(GPR_ERROR, "Could not pin grpc_sync_server worker to CPU %d",
+              cpu);
+    }
+    return;
+  }
+#else
+  (void)cpu_index;
+#endif
+}
+
+}  // namespace
+
 ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
     : thd_mgr_(thd_mgr) {
   // Make thread creation exclusive with respect to its join happening in
@@ -40,6 +71,7 @@ ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
 }
 
 void ThreadManager::WorkerThread::Run() {
+  if (thd_mgr_->cpu_index_ >= 0) PinCurrentThread(thd_mgr_->cpu_index_);
   thd_mgr_->MainWorkLoop();
   thd_mgr_->MarkAsCompleted(this);
 }
@@ -56,6 +88,8 @@ ThreadManager::ThreadManager(const char* name,
       num_pollers_(0),
       min_pollers_(min_pollers),
       max_pollers_(max_pollers == -1 ? INT_MAX : max_pollers),
+      fixed_thread_(false),
+      cpu_index_(-1),
       num_threads_(0),
       max_active_threads_sofar_(0) {
   resource_user_ = grpc_resource_user_create(resource_quota, name);
@@ -123,6 +157,13 @@ void ThreadManager::CleanupCompletedThreads() {
   for (auto thd : completed_threads) delete thd;
 }
 
+void ThreadManager::UseFixedPinnedThread(int cpu_index) {
+  min_pollers_ = 1;
+  max_pollers_ = 1 + kMaxOverflowPollers;
+  fixed_thread_ = true;
+  cpu_index_ = cpu_index;
+}
+
 void ThreadManager::Initialize() {
   if (!grpc_resource_user_allocate_threads(resource_user_, min_pollers_)) {
     gpr_log(GPR_ERROR,
@@ -159,8 +200,12 @@ void ThreadManager::MainWorkLoop() {
     switch (work_status) {
       case TIMEOUT:
         // If we timed out and we have more pollers than we need (or we are
-        // shutdown), finish this thread
-        if (shutdown_ || num_pollers_ > max_pollers_) done = true;
+        // shutdown), finish this thread. With a fixed thread, an overflow
+        // poller is no longer needed once another thread polls again.
+        if (shutdown_ || num_pollers_ > max_pollers_ ||
+            (fixed_thread_ && num_pollers_ >= min_pollers_)) {
+          done = true;
+        }
         break;
       case SHUTDOWN:
         // If the thread manager is shutdown, finish this thread
@@ -170,7 +215,8 @@ void ThreadManager::MainWorkLoop() {
         // If we got work and there are now insufficient pollers and there is
         // quota available to create a new thread, start a new poller thread
         bool resource_exhausted = false;
-        if (!shutdown_ && num_pollers_ < min_pollers_) {
+        if (!shutdown_ && num_pollers_ < min_pollers_ &&
+            (!fixed_thread_ || num_threads_ < max_pollers_)) {
           if (grpc_resource_user_allocate_threads(resource_user_, 1)) {
             // We can allocate a new poller thread
             num_pollers_++;
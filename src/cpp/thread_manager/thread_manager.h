@@ -39,6 +39,19 @@ class ThreadManager {
   // Initializes and Starts the Rpc Manager threads
   void Initialize();
 
+  // Switches to a single polling thread, instead of growing and shrinking the
+  // pollers between min_pollers and max_pollers. Where supported, the thread
+  // is pinned to the 'cpu_index'-th CPU (modulo the number of CPUs) this
+  // process may run on. So that a long-running DoWork() does not hold up the
+  // work behind it, at most kMaxOverflowPollers more threads, pinned to the
+  // same CPU, are started while no thread is polling; they retire once a poll
+  // times out while another thread is polling.
+  // Must be called before Initialize().
+  void UseFixedPinnedThread(int cpu_index);
+
+  // See UseFixedPinnedThread().
+  static constexpr int kMaxOverflowPollers = 1;
+
   // The return type of PollForWork() function
   enum WorkStatus { WORK_FOUND, SHUTDOWN, TIMEOUT };
 
@@ -163,6 +176,11 @@ class ThreadManager {
   int min_pollers_;
   int max_pollers_;
 
+  // Set by UseFixedPinnedThread(): at most max_pollers_ threads ever run, and
+  // all of them are pinned to cpu_index_ (if it is not negative)
+  bool fixed_thread_;
+  int cpu_index_;
+
   // The total number of threads currently active (includes threads includes the
   // threads that are currently polling i.e num_pollers_)
   int num_threads_;
@@ -24,6 +24,7 @@
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "test/core/util/test_config.h"
 
@@ -147,10 +148,105 @@ static void test_create_channel_stack(void) {
   grpc_slice_unref_internal(path);
 }
 
+static grpc_error_handle counting_channel_init_func(
+    grpc_channel_element* /*elem*/, grpc_channel_element_args* /*args*/) {
+  return GRPC_ERROR_NONE;
+}
+
+static grpc_error_handle counting_call_init_func(
+    grpc_call_element* elem, const grpc_call_element_args* /*args*/) {
+  *static_cast<int*>(elem->call_data) = 0;
+  return GRPC_ERROR_NONE;
+}
+
+static void counting_call_destroy_func(
+    grpc_call_element* /*elem*/, const grpc_call_final_info* /*final_info*/,
+    grpc_closure* /*ignored*/) {}
+
+static void counting_call_func(grpc_call_element* elem,
+                               grpc_transport_stream_op_batch* op) {
+  ++*static_cast<int*>(elem->call_data);
+  grpc_call_next_op(elem, op);
+}
+
+static void terminal_call_func(grpc_call_element* elem,
+                               grpc_transport_stream_op_batch* /*op*/) {
+  ++*static_cast<int*>(elem->call_data);
+}
+
+#define COUNTING_FILTER(start_batch, name)                                     \
+  {                                                                            \
+    start_batch, grpc_channel_next_op, sizeof(int), counting_call_init_func,   \
+        grpc_call_stack_ignore_set_pollset_or_pollset_set,                     \
+        counting_call_destroy_func, 0, counting_channel_init_func,             \
+        channel_destroy_func, grpc_channel_next_get_info, name                 \
+  }
+
+static const grpc_channel_filter top_filter =
+    COUNTING_FILTER(counting_call_func, "top");
+static const grpc_channel_filter passthrough_filter =
+    COUNTING_FILTER(grpc_call_next_op, "passthrough");
+static const grpc_channel_filter recv_filter =
+    COUNTING_FILTER(counting_call_func, "recv");
+static const grpc_channel_filter terminal_filter =
+    COUNTING_FILTER(terminal_call_func, "terminal");
+
+// Sends a send_message and then a recv_message batch down
+// top -> passthrough -> recv -> terminal, and checks how many batches each
+// counting filter saw.
+static void test_skip_passthrough_filters(bool skip) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_channel_filter_register_handled_ops(&recv_filter,
+                                           GRPC_STREAM_OP_RECV_MESSAGE);
+  const grpc_channel_filter* filters[] = {&top_filter, &passthrough_filter,
+                                          &recv_filter, &terminal_filter};
+  grpc_arg arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SKIP_PASSTHROUGH_FILTERS), skip);
+  grpc_channel_args chan_args = {1, &arg};
+  grpc_channel_stack* channel_stack = static_cast<grpc_channel_stack*>(
+      gpr_malloc(grpc_channel_stack_size(filters, 4)));
+  GPR_ASSERT(GRPC_ERROR_NONE ==
+             grpc_channel_stack_init(1, free_channel, channel_stack, filters, 4,
+                                     &chan_args, nullptr, "test",
+                                     channel_stack));
+  grpc_call_stack* call_stack =
+      static_cast<grpc_call_stack*>(gpr_malloc(channel_stack->call_stack_size));
+  grpc_slice path = grpc_slice_from_static_string("/service/method");
+  const grpc_call_element_args args = {
+      call_stack, nullptr, nullptr, path, gpr_get_cycle_counter(),
+      GRPC_MILLIS_INF_FUTURE, nullptr, nullptr};
+  GPR_ASSERT(GRPC_ERROR_NONE == grpc_call_stack_init(channel_stack, 1,
+                                                     free_call, call_stack,
+                                                     &args));
+  auto count = [call_stack](size_t i) {
+    grpc_call_element* elem = grpc_call_stack_element(call_stack, i);
+    return *static_cast<int*>(elem->call_data);
+  };
+  grpc_call_element* top = grpc_call_stack_element(call_stack, 0);
+  grpc_transport_stream_op_batch op = {};
+  op.send_message = true;
+  top->filter->start_transport_stream_op_batch(top, &op);
+  GPR_ASSERT(count(0) == 1);
+  GPR_ASSERT(count(2) == (skip ? 0 : 1));
+  GPR_ASSERT(count(3) == 1);
+  op = {};
+  op.recv_message = true;
+  top->filter->start_transport_stream_op_batch(top, &op);
+  GPR_ASSERT(count(0) == 2);
+  GPR_ASSERT(count(2) == (skip ? 1 : 2));
+  GPR_ASSERT(count(3) == 2);
+
+  GRPC_CALL_STACK_UNREF(call_stack, "done");
+  GRPC_CHANNEL_STACK_UNREF(channel_stack, "done");
+  grpc_slice_unref_internal(path);
+}
+
 int main(int argc, char** argv) {
   grpc::testing::TestEnvironment env(argc, argv);
   grpc_init();
   test_create_channel_stack();
+  test_skip_passthrough_filters(true);
+  test_skip_passthrough_filters(false);
   grpc_shutdown();
   return 0;
 }
@@ -0,0 +1,531 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Exercises GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS and
+   GRPC_ARG_SUBCHANNEL_SPARE_CONNECTIONS end to end.  The client reaches the
+   server through a TCP proxy, which tells the connections of the pool apart
+   and can close any one of them. */
+
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+#define MAX_CONNECTIONS 3
+#define MAX_CALLS 10
+
+static void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+namespace {
+
+// Forwards every connection accepted on port() to the server on
+// backend_port.  Connections are numbered in the order they are accepted.
+class TcpProxy {
+ public:
+  explicit TcpProxy(int backend_port) : backend_port_(backend_port) {
+    port_ = grpc_pick_unused_port_or_die();
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    GPR_ASSERT(listen_fd_ >= 0);
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in addr = LoopbackAddress(port_);
+    GPR_ASSERT(bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr),
+                    sizeof(addr)) == 0);
+    GPR_ASSERT(listen(listen_fd_, 16) == 0);
+    thread_ = std::thread([this]() { Run(); });
+  }
+
+  ~TcpProxy() {
+    shutdown_ = true;
+    thread_.join();
+    for (Connection& c : connections_) {
+      if (c.open) CloseLocked(&c);
+    }
+    close(listen_fd_);
+  }
+
+  int port() const { return port_; }
+
+  size_t num_accepted() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return connections_.size();
+  }
+
+  size_t num_open() {
+    std::lock_guard<std::mutex> lock(mu_);
+    size_t open = 0;
+    for (const Connection& c : connections_) open += c.open;
+    return open;
+  }
+
+  // Returns the connection that the server sees as \a peer, or -1.
+  int ConnectionForPeer(const char* peer) {
+    const char* port = strrchr(peer, ':');
+    GPR_ASSERT(port != nullptr);
+    const int peer_port = atoi(port + 1);
+    std::lock_guard<std::mutex> lock(mu_);
+    for (size_t i = 0; i < connections_.size(); i++) {
+      if (connections_[i].backend_local_port == peer_port) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  // Closes both sides of connection \a index.
+  void CloseConnection(size_t index) {
+    std::lock_guard<std::mutex> lock(mu_);
+    GPR_ASSERT(index < connections_.size());
+    GPR_ASSERT(connections_[index].open);
+    shutdown(connections_[index].client_fd, SHUT_RDWR);
+    shutdown(connections_[index].backend_fd, SHUT_RDWR);
+  }
+
+ private:
+  struct Connection {
+    int client_fd;
+    int backend_fd;
+    int backend_local_port;
+    bool open;
+  };
+
+  static sockaddr_in LoopbackAddress(int port) {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    return addr;
+  }
+
+  static bool WriteAll(int fd, const char* data, ssize_t length) {
+    while (length > 0) {
+      const ssize_t written = write(fd, data, length);
+      if (written <= 0) return false;
+      data += written;
+      length -= written;
+    }
+    return true;
+  }
+
+  void CloseLocked(Connection* c) {
+    close(c->client_fd);
+    close(c->backend_fd);
+    c->open = false;
+  }
+
+  void AcceptLocked() {
+    const int client_fd = accept(listen_fd_, nullptr, nullptr);
+    if (client_fd < 0) return;
+    const int backend_fd = socket(AF_INET, SOCK_STREAM, 0);
+    GPR_ASSERT(backend_fd >= 0);
+    sockaddr_in addr = LoopbackAddress(backend_port_);
+    GPR_ASSERT(connect(backend_fd, reinterpret_cast<sockaddr*>(&addr),
+                       sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    GPR_ASSERT(getsockname(backend_fd, reinterpret_cast<sockaddr*>(&addr),
+                           &len) == 0);
+    gpr_log(GPR_INFO, "proxy: connection %" PRIuPTR " accepted",
+            connections_.size());
+    connections_.push_back(
+        Connection{client_fd, backend_fd, ntohs(addr.sin_port), true});
+  }
+
+  void Run() {
+    std::vector<pollfd> fds;
+    std::vector<size_t> owners;
+    while (!shutdown_) {
+      fds.clear();
+      owners.clear();
+      {
+        std::lock_guard<std::mutex> lock(mu_);
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        owners.push_back(0);
+        for (size_t i = 0; i < connections_.size(); i++) {
+          if (!connections_[i].open) continue;
+          fds.push_back(pollfd{connections_[i].client_fd, POLLIN, 0});
+          owners.push_back(i);
+          fds.push_back(pollfd{connections_[i].backend_fd, POLLIN, 0});
+          owners.push_back(i);
+        }
+      }
+      if (poll(fds.data(), fds.size(), 10) <= 0) continue;
+      std::lock_guard<std::mutex> lock(mu_);
+      if (fds[0].revents != 0) AcceptLocked();
+      for (size_t i = 1; i < fds.size(); i++) {
+        if (fds[i].revents == 0) continue;
+        Connection* c = &connections_[owners[i]];
+        if (!c->open) continue;
+        const int to =
+            fds[i].fd == c->client_fd ? c->backend_fd : c->client_fd;
+        char buf[65536];
+        const ssize_t n = read(fds[i].fd, buf, sizeof(buf));
+        if (n <= 0 || !WriteAll(to, buf, n)) {
+          gpr_log(GPR_INFO, "proxy: connection %" PRIuPTR " closed",
+                  owners[i]);
+          CloseLocked(c);
+        }
+      }
+    }
+  }
+
+  const int backend_port_;
+  int port_;
+  int listen_fd_;
+  std::atomic<bool> shutdown_{false};
+  std::thread thread_;
+  std::mutex mu_;
+  std::vector<Connection> connections_;
+};
+
+struct call_state {
+  grpc_call* client;
+  grpc_call* server;
+  grpc_call_details details;
+  grpc_metadata_array request_metadata;
+  grpc_metadata_array trailing_metadata;
+  grpc_status_code status;
+  grpc_slice status_details;
+  int cancelled;
+  // The proxy connection the call was started on.
+  int connection;
+  bool done;
+};
+
+struct test_state {
+  TcpProxy* proxy;
+  grpc_completion_queue* cq;
+  cq_verifier* cqv;
+  grpc_server* server;
+  grpc_channel* channel;
+  call_state calls[MAX_CALLS];
+  int num_calls;
+};
+
+// Polls the completion queue, which must stay empty, until \a done returns
+// true.
+template <typename F>
+void poll_until(test_state* s, F done) {
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+  while (!done()) {
+    GPR_ASSERT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0);
+    grpc_event ev = grpc_completion_queue_next(
+        s->cq, grpc_timeout_milliseconds_to_deadline(10), nullptr);
+    GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+  }
+}
+
+// Gives a connection attempt that may be in flight the time to finish.
+void settle(test_state* s) {
+  gpr_timespec deadline = grpc_timeout_milliseconds_to_deadline(300);
+  poll_until(s, [deadline]() {
+    return gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) >= 0;
+  });
+}
+
+// Starts a call and waits for the server to receive it.  Returns the
+// index of the call.
+int start_call(test_state* s) {
+  GPR_ASSERT(s->num_calls < MAX_CALLS);
+  const int i = s->num_calls++;
+  call_state* c = &s->calls[i];
+  memset(c, 0, sizeof(*c));
+  grpc_call_details_init(&c->details);
+  grpc_metadata_array_init(&c->request_metadata);
+  grpc_metadata_array_init(&c->trailing_metadata);
+  c->client = grpc_channel_create_call(
+      s->channel, nullptr, GRPC_PROPAGATE_DEFAULTS, s->cq,
+      grpc_slice_from_static_string("/foo"), nullptr,
+      grpc_timeout_seconds_to_deadline(60), nullptr);
+  grpc_op ops[2];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[0].flags = GRPC_INITIAL_METADATA_WAIT_FOR_READY;
+  ops[1].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  ops[1].data.recv_status_on_client.trailing_metadata = &c->trailing_metadata;
+  ops[1].data.recv_status_on_client.status = &c->status;
+  ops[1].data.recv_status_on_client.status_details = &c->status_details;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(c->client, ops, 2, tag(100 + i), nullptr));
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_server_request_call(s->server, &c->server, &c->details,
+                                      &c->request_metadata, s->cq, s->cq,
+                                      tag(200 + i)));
+  CQ_EXPECT_COMPLETION(s->cqv, tag(200 + i), 1);
+  cq_verify(s->cqv);
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[0].data.recv_close_on_server.cancelled = &c->cancelled;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(c->server, ops, 1, tag(300 + i), nullptr));
+  char* peer = grpc_call_get_peer(c->server);
+  c->connection = s->proxy->ConnectionForPeer(peer);
+  gpr_log(GPR_INFO, "call %d started on connection %d (%s)", i, c->connection,
+          peer);
+  gpr_free(peer);
+  GPR_ASSERT(c->connection >= 0);
+  return i;
+}
+
+// Closes \a connection and checks that exactly the calls on it fail.
+void close_connection(test_state* s, int connection) {
+  s->proxy->CloseConnection(connection);
+  for (int i = 0; i < s->num_calls; i++) {
+    call_state* c = &s->calls[i];
+    if (c->done || c->connection != connection) continue;
+    CQ_EXPECT_COMPLETION(s->cqv, tag(100 + i), 1);
+    CQ_EXPECT_COMPLETION(s->cqv, tag(300 + i), 1);
+  }
+  cq_verify(s->cqv);
+  for (int i = 0; i < s->num_calls; i++) {
+    call_state* c = &s->calls[i];
+    if (c->done || c->connection != connection) continue;
+    GPR_ASSERT(c->status == GRPC_STATUS_UNAVAILABLE);
+    GPR_ASSERT(c->cancelled);
+    c->done = true;
+  }
+}
+
+// Finishes every call that is still running with an OK status.
+void finish_calls(test_state* s) {
+  for (int i = 0; i < s->num_calls; i++) {
+    call_state* c = &s->calls[i];
+    if (c->done) continue;
+    grpc_op ops[2];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[1].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+    ops[1].data.send_status_from_server.status = GRPC_STATUS_OK;
+    GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(c->server, ops, 2,
+                                                     tag(400 + i), nullptr));
+    CQ_EXPECT_COMPLETION(s->cqv, tag(100 + i), 1);
+    CQ_EXPECT_COMPLETION(s->cqv, tag(300 + i), 1);
+    CQ_EXPECT_COMPLETION(s->cqv, tag(400 + i), 1);
+  }
+  cq_verify(s->cqv);
+  for (int i = 0; i < s->num_calls; i++) {
+    call_state* c = &s->calls[i];
+    if (c->done) continue;
+    GPR_ASSERT(c->status == GRPC_STATUS_OK);
+    c->done = true;
+  }
+}
+
+// Creates the completion queue and starts the server.  Returns the server
+// port.
+int start_server(test_state* s) {
+  s->num_calls = 0;
+  s->cq = grpc_completion_queue_create_for_next(nullptr);
+  s->cqv = cq_verifier_create(s->cq);
+  const int server_port = grpc_pick_unused_port_or_die();
+  s->server = grpc_server_create(nullptr, nullptr);
+  std::string server_addr = grpc_core::JoinHostPort("127.0.0.1", server_port);
+  GPR_ASSERT(grpc_server_add_insecure_http2_port(s->server,
+                                                 server_addr.c_str()) != 0);
+  grpc_server_register_completion_queue(s->server, s->cq, nullptr);
+  grpc_server_start(s->server);
+  return server_port;
+}
+
+// Connects a channel with \a args to the server through the proxy.
+void create_channel(test_state* s, grpc_arg* args, size_t num_args) {
+  grpc_channel_args client_args = {num_args, args};
+  std::string proxy_addr =
+      grpc_core::JoinHostPort("127.0.0.1", s->proxy->port());
+  s->channel =
+      grpc_insecure_channel_create(proxy_addr.c_str(), &client_args, nullptr);
+}
+
+void shutdown_server(test_state* s) {
+  grpc_server_shutdown_and_notify(s->server, s->cq, tag(1000));
+  CQ_EXPECT_COMPLETION(s->cqv, tag(1000), 1);
+  cq_verify(s->cqv);
+  grpc_server_destroy(s->server);
+  cq_verifier_destroy(s->cqv);
+  grpc_completion_queue_shutdown(s->cq);
+  while (grpc_completion_queue_next(s->cq, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(s->cq);
+}
+
+void destroy_calls(test_state* s) {
+  for (int i = 0; i < s->num_calls; i++) {
+    call_state* c = &s->calls[i];
+    if (c->client == nullptr) continue;
+    grpc_call_unref(c->client);
+    grpc_call_unref(c->server);
+    grpc_call_details_destroy(&c->details);
+    grpc_metadata_array_destroy(&c->request_metadata);
+    grpc_metadata_array_destroy(&c->trailing_metadata);
+    grpc_slice_unref(c->status_details);
+    c->client = nullptr;
+  }
+}
+
+}  // namespace
+
+static void test_connection_pool(void) {
+  gpr_log(GPR_INFO, "test_connection_pool");
+  test_state s;
+  TcpProxy proxy(start_server(&s));
+  s.proxy = &proxy;
+  grpc_arg args[2];
+  args[0] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS), MAX_CONNECTIONS);
+  args[1] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION), 1);
+  create_channel(&s, args, GPR_ARRAY_SIZE(args));
+
+  // The first call opens the connection that heads the pool.  The second
+  // finds it saturated, so it asks for another connection, but is itself
+  // started on the head connection.
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 0);
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 0);
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 2; });
+  settle(&s);
+
+  // Calls go to the connection with the fewest streams, and the pool keeps
+  // growing while every connection is saturated.
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 1);
+  settle(&s);
+  GPR_ASSERT(proxy.num_accepted() == 2);
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 1);
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 3; });
+  settle(&s);
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 2);
+
+  // ... but not beyond GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS.
+  GPR_ASSERT(s.calls[start_call(&s)].connection != 0);
+  settle(&s);
+  GPR_ASSERT(proxy.num_accepted() == MAX_CONNECTIONS);
+
+  // Losing a pooled connection only fails the calls on it, and the pool
+  // replaces it on the next saturated pick.
+  close_connection(&s, 1);
+  GPR_ASSERT(grpc_channel_check_connectivity_state(s.channel, 0) ==
+             GRPC_CHANNEL_READY);
+  GPR_ASSERT(s.calls[start_call(&s)].connection != 1);
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 4; });
+
+  // Losing the head connection drops the whole pool: the next call goes to
+  // a new connection, even though the pooled ones are still up.
+  close_connection(&s, 0);
+  const int last = start_call(&s);
+  GPR_ASSERT(s.calls[last].connection == 4);
+  GPR_ASSERT(proxy.num_accepted() == 5);
+
+  // The dropped connections go away with their last call.
+  finish_calls(&s);
+  destroy_calls(&s);
+  poll_until(&s, [&proxy]() { return proxy.num_open() == 1; });
+
+  grpc_channel_destroy(s.channel);
+  shutdown_server(&s);
+}
+
+static void test_spare_connections(void) {
+  gpr_log(GPR_INFO, "test_spare_connections");
+  test_state s;
+  TcpProxy proxy(start_server(&s));
+  s.proxy = &proxy;
+  grpc_arg args[2];
+  args[0] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS), MAX_CONNECTIONS);
+  args[1] = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SUBCHANNEL_SPARE_CONNECTIONS), 2);
+  create_channel(&s, args, GPR_ARRAY_SIZE(args));
+
+  // The spare connection is opened as soon as the subchannel is READY,
+  // before any call is made.  Without calls, connection attempts only make
+  // progress while something polls for the channel, so keep a connectivity
+  // watch pending, as an application waiting on the channel would.
+  grpc_channel_check_connectivity_state(s.channel, 1);
+  grpc_channel_watch_connectivity_state(s.channel, GRPC_CHANNEL_IDLE,
+                                        grpc_timeout_seconds_to_deadline(10),
+                                        s.cq, tag(900));
+  CQ_EXPECT_COMPLETION(s.cqv, tag(900), 1);
+  cq_verify(s.cqv);
+  grpc_channel_watch_connectivity_state(s.channel, GRPC_CHANNEL_CONNECTING,
+                                        grpc_timeout_seconds_to_deadline(10),
+                                        s.cq, tag(901));
+  CQ_EXPECT_COMPLETION(s.cqv, tag(901), 1);
+  cq_verify(s.cqv);
+  GPR_ASSERT(grpc_channel_check_connectivity_state(s.channel, 0) ==
+             GRPC_CHANNEL_READY);
+  grpc_channel_watch_connectivity_state(s.channel, GRPC_CHANNEL_READY,
+                                        grpc_timeout_seconds_to_deadline(60),
+                                        s.cq, tag(902));
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 2; });
+  settle(&s);
+
+  // Calls are far from saturating a connection, but each one that takes a
+  // spare connection has it replaced...
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 0);
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 3; });
+  settle(&s);
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 1);
+
+  // ... up to GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS.
+  GPR_ASSERT(s.calls[start_call(&s)].connection == 2);
+  settle(&s);
+  GPR_ASSERT(proxy.num_accepted() == MAX_CONNECTIONS);
+
+  // A lost connection is replaced without waiting for a call, since the
+  // pool is left without a spare connection.
+  close_connection(&s, 2);
+  poll_until(&s, [&proxy]() { return proxy.num_accepted() == 4; });
+
+  finish_calls(&s);
+  destroy_calls(&s);
+  grpc_channel_destroy(s.channel);
+  CQ_EXPECT_COMPLETION(s.cqv, tag(902), 1);
+  cq_verify(s.cqv);
+  shutdown_server(&s);
+}
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  test_connection_pool();
+  test_spare_connections();
+  grpc_shutdown();
+  return 0;
+}
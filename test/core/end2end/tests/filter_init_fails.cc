@@ -27,6 +27,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channel_stack_builder.h"
 #include "src/core/lib/surface/channel_init.h"
 #include "test/core/end2end/cq_verifier.h"
@@ -199,16 +200,22 @@ static void test_server_channel_filter(grpc_end2end_test_config config) {
 }
 
 // Simple request via a CLIENT_CHANNEL or CLIENT_DIRECT_CHANNEL filter
-// that always fails to initialize the call.
-static void test_client_channel_filter(grpc_end2end_test_config config) {
+// that always fails to initialize the call.  With \a warmup, the client
+// channel is asked to start connecting as soon as it is created.
+static void test_client_channel_filter(grpc_end2end_test_config config,
+                                       bool warmup) {
   grpc_call* c;
   grpc_slice request_payload_slice =
       grpc_slice_from_copied_string("hello world");
   grpc_byte_buffer* request_payload =
       grpc_raw_byte_buffer_create(&request_payload_slice, 1);
   gpr_timespec deadline = five_seconds_from_now();
+  grpc_arg warmup_arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_CLIENT_CHANNEL_WARMUP), 1);
+  grpc_channel_args client_args = {1, &warmup_arg};
   grpc_end2end_test_fixture f =
-      begin_test(config, "filter_init_fails", nullptr, nullptr);
+      begin_test(config, "filter_init_fails",
+                 warmup ? &client_args : nullptr, nullptr);
   cq_verifier* cqv = cq_verifier_create(f.cq);
   grpc_op ops[6];
   grpc_op* op;
@@ -533,7 +540,15 @@ static void filter_init_fails_internal(grpc_end2end_test_config config) {
   g_enable_server_channel_filter = false;
   gpr_log(GPR_INFO, "Testing CLIENT_CHANNEL / CLIENT_DIRECT_CHANNEL filter.");
   g_enable_client_channel_filter = true;
-  test_client_channel_filter(config);
+  test_client_channel_filter(config, /*warmup=*/false);
+  if (g_channel_filter_init_failure) {
+    // The client channel itself initializes fine, but must not start
+    // warming up a channel stack that is about to be destroyed.
+    gpr_log(GPR_INFO,
+            "Testing CLIENT_CHANNEL / CLIENT_DIRECT_CHANNEL filter with "
+            "warm-up.");
+    test_client_channel_filter(config, /*warmup=*/true);
+  }
   g_enable_client_channel_filter = false;
   // If the client handshake completes before the server handshake and the
   // client is able to send application data before the server handshake
@@ -71,6 +71,21 @@ static void test(const char* name, size_t init_size, const size_t* allocs,
   static const size_t allocs_##name[] = {__VA_ARGS__}; \
   test(#name, init_size, allocs_##name, GPR_ARRAY_SIZE(allocs_##name))
 
+static void test_reset(void) {
+  gpr_log(GPR_DEBUG, "test_reset");
+
+  Arena* a = Arena::Create(1024);
+  void* first = a->Alloc(16);
+  memset(a->Alloc(512), 1, 512);
+  // Spill out of the initial zone.
+  memset(a->Alloc(4096), 1, 4096);
+  GPR_ASSERT(a->Reset() == 16 + 512 + 4096);
+  // The initial zone is handed out again from its start.
+  GPR_ASSERT(a->Alloc(16) == first);
+  GPR_ASSERT(a->initial_zone_size() == 1024);
+  GPR_ASSERT(a->Destroy() == 16);
+}
+
 #define CONCURRENT_TEST_THREADS 10
 
 size_t concurrent_test_iterations() {
@@ -125,6 +140,7 @@ int main(int argc, char* argv[]) {
   TEST(1_3, 1, 3);
   TEST(1_inc, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
   TEST(6_123, 6, 1, 2, 3);
+  test_reset();
   concurrent_test();
 
   return 0;
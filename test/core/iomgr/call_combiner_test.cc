@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/iomgr/call_combiner.h"
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "test/core/util/test_config.h"
+
+typedef struct step {
+  grpc_core::CallCombiner call_combiner;
+  grpc_closure closure;
+  int* runs;
+  // Whether the closure yields the call combiner when done.
+  bool stop;
+  // If set, the closure enters this step's call combiner inline.
+  struct step* next;
+} step;
+
+static void run_step(void* arg, grpc_error_handle /*error*/) {
+  step* s = static_cast<step*>(arg);
+  ++*s->runs;
+  if (s->next != nullptr) {
+    GRPC_CALL_COMBINER_START_INLINE(&s->next->call_combiner,
+                                    &s->next->closure, GRPC_ERROR_NONE,
+                                    "next step");
+  }
+  if (s->stop) GRPC_CALL_COMBINER_STOP(&s->call_combiner, "step done");
+}
+
+static void init_step(step* s, int* runs) {
+  GRPC_CLOSURE_INIT(&s->closure, run_step, s, nullptr);
+  s->runs = runs;
+  s->stop = true;
+  s->next = nullptr;
+}
+
+static void test_start_inline_when_idle(void) {
+  gpr_log(GPR_DEBUG, "test_start_inline_when_idle");
+  grpc_core::ExecCtx exec_ctx;
+  int runs = 0;
+  step s;
+  init_step(&s, &runs);
+  GRPC_CALL_COMBINER_START_INLINE(&s.call_combiner, &s.closure,
+                                  GRPC_ERROR_NONE, "idle");
+  // The closure ran before returning, without going through the ExecCtx.
+  GPR_ASSERT(runs == 1);
+  GPR_ASSERT(!grpc_core::ExecCtx::Get()->HasWork());
+}
+
+static void test_start_inline_when_busy(void) {
+  gpr_log(GPR_DEBUG, "test_start_inline_when_busy");
+  grpc_core::ExecCtx exec_ctx;
+  int runs = 0;
+  step s;
+  init_step(&s, &runs);
+  // Hold the call combiner.
+  s.stop = false;
+  GRPC_CALL_COMBINER_START_INLINE(&s.call_combiner, &s.closure,
+                                  GRPC_ERROR_NONE, "hold");
+  GPR_ASSERT(runs == 1);
+  s.stop = true;
+  grpc_closure second;
+  GRPC_CLOSURE_INIT(&second, run_step, &s, nullptr);
+  GRPC_CALL_COMBINER_START_INLINE(&s.call_combiner, &second, GRPC_ERROR_NONE,
+                                  "busy");
+  // The call combiner was busy, so the closure was queued.
+  GPR_ASSERT(runs == 1);
+  GRPC_CALL_COMBINER_STOP(&s.call_combiner, "release");
+  // Handing over to a queued closure goes through the ExecCtx.
+  GPR_ASSERT(runs == 1);
+  grpc_core::ExecCtx::Get()->Flush();
+  GPR_ASSERT(runs == 2);
+}
+
+static void test_inline_depth_is_bounded(void) {
+  gpr_log(GPR_DEBUG, "test_inline_depth_is_bounded");
+  const int kChainLength = 16;
+  grpc_core::ExecCtx exec_ctx;
+  int runs = 0;
+  step chain[kChainLength];
+  for (int i = 0; i < kChainLength; i++) {
+    init_step(&chain[i], &runs);
+    if (i + 1 < kChainLength) chain[i].next = &chain[i + 1];
+  }
+  GRPC_CALL_COMBINER_START_INLINE(&chain[0].call_combiner, &chain[0].closure,
+                                  GRPC_ERROR_NONE, "chain");
+  // Some steps ran inline, but not the whole chain.
+  gpr_log(GPR_DEBUG, "%d of %d steps ran inline", runs, kChainLength);
+  GPR_ASSERT(runs > 1);
+  GPR_ASSERT(runs < kChainLength);
+  // The rest ran from the ExecCtx.
+  grpc_core::ExecCtx::Get()->Flush();
+  GPR_ASSERT(runs == kChainLength);
+}
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  test_start_inline_when_idle();
+  test_start_inline_when_busy();
+  test_inline_depth_is_bounded();
+  grpc_shutdown();
+  return 0;
+}
@@ -93,6 +93,24 @@ class TestThread {
   gpr_event done_;
 };
 
+TEST(WorkSerializerTest, OrphanWhileDraining) {
+  auto lock = absl::make_unique<grpc_core::WorkSerializer>();
+  int count = 0;
+  lock->Run(
+      [&lock, &count]() {
+        // These callbacks are queued behind this one and drained in a batch,
+        // the last of which orphans the work serializer.
+        for (int i = 0; i < 5; ++i) {
+          lock->Run([&count]() { ++count; }, DEBUG_LOCATION);
+        }
+        lock->Run([&lock]() { lock.reset(); }, DEBUG_LOCATION);
+        EXPECT_EQ(count, 0);
+      },
+      DEBUG_LOCATION);
+  EXPECT_EQ(count, 5);
+  EXPECT_EQ(lock, nullptr);
+}
+
 TEST(WorkSerializerTest, ExecuteMany) {
   grpc_core::WorkSerializer lock;
   {
@@ -25,9 +25,16 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 #include "src/core/lib/security/credentials/fake/fake_credentials.h"
+#include "src/core/lib/surface/channel.h"
+#include "src/core/lib/surface/completion_queue.h"
+#include "src/core/lib/surface/server.h"
 #include "test/core/util/port.h"
 #include "test/core/util/test_config.h"
 
@@ -130,6 +137,267 @@ void test_bind_server_to_addr(const char* host, bool secure) {
   grpc_completion_queue_destroy(cq);
 }
 
+static void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+static void expect_next(grpc_completion_queue* cq, void* expected_tag) {
+  grpc_event ev = grpc_completion_queue_next(
+      cq, grpc_timeout_seconds_to_deadline(10), nullptr);
+  GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+  GPR_ASSERT(ev.tag == expected_tag);
+  GPR_ASSERT(ev.success);
+}
+
+/* Waits for \a expected_tag on \a cq while also polling \a other_cq, which
+   must have nothing to report, so that both ends of a connection progress. */
+static void expect_next_polling(grpc_completion_queue* cq,
+                                grpc_completion_queue* other_cq,
+                                void* expected_tag) {
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+  while (true) {
+    grpc_event ev = grpc_completion_queue_next(
+        cq, grpc_timeout_milliseconds_to_deadline(10), nullptr);
+    if (ev.type == GRPC_OP_COMPLETE) {
+      GPR_ASSERT(ev.tag == expected_tag);
+      GPR_ASSERT(ev.success);
+      return;
+    }
+    GPR_ASSERT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0);
+    ev = grpc_completion_queue_next(
+        other_cq, grpc_timeout_milliseconds_to_deadline(10), nullptr);
+    GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+  }
+}
+
+/* Starts calls with mixed deadlines while the application has no call
+   requested, so that they all wait on the server, and checks the order in
+   which they are matched to requests made afterwards. */
+static void test_pending_call_order(bool earliest_deadline_first) {
+  static const int kDeadlineSeconds[] = {30, 10, 40, 20, 50, 5};
+  static const size_t kNumCalls = GPR_ARRAY_SIZE(kDeadlineSeconds);
+  gpr_log(GPR_INFO, "Test pending call order, earliest_deadline_first=%d",
+          earliest_deadline_first);
+
+  grpc_arg a = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SERVER_EDF_PENDING_CALLS),
+      earliest_deadline_first);
+  grpc_channel_args args = {1, &a};
+  grpc_server* server = grpc_server_create(&args, nullptr);
+  grpc_completion_queue* server_cq =
+      grpc_completion_queue_create_for_next(nullptr);
+  grpc_server_register_completion_queue(server, server_cq, nullptr);
+  std::string addr =
+      grpc_core::JoinHostPort("localhost", grpc_pick_unused_port_or_die());
+  GPR_ASSERT(grpc_server_add_insecure_http2_port(server, addr.c_str()));
+  grpc_server_start(server);
+
+  grpc_channel* channel =
+      grpc_insecure_channel_create(addr.c_str(), nullptr, nullptr);
+  grpc_completion_queue* client_cq =
+      grpc_completion_queue_create_for_next(nullptr);
+  grpc_call* client_calls[kNumCalls];
+  grpc_slice method = grpc_slice_from_static_string("/foo");
+  /* Each call is sent before the next one is started, so that they reach the
+     server in order. */
+  for (size_t i = 0; i < kNumCalls; i++) {
+    client_calls[i] = grpc_channel_create_call(
+        channel, nullptr, GRPC_PROPAGATE_DEFAULTS, client_cq, method, nullptr,
+        grpc_timeout_seconds_to_deadline(kDeadlineSeconds[i]), nullptr);
+    grpc_op op = {};
+    op.op = GRPC_OP_SEND_INITIAL_METADATA;
+    op.flags = GRPC_INITIAL_METADATA_WAIT_FOR_READY;
+    GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(client_calls[i], &op, 1,
+                                                     tag(i + 1), nullptr));
+    expect_next_polling(client_cq, server_cq, tag(i + 1));
+  }
+  /* Let the server read the calls. */
+  grpc_event ev = grpc_completion_queue_next(
+      server_cq, grpc_timeout_milliseconds_to_deadline(500), nullptr);
+  GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+
+  gpr_timespec matched_deadlines[kNumCalls];
+  for (size_t i = 0; i < kNumCalls; i++) {
+    grpc_call* server_call;
+    grpc_call_details details;
+    grpc_metadata_array request_metadata;
+    grpc_call_details_init(&details);
+    grpc_metadata_array_init(&request_metadata);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server, &server_call, &details,
+                                        &request_metadata, server_cq,
+                                        server_cq, tag(100 + i)));
+    expect_next(server_cq, tag(100 + i));
+    matched_deadlines[i] = details.deadline;
+    grpc_call_cancel(server_call, nullptr);
+    grpc_call_unref(server_call);
+    grpc_call_details_destroy(&details);
+    grpc_metadata_array_destroy(&request_metadata);
+  }
+  /* The deadlines are far enough apart for the order of the deadlines the
+     server received to be that of the deadlines the calls were sent with. */
+  for (size_t i = 0; i + 1 < kNumCalls; i++) {
+    const bool earlier =
+        gpr_time_cmp(matched_deadlines[i], matched_deadlines[i + 1]) < 0;
+    if (earliest_deadline_first) {
+      GPR_ASSERT(earlier);
+    } else {
+      GPR_ASSERT(earlier == (kDeadlineSeconds[i] < kDeadlineSeconds[i + 1]));
+    }
+  }
+
+  for (size_t i = 0; i < kNumCalls; i++) {
+    grpc_call_cancel(client_calls[i], nullptr);
+    grpc_call_unref(client_calls[i]);
+  }
+  grpc_channel_destroy(channel);
+  grpc_completion_queue_shutdown(client_cq);
+  while (grpc_completion_queue_next(client_cq,
+                                    gpr_inf_future(GPR_CLOCK_MONOTONIC),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(client_cq);
+  grpc_server_shutdown_and_notify(server, server_cq, tag(1000));
+  expect_next(server_cq, tag(1000));
+  grpc_server_destroy(server);
+  grpc_completion_queue_shutdown(server_cq);
+  while (grpc_completion_queue_next(server_cq,
+                                    gpr_inf_future(GPR_CLOCK_MONOTONIC),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(server_cq);
+}
+
+/* Connects a client channel to \a server over a socket pair whose server side
+   is bound to \a server_cq, as if the connection had been accepted while
+   \a server_cq was being polled. */
+static grpc_channel* connect_to_server_cq(grpc_server* server,
+                                          grpc_completion_queue* server_cq) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_endpoint_pair sfd = grpc_iomgr_create_endpoint_pair("server_test",
+                                                           nullptr);
+  const grpc_channel_args* server_args =
+      server->core_server->channel_args();
+  grpc_transport* transport =
+      grpc_create_chttp2_transport(server_args, sfd.server, false);
+  grpc_endpoint_add_to_pollset(sfd.server, grpc_cq_pollset(server_cq));
+  GPR_ASSERT(GRPC_ERROR_NONE == server->core_server->SetupTransport(
+                                    transport, grpc_cq_pollset(server_cq),
+                                    server_args, nullptr));
+  grpc_chttp2_transport_start_reading(transport, nullptr, nullptr, nullptr);
+
+  grpc_arg authority_arg = grpc_channel_arg_string_create(
+      const_cast<char*>(GRPC_ARG_DEFAULT_AUTHORITY),
+      const_cast<char*>("test-authority"));
+  grpc_channel_args client_args = {1, &authority_arg};
+  transport = grpc_create_chttp2_transport(&client_args, sfd.client, true);
+  grpc_channel* channel =
+      grpc_channel_create("socketpair-target", &client_args,
+                          GRPC_CLIENT_DIRECT_CHANNEL, transport, nullptr);
+  GPR_ASSERT(channel != nullptr);
+  grpc_chttp2_transport_start_reading(transport, nullptr, nullptr, nullptr);
+  return channel;
+}
+
+/* Queues a call on the shard of a second server cq and then newer calls on the
+   shard of the cq the application requests calls on, and checks that the
+   older call is matched first: pending calls are matched in arrival (or
+   deadline) order across cqs, not just within the requester's own. */
+static void test_pending_call_order_across_cqs(bool earliest_deadline_first) {
+  /* The first call goes to cq_b, the others to cq_a. */
+  static const int kDeadlineSeconds[] = {10, 20, 30};
+  static const size_t kNumCalls = GPR_ARRAY_SIZE(kDeadlineSeconds);
+  gpr_log(GPR_INFO,
+          "Test pending call order across cqs, earliest_deadline_first=%d",
+          earliest_deadline_first);
+
+  grpc_arg a = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SERVER_EDF_PENDING_CALLS),
+      earliest_deadline_first);
+  grpc_channel_args args = {1, &a};
+  grpc_server* server = grpc_server_create(&args, nullptr);
+  grpc_completion_queue* cq_a = grpc_completion_queue_create_for_next(nullptr);
+  grpc_completion_queue* cq_b = grpc_completion_queue_create_for_next(nullptr);
+  grpc_server_register_completion_queue(server, cq_a, nullptr);
+  grpc_server_register_completion_queue(server, cq_b, nullptr);
+  grpc_server_start(server);
+
+  grpc_channel* channels[] = {connect_to_server_cq(server, cq_b),
+                              connect_to_server_cq(server, cq_a)};
+  grpc_completion_queue* client_cq =
+      grpc_completion_queue_create_for_next(nullptr);
+  grpc_call* client_calls[kNumCalls];
+  grpc_slice method = grpc_slice_from_static_string("/foo");
+  for (size_t i = 0; i < kNumCalls; i++) {
+    client_calls[i] = grpc_channel_create_call(
+        channels[i == 0 ? 0 : 1], nullptr, GRPC_PROPAGATE_DEFAULTS, client_cq,
+        method, nullptr, grpc_timeout_seconds_to_deadline(kDeadlineSeconds[i]),
+        nullptr);
+    grpc_op op = {};
+    op.op = GRPC_OP_SEND_INITIAL_METADATA;
+    GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(client_calls[i], &op, 1,
+                                                     tag(i + 1), nullptr));
+    expect_next_polling(client_cq, cq_a, tag(i + 1));
+    /* Let the server read the call before the next one is sent. */
+    for (grpc_completion_queue* cq : {cq_a, cq_b}) {
+      grpc_event ev = grpc_completion_queue_next(
+          cq, grpc_timeout_milliseconds_to_deadline(200), nullptr);
+      GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+    }
+  }
+
+  /* All calls are requested on cq_a. */
+  gpr_timespec matched_deadlines[kNumCalls];
+  for (size_t i = 0; i < kNumCalls; i++) {
+    grpc_call* server_call;
+    grpc_call_details details;
+    grpc_metadata_array request_metadata;
+    grpc_call_details_init(&details);
+    grpc_metadata_array_init(&request_metadata);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server, &server_call, &details,
+                                        &request_metadata, cq_a, cq_a,
+                                        tag(100 + i)));
+    expect_next(cq_a, tag(100 + i));
+    matched_deadlines[i] = details.deadline;
+    grpc_call_cancel(server_call, nullptr);
+    grpc_call_unref(server_call);
+    grpc_call_details_destroy(&details);
+    grpc_metadata_array_destroy(&request_metadata);
+  }
+  /* Both by arrival and by deadline, the call on cq_b comes first. */
+  for (size_t i = 0; i + 1 < kNumCalls; i++) {
+    GPR_ASSERT(gpr_time_cmp(matched_deadlines[i], matched_deadlines[i + 1]) <
+               0);
+  }
+
+  for (size_t i = 0; i < kNumCalls; i++) {
+    grpc_call_cancel(client_calls[i], nullptr);
+    grpc_call_unref(client_calls[i]);
+  }
+  for (grpc_channel* channel : channels) {
+    grpc_channel_destroy(channel);
+  }
+  grpc_completion_queue_shutdown(client_cq);
+  while (grpc_completion_queue_next(client_cq,
+                                    gpr_inf_future(GPR_CLOCK_MONOTONIC),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(client_cq);
+  grpc_server_shutdown_and_notify(server, cq_a, tag(1000));
+  expect_next_polling(cq_a, cq_b, tag(1000));
+  grpc_server_destroy(server);
+  for (grpc_completion_queue* cq : {cq_a, cq_b}) {
+    grpc_completion_queue_shutdown(cq);
+    while (grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_MONOTONIC),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq);
+  }
+}
+
 static int external_dns_works(const char* host) {
   grpc_resolved_addresses* res = nullptr;
   grpc_error_handle error = grpc_blocking_resolve_address(host, "80", &res);
@@ -156,6 +424,10 @@ int main(int argc, char** argv) {
 #ifndef GRPC_UV
   test_bind_server_twice();
 #endif
+  test_pending_call_order(false);
+  test_pending_call_order(true);
+  test_pending_call_order_across_cqs(false);
+  test_pending_call_order_across_cqs(true);
 
   static const char* addrs[] = {
       "::1", "127.0.0.1", "::ffff:127.0.0.1", "localhost", "0.0.0.0", "::",
@@ -394,6 +394,53 @@ static void test_interned_key_indexed() {
   }
 }
 
+static void test_exact_index_basic_headers() {
+  grpc_chttp2_hpack_compressor_enable_exact_index(&g_compressor);
+  verify_params params = {
+      false,
+      false,
+      false,
+  };
+  verify(params, "000005 0104 deadbeef 40 0161 0161", 1, "a", "a");
+  verify(params, "000001 0104 deadbeef be", 1, "a", "a");
+  verify(params, "000006 0104 deadbeef be 40 0162 0163", 2, "a", "a", "b", "c");
+  verify(params, "000002 0104 deadbeef bf be", 2, "a", "a", "b", "c");
+  verify(params, "000004 0104 deadbeef 7f 00 0164", 1, "a", "d");
+  verify(params, "000003 0104 deadbeef c0 bf be", 3, "a", "a", "b", "c", "a",
+         "d");
+}
+
+static void test_exact_index_admission() {
+  grpc_chttp2_hpack_compressor_enable_exact_index(&g_compressor);
+  verify_params params = {
+      false,
+      false,
+      false,
+  };
+  char kv[3];
+
+  /* make one pair popular */
+  verify(params, "000007 0104 deadbeef 40 026161 026261", 1, "aa", "ba");
+  for (int i = 0; i < 10; i++) {
+    verify(params, "000001 0104 deadbeef be", 1, "aa", "ba");
+  }
+  /* fill the rest of the 4096 byte table with one-off pairs (36 bytes each) */
+  for (int i = 2; i < 114; i++) {
+    encode_int_to_str(i, kv);
+    std::string expect =
+        absl::StrFormat("000007 0104 deadbeef 40 02%02x%02x 02%02x%02x", kv[0],
+                        kv[1], kv[0], kv[1]);
+    verify(params, expect.c_str(), 1, kv, kv);
+  }
+  /* the table is full: another one-off pair must not evict the popular one */
+  encode_int_to_str(114, kv);
+  std::string expect =
+      absl::StrFormat("000007 0104 deadbeef 00 02%02x%02x 02%02x%02x", kv[0],
+                      kv[1], kv[0], kv[1]);
+  verify(params, expect.c_str(), 1, kv, kv);
+  verify(params, "000002 0104 deadbeef ff2f", 1, "aa", "ba");
+}
+
 static void run_test(void (*test)(), const char* name) {
   gpr_log(GPR_INFO, "RUN TEST: %s", name);
   grpc_core::ExecCtx exec_ctx;
@@ -412,6 +459,8 @@ int main(int argc, char** argv) {
   TEST(test_encode_header_size);
   TEST(test_interned_key_indexed);
   TEST(test_continuation_headers);
+  TEST(test_exact_index_basic_headers);
+  TEST(test_exact_index_admission);
   grpc_shutdown();
   for (i = 0; i < num_to_delete; i++) {
     gpr_free(to_delete[i]);
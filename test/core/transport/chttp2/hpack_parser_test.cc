@@ -212,11 +212,55 @@ static void test_vectors(grpc_slice_split_mode mode) {
   grpc_chttp2_hpack_parser_destroy(&parser);
 }
 
+/* what grpc_chttp2_header_parser_parse does at the end of each header block */
+static void begin_block(grpc_chttp2_hpack_parser* parser) {
+  parser->dynamic_table_update_allowed = 2;
+}
+
+static void test_repeated_indexed_prefix(grpc_slice_split_mode mode) {
+  grpc_chttp2_hpack_parser parser;
+  grpc_core::ExecCtx exec_ctx;
+
+  grpc_chttp2_hpack_parser_init(&parser);
+  new (&parser.table) grpc_chttp2_hptbl();
+  /* D.3.1: adds :authority, so the recorded prefix goes stale */
+  test_vector(&parser, mode,
+              "8286 8441 0f77 7777 2e65 7861 6d70 6c65"
+              "2e63 6f6d",
+              ":method", "GET", ":scheme", "http", ":path", "/", ":authority",
+              "www.example.com", NULL);
+  begin_block(&parser);
+  test_vector(&parser, mode, "8286 84be", ":method", "GET", ":scheme", "http",
+              ":path", "/", ":authority", "www.example.com", NULL);
+  /* the same prefix again, with the table unchanged */
+  begin_block(&parser);
+  test_vector(&parser, mode, "8286 84be", ":method", "GET", ":scheme", "http",
+              ":path", "/", ":authority", "www.example.com", NULL);
+  /* the same prefix followed by an addition to the table */
+  begin_block(&parser);
+  test_vector(&parser, mode, "8286 84be 5808 6e6f 2d63 6163 6865", ":method",
+              "GET", ":scheme", "http", ":path", "/", ":authority",
+              "www.example.com", "cache-control", "no-cache", NULL);
+  /* same bytes, but be now refers to cache-control */
+  begin_block(&parser);
+  test_vector(&parser, mode, "8286 84be", ":method", "GET", ":scheme", "http",
+              ":path", "/", "cache-control", "no-cache", NULL);
+  begin_block(&parser);
+  test_vector(&parser, mode, "8286 84be", ":method", "GET", ":scheme", "http",
+              ":path", "/", "cache-control", "no-cache", NULL);
+  /* a shorter block than the recorded prefix */
+  begin_block(&parser);
+  test_vector(&parser, mode, "82", ":method", "GET", NULL);
+  grpc_chttp2_hpack_parser_destroy(&parser);
+}
+
 int main(int argc, char** argv) {
   grpc::testing::TestEnvironment env(argc, argv);
   grpc_init();
   test_vectors(GRPC_SLICE_SPLIT_MERGE_ALL);
   test_vectors(GRPC_SLICE_SPLIT_ONE_BYTE);
+  test_repeated_indexed_prefix(GRPC_SLICE_SPLIT_MERGE_ALL);
+  test_repeated_indexed_prefix(GRPC_SLICE_SPLIT_ONE_BYTE);
   grpc_shutdown();
   return 0;
 }
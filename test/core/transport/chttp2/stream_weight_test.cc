@@ -0,0 +1,274 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/channel/context.h"
+#include "src/core/lib/gprpp/arena.h"
+#include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/transport/byte_stream.h"
+#include "src/core/lib/transport/transport.h"
+#include "test/core/util/mock_endpoint.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+constexpr size_t kMessageSize = 1024 * 1024;
+constexpr uint32_t kMaxWindow = 0x7fffffff;
+constexpr uint8_t kFrameData = 0;
+constexpr uint8_t kFrameSettings = 4;
+constexpr uint8_t kFrameWindowUpdate = 8;
+constexpr uint16_t kSettingsInitialWindowSize = 4;
+// "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+constexpr size_t kClientPrefaceLength = 24;
+
+// Everything the client transport has written to the mock endpoint.
+std::string* g_written;
+
+void OnWrite(grpc_slice slice) {
+  g_written->append(reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(slice)),
+                    GRPC_SLICE_LENGTH(slice));
+}
+
+void AppendBigEndian(std::string* out, uint32_t value, int bytes) {
+  for (int i = bytes - 1; i >= 0; --i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint32_t ReadBigEndian(const std::string& in, size_t offset, int bytes) {
+  uint32_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value = (value << 8) | static_cast<uint8_t>(in[offset + i]);
+  }
+  return value;
+}
+
+void AppendFrameHeader(std::string* out, uint32_t length, uint8_t type) {
+  AppendBigEndian(out, length, 3);
+  out->push_back(static_cast<char>(type));
+  out->push_back(0);           // flags
+  AppendBigEndian(out, 0, 4);  // stream id
+}
+
+// The server opens both the connection and the stream flow control windows
+// as far as they go, so that only the stream scheduler decides which stream
+// is written next.
+grpc_slice ServerPreface() {
+  std::string preface;
+  AppendFrameHeader(&preface, 6, kFrameSettings);
+  AppendBigEndian(&preface, kSettingsInitialWindowSize, 2);
+  AppendBigEndian(&preface, kMaxWindow, 4);
+  AppendFrameHeader(&preface, 4, kFrameWindowUpdate);
+  AppendBigEndian(&preface, kMaxWindow - 65535, 4);
+  return grpc_slice_from_cpp_string(std::move(preface));
+}
+
+// The DATA frames written by the client, in order, as (stream id, length).
+std::vector<std::pair<uint32_t, uint32_t>> WrittenDataFrames() {
+  std::vector<std::pair<uint32_t, uint32_t>> frames;
+  size_t offset = kClientPrefaceLength;
+  while (offset + 9 <= g_written->size()) {
+    const uint32_t length = ReadBigEndian(*g_written, offset, 3);
+    const uint8_t type = static_cast<uint8_t>((*g_written)[offset + 3]);
+    const uint32_t stream_id =
+        ReadBigEndian(*g_written, offset + 5, 4) & 0x7fffffff;
+    if (type == kFrameData && length > 0) {
+      frames.emplace_back(stream_id, length);
+    }
+    offset += 9 + length;
+  }
+  return frames;
+}
+
+class TestStream {
+ public:
+  TestStream(grpc_transport* transport, uintptr_t weight)
+      : transport_(transport),
+        arena_(Arena::Create(4096)),
+        stream_(static_cast<grpc_stream*>(
+            gpr_zalloc(grpc_transport_stream_size(transport)))),
+        payload_(context_) {
+    context_[GRPC_CONTEXT_STREAM_WEIGHT].value =
+        reinterpret_cast<void*>(weight);
+    GRPC_STREAM_REF_INIT(&refcount_, 1, DestroyStream, this, "test_stream");
+    grpc_transport_init_stream(transport_, stream_, &refcount_, nullptr,
+                               arena_);
+    grpc_metadata_batch_init(&initial_metadata_);
+    initial_metadata_.deadline = GRPC_MILLIS_INF_FUTURE;
+    GRPC_CLOSURE_INIT(&on_complete_, OnComplete, this, nullptr);
+    GRPC_CLOSURE_INIT(&destroyed_, OnDestroyed, this, nullptr);
+  }
+
+  ~TestStream() {
+    grpc_transport_stream_op_batch cancel_op = {};
+    grpc_transport_stream_op_batch_payload cancel_payload(nullptr);
+    cancel_op.cancel_stream = true;
+    cancel_op.payload = &cancel_payload;
+    cancel_payload.cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+    grpc_transport_perform_stream_op(transport_, stream_, &cancel_op);
+    ExecCtx::Get()->Flush();
+#ifndef NDEBUG
+    grpc_stream_unref(&refcount_, "test_stream");
+#else
+    grpc_stream_unref(&refcount_);
+#endif
+    ExecCtx::Get()->Flush();
+    GPR_ASSERT(destroyed_called_);
+    if (op_.send_message) byte_stream_.Destroy();
+    grpc_metadata_batch_destroy(&initial_metadata_);
+    gpr_free(stream_);
+    arena_->Destroy();
+  }
+
+  // Sends initial metadata and one message of kMessageSize bytes.
+  void SendMessage() {
+    grpc_slice_buffer message;
+    grpc_slice_buffer_init(&message);
+    grpc_slice_buffer_add(
+        &message, grpc_slice_from_cpp_string(std::string(kMessageSize, 'a')));
+    byte_stream_.Init(&message, 0);
+    grpc_slice_buffer_destroy_internal(&message);
+    op_.send_initial_metadata = true;
+    op_.send_message = true;
+    op_.on_complete = &on_complete_;
+    op_.payload = &payload_;
+    payload_.send_initial_metadata.send_initial_metadata = &initial_metadata_;
+    payload_.send_message.send_message.reset(byte_stream_.get());
+    grpc_transport_perform_stream_op(transport_, stream_, &op_);
+  }
+
+  bool sent() const { return sent_; }
+
+ private:
+  static void OnComplete(void* arg, grpc_error_handle error) {
+    EXPECT_EQ(error, GRPC_ERROR_NONE);
+    static_cast<TestStream*>(arg)->sent_ = true;
+  }
+
+  static void DestroyStream(void* arg, grpc_error_handle /*error*/) {
+    TestStream* self = static_cast<TestStream*>(arg);
+    grpc_transport_destroy_stream(self->transport_, self->stream_,
+                                  &self->destroyed_);
+  }
+
+  static void OnDestroyed(void* arg, grpc_error_handle /*error*/) {
+    static_cast<TestStream*>(arg)->destroyed_called_ = true;
+  }
+
+  grpc_transport* transport_;
+  Arena* arena_;
+  grpc_stream* stream_;
+  grpc_stream_refcount refcount_;
+  grpc_call_context_element context_[GRPC_CONTEXT_COUNT] = {};
+  grpc_metadata_batch initial_metadata_;
+  ManualConstructor<SliceBufferByteStream> byte_stream_;
+  grpc_transport_stream_op_batch op_ = {};
+  grpc_transport_stream_op_batch_payload payload_;
+  grpc_closure on_complete_;
+  grpc_closure destroyed_;
+  bool sent_ = false;
+  bool destroyed_called_ = false;
+};
+
+// Sends one large message on each of two streams with the given weights, and
+// returns how many bytes of DATA the first stream got for every byte the
+// second stream got while both of them still had data to send.
+double BandwidthRatio(uintptr_t weight0, uintptr_t weight1) {
+  std::string written;
+  g_written = &written;
+  ExecCtx exec_ctx;
+  grpc_arg arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_HTTP2_BDP_PROBE), 0);
+  grpc_channel_args args = {1, &arg};
+  grpc_resource_quota* resource_quota =
+      grpc_resource_quota_create("stream_weight_test");
+  grpc_endpoint* endpoint = grpc_mock_endpoint_create(OnWrite, resource_quota);
+  grpc_mock_endpoint_put_read(endpoint, ServerPreface());
+  grpc_transport* transport =
+      grpc_create_chttp2_transport(&args, endpoint, true);
+  grpc_chttp2_transport_start_reading(transport, nullptr, nullptr, nullptr);
+  exec_ctx.Flush();
+  std::map<uint32_t, uint64_t> bytes_per_stream;
+  {
+    TestStream stream0(transport, weight0);
+    TestStream stream1(transport, weight1);
+    // Both streams become writable before the transport starts writing.
+    stream0.SendMessage();
+    stream1.SendMessage();
+    exec_ctx.Flush();
+    EXPECT_TRUE(stream0.sent());
+    EXPECT_TRUE(stream1.sent());
+    // Client stream ids are handed out in order, starting from 1.
+    std::vector<std::pair<uint32_t, uint32_t>> frames = WrittenDataFrames();
+    std::map<uint32_t, uint64_t> remaining = {{1, kMessageSize},
+                                              {3, kMessageSize}};
+    for (const auto& frame : frames) {
+      if (remaining[1] == 0 || remaining[3] == 0) break;
+      bytes_per_stream[frame.first] += frame.second;
+      remaining[frame.first] -= frame.second;
+    }
+  }
+  grpc_transport_destroy(transport);
+  grpc_resource_quota_unref(resource_quota);
+  exec_ctx.Flush();
+  g_written = nullptr;
+  EXPECT_GT(bytes_per_stream[3], 0u);
+  return static_cast<double>(bytes_per_stream[1]) / bytes_per_stream[3];
+}
+
+TEST(StreamWeightTest, EqualWeightsShareEqually) {
+  EXPECT_NEAR(BandwidthRatio(1, 1), 1.0, 0.1);
+}
+
+TEST(StreamWeightTest, WeightsShareProportionally) {
+  EXPECT_NEAR(BandwidthRatio(3, 1), 3.0, 0.3);
+  EXPECT_NEAR(BandwidthRatio(1, 4), 0.25, 0.05);
+}
+
+TEST(StreamWeightTest, UnsetWeightCountsAsOne) {
+  EXPECT_NEAR(BandwidthRatio(0, 2), 0.5, 0.1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int retval = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return retval;
+}
@@ -0,0 +1,141 @@
+//
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "src/core/ext/xds/xds_route_matcher.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+// One route of every kind of path matcher, with overlapping routes so that
+// most paths match several of them, followed by a catch-all route.
+std::vector<StringMatcher> MakePathMatchers() {
+  std::vector<StringMatcher> matchers;
+  auto add = [&matchers](StringMatcher::Type type, absl::string_view matcher,
+                         bool case_sensitive) {
+    auto string_matcher = StringMatcher::Create(type, matcher, case_sensitive);
+    ASSERT_TRUE(string_matcher.ok()) << string_matcher.status();
+    matchers.push_back(std::move(*string_matcher));
+  };
+  for (bool case_sensitive : {true, false}) {
+    add(StringMatcher::Type::kExact, "/pkg.Service/Get", case_sensitive);
+    add(StringMatcher::Type::kExact, "/pkg.Service/Put", case_sensitive);
+    add(StringMatcher::Type::kPrefix, "/pkg.Service/", case_sensitive);
+    add(StringMatcher::Type::kPrefix, "/pkg.", case_sensitive);
+    add(StringMatcher::Type::kPrefix, "/pkg.Service/Get", case_sensitive);
+    add(StringMatcher::Type::kSuffix, "/Get", case_sensitive);
+    add(StringMatcher::Type::kContains, "Service", case_sensitive);
+  }
+  add(StringMatcher::Type::kSafeRegex, "/pkg\\.Service/G.*", true);
+  add(StringMatcher::Type::kSafeRegex, "/pkg\\.[A-Z][a-z]+/Put", true);
+  add(StringMatcher::Type::kSafeRegex, "/other\\..*", true);
+  add(StringMatcher::Type::kSafeRegex, "/pkg\\.Service/", true);
+  add(StringMatcher::Type::kPrefix, "", true);
+  return matchers;
+}
+
+std::vector<std::string> MakePaths() {
+  return {"/pkg.Service/Get",  "/pkg.Service/Put", "/pkg.Service/GetAll",
+          "/PKG.SERVICE/GET",  "/pkg.Other/Put",   "/pkg.Other/Get",
+          "/other.Service/Get", "/other.Thing/Do",  "/pkg.Service/",
+          "/pkg.",             "/pkg",             "",
+          "Service",           "/Get"};
+}
+
+// The routes whose path matcher matches \a path, found by evaluating every
+// matcher in turn.
+std::vector<size_t> LinearScan(const std::vector<StringMatcher>& matchers,
+                               absl::string_view path) {
+  std::vector<size_t> routes;
+  for (size_t i = 0; i < matchers.size(); ++i) {
+    if (matchers[i].Match(path)) routes.push_back(i);
+  }
+  return routes;
+}
+
+void CheckMatchesLinearScan(const RE2::Options& regex_options) {
+  std::vector<StringMatcher> matchers = MakePathMatchers();
+  std::vector<const StringMatcher*> path_matchers;
+  for (const StringMatcher& matcher : matchers) {
+    path_matchers.push_back(&matcher);
+  }
+  XdsRouteMatcher route_matcher(path_matchers, regex_options);
+  std::vector<size_t> scratch;
+  // The second pass is answered from the cache.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (const std::string& path : MakePaths()) {
+      EXPECT_THAT(route_matcher.MatchingRoutes(path, &scratch),
+                  ::testing::ElementsAreArray(LinearScan(matchers, path)))
+          << "path \"" << path << "\", pass " << pass;
+    }
+  }
+}
+
+TEST(XdsRouteMatcherTest, MatchesLinearScan) {
+  CheckMatchesLinearScan(RE2::Options());
+}
+
+TEST(XdsRouteMatcherTest, MatchesLinearScanWithoutRegexSet) {
+  // Too little memory to compile the regex set, so the regexes are
+  // evaluated one by one.
+  RE2::Options regex_options;
+  regex_options.set_max_mem(1);
+  regex_options.set_log_errors(false);
+  CheckMatchesLinearScan(regex_options);
+}
+
+TEST(XdsRouteMatcherTest, CachesResults) {
+  std::vector<StringMatcher> matchers = MakePathMatchers();
+  std::vector<const StringMatcher*> path_matchers;
+  for (const StringMatcher& matcher : matchers) {
+    path_matchers.push_back(&matcher);
+  }
+  XdsRouteMatcher route_matcher(path_matchers);
+  std::vector<size_t> scratch;
+  const std::vector<size_t>* first =
+      &route_matcher.MatchingRoutes("/pkg.Service/Get", &scratch);
+  EXPECT_NE(first, &scratch);
+  EXPECT_EQ(&route_matcher.MatchingRoutes("/pkg.Service/Get", &scratch), first);
+  // Once the cache is full, new paths are matched into the scratch vector.
+  for (size_t i = 1; i < XdsRouteMatcher::kMaxCachedPaths; ++i) {
+    route_matcher.MatchingRoutes(absl::StrCat("/pkg.Service/", i), &scratch);
+  }
+  EXPECT_EQ(&route_matcher.MatchingRoutes("/pkg.Service/Put", &scratch),
+            &scratch);
+  EXPECT_THAT(scratch, ::testing::ElementsAreArray(
+                           LinearScan(matchers, "/pkg.Service/Put")));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/impl/codegen/log.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/client_callback.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+
+// Count every C++ heap allocation made by the process, so that the test can
+// check how many the unary path makes.
+static std::atomic<int64_t> g_allocation_count{0};
+
+void* operator new(std::size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, std::size_t /*size*/) noexcept { free(p); }
+
+namespace grpc {
+namespace testing {
+namespace {
+
+// Finishes every call right away, so that the only objects involved are the
+// ones the library creates for the call.
+class FinishingService : public EchoTestService::CallbackService {
+ public:
+  ServerUnaryReactor* Echo(CallbackServerContext* context,
+                           const EchoRequest* /*request*/,
+                           EchoResponse* /*response*/) override {
+    ServerUnaryReactor* reactor = context->DefaultReactor();
+    reactor->Finish(Status::OK);
+    return reactor;
+  }
+};
+
+class WaitingReactor : public ClientUnaryReactor {
+ public:
+  void OnDone(const Status& s) override {
+    std::lock_guard<std::mutex> l(mu_);
+    status_ = s;
+    done_ = true;
+    cv_.notify_one();
+  }
+
+  Status Await() {
+    std::unique_lock<std::mutex> l(mu_);
+    while (!done_) {
+      cv_.wait(l);
+    }
+    return status_;
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool done_ = false;
+  Status status_;
+};
+
+class CallbackAllocationEnd2endTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { grpc_init(); }
+  static void TearDownTestCase() { grpc_shutdown(); }
+
+  void SetUp() override {
+    ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    ChannelArguments args;
+    stub_ = EchoTestService::NewStub(server_->InProcessChannel(args));
+  }
+
+  void TearDown() override { server_->Shutdown(); }
+
+  void SendRpcs(int num_rpcs) {
+    EchoRequest request;
+    for (int i = 0; i < num_rpcs; i++) {
+      EchoResponse response;
+      ClientContext cli_ctx;
+      WaitingReactor reactor;
+      stub_->experimental_async()->Echo(&cli_ctx, &request, &response,
+                                        &reactor);
+      reactor.StartCall();
+      EXPECT_TRUE(reactor.Await().ok());
+    }
+  }
+
+  FinishingService service_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+TEST_F(CallbackAllocationEnd2endTest, UnaryRpcDoesNotAllocate) {
+  // The first calls fill the channel's call arena pool and any lazily built
+  // state.
+  SendRpcs(100);
+  const int kRpcCount = 1000;
+  const int64_t before = g_allocation_count.load();
+  SendRpcs(kRpcCount);
+  const int64_t allocations = g_allocation_count.load() - before;
+  gpr_log(GPR_INFO, "%" PRId64 " allocations for %d RPCs", allocations,
+          kRpcCount);
+  EXPECT_EQ(allocations, 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  int ret = RUN_ALL_TESTS();
+  return ret;
+}
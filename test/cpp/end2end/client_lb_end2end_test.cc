@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <random>
 #include <set>
 #include <string>
@@ -1636,6 +1637,159 @@ TEST_F(ClientLbEnd2endTest,
   EnableDefaultHealthCheckService(false);
 }
 
+TEST_F(ClientLbEnd2endTest, WeightedRoundRobin) {
+  const int kNumServers = 3;
+  const int kNumRpcs = 700;
+  StartServers(kNumServers);
+  // Servers report the same QPS but different CPU utilizations, so their
+  // weights are in the ratio 4:2:1.
+  udpa::data::orca::v1::OrcaLoadReport load_reports[kNumServers];
+  const double kCpuUtilization[kNumServers] = {0.2, 0.4, 0.8};
+  for (size_t i = 0; i < kNumServers; ++i) {
+    load_reports[i].set_rps(100);
+    load_reports[i].set_cpu_utilization(kCpuUtilization[i]);
+    servers_[i]->service_.set_load_report(&load_reports[i]);
+  }
+  const char* kServiceConfigJson =
+      "{\"loadBalancingConfig\": [{\"weighted_round_robin\": {"
+      "\"blackoutPeriod\": \"0s\", \"weightUpdatePeriod\": \"0.1s\"}}]}";
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(), kServiceConfigJson);
+  // Picks are round robin until the backends' weights are known.
+  do {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  } while (!SeenAllServers());
+  // Give the policy time to rebuild its picker from the reported weights.
+  gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(300));
+  auto check_distribution = [&](const std::vector<int>& shares) {
+    ResetCounters();
+    for (size_t i = 0; i < kNumRpcs; ++i) {
+      CheckRpcSendOk(stub, DEBUG_LOCATION);
+    }
+    const int total_shares = std::accumulate(shares.begin(), shares.end(), 0);
+    for (size_t i = 0; i < kNumServers; ++i) {
+      const double expected =
+          static_cast<double>(kNumRpcs) * shares[i] / total_shares;
+      EXPECT_NEAR(servers_[i]->service_.request_count(), expected,
+                  expected * 0.2)
+          << "server " << i;
+    }
+  };
+  check_distribution({4, 2, 1});
+  // Reverse the load.  Each backend's weight changes with its next report.
+  for (size_t i = 0; i < kNumServers; ++i) {
+    load_reports[i].set_cpu_utilization(kCpuUtilization[kNumServers - 1 - i]);
+  }
+  for (size_t i = 0; i < kNumRpcs; ++i) {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  }
+  gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(300));
+  check_distribution({1, 2, 4});
+  // Check LB policy name for the channel.
+  EXPECT_EQ("weighted_round_robin", channel->GetLoadBalancingPolicyName());
+}
+
+TEST_F(ClientLbEnd2endTest, WeightedRoundRobinWithoutLoadReports) {
+  const int kNumServers = 3;
+  const int kNumRpcsPerServer = 10;
+  StartServers(kNumServers);
+  const char* kServiceConfigJson =
+      "{\"loadBalancingConfig\": [{\"weighted_round_robin\": {"
+      "\"blackoutPeriod\": \"0s\"}}]}";
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(), kServiceConfigJson);
+  do {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  } while (!SeenAllServers());
+  // With no weights, every backend gets the same share.
+  ResetCounters();
+  for (size_t i = 0; i < kNumServers * kNumRpcsPerServer; ++i) {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  }
+  for (size_t i = 0; i < kNumServers; ++i) {
+    EXPECT_EQ(kNumRpcsPerServer, servers_[i]->service_.request_count())
+        << "server " << i;
+  }
+}
+
+TEST_F(ClientLbEnd2endTest, RoundRobinWarmup) {
+  const int kNumServers = 3;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_CLIENT_CHANNEL_WARMUP, 1);
+  args.SetInt(GRPC_ARG_LB_WARMUP_READY_PERCENT, 100);
+  auto channel = BuildChannel("round_robin", response_generator, args);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  // The channel connects without an RPC or try_to_connect, and only
+  // reports READY once every backend is connected.
+  EXPECT_TRUE(WaitForChannelState(
+      channel.get(),
+      [](grpc_connectivity_state state) { return state == GRPC_CHANNEL_READY; },
+      /*try_to_connect=*/false));
+  const gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  for (size_t i = 0; i < kNumServers; ++i) {
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+  }
+  gpr_log(GPR_INFO, "first %d RPCs after warm-up took %d ms", kNumServers,
+          gpr_time_to_millis(
+              gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start)));
+  for (size_t i = 0; i < kNumServers; ++i) {
+    EXPECT_EQ(1, servers_[i]->service_.request_count()) << "server " << i;
+  }
+}
+
+TEST_F(ClientLbEnd2endTest, RoundRobinWarmupWithUnreachableBackend) {
+  const int kNumServers = 2;
+  StartServers(kNumServers);
+  std::vector<int> ports = GetServersPorts();
+  ports.push_back(grpc_pick_unused_port_or_die());
+  auto response_generator = BuildResolverResponseGenerator();
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_LB_WARMUP_READY_PERCENT, 100);
+  auto channel = BuildChannel("round_robin", response_generator, args);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(ports);
+  // The backend that cannot connect does not hold up the others.
+  EXPECT_TRUE(WaitForChannelReady(channel.get()));
+  CheckRpcSendOk(stub, DEBUG_LOCATION);
+}
+
+TEST_F(ClientLbEnd2endTest, WarmupThenAllBackendsFail) {
+  const int kNumServers = 3;
+  CreateServers(kNumServers);
+  for (const char* policy :
+       {"round_robin", "least_request", "weighted_round_robin"}) {
+    gpr_log(GPR_INFO, "testing %s", policy);
+    for (size_t i = 0; i < kNumServers; ++i) {
+      StartServer(i);
+    }
+    auto response_generator = BuildResolverResponseGenerator();
+    ChannelArguments args;
+    args.SetInt(GRPC_ARG_LB_WARMUP_READY_PERCENT, 100);
+    auto channel = BuildChannel(policy, response_generator, args);
+    auto stub = BuildStub(channel);
+    response_generator.SetNextResolution(GetServersPorts());
+    EXPECT_TRUE(WaitForChannelReady(channel.get()));
+    CheckRpcSendOk(stub, DEBUG_LOCATION);
+    // Once every subchannel has left READY, the warmed-up list must not
+    // report READY with nothing to pick from.
+    for (size_t i = 0; i < kNumServers; ++i) {
+      servers_[i]->Shutdown();
+    }
+    EXPECT_TRUE(WaitForChannelState(
+        channel.get(), [](grpc_connectivity_state state) {
+          return state == GRPC_CHANNEL_TRANSIENT_FAILURE;
+        }));
+    CheckRpcSendFailure(stub);
+  }
+}
+
 TEST_F(ClientLbEnd2endTest, ChannelIdleness) {
   // Start server.
   const int kNumServers = 1;
@@ -33,6 +33,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
 #include "absl/types/optional.h"
 
 #include <grpc/grpc.h>
@@ -260,14 +261,26 @@ constexpr char kBadClientCertPath[] = "src/core/tsi/test_creds/badclient.pem";
 constexpr char kBadClientKeyPath[] = "src/core/tsi/test_creds/badclient.key";
 
 char* g_bootstrap_file_v3;
+char* g_bootstrap_file_v3_delta;
 char* g_bootstrap_file_v2;
 
+// The v3 bootstrap with the delta protocol enabled.
+const std::string& BootstrapFileV3Delta() {
+  static const std::string* bootstrap = new std::string(absl::StrReplaceAll(
+      kBootstrapFileV3, {{"[\"xds_v3\"]", "[\"xds_v3\", \"xds_delta\"]"}}));
+  return *bootstrap;
+}
+
 void WriteBootstrapFiles() {
   char* bootstrap_file;
   FILE* out = gpr_tmpfile("xds_bootstrap_v3", &bootstrap_file);
   fputs(kBootstrapFileV3, out);
   fclose(out);
   g_bootstrap_file_v3 = bootstrap_file;
+  out = gpr_tmpfile("xds_bootstrap_v3_delta", &bootstrap_file);
+  fputs(BootstrapFileV3Delta().c_str(), out);
+  fclose(out);
+  g_bootstrap_file_v3_delta = bootstrap_file;
   out = gpr_tmpfile("xds_bootstrap_v2", &bootstrap_file);
   fputs(kBootstrapFileV2, out);
   fclose(out);
@@ -517,11 +530,23 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
   };
 
   AdsServiceImpl()
-      : v2_rpc_service_(this, /*is_v2=*/true),
-        v3_rpc_service_(this, /*is_v2=*/false) {}
+      : v2_rpc_service_(this, /*is_v2=*/true), v3_rpc_service_(this) {}
 
   bool seen_v2_client() const { return seen_v2_client_; }
   bool seen_v3_client() const { return seen_v3_client_; }
+  bool seen_delta_client() const { return seen_delta_client_; }
+
+  // Number of resources of the given type sent on delta streams.
+  size_t delta_resources_sent(const std::string& type_url) {
+    grpc_core::MutexLock lock(&ads_mu_);
+    return delta_resources_sent_[type_url];
+  }
+
+  // Number of resource versions reported by clients on new delta streams.
+  size_t delta_initial_resource_versions_received() {
+    grpc_core::MutexLock lock(&ads_mu_);
+    return delta_initial_resource_versions_received_;
+  }
 
   ::envoy::service::discovery::v2::AggregatedDiscoveryService::Service*
   v2_rpc_service() {
@@ -830,7 +855,7 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
       return Status::OK;
     }
 
-   private:
+   protected:
     // Processes a response read from the client.
     // Populates response if needed.
     void ProcessRequest(const DiscoveryRequest& request,
@@ -1058,6 +1083,219 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
     const bool is_v2_;
   };
 
+  // The v3 service, which also speaks the delta protocol.
+  class V3RpcService
+      : public RpcService<
+            ::envoy::service::discovery::v3::AggregatedDiscoveryService,
+            ::envoy::service::discovery::v3::DiscoveryRequest,
+            ::envoy::service::discovery::v3::DiscoveryResponse> {
+   public:
+    using DeltaDiscoveryRequest =
+        ::envoy::service::discovery::v3::DeltaDiscoveryRequest;
+    using DeltaDiscoveryResponse =
+        ::envoy::service::discovery::v3::DeltaDiscoveryResponse;
+    using DeltaStream =
+        ServerReaderWriter<DeltaDiscoveryResponse, DeltaDiscoveryRequest>;
+
+    explicit V3RpcService(AdsServiceImpl* parent)
+        : RpcService(parent, /*is_v2=*/false) {}
+
+    Status DeltaAggregatedResources(ServerContext* context,
+                                    DeltaStream* stream) override {
+      gpr_log(GPR_INFO, "ADS[%p]: DeltaAggregatedResources starts", this);
+      parent_->AddClient(context->peer());
+      parent_->seen_v3_client_ = true;
+      parent_->seen_delta_client_ = true;
+      std::shared_ptr<AdsServiceImpl> ads_service_impl =
+          parent_->shared_from_this();
+      UpdateQueue update_queue;
+      SubscriptionMap subscription_map;
+      // Last nonce sent for each resource type.
+      std::map<std::string /*type_url*/, int> nonce_map;
+      std::deque<DeltaDiscoveryRequest> requests;
+      bool stream_closed = false;
+      std::thread reader([this, stream, &requests, &stream_closed] {
+        DeltaDiscoveryRequest request;
+        while (stream->Read(&request)) {
+          grpc_core::MutexLock lock(&parent_->ads_mu_);
+          requests.emplace_back(std::move(request));
+        }
+        gpr_log(GPR_INFO, "ADS[%p]: Null read, stream closed", this);
+        grpc_core::MutexLock lock(&parent_->ads_mu_);
+        stream_closed = true;
+      });
+      while (true) {
+        bool did_work = false;
+        absl::optional<DeltaDiscoveryResponse> response;
+        {
+          grpc_core::MutexLock lock(&parent_->ads_mu_);
+          if (stream_closed || parent_->ads_done_) break;
+          if (!requests.empty()) {
+            DeltaDiscoveryRequest request = std::move(requests.front());
+            requests.pop_front();
+            did_work = true;
+            gpr_log(GPR_INFO,
+                    "ADS[%p]: Received delta request for type %s with content "
+                    "%s",
+                    this, request.type_url().c_str(),
+                    request.DebugString().c_str());
+            ProcessDeltaRequest(request, &update_queue, &subscription_map,
+                                &nonce_map[request.type_url()], &response);
+          } else if (!update_queue.empty()) {
+            const std::string resource_type =
+                std::move(update_queue.front().first);
+            const std::string resource_name =
+                std::move(update_queue.front().second);
+            update_queue.pop_front();
+            did_work = true;
+            ProcessDeltaUpdate(resource_type, resource_name, subscription_map,
+                               &nonce_map[resource_type], &response);
+          }
+        }
+        if (response.has_value()) {
+          gpr_log(GPR_INFO, "ADS[%p]: Sending delta response: %s", this,
+                  response->DebugString().c_str());
+          stream->Write(response.value());
+        }
+        gpr_timespec deadline =
+            grpc_timeout_milliseconds_to_deadline(did_work ? 0 : 10);
+        {
+          grpc_core::MutexLock lock(&parent_->ads_mu_);
+          if (!grpc_core::WaitUntilWithDeadline(
+                  &parent_->ads_cond_, &parent_->ads_mu_,
+                  [this] { return parent_->ads_done_; },
+                  grpc_core::ToAbslTime(deadline))) {
+            break;
+          }
+        }
+      }
+      reader.join();
+      {
+        grpc_core::MutexLock lock(&parent_->ads_mu_);
+        for (auto& p : subscription_map) {
+          ResourceNameMap& resource_name_map =
+              parent_->resource_map_[p.first].resource_name_map;
+          for (auto& q : p.second) {
+            resource_name_map[q.first].subscriptions.erase(&q.second);
+          }
+        }
+      }
+      gpr_log(GPR_INFO, "ADS[%p]: DeltaAggregatedResources done", this);
+      parent_->RemoveClient(context->peer());
+      return Status::OK;
+    }
+
+   private:
+    void ProcessDeltaRequest(const DeltaDiscoveryRequest& request,
+                             UpdateQueue* update_queue,
+                             SubscriptionMap* subscription_map, int* nonce,
+                             absl::optional<DeltaDiscoveryResponse>* response) {
+      const std::string& type_url = request.type_url();
+      // Check for ACK or NACK.
+      if (!request.response_nonce().empty()) {
+        int client_nonce;
+        GPR_ASSERT(absl::SimpleAtoi(request.response_nonce(), &client_nonce));
+        auto it = parent_->resource_type_response_state_.find(type_url);
+        if (client_nonce == *nonce &&
+            it != parent_->resource_type_response_state_.end()) {
+          if (!request.has_error_detail()) {
+            it->second.state = ResponseState::ACKED;
+            it->second.error_message.clear();
+          } else {
+            it->second.state = ResponseState::NACKED;
+            EXPECT_EQ(request.error_detail().code(),
+                      GRPC_STATUS_INVALID_ARGUMENT);
+            it->second.error_message = request.error_detail().message();
+          }
+        }
+      }
+      parent_->delta_initial_resource_versions_received_ +=
+          request.initial_resource_versions_size();
+      if (parent_->resource_types_to_ignore_.find(type_url) !=
+          parent_->resource_types_to_ignore_.end()) {
+        return;
+      }
+      auto& subscription_name_map = (*subscription_map)[type_url];
+      auto& resource_name_map =
+          parent_->resource_map_[type_url].resource_name_map;
+      for (const std::string& resource_name :
+           request.resource_names_subscribe()) {
+        auto& resource_state = resource_name_map[resource_name];
+        if (!parent_->MaybeSubscribe(type_url, resource_name,
+                                     &subscription_name_map[resource_name],
+                                     &resource_state, update_queue) ||
+            !resource_state.resource.has_value()) {
+          continue;
+        }
+        // Don't re-send resources the client already has.
+        auto it = request.initial_resource_versions().find(resource_name);
+        if (it != request.initial_resource_versions().end() &&
+            it->second ==
+                std::to_string(resource_state.resource_type_version)) {
+          continue;
+        }
+        AddDeltaResource(resource_name, resource_state, response);
+      }
+      if (request.resource_names_unsubscribe_size() > 0) {
+        std::set<std::string> remaining;
+        for (const auto& p : subscription_name_map) remaining.insert(p.first);
+        for (const std::string& resource_name :
+             request.resource_names_unsubscribe()) {
+          remaining.erase(resource_name);
+        }
+        parent_->ProcessUnsubscriptions(type_url, remaining,
+                                        &subscription_name_map,
+                                        &resource_name_map);
+      }
+      if (response->has_value()) {
+        CompleteDeltaResponse(type_url, nonce, &response->value());
+      }
+    }
+
+    void ProcessDeltaUpdate(const std::string& type_url,
+                            const std::string& resource_name,
+                            const SubscriptionMap& subscription_map,
+                            int* nonce,
+                            absl::optional<DeltaDiscoveryResponse>* response) {
+      auto it = subscription_map.find(type_url);
+      if (it == subscription_map.end() ||
+          it->second.find(resource_name) == it->second.end()) {
+        return;
+      }
+      const ResourceState& resource_state =
+          parent_->resource_map_[type_url].resource_name_map[resource_name];
+      response->emplace();
+      if (resource_state.resource.has_value()) {
+        AddDeltaResource(resource_name, resource_state, response);
+      } else {
+        (*response)->add_removed_resources(resource_name);
+      }
+      CompleteDeltaResponse(type_url, nonce, &response->value());
+    }
+
+    static void AddDeltaResource(
+        const std::string& resource_name, const ResourceState& resource_state,
+        absl::optional<DeltaDiscoveryResponse>* response) {
+      if (!response->has_value()) response->emplace();
+      auto* resource = (*response)->add_resources();
+      resource->set_name(resource_name);
+      resource->set_version(
+          std::to_string(resource_state.resource_type_version));
+      *resource->mutable_resource() = resource_state.resource.value();
+    }
+
+    void CompleteDeltaResponse(const std::string& type_url, int* nonce,
+                               DeltaDiscoveryResponse* response) {
+      auto& response_state = parent_->resource_type_response_state_[type_url];
+      if (response_state.state == ResponseState::NOT_SENT) {
+        response_state.state = ResponseState::SENT;
+      }
+      response->set_type_url(type_url);
+      response->set_nonce(std::to_string(++*nonce));
+      parent_->delta_resources_sent_[type_url] += response->resources_size();
+    }
+  };
+
   // Checks whether the client needs to receive a newer version of
   // the resource.
   static bool ClientNeedsResourceUpdate(
@@ -1132,13 +1370,11 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
              ::envoy::api::v2::DiscoveryRequest,
              ::envoy::api::v2::DiscoveryResponse>
       v2_rpc_service_;
-  RpcService<::envoy::service::discovery::v3::AggregatedDiscoveryService,
-             ::envoy::service::discovery::v3::DiscoveryRequest,
-             ::envoy::service::discovery::v3::DiscoveryResponse>
-      v3_rpc_service_;
+  V3RpcService v3_rpc_service_;
 
   std::atomic_bool seen_v2_client_{false};
   std::atomic_bool seen_v3_client_{false};
+  std::atomic_bool seen_delta_client_{false};
 
   grpc_core::CondVar ads_cond_;
   // Protect the members below.
@@ -1148,6 +1384,8 @@ class AdsServiceImpl : public std::enable_shared_from_this<AdsServiceImpl> {
       resource_type_response_state_;
   std::set<std::string /*resource_type*/> resource_types_to_ignore_;
   std::map<std::string /*resource_type*/, int> resource_type_min_versions_;
+  std::map<std::string /*resource_type*/, size_t> delta_resources_sent_;
+  size_t delta_initial_resource_versions_received_ = 0;
   // An instance data member containing the current state of all resources.
   // Note that an entry will exist whenever either of the following is true:
   // - The resource exists (i.e., has been created by SetResource() and has not
@@ -1356,6 +1594,11 @@ class TestType {
     return *this;
   }
 
+  TestType& set_use_delta() {
+    use_delta_ = true;
+    return *this;
+  }
+
   TestType& set_use_xds_credentials() {
     use_xds_credentials_ = true;
     return *this;
@@ -1380,14 +1623,30 @@ class TestType {
   bool enable_load_reporting() const { return enable_load_reporting_; }
   bool enable_rds_testing() const { return enable_rds_testing_; }
   bool use_v2() const { return use_v2_; }
+  bool use_delta() const { return use_delta_; }
   bool use_xds_credentials() const { return use_xds_credentials_; }
   bool use_csds_streaming() const { return use_csds_streaming_; }
   FilterConfigSetup filter_config_setup() const { return filter_config_setup_; }
   BootstrapSource bootstrap_source() const { return bootstrap_source_; }
 
+  // Returns the bootstrap contents matching the xDS protocol under test.
+  const char* bootstrap_contents() const {
+    if (use_v2_) return kBootstrapFileV2;
+    if (use_delta_) return BootstrapFileV3Delta().c_str();
+    return kBootstrapFileV3;
+  }
+
+  // Returns the path of the bootstrap file written by WriteBootstrapFiles().
+  const char* bootstrap_file() const {
+    if (use_v2_) return g_bootstrap_file_v2;
+    if (use_delta_) return g_bootstrap_file_v3_delta;
+    return g_bootstrap_file_v3;
+  }
+
   std::string AsString() const {
     std::string retval = (use_fake_resolver_ ? "FakeResolver" : "XdsResolver");
     retval += (use_v2_ ? "V2" : "V3");
+    if (use_delta_) retval += "Delta";
     if (enable_load_reporting_) retval += "WithLoadReporting";
     if (enable_rds_testing_) retval += "Rds";
     if (use_xds_credentials_) retval += "XdsCreds";
@@ -1408,6 +1667,7 @@ class TestType {
   bool enable_load_reporting_ = false;
   bool enable_rds_testing_ = false;
   bool use_v2_ = false;
+  bool use_delta_ = false;
   bool use_xds_credentials_ = false;
   bool use_csds_streaming_ = false;
   FilterConfigSetup filter_config_setup_ = kHTTPConnectionManagerOriginal;
@@ -1753,12 +2013,9 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
     // the contents here.  That would allow us to use an ipv4: or ipv6:
     // URI for the xDS server instead of using the fake resolver.
     if (GetParam().bootstrap_source() == TestType::kBootstrapFromEnvVar) {
-      gpr_setenv("GRPC_XDS_BOOTSTRAP_CONFIG",
-                 GetParam().use_v2() ? kBootstrapFileV2 : kBootstrapFileV3);
+      gpr_setenv("GRPC_XDS_BOOTSTRAP_CONFIG", GetParam().bootstrap_contents());
     } else if (GetParam().bootstrap_source() == TestType::kBootstrapFromFile) {
-      gpr_setenv("GRPC_XDS_BOOTSTRAP", GetParam().use_v2()
-                                           ? g_bootstrap_file_v2
-                                           : g_bootstrap_file_v3);
+      gpr_setenv("GRPC_XDS_BOOTSTRAP", GetParam().bootstrap_file());
     }
     if (GetParam().bootstrap_source() != TestType::kBootstrapFromChannelArg) {
       // If getting bootstrap from channel arg, we'll pass these args in
@@ -1840,7 +2097,7 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
       // same thing for the response generator to use for the xDS
       // channel and the xDS resource-does-not-exist timeout value.
       args.SetString(GRPC_ARG_TEST_ONLY_DO_NOT_USE_IN_PROD_XDS_BOOTSTRAP_CONFIG,
-                     GetParam().use_v2() ? kBootstrapFileV2 : kBootstrapFileV3);
+                     GetParam().bootstrap_contents());
       if (xds_channel_args == nullptr) xds_channel_args = &xds_channel_args_;
       args.SetPointerWithVtable(
           GRPC_ARG_TEST_ONLY_DO_NOT_USE_IN_PROD_XDS_CLIENT_CHANNEL_ARGS,
@@ -2448,7 +2705,7 @@ class XdsEnd2endTest : public ::testing::TestWithParam<TestType> {
       void UpdateArguments(grpc::ChannelArguments* args) override {
         args->SetString(
             GRPC_ARG_TEST_ONLY_DO_NOT_USE_IN_PROD_XDS_BOOTSTRAP_CONFIG,
-            GetParam().use_v2() ? kBootstrapFileV2 : kBootstrapFileV3);
+            GetParam().bootstrap_contents());
         args->SetPointerWithVtable(
             GRPC_ARG_TEST_ONLY_DO_NOT_USE_IN_PROD_XDS_CLIENT_CHANNEL_ARGS,
             &test_obj_->xds_channel_args_, &kChannelArgsArgVtable);
@@ -3217,6 +3474,109 @@ TEST_P(XdsResolverOnlyTest, ClusterChangeAfterAdsCallFails) {
   WaitForBackend(1, WaitForBackendOptions().set_allow_failures(true));
 }
 
+using XdsDeltaTest = BasicTest;
+
+// Tests that the client speaks the delta protocol when enabled.
+TEST_P(XdsDeltaTest, Vanilla) {
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  AdsServiceImpl::EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends()},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends();
+  EXPECT_TRUE(balancers_[0]->ads_service()->seen_delta_client());
+  EXPECT_EQ(balancers_[0]->ads_service()->lds_response_state().state,
+            AdsServiceImpl::ResponseState::ACKED);
+  EXPECT_EQ(balancers_[0]->ads_service()->cds_response_state().state,
+            AdsServiceImpl::ResponseState::ACKED);
+  // The EDS ACK can reach the server after the RPCs above complete.
+  for (int i = 0; i < 100; ++i) {
+    if (balancers_[0]->ads_service()->eds_response_state().state ==
+        AdsServiceImpl::ResponseState::ACKED) {
+      break;
+    }
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+  }
+  EXPECT_EQ(balancers_[0]->ads_service()->eds_response_state().state,
+            AdsServiceImpl::ResponseState::ACKED);
+}
+
+// Tests that an update to one resource does not resend the others.
+TEST_P(XdsDeltaTest, OnlyChangedResourcesAreSent) {
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  AdsServiceImpl::EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends(0, 1)},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends(0, 1);
+  const size_t lds_sent =
+      balancers_[0]->ads_service()->delta_resources_sent(kLdsTypeUrl);
+  const size_t cds_sent =
+      balancers_[0]->ads_service()->delta_resources_sent(kCdsTypeUrl);
+  const size_t eds_sent =
+      balancers_[0]->ads_service()->delta_resources_sent(kEdsTypeUrl);
+  args = AdsServiceImpl::EdsResourceArgs({
+      {"locality0", CreateEndpointsForBackends(1, 2)},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends(1, 2);
+  EXPECT_EQ(balancers_[0]->ads_service()->delta_resources_sent(kEdsTypeUrl),
+            eds_sent + 1);
+  EXPECT_EQ(balancers_[0]->ads_service()->delta_resources_sent(kLdsTypeUrl),
+            lds_sent);
+  EXPECT_EQ(balancers_[0]->ads_service()->delta_resources_sent(kCdsTypeUrl),
+            cds_sent);
+}
+
+// Tests that a removal sent in removed_resources is honored.
+TEST_P(XdsDeltaTest, ClusterRemoved) {
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  AdsServiceImpl::EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends()},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends();
+  // Unset CDS resource.
+  balancers_[0]->ads_service()->UnsetResource(kCdsTypeUrl, kDefaultClusterName);
+  // Wait for RPCs to start failing.
+  do {
+  } while (SendRpc(RpcOptions(), nullptr).ok());
+  // Make sure RPCs are still failing.
+  CheckRpcSendFailure(1000);
+  EXPECT_EQ(balancers_[0]->ads_service()->cds_response_state().state,
+            AdsServiceImpl::ResponseState::ACKED);
+}
+
+// Tests that on reconnection the client reports the versions it has
+// cached, so that unchanged resources are not sent again.
+TEST_P(XdsDeltaTest, ReconnectReportsResourceVersions) {
+  SetNextResolution({});
+  SetNextResolutionForLbChannelAllBalancers();
+  AdsServiceImpl::EdsResourceArgs args({
+      {"locality0", CreateEndpointsForBackends(0, 1)},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  WaitForAllBackends(0, 1);
+  const size_t cds_sent =
+      balancers_[0]->ads_service()->delta_resources_sent(kCdsTypeUrl);
+  balancers_[0]->Shutdown();
+  args = AdsServiceImpl::EdsResourceArgs({
+      {"locality0", CreateEndpointsForBackends(1, 2)},
+  });
+  balancers_[0]->ads_service()->SetEdsResource(BuildEdsResource(args));
+  balancers_[0]->Start();
+  WaitForAllBackends(1, 2);
+  EXPECT_GT(balancers_[0]
+                ->ads_service()
+                ->delta_initial_resource_versions_received(),
+            0u);
+  EXPECT_EQ(balancers_[0]->ads_service()->delta_resources_sent(kCdsTypeUrl),
+            cds_sent);
+}
+
 using GlobalXdsClientTest = BasicTest;
 
 TEST_P(GlobalXdsClientTest, MultipleChannelsShareXdsClient) {
@@ -11474,6 +11834,13 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(TestType(), TestType().set_enable_load_reporting()),
     &TestTypeName);
 
+// Delta xDS is v3 only.
+INSTANTIATE_TEST_SUITE_P(
+    XdsTest, XdsDeltaTest,
+    ::testing::Values(TestType().set_use_delta(),
+                      TestType().set_use_delta().set_enable_rds_testing()),
+    &TestTypeName);
+
 // Runs with bootstrap from env var, so that there's a global XdsClient.
 INSTANTIATE_TEST_SUITE_P(
     XdsTest, GlobalXdsClientTest,
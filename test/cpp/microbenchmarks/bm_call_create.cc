@@ -602,6 +602,105 @@ BENCHMARK_TEMPLATE(BM_IsolatedFilter, MessageSizeFilter, SendEmptyMetadata);
 // BENCHMARK_TEMPLATE(BM_IsolatedFilter, LoadReportingFilter,
 // SendEmptyMetadata);
 
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks dispatching a batch down a stack of filters that mostly pass it
+// through
+
+namespace passthrough_filters {
+
+// Passes every batch straight down.
+static const grpc_channel_filter passthrough_filter = {
+    grpc_call_next_op,
+    phony_filter::StartTransportOp,
+    0,
+    phony_filter::InitCallElem,
+    phony_filter::SetPollsetOrPollsetSet,
+    phony_filter::DestroyCallElem,
+    0,
+    phony_filter::InitChannelElem,
+    phony_filter::DestroyChannelElem,
+    phony_filter::GetChannelInfo,
+    "passthrough_filter"};
+
+static void RecvOnlyStartTransportStreamOp(grpc_call_element* elem,
+                                           grpc_transport_stream_op_batch* op) {
+  if (op->recv_message) {
+    benchmark::DoNotOptimize(op->payload->recv_message.recv_message);
+  }
+  grpc_call_next_op(elem, op);
+}
+
+// Only looks at recv_message, and declares so.
+static const grpc_channel_filter recv_only_filter = {
+    RecvOnlyStartTransportStreamOp,
+    phony_filter::StartTransportOp,
+    0,
+    phony_filter::InitCallElem,
+    phony_filter::SetPollsetOrPollsetSet,
+    phony_filter::DestroyCallElem,
+    0,
+    phony_filter::InitChannelElem,
+    phony_filter::DestroyChannelElem,
+    phony_filter::GetChannelInfo,
+    "recv_only_filter"};
+
+}  // namespace passthrough_filters
+
+// Sends a send_message batch down eight filters that do not act on it, with
+// GRPC_ARG_SKIP_PASSTHROUGH_FILTERS set to state.range(0).
+static void BM_PassthroughFilterDispatch(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_channel_filter_register_handled_ops(
+      &passthrough_filters::recv_only_filter, GRPC_STREAM_OP_RECV_MESSAGE);
+  std::vector<const grpc_channel_filter*> filters;
+  for (int i = 0; i < 4; i++) {
+    filters.push_back(&passthrough_filters::passthrough_filter);
+    filters.push_back(&passthrough_filters::recv_only_filter);
+  }
+  filters.push_back(&phony_filter::phony_filter);
+  grpc_arg arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_SKIP_PASSTHROUGH_FILTERS), state.range(0));
+  grpc_channel_args channel_args = {1, &arg};
+  grpc_channel_stack* channel_stack = static_cast<grpc_channel_stack*>(
+      gpr_zalloc(grpc_channel_stack_size(&filters[0], filters.size())));
+  GPR_ASSERT(GRPC_LOG_IF_ERROR(
+      "channel_stack_init",
+      grpc_channel_stack_init(1, FilterDestroy, channel_stack, &filters[0],
+                              filters.size(), &channel_args, nullptr,
+                              "CHANNEL", channel_stack)));
+  grpc_call_stack* call_stack =
+      static_cast<grpc_call_stack*>(gpr_zalloc(channel_stack->call_stack_size));
+  grpc_slice method = grpc_slice_from_static_string("/foo/bar");
+  grpc_call_context_element context[GRPC_CONTEXT_COUNT] = {};
+  grpc_call_element_args call_args{call_stack,
+                                   nullptr,
+                                   context,
+                                   method,
+                                   gpr_get_cycle_counter(),
+                                   GRPC_MILLIS_INF_FUTURE,
+                                   nullptr,
+                                   nullptr};
+  GRPC_ERROR_UNREF(
+      grpc_call_stack_init(channel_stack, 1, DoNothing, nullptr, &call_args));
+  grpc_transport_stream_op_batch_payload payload(nullptr);
+  grpc_transport_stream_op_batch op = {};
+  op.send_message = true;
+  op.payload = &payload;
+  grpc_call_element* top = grpc_call_stack_element(call_stack, 0);
+  for (auto _ : state) {
+    top->filter->start_transport_stream_op_batch(top, &op);
+  }
+  grpc_call_final_info final_info;
+  grpc_call_stack_destroy(call_stack, &final_info, nullptr);
+  grpc_channel_stack_destroy(channel_stack);
+  grpc_core::ExecCtx::Get()->Flush();
+  gpr_free(channel_stack);
+  gpr_free(call_stack);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_PassthroughFilterDispatch)->Arg(0)->Arg(1);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Benchmarks isolating grpc_call
 
@@ -686,7 +785,7 @@ static const grpc_channel_filter isolated_call_filter = {
 
 class IsolatedCallFixture : public TrackCounters {
  public:
-  IsolatedCallFixture() {
+  explicit IsolatedCallFixture(const grpc_channel_args* args = nullptr) {
     // We are calling grpc_channel_stack_builder_create() instead of
     // grpc_channel_create() here, which means we're not getting the
     // grpc_init() called by grpc_channel_create(), but we are getting
@@ -701,6 +800,7 @@ class IsolatedCallFixture : public TrackCounters {
         nullptr));
     {
       grpc_core::ExecCtx exec_ctx;
+      grpc_channel_stack_builder_set_channel_arguments(builder, args);
       channel_ = grpc_channel_create_with_builder(builder, GRPC_CLIENT_CHANNEL);
     }
     cq_ = grpc_completion_queue_create_for_next(nullptr);
@@ -735,6 +835,25 @@ static void BM_IsolatedCall_NoOp(benchmark::State& state) {
 }
 BENCHMARK(BM_IsolatedCall_NoOp);
 
+// Arg: number of call arenas the channel may keep for reuse.
+static void BM_IsolatedCall_ArenaPool(benchmark::State& state) {
+  grpc_arg arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_CALL_ARENA_POOL_SIZE), state.range(0));
+  grpc_channel_args args = {1, &arg};
+  IsolatedCallFixture fixture(&args);
+  gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
+  void* method_hdl = grpc_channel_register_call(fixture.channel(), "/foo/bar",
+                                                nullptr, nullptr);
+  for (auto _ : state) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    grpc_call_unref(grpc_channel_create_registered_call(
+        fixture.channel(), nullptr, GRPC_PROPAGATE_DEFAULTS, fixture.cq(),
+        method_hdl, deadline, nullptr));
+  }
+  fixture.Finish(state);
+}
+BENCHMARK(BM_IsolatedCall_ArenaPool)->Arg(0)->Arg(4);
+
 static void BM_IsolatedCall_Unary(benchmark::State& state) {
   IsolatedCallFixture fixture;
   gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
@@ -101,6 +101,11 @@ BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcess, NoOpMutator,
 BENCHMARK_TEMPLATE(BM_CallbackUnaryPingPong, InProcess, NoOpMutator,
                    Server_AddInitialMetadata<RandomAsciiMetadata<10>, 100>)
     ->Args({0, 0});
+
+// Unary calls from many threads sharing one load-balanced channel
+BENCHMARK_TEMPLATE(BM_CallbackUnaryConcurrentPicks, TCP)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
 }  // namespace testing
 }  // namespace grpc
 
@@ -21,9 +21,11 @@
 #include <benchmark/benchmark.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/time.h>
 #include <string.h>
 #include <memory>
 #include <sstream>
+#include <string>
 
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
@@ -109,7 +111,9 @@ static void BM_HpackEncoderEncodeDeadline(benchmark::State& state) {
 }
 BENCHMARK(BM_HpackEncoderEncodeDeadline);
 
-template <class Fixture>
+// kExactIndex selects the encoder's exact-index mode
+// (grpc_chttp2_hpack_compressor_enable_exact_index).
+template <class Fixture, bool kExactIndex = false>
 static void BM_HpackEncoderEncodeHeader(benchmark::State& state) {
   TrackCounters track_counters;
   grpc_core::ExecCtx exec_ctx;
@@ -119,7 +123,10 @@ static void BM_HpackEncoderEncodeHeader(benchmark::State& state) {
   grpc_metadata_batch_init(&b);
   std::vector<grpc_mdelem> elems = Fixture::GetElems();
   std::vector<grpc_linked_mdelem> storage(elems.size());
+  size_t raw_bytes_per_iter = 0;
   for (size_t i = 0; i < elems.size(); i++) {
+    raw_bytes_per_iter += GRPC_SLICE_LENGTH(GRPC_MDKEY(elems[i])) +
+                          GRPC_SLICE_LENGTH(GRPC_MDVALUE(elems[i]));
     GPR_ASSERT(GRPC_LOG_IF_ERROR(
         "addmd", grpc_metadata_batch_add_tail(&b, &storage[i], elems[i])));
   }
@@ -127,10 +134,14 @@ static void BM_HpackEncoderEncodeHeader(benchmark::State& state) {
   std::unique_ptr<grpc_chttp2_hpack_compressor> c(
       new grpc_chttp2_hpack_compressor);
   grpc_chttp2_hpack_compressor_init(c.get());
+  if (kExactIndex) {
+    grpc_chttp2_hpack_compressor_enable_exact_index(c.get());
+  }
   grpc_transport_one_way_stats stats;
   stats = {};
   grpc_slice_buffer outbuf;
   grpc_slice_buffer_init(&outbuf);
+  const gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
   while (state.KeepRunning()) {
     static constexpr int kEnsureMaxFrameAtLeast = 2;
     grpc_encode_header_options hopt = {
@@ -152,6 +163,8 @@ static void BM_HpackEncoderEncodeHeader(benchmark::State& state) {
     grpc_slice_buffer_reset_and_unref_internal(&outbuf);
     grpc_core::ExecCtx::Get()->Flush();
   }
+  const gpr_timespec elapsed =
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start);
   grpc_metadata_batch_destroy(&b);
   grpc_chttp2_hpack_compressor_destroy(c.get());
   grpc_slice_buffer_destroy_internal(&outbuf);
@@ -163,6 +176,16 @@ static void BM_HpackEncoderEncodeHeader(benchmark::State& state) {
         << " header_bytes/iter:"
         << (static_cast<double>(stats.header_bytes) /
             static_cast<double>(state.iterations()));
+  if (!elems.empty()) {
+    // encoded_ratio: bytes on the wire per byte of key+value.
+    label << " encoded_ratio:"
+          << (static_cast<double>(stats.header_bytes) /
+              static_cast<double>(raw_bytes_per_iter * state.iterations()))
+          << " ns/header:"
+          << ((static_cast<double>(elapsed.tv_sec) * GPR_NS_PER_SEC +
+               static_cast<double>(elapsed.tv_nsec)) /
+              static_cast<double>(elems.size() * state.iterations()));
+  }
   track_counters.AddLabel(label.str());
   track_counters.Finish(state);
 }
@@ -337,6 +360,24 @@ class RepresentativeServerTrailingMetadata {
   }
 };
 
+// More distinct interned headers than fit in the default 4096 byte dynamic
+// table, to exercise the encoder's indexing and admission policies.
+class ManyInternedElems {
+ public:
+  static constexpr bool kEnableTrueBinary = false;
+  static std::vector<grpc_mdelem> GetElems() {
+    std::vector<grpc_mdelem> out;
+    for (int i = 0; i < 96; i++) {
+      std::string key = "x-header-" + std::to_string(i);
+      std::string value = "value-" + std::to_string(i);
+      out.push_back(grpc_mdelem_from_slices(
+          grpc_slice_intern(grpc_slice_from_copied_string(key.c_str())),
+          grpc_slice_intern(grpc_slice_from_copied_string(value.c_str()))));
+    }
+    return out;
+  }
+};
+
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, EmptyBatch)->Args({0, 16384});
 // test with eof (shouldn't affect anything)
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, EmptyBatch)->Args({1, 16384});
@@ -424,6 +465,24 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    RepresentativeServerTrailingMetadata)
     ->Args({1, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, ManyInternedElems)
+    ->Args({0, 16384});
+
+// the same fixtures with the encoder in exact-index mode
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   SingleInternedBinaryElem<31, false>, true)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   RepresentativeClientInitialMetadata, true)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   MoreRepresentativeClientInitialMetadata, true)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   RepresentativeServerInitialMetadata, true)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, ManyInternedElems, true)
+    ->Args({0, 16384});
 
 }  // namespace hpack_encoder_fixtures
 
@@ -457,7 +516,11 @@ static grpc_error_handle UnrefHeader(void* /*user_data*/, grpc_mdelem md) {
   return GRPC_ERROR_NONE;
 }
 
-template <class Fixture, grpc_error_handle (*OnHeader)(void*, grpc_mdelem)>
+// With kBlockPerIteration, each iteration's slices are parsed as a header block
+// of their own (as the transport delimits them), which lets the parser reuse
+// the leading indexed fields of the previous block.
+template <class Fixture, grpc_error_handle (*OnHeader)(void*, grpc_mdelem),
+          bool kBlockPerIteration = false>
 static void BM_HpackParserParseHeader(benchmark::State& state) {
   TrackCounters track_counters;
   grpc_core::ExecCtx exec_ctx;
@@ -472,6 +535,10 @@ static void BM_HpackParserParseHeader(benchmark::State& state) {
     GPR_ASSERT(GRPC_ERROR_NONE == grpc_chttp2_hpack_parser_parse(&p, slice));
   }
   while (state.KeepRunning()) {
+    if (kBlockPerIteration) {
+      // what grpc_chttp2_header_parser_parse does at the end of a block
+      p.dynamic_table_update_allowed = 2;
+    }
     for (auto slice : benchmark_slices) {
       GPR_ASSERT(GRPC_ERROR_NONE == grpc_chttp2_hpack_parser_parse(&p, slice));
     }
@@ -929,6 +996,15 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerInitialMetadata, OnInitialHeader);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, SameDeadline, OnHeaderTimeout);
+// one header block per iteration, hitting the repeated indexed prefix path
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   RepresentativeClientInitialMetadata, UnrefHeader, true);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   MoreRepresentativeClientInitialMetadata, UnrefHeader, true);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   RepresentativeServerInitialMetadata, UnrefHeader, true);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   RepresentativeServerInitialMetadata, OnInitialHeader, true);
 
 }  // namespace hpack_parser_fixtures
 
@@ -23,6 +23,7 @@
 #include <sstream>
 
 #include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/iomgr/call_combiner.h"
 #include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/combiner.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
@@ -347,6 +348,42 @@ static void BM_ClosureSched4OnTwoCombiners(benchmark::State& state) {
 }
 BENCHMARK(BM_ClosureSched4OnTwoCombiners);
 
+static void StopCallCombiner(void* arg, grpc_error_handle /*error*/) {
+  GRPC_CALL_COMBINER_STOP(static_cast<grpc_core::CallCombiner*>(arg),
+                          "benchmark");
+}
+
+static void BM_ClosureSchedOnCallCombiner(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::CallCombiner call_combiner;
+  grpc_closure c;
+  GRPC_CLOSURE_INIT(&c, StopCallCombiner, &call_combiner, nullptr);
+  grpc_core::ExecCtx exec_ctx;
+  for (auto _ : state) {
+    GRPC_CALL_COMBINER_START(&call_combiner, &c, GRPC_ERROR_NONE, "benchmark");
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_ClosureSchedOnCallCombiner);
+
+static void BM_ClosureRunInlineOnCallCombiner(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::CallCombiner call_combiner;
+  grpc_closure c;
+  GRPC_CLOSURE_INIT(&c, StopCallCombiner, &call_combiner, nullptr);
+  grpc_core::ExecCtx exec_ctx;
+  for (auto _ : state) {
+    GRPC_CALL_COMBINER_START_INLINE(&call_combiner, &c, GRPC_ERROR_NONE,
+                                    "benchmark");
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_ClosureRunInlineOnCallCombiner);
+
 // Helper that continuously reschedules the same closure against something until
 // the benchmark is complete
 class Rescheduler {
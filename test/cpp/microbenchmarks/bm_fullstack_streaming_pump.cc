@@ -53,6 +53,17 @@ BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, MinTCP)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, MinUDS)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, MinInProcess)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, MinInProcessCHTTP2)->Arg(0);
+BENCHMARK_TEMPLATE(BM_PumpManySlowConsumerStreams, TCP)
+    ->Args({10000, 0})
+    ->Args({10000, 16 * 1024 * 1024});
+BENCHMARK_TEMPLATE(BM_PumpManySlowConsumerStreams, InProcessCHTTP2)
+    ->Args({10000, 0})
+    ->Args({10000, 16 * 1024 * 1024});
+BENCHMARK_TEMPLATE(BM_PumpStreamsAcrossConnections, TCP)
+    ->Args({64, 1})
+    ->Args({64, 2})
+    ->Args({64, 4})
+    ->Args({64, 8});
 
 }  // namespace testing
 }  // namespace grpc
@@ -20,10 +20,12 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
 #include <fstream>
 
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
 #include "src/core/ext/transport/chttp2/transport/internal.h"
 #include "src/core/lib/iomgr/timer_manager.h"
@@ -77,18 +79,50 @@ static void write_csv(std::ostream* out, A0&& a0, Arg&&... arg) {
   write_csv(out, std::forward<Arg>(arg)...);
 }
 
+class TrickleFixtureConfiguration : public FixtureConfiguration {
+ public:
+  explicit TrickleFixtureConfiguration(bool adaptive_write_size,
+                                       const char* stream_scheduler = "drr")
+      : adaptive_write_size_(adaptive_write_size),
+        stream_scheduler_(stream_scheduler) {}
+
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+    c->SetInt(GRPC_ARG_HTTP2_ADAPTIVE_WRITE_SIZE, adaptive_write_size_);
+    c->SetString(GRPC_ARG_HTTP2_STREAM_SCHEDULER, stream_scheduler_);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+    b->AddChannelArgument(GRPC_ARG_HTTP2_ADAPTIVE_WRITE_SIZE,
+                          adaptive_write_size_);
+    b->AddChannelArgument(GRPC_ARG_HTTP2_STREAM_SCHEDULER, stream_scheduler_);
+  }
+
+  std::string Label() const {
+    return absl::StrCat(adaptive_write_size_ ? "adaptive" : "fixed", ".",
+                        stream_scheduler_);
+  }
+
+ private:
+  const bool adaptive_write_size_;
+  const std::string stream_scheduler_;
+};
+
 class TrickledCHTTP2 : public EndpointPairFixture {
  public:
   TrickledCHTTP2(Service* service, bool streaming, size_t req_size,
                  size_t resp_size, size_t kilobits_per_second,
+                 const TrickleFixtureConfiguration& config,
                  grpc_passthru_endpoint_stats* stats)
       : EndpointPairFixture(service, MakeEndpoints(kilobits_per_second, stats),
-                            FixtureConfiguration()),
+                            config),
         stats_(stats) {
     if (absl::GetFlag(FLAGS_log)) {
       std::ostringstream fn;
       fn << "trickle." << (streaming ? "streaming" : "unary") << "." << req_size
-         << "." << resp_size << "." << kilobits_per_second << ".csv";
+         << "." << resp_size << "." << kilobits_per_second << "."
+         << config.Label() << ".csv";
       log_ = absl::make_unique<std::ofstream>(fn.str().c_str());
       write_csv(log_.get(), "t", "iteration", "client_backlog",
                 "server_backlog", "client_t_stall", "client_s_stall",
@@ -262,6 +296,7 @@ static void BM_PumpStreamServerToClient_Trickle(benchmark::State& state) {
   std::unique_ptr<TrickledCHTTP2> fixture(new TrickledCHTTP2(
       &service, true, state.range(0) /* req_size */,
       state.range(0) /* resp_size */, state.range(1) /* bw in kbit/s */,
+      TrickleFixtureConfiguration(state.range(2) != 0 /* adaptive */),
       grpc_passthru_endpoint_stats_create()));
   {
     EchoResponse send_response;
@@ -346,7 +381,9 @@ static void StreamingTrickleArgs(benchmark::internal::Benchmark* b) {
       double expected_time =
           static_cast<double>(14 + i) / (125.0 * static_cast<double>(j));
       if (expected_time > 2.0) continue;
-      b->Args({i, j});
+      for (int adaptive = 0; adaptive <= 1; adaptive++) {
+        b->Args({i, j, adaptive});
+      }
     }
   }
 }
@@ -357,6 +394,7 @@ static void BM_PumpUnbalancedUnary_Trickle(benchmark::State& state) {
   std::unique_ptr<TrickledCHTTP2> fixture(new TrickledCHTTP2(
       &service, false, state.range(0) /* req_size */,
       state.range(1) /* resp_size */, state.range(2) /* bw in kbit/s */,
+      TrickleFixtureConfiguration(state.range(3) != 0 /* adaptive */),
       grpc_passthru_endpoint_stats_create()));
   EchoRequest send_request;
   EchoResponse send_response;
@@ -444,18 +482,159 @@ static void BM_PumpUnbalancedUnary_Trickle(benchmark::State& state) {
 
 static void UnaryTrickleArgs(benchmark::internal::Benchmark* b) {
   for (int bw = 64; bw <= 128 * 1024 * 1024; bw *= 16) {
-    b->Args({1, 1, bw});
-    for (int i = 64; i <= 128 * 1024 * 1024; i *= 64) {
-      double expected_time =
-          static_cast<double>(14 + i) / (125.0 * static_cast<double>(bw));
-      if (expected_time > 2.0) continue;
-      b->Args({i, 1, bw});
-      b->Args({1, i, bw});
-      b->Args({i, i, bw});
+    for (int adaptive = 0; adaptive <= 1; adaptive++) {
+      b->Args({1, 1, bw, adaptive});
+      for (int i = 64; i <= 128 * 1024 * 1024; i *= 64) {
+        double expected_time =
+            static_cast<double>(14 + i) / (125.0 * static_cast<double>(bw));
+        if (expected_time > 2.0) continue;
+        b->Args({i, 1, bw, adaptive});
+        b->Args({1, i, bw, adaptive});
+        b->Args({i, i, bw, adaptive});
+      }
     }
   }
 }
 BENCHMARK(BM_PumpUnbalancedUnary_Trickle)->Apply(UnaryTrickleArgs);
+
+// Small unary calls multiplexed beside a server streaming call that keeps the
+// link saturated. Reports unary latency in simulated time, so that stream
+// schedulers can be compared on how badly the bulk stream starves unaries.
+static void BM_UnaryBesideSaturatingStream_Trickle(benchmark::State& state) {
+  static const size_t kBulkMessageSize = 1024 * 1024;
+  EchoTestService::AsyncService service;
+  std::unique_ptr<TrickledCHTTP2> fixture(new TrickledCHTTP2(
+      &service, false, state.range(0) /* req_size */,
+      state.range(0) /* resp_size */, state.range(1) /* bw in kbit/s */,
+      TrickleFixtureConfiguration(
+          false, state.range(2) != 0 ? "drr" : "fifo" /* stream_scheduler */),
+      grpc_passthru_endpoint_stats_create()));
+  EchoRequest send_request;
+  EchoResponse send_response;
+  EchoResponse recv_response;
+  if (state.range(0) > 0) {
+    send_request.set_message(std::string(state.range(0), 'a'));
+    send_response.set_message(std::string(state.range(0), 'a'));
+  }
+  EchoResponse bulk_send;
+  EchoResponse bulk_recv;
+  bulk_send.set_message(std::string(kBulkMessageSize, 'a'));
+  // tags: 0/1 bulk stream started (server/client), 2 bulk write done, 3 bulk
+  // read done, 4 unary call arrived, 5 unary response sent, 6 unary done,
+  // 7/8 bulk stream finished (server/client)
+  ServerContext bulk_svr_ctx;
+  ServerAsyncReaderWriter<EchoResponse, EchoRequest> bulk_rw(&bulk_svr_ctx);
+  service.RequestBidiStream(&bulk_svr_ctx, &bulk_rw, fixture->cq(),
+                            fixture->cq(), tag(0));
+  std::unique_ptr<EchoTestService::Stub> stub(
+      EchoTestService::NewStub(fixture->channel()));
+  ClientContext bulk_cli_ctx;
+  auto bulk_cli_rw = stub->AsyncBidiStream(&bulk_cli_ctx, fixture->cq(), tag(1));
+  bool bulk_running = true;
+  bool bulk_write_pending = false;
+  // Returns the next event that is not part of keeping the bulk stream busy.
+  auto next_event = [&](int64_t iteration, bool* ok) {
+    void* t;
+    while (true) {
+      TrickleCQNext(fixture.get(), &t, ok, iteration);
+      if (t == tag(2)) {
+        bulk_write_pending = false;
+        if (!bulk_running) return 2;
+        if (*ok) {
+          bulk_rw.Write(bulk_send, tag(2));
+          bulk_write_pending = true;
+        }
+      } else if (t == tag(3)) {
+        if (*ok) bulk_cli_rw->Read(&bulk_recv, tag(3));
+      } else {
+        return static_cast<int>(reinterpret_cast<intptr_t>(t));
+      }
+    }
+  };
+  bool ok;
+  for (int need_tags = (1 << 0) | (1 << 1); need_tags != 0;) {
+    int i = next_event(-1, &ok);
+    GPR_ASSERT(ok);
+    GPR_ASSERT(need_tags & (1 << i));
+    need_tags &= ~(1 << i);
+  }
+  bulk_rw.Write(bulk_send, tag(2));
+  bulk_write_pending = true;
+  bulk_cli_rw->Read(&bulk_recv, tag(3));
+
+  struct ServerEnv {
+    ServerContext ctx;
+    EchoRequest recv_request;
+    grpc::ServerAsyncResponseWriter<EchoResponse> response_writer;
+    ServerEnv() : response_writer(&ctx) {}
+  };
+  std::vector<int64_t> latencies_us;
+  auto unary = [&](int64_t iteration) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    ServerEnv senv;
+    service.RequestEcho(&senv.ctx, &senv.recv_request, &senv.response_writer,
+                        fixture->cq(), fixture->cq(), tag(4));
+    const int64_t start_us = gpr_atm_no_barrier_load(&g_now_us);
+    ClientContext cli_ctx;
+    Status recv_status;
+    std::unique_ptr<ClientAsyncResponseReader<EchoResponse>> response_reader(
+        stub->AsyncEcho(&cli_ctx, send_request, fixture->cq()));
+    response_reader->Finish(&recv_response, &recv_status, tag(6));
+    for (int need_tags = (1 << 4) | (1 << 5) | (1 << 6); need_tags != 0;) {
+      int i = next_event(iteration, &ok);
+      GPR_ASSERT(ok);
+      GPR_ASSERT(need_tags & (1 << i));
+      need_tags &= ~(1 << i);
+      if (i == 4) {
+        senv.response_writer.Finish(send_response, Status::OK, tag(5));
+      } else if (i == 6) {
+        latencies_us.push_back(gpr_atm_no_barrier_load(&g_now_us) - start_us);
+      }
+    }
+    GPR_ASSERT(recv_status.ok());
+  };
+  for (int i = 0; i < absl::GetFlag(FLAGS_warmup_iterations); i++) {
+    unary(-1);
+  }
+  latencies_us.clear();
+  while (state.KeepRunning()) {
+    unary(state.iterations());
+  }
+
+  bulk_running = false;
+  while (bulk_write_pending) {
+    next_event(-1, &ok);
+  }
+  bulk_rw.Finish(Status::OK, tag(7));
+  Status bulk_status;
+  bulk_cli_rw->Finish(&bulk_status, tag(8));
+  for (int need_tags = (1 << 7) | (1 << 8); need_tags != 0;) {
+    int i = next_event(-1, &ok);
+    GPR_ASSERT(need_tags & (1 << i));
+    need_tags &= ~(1 << i);
+  }
+  fixture->Finish(state);
+  fixture.reset();
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  if (!latencies_us.empty()) {
+    state.counters["unary_p50_us"] = static_cast<double>(
+        latencies_us[latencies_us.size() / 2]);
+    state.counters["unary_p99_us"] = static_cast<double>(
+        latencies_us[latencies_us.size() * 99 / 100]);
+  }
+}
+
+static void UnaryBesideStreamTrickleArgs(benchmark::internal::Benchmark* b) {
+  for (int bw = 1024; bw <= 128 * 1024; bw *= 8) {
+    for (int scheduler = 0; scheduler <= 1; scheduler++) {
+      b->Args({1, bw, scheduler});
+      b->Args({1024, bw, scheduler});
+    }
+  }
+}
+BENCHMARK(BM_UnaryBesideSaturatingStream_Trickle)
+    ->Apply(UnaryBesideStreamTrickleArgs);
 }  // namespace testing
 }  // namespace grpc
 
@@ -0,0 +1,369 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Simulates LB policy picks against backends with skewed latencies */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+
+#include "src/core/ext/filters/client_channel/lb_policy.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/server_address.h"
+#include "src/core/lib/address_utils/parse_address.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "src/core/lib/json/json.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace {
+
+constexpr int kNumBackends = 8;
+constexpr int kFirstPort = 10000;
+// Every kSlowBackendStride'th backend is kSlowdown times slower.
+constexpr int kSlowBackendStride = 4;
+constexpr double kFastLatencyUs = 100;
+constexpr double kSlowdown = 10;
+
+bool IsSlowBackend(int index) { return index % kSlowBackendStride == 0; }
+
+double BackendLatencyUs(int index) {
+  return IsSlowBackend(index) ? kFastLatencyUs * kSlowdown : kFastLatencyUs;
+}
+
+// A subchannel that is always READY and remembers which backend it is for.
+class SimSubchannel : public grpc_core::SubchannelInterface {
+ public:
+  explicit SimSubchannel(int backend) : backend_(backend) {}
+
+  int backend() const { return backend_; }
+
+  grpc_connectivity_state CheckConnectivityState() override {
+    return GRPC_CHANNEL_READY;
+  }
+  void WatchConnectivityState(
+      grpc_connectivity_state /*initial_state*/,
+      std::unique_ptr<ConnectivityStateWatcherInterface> watcher) override {
+    watcher_ = std::move(watcher);
+  }
+  void CancelConnectivityStateWatch(
+      ConnectivityStateWatcherInterface* /*watcher*/) override {
+    watcher_.reset();
+  }
+  void AttemptToConnect() override {}
+  void ResetBackoff() override {}
+  const grpc_channel_args* channel_args() override { return nullptr; }
+
+ private:
+  const int backend_;
+  std::unique_ptr<ConnectivityStateWatcherInterface> watcher_;
+};
+
+class SimHelper
+    : public grpc_core::LoadBalancingPolicy::ChannelControlHelper {
+ public:
+  explicit SimHelper(
+      std::unique_ptr<grpc_core::LoadBalancingPolicy::SubchannelPicker>*
+          picker)
+      : picker_(picker) {}
+
+  grpc_core::RefCountedPtr<grpc_core::SubchannelInterface> CreateSubchannel(
+      grpc_core::ServerAddress address,
+      const grpc_channel_args& /*args*/) override {
+    return grpc_core::MakeRefCounted<SimSubchannel>(
+        grpc_sockaddr_get_port(&address.address()) - kFirstPort);
+  }
+  void UpdateState(
+      grpc_connectivity_state /*state*/, const absl::Status& /*status*/,
+      std::unique_ptr<grpc_core::LoadBalancingPolicy::SubchannelPicker> picker)
+      override {
+    *picker_ = std::move(picker);
+  }
+  void RequestReresolution() override {}
+  void AddTraceEvent(TraceSeverity /*severity*/,
+                     absl::string_view /*message*/) override {}
+
+ private:
+  std::unique_ptr<grpc_core::LoadBalancingPolicy::SubchannelPicker>* picker_;
+};
+
+// Returns the load report of a backend: every backend serves the same QPS,
+// but slow backends are kSlowdown times busier.
+class SimCallState : public grpc_core::LoadBalancingPolicy::CallState {
+ public:
+  explicit SimCallState(int backend) {
+    backend_metric_data_.cpu_utilization =
+        IsSlowBackend(backend) ? 0.9 : 0.9 / kSlowdown;
+    backend_metric_data_.mem_utilization = 0;
+    backend_metric_data_.requests_per_second = 1000;
+  }
+
+  void* Alloc(size_t /*size*/) override { abort(); }
+  const grpc_core::LoadBalancingPolicy::BackendMetricData*
+  GetBackendMetricData() override {
+    return &backend_metric_data_;
+  }
+  absl::string_view ExperimentalGetCallAttribute(
+      const char* /*key*/) override {
+    return absl::string_view();
+  }
+
+ private:
+  grpc_core::LoadBalancingPolicy::BackendMetricData backend_metric_data_;
+};
+
+// Closed-loop discrete event simulation of calls through an LB policy.
+// Must be used under an ExecCtx.
+class Simulation {
+ public:
+  Simulation(const char* policy_name, const char* config, int num_backends)
+      : num_backends_(num_backends) {
+    for (int i = 0; i < num_backends; ++i) call_states_.emplace_back(i);
+    grpc_core::LoadBalancingPolicy::Args args;
+    args.work_serializer = std::make_shared<grpc_core::WorkSerializer>();
+    args.channel_control_helper = absl::make_unique<SimHelper>(&picker_);
+    policy_ = grpc_core::LoadBalancingPolicyRegistry::CreateLoadBalancingPolicy(
+        policy_name, std::move(args));
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    grpc_core::Json config_json = grpc_core::Json::Parse(
+        absl::StrFormat("[{\"%s\": %s}]", policy_name, config), &error);
+    GPR_ASSERT(error == GRPC_ERROR_NONE);
+    config_ = grpc_core::LoadBalancingPolicyRegistry::ParseLoadBalancingConfig(
+        config_json, &error);
+    GPR_ASSERT(error == GRPC_ERROR_NONE);
+    Reresolve();
+  }
+
+  ~Simulation() {
+    Drain();
+    picker_.reset();
+    policy_.reset();
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+
+  grpc_core::LoadBalancingPolicy::SubchannelPicker* picker() {
+    return picker_.get();
+  }
+
+  // Sends the backend addresses to the policy.  Sending them again makes
+  // the policy build a new picker, which for weighted policies reflects
+  // the load reports seen so far.
+  void Reresolve() {
+    grpc_core::LoadBalancingPolicy::UpdateArgs update;
+    update.config = config_;
+    for (int i = 0; i < num_backends_; ++i) {
+      grpc_resolved_address address;
+      GPR_ASSERT(grpc_parse_ipv4_hostport(
+          "127.0.0.1:" + std::to_string(kFirstPort + i), &address, false));
+      update.addresses.emplace_back(address, nullptr);
+    }
+    grpc_channel_args empty_args = {0, nullptr};
+    update.args = grpc_channel_args_copy(&empty_args);
+    policy_->UpdateLocked(std::move(update));
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+
+  void StartCall() {
+    grpc_core::LoadBalancingPolicy::PickArgs pick_args;
+    pick_args.initial_metadata = nullptr;
+    pick_args.call_state = nullptr;
+    grpc_core::LoadBalancingPolicy::PickResult result =
+        picker_->Pick(pick_args);
+    GPR_ASSERT(result.type ==
+               grpc_core::LoadBalancingPolicy::PickResult::PICK_COMPLETE);
+    const int backend =
+        static_cast<SimSubchannel*>(result.subchannel.get())->backend();
+    in_flight_.push({now_us_ + BackendLatencyUs(backend), backend,
+                     std::move(result.recv_trailing_metadata_ready)});
+  }
+
+  void CompleteNextCall() {
+    Completion done = in_flight_.top();
+    in_flight_.pop();
+    now_us_ = done.time_us;
+    ++completed_calls_;
+    total_latency_us_ += BackendLatencyUs(done.backend);
+    if (IsSlowBackend(done.backend)) ++slow_calls_;
+    if (done.recv_trailing_metadata_ready != nullptr) {
+      done.recv_trailing_metadata_ready(GRPC_ERROR_NONE, nullptr,
+                                        &call_states_[done.backend]);
+    }
+  }
+
+  // Completes every outstanding call.
+  void Drain() {
+    while (!in_flight_.empty()) CompleteNextCall();
+  }
+
+  void ResetStats() {
+    completed_calls_ = 0;
+    slow_calls_ = 0;
+    total_latency_us_ = 0;
+    start_us_ = now_us_;
+  }
+
+  void ReportStats(benchmark::State& state) {
+    if (completed_calls_ == 0) return;
+    const double completed_calls = static_cast<double>(completed_calls_);
+    state.counters["mean_latency_us"] = total_latency_us_ / completed_calls;
+    state.counters["slow_fraction"] = slow_calls_ / completed_calls;
+    state.counters["sim_qps"] = completed_calls / ((now_us_ - start_us_) / 1e6);
+  }
+
+ private:
+  struct Completion {
+    double time_us;
+    int backend;
+    std::function<void(grpc_error_handle,
+                       grpc_core::LoadBalancingPolicy::MetadataInterface*,
+                       grpc_core::LoadBalancingPolicy::CallState*)>
+        recv_trailing_metadata_ready;
+
+    bool operator>(const Completion& other) const {
+      return time_us > other.time_us;
+    }
+  };
+
+  const int num_backends_;
+  std::vector<SimCallState> call_states_;
+  std::unique_ptr<grpc_core::LoadBalancingPolicy::SubchannelPicker> picker_;
+  grpc_core::OrphanablePtr<grpc_core::LoadBalancingPolicy> policy_;
+  grpc_core::RefCountedPtr<grpc_core::LoadBalancingPolicy::Config> config_;
+  std::priority_queue<Completion, std::vector<Completion>,
+                      std::greater<Completion>>
+      in_flight_;
+  double now_us_ = 0;
+  double start_us_ = 0;
+  int64_t completed_calls_ = 0;
+  int64_t slow_calls_ = 0;
+  double total_latency_us_ = 0;
+};
+
+// Weighted policies only see load reports through call completions, so
+// warm them up and have them rebuild their picker before measuring.  The
+// weight update period is long enough that no timer-driven picker update
+// races with the benchmark loop.
+constexpr char kWeightedRoundRobinConfig[] =
+    "{\"blackoutPeriod\": \"0s\", \"weightUpdatePeriod\": \"3600s\"}";
+
+void WarmUp(Simulation* sim, int64_t concurrency) {
+  for (int64_t i = 0; i < concurrency; ++i) sim->StartCall();
+  for (int64_t i = 0; i < 10 * concurrency; ++i) {
+    sim->CompleteNextCall();
+    sim->StartCall();
+  }
+  sim->Drain();
+  sim->Reresolve();
+  sim->ResetStats();
+}
+
+// state.range(0) calls are kept outstanding, and every completed call is
+// immediately replaced by a new pick.  Each iteration is one pick.
+// Reports the mean simulated call latency and the fraction of calls that
+// were sent to slow backends.
+static void BM_SkewedBackendPicks(benchmark::State& state,
+                                  const char* policy_name,
+                                  const char* config) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  {
+    Simulation sim(policy_name, config, kNumBackends);
+    if (sim.picker() == nullptr) {
+      state.SkipWithError("policy did not produce a picker");
+      return;
+    }
+    WarmUp(&sim, state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i) sim.StartCall();
+    for (auto _ : state) {
+      sim.CompleteNextCall();
+      sim.StartCall();
+    }
+    sim.ReportStats(state);
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK_CAPTURE(BM_SkewedBackendPicks, round_robin, "round_robin", "{}")
+    ->RangeMultiplier(4)
+    ->Range(8, 512);
+BENCHMARK_CAPTURE(BM_SkewedBackendPicks, least_request, "least_request",
+                  "{}")
+    ->RangeMultiplier(4)
+    ->Range(8, 512);
+BENCHMARK_CAPTURE(BM_SkewedBackendPicks, weighted_round_robin,
+                  "weighted_round_robin", kWeightedRoundRobinConfig)
+    ->RangeMultiplier(4)
+    ->Range(8, 512);
+
+// Measures the cost of a pick alone, over state.range(0) backends.
+static void BM_Pick(benchmark::State& state, const char* policy_name,
+                    const char* config) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  {
+    Simulation sim(policy_name, config, static_cast<int>(state.range(0)));
+    if (sim.picker() == nullptr) {
+      state.SkipWithError("policy did not produce a picker");
+      return;
+    }
+    WarmUp(&sim, state.range(0));
+    grpc_core::LoadBalancingPolicy::PickArgs pick_args;
+    pick_args.initial_metadata = nullptr;
+    pick_args.call_state = nullptr;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(sim.picker()->Pick(pick_args));
+    }
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK_CAPTURE(BM_Pick, round_robin, "round_robin", "{}")
+    ->RangeMultiplier(8)
+    ->Range(2, 1024);
+BENCHMARK_CAPTURE(BM_Pick, least_request, "least_request", "{}")
+    ->RangeMultiplier(8)
+    ->Range(2, 1024);
+BENCHMARK_CAPTURE(BM_Pick, weighted_round_robin, "weighted_round_robin",
+                  kWeightedRoundRobinConfig)
+    ->RangeMultiplier(8)
+    ->Range(2, 1024);
+
+}  // namespace
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Cost of matching incoming calls to requested calls on a server with many
+   completion queues, when every call has to go through the pending list */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include <atomic>
+#include <vector>
+
+#include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+static constexpr int kNumCqs = 32;
+
+static grpc_server* g_server;
+static grpc_completion_queue* g_server_cqs[kNumCqs];
+static grpc_completion_queue* g_client_cqs[kNumCqs];
+static grpc_channel* g_channels[kNumCqs];
+static std::atomic<int> g_next_thread{0};
+
+static void* tag(intptr_t x) { return reinterpret_cast<void*>(x); }
+
+static void ExpectTag(grpc_completion_queue* cq, void* expected_tag) {
+  grpc_event ev = grpc_completion_queue_next(
+      cq, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+  GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+  GPR_ASSERT(ev.tag == expected_tag);
+  GPR_ASSERT(ev.success);
+}
+
+static void SetUp() {
+  g_server = grpc_server_create(nullptr, nullptr);
+  for (int i = 0; i < kNumCqs; i++) {
+    g_server_cqs[i] = grpc_completion_queue_create_for_next(nullptr);
+    g_client_cqs[i] = grpc_completion_queue_create_for_next(nullptr);
+    grpc_server_register_completion_queue(g_server, g_server_cqs[i], nullptr);
+  }
+  grpc_server_start(g_server);
+  for (int i = 0; i < kNumCqs; i++) {
+    g_channels[i] = grpc_inproc_channel_create(g_server, nullptr, nullptr);
+  }
+}
+
+static void TearDown() {
+  grpc_server_shutdown_and_notify(g_server, g_server_cqs[0], tag(0));
+  ExpectTag(g_server_cqs[0], tag(0));
+  grpc_server_destroy(g_server);
+  for (int i = 0; i < kNumCqs; i++) {
+    grpc_channel_destroy(g_channels[i]);
+    grpc_completion_queue_shutdown(g_server_cqs[i]);
+    grpc_completion_queue_shutdown(g_client_cqs[i]);
+    while (grpc_completion_queue_next(g_server_cqs[i],
+                                      gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    while (grpc_completion_queue_next(g_client_cqs[i],
+                                      gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(g_server_cqs[i]);
+    grpc_completion_queue_destroy(g_client_cqs[i]);
+  }
+}
+
+// Each thread owns one server completion queue.  The client call is started
+// before the server requests it, so that every call is queued on the pending
+// list and matched when the request arrives.
+static void BM_PendingCallMatching(benchmark::State& state) {
+  const int idx = g_next_thread.fetch_add(1) % kNumCqs;
+  grpc_completion_queue* server_cq = g_server_cqs[idx];
+  grpc_completion_queue* client_cq = g_client_cqs[idx];
+  grpc_slice method = grpc_slice_from_static_string("/foo/bar");
+  for (auto _ : state) {
+    grpc_call* client_call = grpc_channel_create_call(
+        g_channels[idx], nullptr, GRPC_PROPAGATE_DEFAULTS, client_cq, method,
+        nullptr, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+    grpc_metadata_array trailing_metadata_recv;
+    grpc_metadata_array_init(&trailing_metadata_recv);
+    grpc_status_code status;
+    grpc_slice details;
+    grpc_op client_ops[3] = {};
+    client_ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    client_ops[1].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    client_ops[2].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+    client_ops[2].data.recv_status_on_client.trailing_metadata =
+        &trailing_metadata_recv;
+    client_ops[2].data.recv_status_on_client.status = &status;
+    client_ops[2].data.recv_status_on_client.status_details = &details;
+    GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(client_call, client_ops,
+                                                     3, tag(1), nullptr));
+
+    grpc_call* server_call;
+    grpc_call_details call_details;
+    grpc_call_details_init(&call_details);
+    grpc_metadata_array request_metadata_recv;
+    grpc_metadata_array_init(&request_metadata_recv);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(g_server, &server_call, &call_details,
+                                        &request_metadata_recv, server_cq,
+                                        server_cq, tag(2)));
+    ExpectTag(server_cq, tag(2));
+
+    int was_cancelled;
+    grpc_op server_ops[3] = {};
+    server_ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    server_ops[1].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+    server_ops[1].data.recv_close_on_server.cancelled = &was_cancelled;
+    server_ops[2].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+    server_ops[2].data.send_status_from_server.status = GRPC_STATUS_OK;
+    GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(server_call, server_ops,
+                                                     3, tag(3), nullptr));
+    ExpectTag(server_cq, tag(3));
+    ExpectTag(client_cq, tag(1));
+
+    grpc_call_unref(server_call);
+    grpc_call_unref(client_call);
+    grpc_slice_unref(details);
+    grpc_call_details_destroy(&call_details);
+    grpc_metadata_array_destroy(&request_metadata_recv);
+    grpc_metadata_array_destroy(&trailing_metadata_recv);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PendingCallMatching)->ThreadRange(1, kNumCqs)->UseRealTime();
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  ::benchmark::Initialize(&argc, argv);
+  grpc::testing::SetUp();
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc::testing::TearDown();
+  grpc_shutdown();
+  return 0;
+}
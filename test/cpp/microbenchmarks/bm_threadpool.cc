@@ -19,10 +19,14 @@
 #include <benchmark/benchmark.h>
 #include <grpc/grpc.h>
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 #include "src/core/lib/iomgr/executor/threadpool.h"
+#include "src/cpp/server/bounded_thread_pool.h"
+#include "src/cpp/server/dynamic_thread_pool.h"
 #include "test/core/util/test_config.h"
 #include "test/cpp/microbenchmarks/helpers.h"
 #include "test/cpp/util/test_config.h"
@@ -311,6 +315,64 @@ static void BM_SpikyLoad(benchmark::State& state) {
 }
 BENCHMARK(BM_SpikyLoad)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
 
+// The C++ API's thread pools (grpc::ThreadPoolInterface), as returned by
+// CreateDefaultThreadPool().
+struct DynamicPool {
+  static ThreadPoolInterface* Create(int num_threads) {
+    return new DynamicThreadPool(num_threads);
+  }
+};
+
+struct BoundedPool {
+  static ThreadPoolInterface* Create(int num_threads) {
+    return new BoundedThreadPool(num_threads, 64 * num_threads);
+  }
+};
+
+// Counts the distinct threads that ran callbacks during one benchmark run.
+static std::atomic<int> g_run_generation{0};
+static std::atomic<int> g_threads_used{0};
+static thread_local int g_thread_generation = -1;
+
+static void NoteThreadUsed() {
+  const int generation = g_run_generation.load(std::memory_order_relaxed);
+  if (g_thread_generation != generation) {
+    g_thread_generation = generation;
+    g_threads_used.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Adds bursts of short callbacks, many more than there are threads, as a sync
+// API server does under bursty load, and waits for each burst to finish.
+// Args: number of threads, burst size.
+template <class Pool>
+static void BM_CppThreadPoolBurst(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const int burst_size = state.range(1);
+  g_run_generation.fetch_add(1);
+  g_threads_used.store(0);
+  std::unique_ptr<ThreadPoolInterface> pool(Pool::Create(num_threads));
+  while (state.KeepRunningBatch(burst_size)) {
+    BlockingCounter counter(burst_size);
+    for (int i = 0; i < burst_size; ++i) {
+      pool->Add([&counter] {
+        NoteThreadUsed();
+        volatile int val = 0;
+        for (int j = 0; j < 1000; ++j) val++;
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  pool.reset();
+  state.counters["threads_used"] = g_threads_used.load();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_CppThreadPoolBurst, DynamicPool)
+    ->RangePair(1, 16, 64, 4096);
+BENCHMARK_TEMPLATE(BM_CppThreadPoolBurst, BoundedPool)
+    ->RangePair(1, 16, 64, 4096);
+
 }  // namespace testing
 }  // namespace grpc
 
@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark WorkSerializer under a flood of subchannel state changes, as seen
+   by the client channel control plane when many subchannels change state at
+   once */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+constexpr int kNumSubchannels = 10000;
+
+// The control plane state that subchannel state changes are applied to. Only
+// accessed from within the work serializer.
+class SubchannelStates {
+ public:
+  SubchannelStates() : states_(kNumSubchannels, GRPC_CHANNEL_IDLE) {}
+
+  void Update(int index, grpc_connectivity_state state) {
+    if (states_[index] != state) {
+      states_[index] = state;
+      ++num_changes_;
+    }
+  }
+
+  int num_changes() const { return num_changes_; }
+
+ private:
+  std::vector<grpc_connectivity_state> states_;
+  int num_changes_ = 0;
+};
+
+static grpc_connectivity_state StateForIteration(int64_t iteration) {
+  return iteration % 2 == 0 ? GRPC_CHANNEL_READY
+                            : GRPC_CHANNEL_TRANSIENT_FAILURE;
+}
+
+// Every subchannel reports a new state from within the work serializer, e.g.
+// while a resolver update is being applied, so the notifications pile up on
+// the queue and are drained by the thread that holds the work serializer.
+static void BM_SubchannelStateChangesWhileBusy(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::WorkSerializer work_serializer;
+  SubchannelStates subchannel_states;
+  int64_t iteration = 0;
+  for (auto _ : state) {
+    const grpc_connectivity_state new_state = StateForIteration(iteration++);
+    work_serializer.Run(
+        [&work_serializer, &subchannel_states, new_state]() {
+          for (int i = 0; i < kNumSubchannels; ++i) {
+            work_serializer.Run(
+                [&subchannel_states, i, new_state]() {
+                  subchannel_states.Update(i, new_state);
+                },
+                DEBUG_LOCATION);
+          }
+        },
+        DEBUG_LOCATION);
+  }
+  GPR_ASSERT(subchannel_states.num_changes() ==
+             kNumSubchannels * state.iterations());
+  state.SetItemsProcessed(state.iterations() * kNumSubchannels);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SubchannelStateChangesWhileBusy);
+
+// The subchannel state changes are reported concurrently by several threads,
+// so that whichever thread finds the work serializer idle drains the changes
+// reported by the others.
+static void BM_SubchannelStateChangesFromThreads(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  TrackCounters track_counters;
+  grpc_core::WorkSerializer work_serializer;
+  SubchannelStates subchannel_states;
+  struct Reporter {
+    grpc_core::WorkSerializer* work_serializer;
+    SubchannelStates* subchannel_states;
+    int begin;
+    int end;
+    grpc_connectivity_state new_state;
+  };
+  int64_t iteration = 0;
+  for (auto _ : state) {
+    const grpc_connectivity_state new_state = StateForIteration(iteration++);
+    std::vector<Reporter> reporters(num_threads);
+    std::vector<grpc_core::Thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      reporters[t] = {&work_serializer, &subchannel_states,
+                      kNumSubchannels * t / num_threads,
+                      kNumSubchannels * (t + 1) / num_threads, new_state};
+      threads.emplace_back(
+          "bm_work_serializer",
+          [](void* arg) {
+            Reporter* reporter = static_cast<Reporter*>(arg);
+            grpc_core::ExecCtx exec_ctx;
+            for (int i = reporter->begin; i < reporter->end; ++i) {
+              SubchannelStates* subchannel_states =
+                  reporter->subchannel_states;
+              grpc_connectivity_state new_state = reporter->new_state;
+              reporter->work_serializer->Run(
+                  [subchannel_states, i, new_state]() {
+                    subchannel_states->Update(i, new_state);
+                  },
+                  DEBUG_LOCATION);
+            }
+          },
+          &reporters[t]);
+      threads.back().Start();
+    }
+    for (auto& thread : threads) {
+      thread.Join();
+    }
+  }
+  // All the threads have returned from Run(), so every change was applied.
+  GPR_ASSERT(subchannel_states.num_changes() ==
+             kNumSubchannels * state.iterations());
+  state.SetItemsProcessed(state.iterations() * kNumSubchannels);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SubchannelStateChangesFromThreads)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->UseRealTime();
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  LibraryInitializer libInit;
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,267 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Replays large ADS responses through XdsApi::ParseAdsResponse, and compares
+   state-of-the-world updates with delta ones */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "envoy/config/core/v3/address.upb.h"
+#include "envoy/config/core/v3/base.upb.h"
+#include "envoy/config/endpoint/v3/endpoint.upb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.upb.h"
+#include "envoy/service/discovery/v3/discovery.upb.h"
+#include "google/protobuf/any.upb.h"
+#include "google/protobuf/wrappers.upb.h"
+#include "upb/upb.hpp"
+
+#include "src/core/ext/xds/xds_api.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+namespace {
+
+constexpr char kEdsTypeUrl[] =
+    "type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment";
+constexpr int kEndpointsPerResource = 4;
+
+grpc_core::TraceFlag bm_xds_api_trace(false, "bm_xds_api");
+
+upb_strview ToStrView(const std::string& s) {
+  return upb_strview_make(s.data(), s.size());
+}
+
+// Serializes a ClusterLoadAssignment for \a name with a single locality.
+// Different values of \a generation yield different endpoint ports, as
+// happens when a backend of the cluster is replaced.
+std::string MakeClusterLoadAssignment(const std::string& name, int generation) {
+  static const std::string kAddress = "10.0.0.1";
+  upb::Arena arena;
+  auto* cla = envoy_config_endpoint_v3_ClusterLoadAssignment_new(arena.ptr());
+  envoy_config_endpoint_v3_ClusterLoadAssignment_set_cluster_name(
+      cla, ToStrView(name));
+  auto* locality_endpoints =
+      envoy_config_endpoint_v3_ClusterLoadAssignment_add_endpoints(
+          cla, arena.ptr());
+  envoy_config_core_v3_Locality_set_region(
+      envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_locality(
+          locality_endpoints, arena.ptr()),
+      upb_strview_makez("region"));
+  auto* weight =
+      envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_load_balancing_weight(
+          locality_endpoints, arena.ptr());
+  google_protobuf_UInt32Value_set_value(weight, 1);
+  for (int i = 0; i < kEndpointsPerResource; ++i) {
+    auto* lb_endpoint =
+        envoy_config_endpoint_v3_LocalityLbEndpoints_add_lb_endpoints(
+            locality_endpoints, arena.ptr());
+    auto* socket_address = envoy_config_core_v3_Address_mutable_socket_address(
+        envoy_config_endpoint_v3_Endpoint_mutable_address(
+            envoy_config_endpoint_v3_LbEndpoint_mutable_endpoint(
+                lb_endpoint, arena.ptr()),
+            arena.ptr()),
+        arena.ptr());
+    envoy_config_core_v3_SocketAddress_set_address(socket_address,
+                                                   ToStrView(kAddress));
+    envoy_config_core_v3_SocketAddress_set_port_value(
+        socket_address, 10000 + generation * kEndpointsPerResource + i);
+  }
+  size_t size;
+  char* bytes = envoy_config_endpoint_v3_ClusterLoadAssignment_serialize(
+      cla, arena.ptr(), &size);
+  return std::string(bytes, size);
+}
+
+// Wraps \a resources in a serialized DiscoveryResponse.
+grpc_slice MakeEdsResponse(const std::vector<std::string>& resources) {
+  upb::Arena arena;
+  auto* response =
+      envoy_service_discovery_v3_DiscoveryResponse_new(arena.ptr());
+  envoy_service_discovery_v3_DiscoveryResponse_set_version_info(
+      response, upb_strview_makez("1"));
+  envoy_service_discovery_v3_DiscoveryResponse_set_nonce(
+      response, upb_strview_makez("A"));
+  envoy_service_discovery_v3_DiscoveryResponse_set_type_url(
+      response, upb_strview_makez(kEdsTypeUrl));
+  for (const std::string& resource : resources) {
+    auto* any = envoy_service_discovery_v3_DiscoveryResponse_add_resources(
+        response, arena.ptr());
+    google_protobuf_Any_set_type_url(any, upb_strview_makez(kEdsTypeUrl));
+    google_protobuf_Any_set_value(any, ToStrView(resource));
+  }
+  size_t size;
+  char* bytes = envoy_service_discovery_v3_DiscoveryResponse_serialize(
+      response, arena.ptr(), &size);
+  return grpc_slice_from_copied_buffer(bytes, size);
+}
+
+// Alternates between two responses carrying range(0) EDS resources, of
+// which range(1) differ between the two. This mirrors a control plane that
+// re-sends every watched resource whenever any endpoint changes.
+void BM_ParseEdsResponse(benchmark::State& state) {
+  const int num_resources = state.range(0);
+  const int num_changed = state.range(1);
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::XdsBootstrap::XdsServer server;
+  server.server_features.insert("xds_v3");
+  grpc_core::XdsApi api(nullptr, &bm_xds_api_trace, nullptr);
+  std::vector<std::string> names;
+  std::vector<std::string> resources[2];
+  for (int i = 0; i < num_resources; ++i) {
+    names.push_back(absl::StrCat("cluster_", i));
+    resources[0].push_back(MakeClusterLoadAssignment(names.back(), 0));
+    resources[1].push_back(i < num_changed ? MakeClusterLoadAssignment(
+                                                 names.back(), 1)
+                                           : resources[0].back());
+  }
+  const std::set<absl::string_view> expected_names(names.begin(), names.end());
+  grpc_slice responses[2] = {MakeEdsResponse(resources[0]),
+                             MakeEdsResponse(resources[1])};
+  const std::set<absl::string_view> none;
+  size_t next = 0;
+  for (auto _ : state) {
+    grpc_core::XdsApi::AdsParseResult result = api.ParseAdsResponse(
+        server, responses[next], none, none, none, expected_names);
+    GPR_ASSERT(result.parse_error == GRPC_ERROR_NONE);
+    GPR_ASSERT(result.eds_update_map.size() ==
+               static_cast<size_t>(num_resources));
+    next ^= 1;
+  }
+  grpc_slice_unref(responses[0]);
+  grpc_slice_unref(responses[1]);
+  state.SetItemsProcessed(state.iterations() * num_resources);
+}
+BENCHMARK(BM_ParseEdsResponse)
+    ->Args({1000, 0})
+    ->Args({1000, 10})
+    ->Args({1000, 1000})
+    ->Args({20000, 0})
+    ->Args({20000, 200})
+    ->Args({20000, 20000});
+
+// Wraps \a resources, keyed by name, in a serialized DeltaDiscoveryResponse.
+grpc_slice MakeDeltaEdsResponse(
+    const std::vector<std::pair<std::string, std::string>>& resources) {
+  upb::Arena arena;
+  auto* response =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_new(arena.ptr());
+  envoy_service_discovery_v3_DeltaDiscoveryResponse_set_system_version_info(
+      response, upb_strview_makez("1"));
+  envoy_service_discovery_v3_DeltaDiscoveryResponse_set_nonce(
+      response, upb_strview_makez("A"));
+  envoy_service_discovery_v3_DeltaDiscoveryResponse_set_type_url(
+      response, upb_strview_makez(kEdsTypeUrl));
+  for (const auto& resource : resources) {
+    auto* delta_resource =
+        envoy_service_discovery_v3_DeltaDiscoveryResponse_add_resources(
+            response, arena.ptr());
+    envoy_service_discovery_v3_Resource_set_name(delta_resource,
+                                                 ToStrView(resource.first));
+    envoy_service_discovery_v3_Resource_set_version(delta_resource,
+                                                    upb_strview_makez("1"));
+    auto* any = envoy_service_discovery_v3_Resource_mutable_resource(
+        delta_resource, arena.ptr());
+    google_protobuf_Any_set_type_url(any, upb_strview_makez(kEdsTypeUrl));
+    google_protobuf_Any_set_value(any, ToStrView(resource.second));
+  }
+  size_t size;
+  char* bytes = envoy_service_discovery_v3_DeltaDiscoveryResponse_serialize(
+      response, arena.ptr(), &size);
+  return grpc_slice_from_copied_buffer(bytes, size);
+}
+
+// Delivers an update in which one of range(0) watched EDS resources has
+// changed, as the control plane would send it: the whole set with
+// state-of-the-world (range(1) == 0), only the changed resource with delta
+// xDS (range(1) == 1).  Each iteration serializes the response and parses it.
+void BM_EdsUpdateSotwVsDelta(benchmark::State& state) {
+  const int num_resources = state.range(0);
+  const bool delta = state.range(1) != 0;
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::XdsBootstrap::XdsServer server;
+  server.server_features.insert("xds_v3");
+  grpc_core::XdsApi api(nullptr, &bm_xds_api_trace, nullptr);
+  std::vector<std::string> names;
+  std::vector<std::string> resources;
+  for (int i = 0; i < num_resources; ++i) {
+    names.push_back(absl::StrCat("cluster_", i));
+    resources.push_back(MakeClusterLoadAssignment(names.back(), 0));
+  }
+  const std::string changed[2] = {resources[0],
+                                  MakeClusterLoadAssignment(names[0], 1)};
+  const std::set<absl::string_view> expected_names(names.begin(), names.end());
+  const std::set<absl::string_view> none;
+  size_t next = 1;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    grpc_slice response;
+    grpc_core::XdsApi::AdsParseResult result;
+    if (delta) {
+      response = MakeDeltaEdsResponse({{names[0], changed[next]}});
+      result = api.ParseDeltaAdsResponse(server, response, none, none, none,
+                                         expected_names);
+      GPR_ASSERT(result.eds_update_map.size() == 1);
+    } else {
+      resources[0] = changed[next];
+      response = MakeEdsResponse(resources);
+      result = api.ParseAdsResponse(server, response, none, none, none,
+                                    expected_names);
+      GPR_ASSERT(result.eds_update_map.size() ==
+                 static_cast<size_t>(num_resources));
+    }
+    GPR_ASSERT(result.parse_error == GRPC_ERROR_NONE);
+    bytes += GRPC_SLICE_LENGTH(response);
+    grpc_slice_unref(response);
+    next ^= 1;
+  }
+  state.counters["bytes_per_update"] = benchmark::Counter(
+      static_cast<double>(bytes) / state.iterations());
+}
+BENCHMARK(BM_EdsUpdateSotwVsDelta)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({20000, 0})
+    ->Args({20000, 1});
+
+}  // namespace
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  ::benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
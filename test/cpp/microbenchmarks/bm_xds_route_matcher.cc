@@ -0,0 +1,125 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark xDS route path matching: linear scan vs XdsRouteMatcher */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+#include "src/core/ext/xds/xds_route_matcher.h"
+#include "src/core/lib/matchers/matchers.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+// Builds a route table with a mix of exact, prefix and regex path
+// matchers, one service per route, followed by a catch-all route.
+std::vector<StringMatcher> MakePathMatchers(int num_routes) {
+  std::vector<StringMatcher> matchers;
+  for (int i = 0; i < num_routes; ++i) {
+    switch (i % 3) {
+      case 0:
+        matchers.push_back(
+            StringMatcher::Create(StringMatcher::Type::kExact,
+                                  absl::StrCat("/pkg.Service", i, "/Method"))
+                .value());
+        break;
+      case 1:
+        matchers.push_back(
+            StringMatcher::Create(StringMatcher::Type::kPrefix,
+                                  absl::StrCat("/pkg.Service", i, "/"))
+                .value());
+        break;
+      case 2:
+        matchers.push_back(
+            StringMatcher::Create(StringMatcher::Type::kSafeRegex,
+                                  absl::StrCat("/pkg\\.Service", i, "/Get.*"))
+                .value());
+        break;
+    }
+  }
+  matchers.push_back(
+      StringMatcher::Create(StringMatcher::Type::kPrefix, "").value());
+  return matchers;
+}
+
+// Paths that hit routes spread across the table.
+std::vector<std::string> MakePaths(int num_routes) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < num_routes; i += num_routes / 8 + 1) {
+    paths.push_back(absl::StrCat("/pkg.Service", i, "/Method"));
+    paths.push_back(absl::StrCat("/pkg.Service", i, "/GetThing"));
+  }
+  paths.push_back("/other.Service/Method");
+  return paths;
+}
+
+void BM_LinearRouteMatch(benchmark::State& state) {
+  std::vector<StringMatcher> matchers = MakePathMatchers(state.range(0));
+  std::vector<std::string> paths = MakePaths(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& path = paths[i++ % paths.size()];
+    size_t route = 0;
+    while (!matchers[route].Match(path)) ++route;
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(BM_LinearRouteMatch)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_CompiledRouteMatch(benchmark::State& state) {
+  std::vector<StringMatcher> matchers = MakePathMatchers(state.range(0));
+  std::vector<const StringMatcher*> path_matchers;
+  for (const StringMatcher& matcher : matchers) {
+    path_matchers.push_back(&matcher);
+  }
+  XdsRouteMatcher route_matcher(path_matchers);
+  std::vector<std::string> paths = MakePaths(state.range(0));
+  std::vector<size_t> scratch;
+  size_t i = 0;
+  for (auto _ : state) {
+    const std::string& path = paths[i++ % paths.size()];
+    benchmark::DoNotOptimize(
+        route_matcher.MatchingRoutes(path, &scratch).front());
+  }
+}
+BENCHMARK(BM_CompiledRouteMatch)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  ::benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
@@ -0,0 +1,423 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Memory and CPU cost of an XdsClient fanning out EDS updates to N channels
+   watching M clusters */
+
+#include <benchmark/benchmark.h>
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "envoy/config/core/v3/address.upb.h"
+#include "envoy/config/core/v3/base.upb.h"
+#include "envoy/config/endpoint/v3/endpoint.upb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.upb.h"
+#include "envoy/service/discovery/v3/discovery.upb.h"
+#include "google/protobuf/any.upb.h"
+#include "google/protobuf/wrappers.upb.h"
+#include "upb/upb.hpp"
+
+#include "src/core/ext/xds/xds_api.h"
+#include "src/core/ext/xds/xds_bootstrap.h"
+#include "src/core/ext/xds/xds_client.h"
+#include "src/core/lib/gprpp/host_port.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/pollset.h"
+#include "src/core/lib/iomgr/pollset_set.h"
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+// Track live heap bytes so that the benchmark can report the memory held
+// by the watchers.
+static std::atomic<int64_t> g_live_bytes{0};
+
+void* operator new(std::size_t size) {
+  void* p = malloc(size + sizeof(max_align_t));
+  if (p == nullptr) throw std::bad_alloc();
+  *static_cast<std::size_t*>(p) = size;
+  g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+  return static_cast<char*>(p) + sizeof(max_align_t);
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr) return;
+  void* base = static_cast<char*>(p) - sizeof(max_align_t);
+  g_live_bytes.fetch_sub(*static_cast<std::size_t*>(base),
+                         std::memory_order_relaxed);
+  free(base);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+  operator delete(p);
+}
+
+namespace grpc_core {
+namespace {
+
+constexpr int kLocalitiesPerCluster = 10;
+constexpr int kEndpointsPerLocality = 10;
+
+std::string ClusterName(int cluster) {
+  return absl::StrCat("cluster", cluster);
+}
+
+upb_strview ToUpb(upb_arena* arena, const std::string& s) {
+  char* data = static_cast<char*>(upb_arena_malloc(arena, s.size()));
+  memcpy(data, s.data(), s.size());
+  return upb_strview_make(data, s.size());
+}
+
+// A DiscoveryResponse holding a ClusterLoadAssignment for each of the first
+// \a num_clusters clusters.  The endpoint ports change with \a version so
+// that the XdsClient does not skip the update as unchanged.
+std::string MakeEdsResponse(int num_clusters, int version) {
+  upb::Arena arena;
+  auto* response =
+      envoy_service_discovery_v3_DiscoveryResponse_new(arena.ptr());
+  const std::string version_str = absl::StrCat(version);
+  envoy_service_discovery_v3_DiscoveryResponse_set_version_info(
+      response, ToUpb(arena.ptr(), version_str));
+  envoy_service_discovery_v3_DiscoveryResponse_set_nonce(
+      response, ToUpb(arena.ptr(), version_str));
+  envoy_service_discovery_v3_DiscoveryResponse_set_type_url(
+      response, upb_strview_makez(XdsApi::kEdsTypeUrl));
+  for (int cluster = 0; cluster < num_clusters; ++cluster) {
+    auto* assignment =
+        envoy_config_endpoint_v3_ClusterLoadAssignment_new(arena.ptr());
+    envoy_config_endpoint_v3_ClusterLoadAssignment_set_cluster_name(
+        assignment, ToUpb(arena.ptr(), ClusterName(cluster)));
+    for (int i = 0; i < kLocalitiesPerCluster; ++i) {
+      auto* locality_endpoints =
+          envoy_config_endpoint_v3_ClusterLoadAssignment_add_endpoints(
+              assignment, arena.ptr());
+      auto* locality =
+          envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_locality(
+              locality_endpoints, arena.ptr());
+      envoy_config_core_v3_Locality_set_region(locality,
+                                               upb_strview_makez("region"));
+      envoy_config_core_v3_Locality_set_zone(
+          locality, ToUpb(arena.ptr(), absl::StrCat("zone", i)));
+      envoy_config_core_v3_Locality_set_sub_zone(
+          locality, ToUpb(arena.ptr(), absl::StrCat("subzone", i)));
+      auto* weight =
+          envoy_config_endpoint_v3_LocalityLbEndpoints_mutable_load_balancing_weight(
+              locality_endpoints, arena.ptr());
+      google_protobuf_UInt32Value_set_value(weight, 1);
+      for (int j = 0; j < kEndpointsPerLocality; ++j) {
+        auto* lb_endpoint =
+            envoy_config_endpoint_v3_LocalityLbEndpoints_add_lb_endpoints(
+                locality_endpoints, arena.ptr());
+        auto* endpoint = envoy_config_endpoint_v3_LbEndpoint_mutable_endpoint(
+            lb_endpoint, arena.ptr());
+        auto* socket_address =
+            envoy_config_core_v3_Address_mutable_socket_address(
+                envoy_config_endpoint_v3_Endpoint_mutable_address(endpoint,
+                                                                  arena.ptr()),
+                arena.ptr());
+        envoy_config_core_v3_SocketAddress_set_address(
+            socket_address,
+            ToUpb(arena.ptr(),
+                  absl::StrCat("10.", cluster % 256, ".", i, ".", j)));
+        envoy_config_core_v3_SocketAddress_set_port_value(
+            socket_address, 1024 + version % 60000);
+      }
+    }
+    size_t length;
+    char* serialized = envoy_config_endpoint_v3_ClusterLoadAssignment_serialize(
+        assignment, arena.ptr(), &length);
+    auto* resource = envoy_service_discovery_v3_DiscoveryResponse_add_resources(
+        response, arena.ptr());
+    google_protobuf_Any_set_type_url(resource,
+                                     upb_strview_makez(XdsApi::kEdsTypeUrl));
+    google_protobuf_Any_set_value(resource,
+                                  upb_strview_make(serialized, length));
+  }
+  size_t length;
+  char* serialized = envoy_service_discovery_v3_DiscoveryResponse_serialize(
+      response, arena.ptr(), &length);
+  return std::string(serialized, length);
+}
+
+// An ADS server that accepts one stream, ignores the requests on it, and
+// sends the EDS responses it is given.
+class FakeAdsServer {
+ public:
+  FakeAdsServer()
+      : address_(JoinHostPort("localhost", grpc_pick_unused_port_or_die())),
+        server_(grpc_server_create(nullptr, nullptr)),
+        cq_(grpc_completion_queue_create_for_next(nullptr)) {
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    GPR_ASSERT(grpc_server_add_insecure_http2_port(server_, address_.c_str()));
+    grpc_server_start(server_);
+    grpc_call_details_init(&call_details_);
+    grpc_metadata_array_init(&request_metadata_);
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(server_, &call_, &call_details_,
+                                        &request_metadata_, cq_, cq_,
+                                        Tag(kCallArrived)));
+    thread_ = Thread(
+        "fake_ads_server",
+        [](void* arg) { static_cast<FakeAdsServer*>(arg)->Serve(); }, this);
+    thread_.Start();
+  }
+
+  ~FakeAdsServer() {
+    grpc_server_shutdown_and_notify(server_, cq_, Tag(kShutdown));
+    grpc_server_cancel_all_calls(server_);
+    thread_.Join();
+    if (call_ != nullptr) grpc_call_unref(call_);
+    grpc_call_details_destroy(&call_details_);
+    grpc_metadata_array_destroy(&request_metadata_);
+    grpc_server_destroy(server_);
+    grpc_completion_queue_destroy(cq_);
+  }
+
+  std::string Bootstrap() const {
+    return absl::StrCat(
+        "{\"xds_servers\": [{\"server_uri\": \"", address_,
+        "\", \"channel_creds\": [{\"type\": \"insecure\"}],"
+        " \"server_features\": [\"xds_v3\"]}],"
+        " \"node\": {\"id\": \"bm_xds_watchers\"}}");
+  }
+
+  bool stream_started() const { return stream_started_.load(); }
+
+  // Starts sending \a response.  The stream must have started, and the
+  // previous response must have been sent.
+  void StartSend(const std::string& response) {
+    GPR_ASSERT(send_done_.exchange(false));
+    grpc_slice slice = grpc_slice_from_copied_buffer(response.data(),
+                                                     response.size());
+    grpc_byte_buffer* buffer = grpc_raw_byte_buffer_create(&slice, 1);
+    grpc_slice_unref(slice);
+    grpc_op op = {};
+    op.op = GRPC_OP_SEND_MESSAGE;
+    op.data.send_message.send_message = buffer;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(call_, &op, 1, Tag(kSent), nullptr));
+    grpc_byte_buffer_destroy(buffer);
+  }
+
+  bool send_done() const { return send_done_.load(); }
+
+ private:
+  enum : intptr_t { kCallArrived = 1, kReceived, kSent, kShutdown };
+
+  static void* Tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+  void StartReceive() {
+    grpc_op op = {};
+    op.op = GRPC_OP_RECV_MESSAGE;
+    op.data.recv_message.recv_message = &request_;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_call_start_batch(call_, &op, 1, Tag(kReceived), nullptr));
+  }
+
+  void Serve() {
+    while (true) {
+      grpc_event ev = grpc_completion_queue_next(
+          cq_, gpr_inf_future(GPR_CLOCK_MONOTONIC), nullptr);
+      if (ev.type == GRPC_QUEUE_SHUTDOWN) return;
+      GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+      switch (reinterpret_cast<intptr_t>(ev.tag)) {
+        case kCallArrived: {
+          if (!ev.success) break;
+          grpc_op op = {};
+          op.op = GRPC_OP_SEND_INITIAL_METADATA;
+          GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(call_, &op, 1,
+                                                           nullptr, nullptr));
+          StartReceive();
+          stream_started_.store(true);
+          break;
+        }
+        case kReceived:
+          // The client's requests and ACKs are not needed.
+          if (request_ == nullptr) break;
+          grpc_byte_buffer_destroy(request_);
+          request_ = nullptr;
+          StartReceive();
+          break;
+        case kSent:
+          send_done_.store(true);
+          break;
+        case kShutdown:
+          grpc_completion_queue_shutdown(cq_);
+          break;
+      }
+    }
+  }
+
+  const std::string address_;
+  grpc_server* server_;
+  grpc_completion_queue* cq_;
+  grpc_call* call_ = nullptr;
+  grpc_call_details call_details_;
+  grpc_metadata_array request_metadata_;
+  grpc_byte_buffer* request_ = nullptr;
+  std::atomic<bool> stream_started_{false};
+  std::atomic<bool> send_done_{true};
+  Thread thread_;
+};
+
+// The number of EDS updates delivered to the watchers.
+std::atomic<int64_t> g_updates_delivered{0};
+
+// Keeps the snapshot it is given, as the xds_cluster_resolver policy does.
+class SharingWatcher : public XdsClient::EndpointWatcherInterface {
+ public:
+  void OnEndpointChanged(
+      std::shared_ptr<const XdsApi::EdsUpdate> update) override {
+    update_ = std::move(update);
+    g_updates_delivered.fetch_add(1, std::memory_order_relaxed);
+  }
+  void OnError(grpc_error_handle error) override { GRPC_ERROR_UNREF(error); }
+  void OnResourceDoesNotExist() override {}
+
+ private:
+  std::shared_ptr<const XdsApi::EdsUpdate> update_;
+};
+
+// Keeps its own copy of every update, as every watcher did before updates
+// were shared.
+class CopyingWatcher : public XdsClient::EndpointWatcherInterface {
+ public:
+  void OnEndpointChanged(
+      std::shared_ptr<const XdsApi::EdsUpdate> update) override {
+    update_ = *update;
+    g_updates_delivered.fetch_add(1, std::memory_order_relaxed);
+  }
+  void OnError(grpc_error_handle error) override { GRPC_ERROR_UNREF(error); }
+  void OnResourceDoesNotExist() override {}
+
+ private:
+  absl::optional<XdsApi::EdsUpdate> update_;
+};
+
+// Polls the XdsClient's pollset_set, as the channels using it would, until
+// \a done returns true.
+template <class Predicate>
+void PollUntil(grpc_pollset* pollset, gpr_mu* mu, Predicate done) {
+  while (!done()) {
+    ExecCtx exec_ctx;
+    grpc_pollset_worker* worker = nullptr;
+    gpr_mu_lock(mu);
+    GRPC_LOG_IF_ERROR("pollset_work",
+                      grpc_pollset_work(pollset, &worker,
+                                        ExecCtx::Get()->Now() + 10));
+    gpr_mu_unlock(mu);
+  }
+}
+
+// Args: number of channels, number of clusters each channel watches.
+template <class Watcher>
+void BM_EdsFanOut(benchmark::State& state) {
+  const int num_channels = state.range(0);
+  const int num_clusters = state.range(1);
+  const int64_t bytes_before = g_live_bytes.load();
+  FakeAdsServer server;
+  ExecCtx exec_ctx;
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  auto bootstrap = XdsBootstrap::Create(server.Bootstrap(), &error);
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  auto xds_client = MakeRefCounted<XdsClient>(std::move(bootstrap), nullptr);
+  gpr_mu* mu;
+  grpc_pollset* pollset =
+      static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+  grpc_pollset_init(pollset, &mu);
+  grpc_pollset_set_add_pollset(xds_client->interested_parties(), pollset);
+  // One watcher per channel per cluster.
+  std::vector<std::vector<Watcher*>> watchers(num_clusters);
+  for (int cluster = 0; cluster < num_clusters; ++cluster) {
+    for (int i = 0; i < num_channels; ++i) {
+      auto watcher = absl::make_unique<Watcher>();
+      watchers[cluster].push_back(watcher.get());
+      xds_client->WatchEndpointData(ClusterName(cluster), std::move(watcher));
+    }
+  }
+  exec_ctx.Flush();
+  PollUntil(pollset, mu, [&server]() { return server.stream_started(); });
+  int version = 0;
+  for (auto _ : state) {
+    // The XdsClient parses each cluster once and hands the result to every
+    // watcher of that cluster.
+    state.PauseTiming();
+    std::string response = MakeEdsResponse(num_clusters, ++version);
+    const int64_t delivered = g_updates_delivered.load() +
+                              static_cast<int64_t>(num_channels) * num_clusters;
+    state.ResumeTiming();
+    server.StartSend(response);
+    PollUntil(pollset, mu, [&server, delivered]() {
+      return server.send_done() && g_updates_delivered.load() >= delivered;
+    });
+  }
+  state.counters["bytes_per_channel"] =
+      static_cast<double>(g_live_bytes.load() - bytes_before) / num_channels;
+  state.SetItemsProcessed(state.iterations() * num_channels * num_clusters);
+  for (int cluster = 0; cluster < num_clusters; ++cluster) {
+    for (Watcher* watcher : watchers[cluster]) {
+      xds_client->CancelEndpointDataWatch(ClusterName(cluster), watcher);
+    }
+  }
+  grpc_pollset_set_del_pollset(xds_client->interested_parties(), pollset);
+  xds_client.reset();
+  grpc_closure on_shutdown;
+  GRPC_CLOSURE_INIT(
+      &on_shutdown, [](void* /*arg*/, grpc_error_handle /*error*/) {}, nullptr,
+      grpc_schedule_on_exec_ctx);
+  grpc_pollset_shutdown(pollset, &on_shutdown);
+  exec_ctx.Flush();
+  grpc_pollset_destroy(pollset);
+  gpr_free(pollset);
+}
+BENCHMARK_TEMPLATE(BM_EdsFanOut, SharingWatcher)
+    ->Args({100, 10})
+    ->Args({500, 10})
+    ->Args({100, 50});
+BENCHMARK_TEMPLATE(BM_EdsFanOut, CopyingWatcher)
+    ->Args({100, 10})
+    ->Args({500, 10})
+    ->Args({100, 50});
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc_init();
+  ::benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
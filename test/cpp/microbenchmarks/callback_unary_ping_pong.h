@@ -95,6 +95,45 @@ static void BM_CallbackUnaryPingPong(benchmark::State& state) {
                           response_msgs_size * state.iterations());
 }
 
+class RoundRobinConfiguration : public FixtureConfiguration {
+ public:
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    c->SetLoadBalancingPolicyName("round_robin");
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+  }
+};
+
+// Issues blocking unary calls from every benchmark thread over one shared
+// round_robin channel, so that the LB picks of all calls run concurrently on
+// the same client channel and picker.
+template <class Fixture>
+static void BM_CallbackUnaryConcurrentPicks(benchmark::State& state) {
+  static CallbackStreamingTestService* service = nullptr;
+  static Fixture* fixture = nullptr;
+  // Setup for each run of test.
+  if (state.thread_index == 0) {
+    service = new CallbackStreamingTestService;
+    fixture = new Fixture(service, RoundRobinConfiguration());
+  }
+  std::unique_ptr<EchoTestService::Stub> stub;
+  EchoRequest request;
+  EchoResponse response;
+  for (auto _ : state) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    // Threads only wait for the fixture once they enter the loop.
+    if (stub == nullptr) stub = EchoTestService::NewStub(fixture->channel());
+    ClientContext cli_ctx;
+    GPR_ASSERT(stub->Echo(&cli_ctx, request, &response).ok());
+  }
+  state.SetItemsProcessed(state.iterations());
+  // Teardown at the end of each test run.
+  if (state.thread_index == 0) {
+    fixture->Finish(state);
+    delete fixture;
+    delete service;
+  }
+}
+
 }  // namespace testing
 }  // namespace grpc
 
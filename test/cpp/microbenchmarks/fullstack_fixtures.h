@@ -328,6 +328,31 @@ typedef MinStackize<InProcess> MinInProcess;
 typedef MinStackize<SockPair> MinSockPair;
 typedef MinStackize<InProcessCHTTP2> MinInProcessCHTTP2;
 
+////////////////////////////////////////////////////////////////////////////////
+// Fixtures that jump over pass-through filters
+
+class FilterSkippingConfiguration : public FixtureConfiguration {
+  void ApplyCommonChannelArguments(ChannelArguments* a) const override {
+    a->SetInt(GRPC_ARG_SKIP_PASSTHROUGH_FILTERS, 1);
+    FixtureConfiguration::ApplyCommonChannelArguments(a);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    b->AddChannelArgument(GRPC_ARG_SKIP_PASSTHROUGH_FILTERS, 1);
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+};
+
+template <class Base>
+class FilterSkipping : public Base {
+ public:
+  explicit FilterSkipping(Service* service)
+      : Base(service, FilterSkippingConfiguration()) {}
+};
+
+typedef FilterSkipping<TCP> SkipTCP;
+typedef FilterSkipping<InProcessCHTTP2> SkipInProcessCHTTP2;
+
 }  // namespace testing
 }  // namespace grpc
 
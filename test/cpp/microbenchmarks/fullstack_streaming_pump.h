@@ -22,7 +22,15 @@
 #define TEST_CPP_MICROBENCHMARKS_FULLSTACK_STREAMING_PUMP_H
 
 #include <benchmark/benchmark.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
 #include <sstream>
+#include <vector>
+
 #include "src/core/lib/profiling/timers.h"
 #include "src/proto/grpc/testing/echo.grpc.pb.h"
 #include "test/cpp/microbenchmarks/fullstack_context_mutators.h"
@@ -163,6 +171,245 @@ static void BM_PumpStreamServerToClient(benchmark::State& state) {
   fixture.reset();
   state.SetBytesProcessed(state.range(0) * state.iterations());
 }
+
+class StreamMemoryBudgetConfiguration : public FixtureConfiguration {
+ public:
+  explicit StreamMemoryBudgetConfiguration(int budget) : budget_(budget) {}
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    if (budget_ > 0) c->SetInt(GRPC_ARG_HTTP2_STREAM_MEMORY_BUDGET, budget_);
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+  }
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    if (budget_ > 0) {
+      b->AddChannelArgument(GRPC_ARG_HTTP2_STREAM_MEMORY_BUDGET, budget_);
+    }
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+
+ private:
+  const int budget_;
+};
+
+static int64_t ResidentSetBytes() {
+  int64_t pages = 0;
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (f == nullptr) return 0;
+  if (fscanf(f, "%*d %" SCNd64, &pages) != 1) pages = 0;
+  fclose(f);
+  return pages * sysconf(_SC_PAGESIZE);
+}
+
+// Opens range(0) streams whose clients write as fast as flow control allows,
+// while the server reads just one message per stream per iteration. With a
+// stream memory budget of range(1) bytes, resident memory must stay within
+// the budget plus a fixed allowance per stream.
+template <class Fixture>
+static void BM_PumpManySlowConsumerStreams(benchmark::State& state) {
+  const int num_streams = static_cast<int>(state.range(0));
+  const int budget = static_cast<int>(state.range(1));
+  const int64_t kPerStreamAllowance = 48 * 1024;
+  const int64_t rss_before = ResidentSetBytes();
+  EchoTestService::AsyncService service;
+  std::unique_ptr<Fixture> fixture(
+      new Fixture(&service, StreamMemoryBudgetConfiguration(budget)));
+  {
+    // Tags are stream index * 4 + one of these.
+    enum { kWrite, kRead, kClient, kServer };
+    auto stream_tag = [](int i, int kind) {
+      return tag(static_cast<intptr_t>(i) * 4 + kind);
+    };
+    EchoRequest send_request;
+    send_request.set_message(std::string(1024, 'a'));
+    std::vector<EchoRequest> recv_requests(num_streams);
+    std::vector<std::unique_ptr<ServerContext>> svr_ctxs;
+    std::vector<
+        std::unique_ptr<ServerAsyncReaderWriter<EchoResponse, EchoRequest>>>
+        response_rws;
+    std::vector<std::unique_ptr<ClientContext>> cli_ctxs;
+    std::vector<
+        std::unique_ptr<ClientAsyncReaderWriter<EchoRequest, EchoResponse>>>
+        request_rws;
+    std::vector<Status> final_statuses(num_streams);
+    std::unique_ptr<EchoTestService::Stub> stub(
+        EchoTestService::NewStub(fixture->channel()));
+    for (int i = 0; i < num_streams; i++) {
+      svr_ctxs.emplace_back(new ServerContext);
+      response_rws.emplace_back(
+          new ServerAsyncReaderWriter<EchoResponse, EchoRequest>(
+              svr_ctxs.back().get()));
+      service.RequestBidiStream(svr_ctxs.back().get(),
+                                response_rws.back().get(), fixture->cq(),
+                                fixture->cq(), stream_tag(i, kServer));
+      cli_ctxs.emplace_back(new ClientContext);
+      request_rws.push_back(stub->AsyncBidiStream(
+          cli_ctxs.back().get(), fixture->cq(), stream_tag(i, kClient)));
+    }
+    void* t;
+    bool ok;
+    for (int i = 0; i < 2 * num_streams; i++) {
+      GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+      GPR_ASSERT(ok);
+    }
+    for (int i = 0; i < num_streams; i++) {
+      request_rws[i]->Write(send_request, stream_tag(i, kWrite));
+    }
+    int outstanding = num_streams;
+    for (auto _ : state) {
+      GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+      for (int i = 0; i < num_streams; i++) {
+        response_rws[i]->Read(&recv_requests[i], stream_tag(i, kRead));
+      }
+      int reads_pending = num_streams;
+      while (reads_pending > 0) {
+        GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+        GPR_ASSERT(ok);
+        intptr_t i = reinterpret_cast<intptr_t>(t);
+        if (i % 4 == kRead) {
+          reads_pending--;
+        } else {
+          GPR_ASSERT(i % 4 == kWrite);
+          request_rws[i / 4]->Write(send_request, t);
+        }
+      }
+    }
+    const int64_t rss_growth = ResidentSetBytes() - rss_before;
+    state.counters["rss_growth_mb"] =
+        static_cast<double>(rss_growth) / (1024 * 1024);
+    if (budget > 0 && rss_growth > budget + num_streams * kPerStreamAllowance) {
+      state.SkipWithError("resident memory exceeded the stream memory budget");
+    }
+    for (int i = 0; i < num_streams; i++) {
+      cli_ctxs[i]->TryCancel();
+      response_rws[i]->Finish(Status::OK, stream_tag(i, kServer));
+      request_rws[i]->Finish(&final_statuses[i], stream_tag(i, kClient));
+    }
+    outstanding += 2 * num_streams;
+    while (outstanding > 0) {
+      GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+      outstanding--;
+    }
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(1024 * num_streams * state.iterations());
+}
+
+class ConnectionPoolConfiguration : public FixtureConfiguration {
+ public:
+  ConnectionPoolConfiguration(int max_connections, int streams_per_connection)
+      : max_connections_(max_connections),
+        streams_per_connection_(streams_per_connection) {}
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    c->SetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, max_connections_);
+    c->SetInt(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION,
+              streams_per_connection_);
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+  }
+
+ private:
+  const int max_connections_;
+  const int streams_per_connection_;
+};
+
+// Pumps client-to-server messages over range(0) streams while the
+// subchannel may open up to range(1) connections. Streams are opened one
+// connection's worth at a time, pausing whenever the open connections are
+// saturated so that the next connection is up before more streams arrive.
+template <class Fixture>
+static void BM_PumpStreamsAcrossConnections(benchmark::State& state) {
+  const int num_streams = static_cast<int>(state.range(0));
+  const int max_connections = static_cast<int>(state.range(1));
+  const int streams_per_connection = std::max(1, num_streams / max_connections);
+  const int kMessageSize = 64 * 1024;
+  EchoTestService::AsyncService service;
+  std::unique_ptr<Fixture> fixture(new Fixture(
+      &service,
+      ConnectionPoolConfiguration(max_connections, streams_per_connection)));
+  {
+    // Tags are stream index * 4 + one of these.
+    enum { kWrite, kRead, kClient, kServer };
+    auto stream_tag = [](int i, int kind) {
+      return tag(static_cast<intptr_t>(i) * 4 + kind);
+    };
+    EchoRequest send_request;
+    send_request.set_message(std::string(kMessageSize, 'a'));
+    std::vector<EchoRequest> recv_requests(num_streams);
+    std::vector<std::unique_ptr<ServerContext>> svr_ctxs;
+    std::vector<
+        std::unique_ptr<ServerAsyncReaderWriter<EchoResponse, EchoRequest>>>
+        response_rws;
+    std::vector<std::unique_ptr<ClientContext>> cli_ctxs;
+    std::vector<
+        std::unique_ptr<ClientAsyncReaderWriter<EchoRequest, EchoResponse>>>
+        request_rws;
+    std::vector<Status> final_statuses(num_streams);
+    std::unique_ptr<EchoTestService::Stub> stub(
+        EchoTestService::NewStub(fixture->channel()));
+    void* t;
+    bool ok;
+    for (int i = 0; i < num_streams; i++) {
+      svr_ctxs.emplace_back(new ServerContext);
+      response_rws.emplace_back(
+          new ServerAsyncReaderWriter<EchoResponse, EchoRequest>(
+              svr_ctxs.back().get()));
+      service.RequestBidiStream(svr_ctxs.back().get(),
+                                response_rws.back().get(), fixture->cq(),
+                                fixture->cq(), stream_tag(i, kServer));
+      cli_ctxs.emplace_back(new ClientContext);
+      request_rws.push_back(stub->AsyncBidiStream(
+          cli_ctxs.back().get(), fixture->cq(), stream_tag(i, kClient)));
+      for (int j = 0; j < 2; j++) {
+        GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+        GPR_ASSERT(ok);
+      }
+      if (i > 0 && i % streams_per_connection == 0) {
+        // This stream asked for another connection; poll while it comes up.
+        GPR_ASSERT(fixture->cq()->AsyncNext(
+                       &t, &ok,
+                       std::chrono::system_clock::now() +
+                           std::chrono::milliseconds(100)) ==
+                   CompletionQueue::TIMEOUT);
+      }
+    }
+    for (int i = 0; i < num_streams; i++) {
+      request_rws[i]->Write(send_request, stream_tag(i, kWrite));
+    }
+    int outstanding = num_streams;
+    for (auto _ : state) {
+      GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+      for (int i = 0; i < num_streams; i++) {
+        response_rws[i]->Read(&recv_requests[i], stream_tag(i, kRead));
+      }
+      int reads_pending = num_streams;
+      while (reads_pending > 0) {
+        GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+        GPR_ASSERT(ok);
+        intptr_t i = reinterpret_cast<intptr_t>(t);
+        if (i % 4 == kRead) {
+          reads_pending--;
+        } else {
+          GPR_ASSERT(i % 4 == kWrite);
+          request_rws[i / 4]->Write(send_request, t);
+        }
+      }
+    }
+    for (int i = 0; i < num_streams; i++) {
+      cli_ctxs[i]->TryCancel();
+      response_rws[i]->Finish(Status::OK, stream_tag(i, kServer));
+      request_rws[i]->Finish(&final_statuses[i], stream_tag(i, kClient));
+    }
+    outstanding += 2 * num_streams;
+    while (outstanding > 0) {
+      GPR_ASSERT(fixture->cq()->Next(&t, &ok));
+      outstanding--;
+    }
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  state.SetBytesProcessed(static_cast<int64_t>(kMessageSize) * num_streams *
+                          state.iterations());
+}
+
 }  // namespace testing
 }  // namespace grpc
 
@@ -0,0 +1,295 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "absl/strings/str_cat.h"
+
+#include "src/core/ext/filters/client_channel/resolver/dns/c_ares/grpc_ares_wrapper.h"
+#include "src/core/ext/filters/client_channel/resolver/dns/dns_resolver_selection.h"
+#include "src/core/lib/iomgr/pollset.h"
+#include "src/core/lib/iomgr/pollset_set.h"
+#include "src/core/lib/iomgr/work_serializer.h"
+#include "test/core/util/test_config.h"
+
+namespace {
+
+// A DNS server on localhost that counts the queries it receives and answers
+// A queries with 127.0.0.1, answers every query with NXDOMAIN, or never
+// answers.
+class FakeDnsServer {
+ public:
+  enum class Mode { kAnswer, kNameError, kNoReply };
+
+  explicit FakeDnsServer(Mode mode) : mode_(mode) {
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    GPR_ASSERT(socket_ >= 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    GPR_ASSERT(bind(socket_, reinterpret_cast<const sockaddr*>(&addr),
+                    sizeof(addr)) == 0);
+    socklen_t addr_len = sizeof(addr);
+    GPR_ASSERT(getsockname(socket_, reinterpret_cast<sockaddr*>(&addr),
+                           &addr_len) == 0);
+    address_ = absl::StrCat("127.0.0.1:", ntohs(addr.sin_port));
+    thread_ = std::thread([this]() { Serve(); });
+  }
+
+  ~FakeDnsServer() {
+    shutdown_ = true;
+    thread_.join();
+    close(socket_);
+  }
+
+  const std::string& address() const { return address_; }
+
+  int num_queries() const { return num_queries_; }
+
+ private:
+  void Serve() {
+    while (!shutdown_) {
+      pollfd pfd = {socket_, POLLIN, 0};
+      if (poll(&pfd, 1, 100) <= 0) continue;
+      char query[512];
+      sockaddr_storage from;
+      socklen_t from_len = sizeof(from);
+      const ssize_t query_len =
+          recvfrom(socket_, query, sizeof(query), 0,
+                   reinterpret_cast<sockaddr*>(&from), &from_len);
+      if (query_len < 12) continue;
+      ++num_queries_;
+      if (mode_ == Mode::kNoReply) continue;
+      // The question is the name's labels, then the type and the class.
+      ssize_t question_end = 12;
+      while (question_end < query_len && query[question_end] != 0) {
+        question_end += static_cast<uint8_t>(query[question_end]) + 1;
+      }
+      question_end += 5;
+      if (question_end > query_len) continue;
+      const bool type_a = query[question_end - 4] == 0 &&
+                          query[question_end - 3] == 1;
+      const bool answer = mode_ == Mode::kAnswer && type_a;
+      std::string reply(query, question_end);
+      reply[2] = static_cast<char>(0x81);  // response, recursion desired
+      reply[3] = static_cast<char>(mode_ == Mode::kNameError ? 0x83 : 0x80);
+      reply.replace(6, 6, std::string(6, '\0'));
+      if (answer) {
+        reply[7] = 1;
+        // Name (a pointer to the question's), type A, class IN, a TTL of 60s
+        // and 127.0.0.1.
+        reply.append("\xc0\x0c\x00\x01\x00\x01\x00\x00\x00\x3c\x00\x04"
+                     "\x7f\x00\x00\x01",
+                     16);
+      }
+      sendto(socket_, reply.data(), reply.size(), 0,
+             reinterpret_cast<const sockaddr*>(&from), from_len);
+    }
+  }
+
+  const Mode mode_;
+  int socket_;
+  std::string address_;
+  std::atomic<bool> shutdown_{false};
+  std::atomic<int> num_queries_{0};
+  std::thread thread_;
+};
+
+struct LookupResult {
+  grpc_error_handle error = GRPC_ERROR_NONE;
+  std::unique_ptr<grpc_core::ServerAddressList> addresses;
+};
+
+// Looks up \a name through grpc_dns_lookup_ares_locked(), from its own
+// pollset_set and work_serializer like a resolver would, and waits for the
+// result.
+LookupResult Lookup(const FakeDnsServer& server, const char* name,
+                    int query_timeout_ms = 5000) {
+  struct State {
+    gpr_mu* mu;
+    grpc_pollset* pollset;
+    gpr_atm done;
+    LookupResult result;
+    grpc_closure on_done;
+  } state;
+  grpc_core::ExecCtx exec_ctx;
+  state.pollset = static_cast<grpc_pollset*>(gpr_zalloc(grpc_pollset_size()));
+  grpc_pollset_init(state.pollset, &state.mu);
+  gpr_atm_rel_store(&state.done, 0);
+  GRPC_CLOSURE_INIT(
+      &state.on_done,
+      [](void* arg, grpc_error_handle error) {
+        State* state = static_cast<State*>(arg);
+        state->result.error = GRPC_ERROR_REF(error);
+        gpr_mu_lock(state->mu);
+        gpr_atm_rel_store(&state->done, 1);
+        GRPC_LOG_IF_ERROR("pollset_kick",
+                          grpc_pollset_kick(state->pollset, nullptr));
+        gpr_mu_unlock(state->mu);
+      },
+      &state, grpc_schedule_on_exec_ctx);
+  grpc_pollset_set* pollset_set = grpc_pollset_set_create();
+  grpc_pollset_set_add_pollset(pollset_set, state.pollset);
+  auto work_serializer = std::make_shared<grpc_core::WorkSerializer>();
+  grpc_ares_request* request = nullptr;
+  work_serializer->Run(
+      [&]() {
+        request = grpc_dns_lookup_ares_locked(
+            server.address().c_str(), name, "443", pollset_set, &state.on_done,
+            &state.result.addresses, nullptr, nullptr, query_timeout_ms,
+            work_serializer);
+      },
+      DEBUG_LOCATION);
+  exec_ctx.Flush();
+  while (gpr_atm_acq_load(&state.done) == 0) {
+    grpc_core::ExecCtx poll_exec_ctx;
+    grpc_pollset_worker* worker = nullptr;
+    gpr_mu_lock(state.mu);
+    GRPC_LOG_IF_ERROR(
+        "pollset_work",
+        grpc_pollset_work(state.pollset, &worker,
+                          grpc_core::ExecCtx::Get()->Now() + 100));
+    gpr_mu_unlock(state.mu);
+  }
+  gpr_free(request);
+  grpc_pollset_set_del_pollset(pollset_set, state.pollset);
+  grpc_pollset_set_destroy(pollset_set);
+  grpc_closure on_shutdown;
+  GRPC_CLOSURE_INIT(
+      &on_shutdown, [](void* /*arg*/, grpc_error_handle /*error*/) {},
+      nullptr, grpc_schedule_on_exec_ctx);
+  grpc_pollset_shutdown(state.pollset, &on_shutdown);
+  exec_ctx.Flush();
+  grpc_pollset_destroy(state.pollset);
+  gpr_free(state.pollset);
+  return std::move(state.result);
+}
+
+class AresCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    GPR_GLOBAL_CONFIG_SET(grpc_dns_resolver, "ares");
+    grpc_init();
+  }
+
+  static void TearDownTestCase() { grpc_shutdown(); }
+
+  void TearDown() override {
+    GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_cache_ttl_ms, 0);
+    GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_negative_cache_ttl_ms, 1000);
+  }
+};
+
+TEST_F(AresCacheTest, CachingIsOffByDefault) {
+  FakeDnsServer server(FakeDnsServer::Mode::kAnswer);
+  LookupResult first = Lookup(server, "default.test.com");
+  ASSERT_EQ(first.error, GRPC_ERROR_NONE) << grpc_error_std_string(first.error);
+  const int num_queries = server.num_queries();
+  EXPECT_GT(num_queries, 0);
+  LookupResult second = Lookup(server, "default.test.com");
+  ASSERT_EQ(second.error, GRPC_ERROR_NONE)
+      << grpc_error_std_string(second.error);
+  EXPECT_GT(server.num_queries(), num_queries);
+}
+
+TEST_F(AresCacheTest, CachedResultIsReused) {
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_cache_ttl_ms, 60000);
+  FakeDnsServer server(FakeDnsServer::Mode::kAnswer);
+  LookupResult first = Lookup(server, "hit.test.com");
+  ASSERT_EQ(first.error, GRPC_ERROR_NONE) << grpc_error_std_string(first.error);
+  ASSERT_NE(first.addresses, nullptr);
+  const int num_queries = server.num_queries();
+  LookupResult second = Lookup(server, "hit.test.com");
+  ASSERT_EQ(second.error, GRPC_ERROR_NONE)
+      << grpc_error_std_string(second.error);
+  EXPECT_EQ(server.num_queries(), num_queries);
+  ASSERT_NE(second.addresses, nullptr);
+  EXPECT_EQ(*second.addresses, *first.addresses);
+}
+
+TEST_F(AresCacheTest, CachedResultExpires) {
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_cache_ttl_ms, 100);
+  FakeDnsServer server(FakeDnsServer::Mode::kAnswer);
+  LookupResult first = Lookup(server, "expiry.test.com");
+  ASSERT_EQ(first.error, GRPC_ERROR_NONE) << grpc_error_std_string(first.error);
+  const int num_queries = server.num_queries();
+  gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(300));
+  LookupResult second = Lookup(server, "expiry.test.com");
+  ASSERT_EQ(second.error, GRPC_ERROR_NONE)
+      << grpc_error_std_string(second.error);
+  EXPECT_GT(server.num_queries(), num_queries);
+}
+
+TEST_F(AresCacheTest, NegativeAnswerIsCached) {
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_cache_ttl_ms, 60000);
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_negative_cache_ttl_ms, 60000);
+  FakeDnsServer server(FakeDnsServer::Mode::kNameError);
+  LookupResult first = Lookup(server, "negative.test.com");
+  EXPECT_NE(first.error, GRPC_ERROR_NONE);
+  const int num_queries = server.num_queries();
+  EXPECT_GT(num_queries, 0);
+  LookupResult second = Lookup(server, "negative.test.com");
+  EXPECT_NE(second.error, GRPC_ERROR_NONE);
+  EXPECT_EQ(server.num_queries(), num_queries);
+}
+
+TEST_F(AresCacheTest, NegativeAnswerIsNotCachedWhenCachingIsOff) {
+  FakeDnsServer server(FakeDnsServer::Mode::kNameError);
+  LookupResult first = Lookup(server, "negative-off.test.com");
+  EXPECT_NE(first.error, GRPC_ERROR_NONE);
+  const int num_queries = server.num_queries();
+  LookupResult second = Lookup(server, "negative-off.test.com");
+  EXPECT_NE(second.error, GRPC_ERROR_NONE);
+  EXPECT_GT(server.num_queries(), num_queries);
+}
+
+TEST_F(AresCacheTest, TransientFailureIsNotCached) {
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_cache_ttl_ms, 60000);
+  GPR_GLOBAL_CONFIG_SET(grpc_dns_ares_negative_cache_ttl_ms, 60000);
+  FakeDnsServer server(FakeDnsServer::Mode::kNoReply);
+  LookupResult first = Lookup(server, "timeout.test.com", 300);
+  EXPECT_NE(first.error, GRPC_ERROR_NONE);
+  const int num_queries = server.num_queries();
+  EXPECT_GT(num_queries, 0);
+  LookupResult second = Lookup(server, "timeout.test.com", 300);
+  EXPECT_NE(second.error, GRPC_ERROR_NONE);
+  EXPECT_GT(server.num_queries(), num_queries);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -263,6 +263,45 @@ TEST_F(CancelDuringAresQuery, TestFdsAreDeletedFromPollsetSet) {
   grpc_pollset_set_destroy(fake_other_pollset_set);
 }
 
+TEST_F(CancelDuringAresQuery, TestCancelResolversSharingActiveDNSQuery) {
+  grpc_core::ExecCtx exec_ctx;
+  int fake_dns_port = grpc_pick_unused_port_or_die();
+  grpc::testing::FakeNonResponsiveDNSServer fake_dns_server(fake_dns_port);
+  std::string client_target = absl::StrFormat(
+      "dns://[::1]:%d/dont-care-since-wont-be-resolved.test.com:1234",
+      fake_dns_port);
+  // Two resolvers of the same target, each with its own pollset_set and
+  // work_serializer, wait on a single DNS query.
+  ArgsStruct args1;
+  ArgsInit(&args1);
+  ArgsStruct args2;
+  ArgsInit(&args2);
+  grpc_core::OrphanablePtr<grpc_core::Resolver> resolver1 =
+      grpc_core::ResolverRegistry::CreateResolver(
+          client_target.c_str(), nullptr, args1.pollset_set, args1.lock,
+          std::unique_ptr<grpc_core::Resolver::ResultHandler>(
+              new AssertFailureResultHandler(&args1)));
+  resolver1->StartLocked();
+  grpc_core::OrphanablePtr<grpc_core::Resolver> resolver2 =
+      grpc_core::ResolverRegistry::CreateResolver(
+          client_target.c_str(), nullptr, args2.pollset_set, args2.lock,
+          std::unique_ptr<grpc_core::Resolver::ResultHandler>(
+              new AssertFailureResultHandler(&args2)));
+  resolver2->StartLocked();
+  // Shutting down the first resolver completes its request without
+  // waiting for the query, which the second one is still waiting on.
+  resolver1.reset();
+  grpc_core::ExecCtx::Get()->Flush();
+  PollPollsetUntilRequestDone(&args1);
+  ArgsFinish(&args1);
+  // Shutting down the second resolver cancels the query.
+  resolver2.reset();
+  grpc_core::ExecCtx::Get()->Flush();
+  PollPollsetUntilRequestDone(&args2);
+  ArgsFinish(&args2);
+  EXPECT_EQ(grpc_iomgr_count_objects_for_testing(), 0u);
+}
+
 // Settings for TestCancelDuringActiveQuery test
 typedef enum {
   NONE,
@@ -0,0 +1,87 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/log.h>
+
+#include "test/core/util/test_config.h"
+#include "test/cpp/qps/benchmark_config.h"
+#include "test/cpp/qps/driver.h"
+#include "test/cpp/qps/report.h"
+#include "test/cpp/qps/server.h"
+#include "test/cpp/util/test_config.h"
+#include "test/cpp/util/test_credentials_provider.h"
+
+namespace grpc {
+namespace testing {
+
+static const int WARMUP = 5;
+static const int BENCHMARK = 5;
+
+// Offers more unary load than a single server thread can serve, so that
+// incoming calls queue up on the server.  With a queue delay target, the
+// excess calls are expected to be shed (and reported as failed requests)
+// while the latency of the calls that are served stays bounded.
+static std::unique_ptr<ScenarioResult> RunQPS(int queue_delay_target_ms) {
+  gpr_log(GPR_INFO, "Running QPS test, overload, queue delay target %dms",
+          queue_delay_target_ms);
+
+  ClientConfig client_config;
+  client_config.set_client_type(ASYNC_CLIENT);
+  client_config.set_outstanding_rpcs_per_channel(1000);
+  client_config.set_client_channels(8);
+  client_config.set_async_client_threads(8);
+  client_config.set_rpc_type(UNARY);
+  client_config.mutable_load_params()->mutable_poisson()->set_offered_load(
+      100000.0 / grpc_test_slowdown_factor());
+
+  ServerConfig server_config;
+  server_config.set_server_type(ASYNC_SERVER);
+  server_config.set_async_server_threads(1);
+  if (queue_delay_target_ms > 0) {
+    ChannelArg* arg = server_config.add_channel_args();
+    arg->set_name(GRPC_ARG_SERVER_QUEUE_DELAY_TARGET_MS);
+    arg->set_int_value(queue_delay_target_ms);
+  }
+
+  auto result =
+      RunScenario(client_config, 1, server_config, 1, WARMUP, BENCHMARK, -2, "",
+                  kInsecureCredentialsType, {}, false, 0);
+
+  GetReporter()->ReportQPS(*result);
+  GetReporter()->ReportLatency(*result);
+  return result;
+}
+
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  grpc::testing::InitTest(&argc, &argv, true);
+
+  const auto unbounded = grpc::testing::RunQPS(0);
+  // Without a queue delay target, no call is rejected by the server.
+  GPR_ASSERT(unbounded->summary().failed_requests_per_second() == 0);
+  const auto bounded = grpc::testing::RunQPS(20);
+  // With one, calls are shed or the served calls wait less.
+  GPR_ASSERT(bounded->summary().failed_requests_per_second() > 0 ||
+             bounded->summary().latency_99() <
+                 unbounded->summary().latency_99());
+
+  return 0;
+}
@@ -167,6 +167,10 @@ class SynchronousServer final : public grpc::testing::Server {
     }
 
     ApplyConfigToBuilder(config, builder.get());
+    if (config.sync_server_thread_per_core()) {
+      builder->SetSyncServerOption(
+          ServerBuilder::SyncServerOption::THREAD_PER_CORE, 1);
+    }
 
     builder->RegisterService(&service_);
 
@@ -16,7 +16,9 @@
  *
  */
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include <grpcpp/impl/codegen/config.h>
 
@@ -156,6 +158,95 @@ TEST(ServerRequestCallTest, ShortDeadlineDoesNotCauseOkayFalse) {
   t.join();
 }
 
+// Runs many more concurrent calls than there are requested calls, spread
+// over many completion queues, so that most calls go through the pending
+// list.  Every call must be matched to exactly one request.
+TEST(ServerRequestCallTest, ManyCqsMatchEachCallExactlyOnce) {
+  constexpr int kNumCqs = 32;
+  constexpr int kNumChannels = 8;
+  constexpr int kNumClientThreads = 64;
+  constexpr int kCallsPerThread = 50;
+
+  std::ostringstream s;
+  int p = grpc_pick_unused_port_or_die();
+  s << "[::1]:" << p;
+  const string address = s.str();
+  testing::EchoTestService::AsyncService service;
+  ServerBuilder builder;
+  builder.AddListeningPort(address, InsecureServerCredentials());
+  std::vector<std::unique_ptr<ServerCompletionQueue>> cqs;
+  for (int i = 0; i < kNumCqs; i++) {
+    cqs.push_back(builder.AddCompletionQueue());
+  }
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+
+  // One server thread per cq, with a single requested call at a time.
+  std::atomic<int> calls_handled{0};
+  std::vector<std::thread> server_threads;
+  for (int i = 0; i < kNumCqs; i++) {
+    ServerCompletionQueue* cq = cqs[i].get();
+    server_threads.emplace_back([&service, &calls_handled, cq] {
+      while (true) {
+        ServerContext ctx;
+        testing::EchoRequest req;
+        ServerAsyncResponseWriter<testing::EchoResponse> responder(&ctx);
+        service.RequestEcho(&ctx, &req, &responder, cq, cq,
+                            reinterpret_cast<void*>(1));
+        bool ok;
+        void* tag;
+        // ok is false only once the server is shutting down.
+        if (!cq->Next(&tag, &ok) || !ok) break;
+        EXPECT_EQ((void*)1, tag);
+        calls_handled++;
+        testing::EchoResponse response;
+        response.set_message(req.message());
+        responder.Finish(response, grpc::Status::OK,
+                         reinterpret_cast<void*>(2));
+        if (!cq->Next(&tag, &ok)) break;
+        EXPECT_EQ((void*)2, tag);
+      }
+    });
+  }
+
+  std::vector<std::unique_ptr<testing::EchoTestService::Stub>> stubs;
+  for (int i = 0; i < kNumChannels; i++) {
+    ChannelArguments args;
+    // Use a separate connection for each channel.
+    args.SetInt("grpc.channel_id", i);
+    stubs.push_back(testing::EchoTestService::NewStub(grpc::CreateCustomChannel(
+        address, InsecureChannelCredentials(), args)));
+  }
+  std::vector<std::thread> client_threads;
+  for (int i = 0; i < kNumClientThreads; i++) {
+    testing::EchoTestService::Stub* stub = stubs[i % kNumChannels].get();
+    client_threads.emplace_back([stub] {
+      for (int n = 0; n < kCallsPerThread; n++) {
+        testing::EchoRequest request;
+        request.set_message("foobar");
+        testing::EchoResponse response;
+        ::grpc::ClientContext ctx;
+        ctx.set_deadline(grpc_timeout_seconds_to_deadline(30));
+        grpc::Status status = stub->Echo(&ctx, request, &response);
+        EXPECT_TRUE(status.ok()) << status.error_message();
+        EXPECT_EQ("foobar", response.message());
+      }
+    });
+  }
+  for (auto& t : client_threads) t.join();
+  EXPECT_EQ(kNumClientThreads * kCallsPerThread, calls_handled.load());
+
+  server->Shutdown();
+  for (auto& t : server_threads) t.join();
+  for (auto& cq : cqs) {
+    cq->Shutdown();
+    bool ok;
+    void* tag;
+    while (cq->Next(&tag, &ok)) {
+    }
+  }
+}
+
 }  // namespace
 }  // namespace grpc
 
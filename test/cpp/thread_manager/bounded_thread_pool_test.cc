@@ -0,0 +1,169 @@
+/*
+ *
+ * Copyright 2021 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <grpc/support/sync.h>
+#include <grpc/support/time.h>
+
+#include "src/cpp/server/bounded_thread_pool.h"
+#include "test/core/util/test_config.h"
+
+#include <gtest/gtest.h>
+
+namespace grpc {
+namespace {
+
+void WaitFor(gpr_event* event) {
+  ASSERT_NE(gpr_event_wait(event, grpc_timeout_seconds_to_deadline(10)),
+            nullptr);
+}
+
+TEST(BoundedThreadPoolTest, AddBlocksWhileQueueIsFull) {
+  gpr_event started;
+  gpr_event release;
+  gpr_event added;
+  gpr_event_init(&started);
+  gpr_event_init(&release);
+  gpr_event_init(&added);
+  std::atomic<int> ran{0};
+  {
+    BoundedThreadPool pool(1, 2);
+    // Keep the only thread busy so that nothing leaves the queue.
+    pool.Add([&]() {
+      gpr_event_set(&started, reinterpret_cast<void*>(1));
+      WaitFor(&release);
+      ran++;
+    });
+    WaitFor(&started);
+    pool.Add([&]() { ran++; });
+    pool.Add([&]() { ran++; });
+    std::thread producer([&]() {
+      pool.Add([&]() { ran++; });
+      gpr_event_set(&added, reinterpret_cast<void*>(1));
+    });
+    EXPECT_EQ(
+        gpr_event_wait(&added, grpc_timeout_milliseconds_to_deadline(200)),
+        nullptr);
+    gpr_event_set(&release, reinterpret_cast<void*>(1));
+    WaitFor(&added);
+    producer.join();
+  }
+  EXPECT_EQ(ran, 4);
+}
+
+TEST(BoundedThreadPoolTest, AddFromPoolThreadRunsInlineWhenQueueIsFull) {
+  constexpr int kCallbacks = 5;
+  std::atomic<int> ran{0};
+  std::atomic<int> ran_inline{0};
+  std::atomic<bool> ran_on_other_thread{false};
+  gpr_event done;
+  gpr_event_init(&done);
+  {
+    BoundedThreadPool pool(1, 2);
+    pool.Add([&]() {
+      const std::thread::id pool_thread = std::this_thread::get_id();
+      // The first two callbacks fill the queue; the rest cannot wait for the
+      // only thread, which is this one, to make room.
+      for (int i = 0; i < kCallbacks; i++) {
+        pool.Add([&, pool_thread]() {
+          if (std::this_thread::get_id() != pool_thread) {
+            ran_on_other_thread = true;
+          }
+          ran++;
+        });
+      }
+      ran_inline = ran.load();
+      gpr_event_set(&done, reinterpret_cast<void*>(1));
+    });
+    WaitFor(&done);
+  }
+  EXPECT_EQ(ran_inline, kCallbacks - 2);
+  EXPECT_EQ(ran, kCallbacks);
+  EXPECT_FALSE(ran_on_other_thread);
+}
+
+TEST(BoundedThreadPoolTest, DestructorRunsQueuedCallbacks) {
+  constexpr int kThreads = 2;
+  constexpr int kCallbacks = 50;
+  gpr_event release;
+  gpr_event_init(&release);
+  std::atomic<int> blocked{0};
+  std::atomic<int> ran{0};
+  std::unique_ptr<std::thread> releaser;
+  {
+    BoundedThreadPool pool(kThreads, 64);
+    for (int i = 0; i < kThreads; i++) {
+      pool.Add([&]() {
+        blocked++;
+        WaitFor(&release);
+      });
+    }
+    while (blocked < kThreads) std::this_thread::yield();
+    for (int i = 0; i < kCallbacks; i++) {
+      pool.Add([&]() { ran++; });
+    }
+    // All the callbacks are still queued when the pool starts shutting down.
+    releaser = std::unique_ptr<std::thread>(new std::thread([&]() {
+      gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(100));
+      gpr_event_set(&release, reinterpret_cast<void*>(1));
+    }));
+  }
+  EXPECT_EQ(ran, kCallbacks);
+  releaser->join();
+}
+
+TEST(BoundedThreadPoolTest, ManyProducers) {
+  constexpr int kProducers = 8;
+  constexpr int kCallbacksPerProducer = 10000;
+  std::atomic<int> ran{0};
+  std::atomic<int64_t> sum{0};
+  {
+    // A queue much smaller than the number of callbacks, so that producers
+    // keep blocking and waking up.
+    BoundedThreadPool pool(4, 8);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+      producers.emplace_back([&, p]() {
+        for (int i = 0; i < kCallbacksPerProducer; i++) {
+          const int64_t value = p * kCallbacksPerProducer + i;
+          pool.Add([&, value]() {
+            sum += value;
+            ran++;
+          });
+        }
+      });
+    }
+    for (auto& producer : producers) producer.join();
+  }
+  const int64_t total = kProducers * kCallbacksPerProducer;
+  EXPECT_EQ(ran, total);
+  EXPECT_EQ(sum, total * (total - 1) / 2);
+}
+
+}  // namespace
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
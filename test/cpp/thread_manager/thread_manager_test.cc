@@ -176,6 +176,82 @@ TEST_P(ThreadManagerTest, TestThreadQuota) {
   }
 }
 
+TEST(ThreadManagerFixedThreadTest, SpawnsAtMostOneOverflowPoller) {
+  // With min_pollers == max_pollers == 2 the dynamic manager would keep two
+  // pollers busy; a fixed thread only gets help while it is doing work, from
+  // a bounded number of overflow pollers.
+  TestThreadManagerSettings settings = {
+      2 /* min_pollers */, 2 /* max_pollers */, 1 /* poll_duration_ms */,
+      1 /* work_duration_ms */, 50 /* max_poll_calls */,
+      INT_MAX /* thread_limit */, 1 /* thread_manager_count */};
+  grpc_resource_quota* rq = grpc_resource_quota_create("Thread manager test");
+  TestThreadManager tm("TestThreadManager", rq, settings);
+  grpc_resource_quota_unref(rq);
+  tm.UseFixedPinnedThread(0);
+  tm.Initialize();
+  tm.Wait();
+  EXPECT_GE(tm.num_poll_for_work(), settings.max_poll_calls);
+  EXPECT_EQ(tm.num_do_work(), tm.num_work_found());
+  EXPECT_LE(tm.GetMaxActiveThreadsSoFar(),
+            1 + grpc::ThreadManager::kMaxOverflowPollers);
+}
+
+// The first work item blocks until a second one has been done, as a handler
+// waiting on another RPC to the same server would.
+class BlockingThreadManager final : public grpc::ThreadManager {
+ public:
+  explicit BlockingThreadManager(grpc_resource_quota* rq)
+      : ThreadManager("BlockingThreadManager", rq, 1, 1) {}
+
+  WorkStatus PollForWork(void** tag, bool* ok) override {
+    *tag = nullptr;
+    *ok = true;
+    int call_num = num_poll_for_work_.fetch_add(1);
+    if (call_num < 2) return WORK_FOUND;
+    if (second_done_.load()) {
+      Shutdown();
+      return SHUTDOWN;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return TIMEOUT;
+  }
+
+  void DoWork(void* /*tag*/, bool /*ok*/, bool /*resources*/) override {
+    if (num_do_work_.fetch_add(1) == 0) {
+      // Bounded, so that a regression fails the test rather than hanging it.
+      auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (!second_done_.load() &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      first_saw_second_done_ = second_done_.load();
+    } else {
+      second_done_.store(true);
+    }
+  }
+
+  bool first_saw_second_done() const { return first_saw_second_done_; }
+
+ private:
+  std::atomic_int num_poll_for_work_{0};
+  std::atomic_int num_do_work_{0};
+  std::atomic_bool second_done_{false};
+  bool first_saw_second_done_ = false;
+};
+
+TEST(ThreadManagerFixedThreadTest, LongRunningWorkDoesNotBlockPolling) {
+  grpc_resource_quota* rq = grpc_resource_quota_create("Thread manager test");
+  BlockingThreadManager tm(rq);
+  grpc_resource_quota_unref(rq);
+  tm.UseFixedPinnedThread(0);
+  tm.Initialize();
+  tm.Wait();
+  EXPECT_TRUE(tm.first_saw_second_done());
+  EXPECT_EQ(tm.GetMaxActiveThreadsSoFar(),
+            1 + grpc::ThreadManager::kMaxOverflowPollers);
+}
+
 }  // namespace
 }  // namespace grpc
 
@@ -30,6 +30,12 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_server_calls_created"] = massage_qps_stats_helpers.counter(
                     core_stats, "server_calls_created")
+            stats[
+                "core_call_arena_pool_hits"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_arena_pool_hits")
+            stats[
+                "core_call_arena_pool_misses"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_arena_pool_misses")
             stats["core_cqs_created"] = massage_qps_stats_helpers.counter(
                 core_stats, "cqs_created")
             stats[
@@ -284,6 +290,15 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_call_combiner_cancelled"] = massage_qps_stats_helpers.counter(
                     core_stats, "call_combiner_cancelled")
+            stats[
+                "core_call_combiner_contended_starts"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_combiner_contended_starts")
+            stats[
+                "core_call_combiner_inline_executions"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_combiner_inline_executions")
+            stats[
+                "core_call_combiner_inline_depth_exceeded"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_combiner_inline_depth_exceeded")
             stats[
                 "core_executor_scheduled_short_items"] = massage_qps_stats_helpers.counter(
                     core_stats, "executor_scheduled_short_items")
@@ -308,6 +323,12 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_server_slowpath_requests_queued"] = massage_qps_stats_helpers.counter(
                     core_stats, "server_slowpath_requests_queued")
+            stats[
+                "core_server_queue_delay_shed_calls"] = massage_qps_stats_helpers.counter(
+                    core_stats, "server_queue_delay_shed_calls")
+            stats[
+                "core_server_expired_pending_calls"] = massage_qps_stats_helpers.counter(
+                    core_stats, "server_expired_pending_calls")
             stats[
                 "core_cq_ev_queue_trylock_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_trylock_failures")
@@ -317,6 +338,12 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_cq_ev_queue_transient_pop_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_transient_pop_failures")
+            stats[
+                "core_work_serializer_items_queued"] = massage_qps_stats_helpers.counter(
+                    core_stats, "work_serializer_items_queued")
+            stats[
+                "core_work_serializer_drain_batches"] = massage_qps_stats_helpers.counter(
+                    core_stats, "work_serializer_drain_batches")
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "call_initial_size")
             stats["core_call_initial_size"] = ",".join(
@@ -509,3 +536,18 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_server_cqs_checked_99p"] = massage_qps_stats_helpers.percentile(
                     h.buckets, 99, h.boundaries)
+            h = massage_qps_stats_helpers.histogram(
+                core_stats, "work_serializer_queue_depth")
+            stats["core_work_serializer_queue_depth"] = ",".join(
+                "%f" % x for x in h.buckets)
+            stats["core_work_serializer_queue_depth_bkts"] = ",".join(
+                "%f" % x for x in h.boundaries)
+            stats[
+                "core_work_serializer_queue_depth_50p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 50, h.boundaries)
+            stats[
+                "core_work_serializer_queue_depth_95p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 95, h.boundaries)
+            stats[
+                "core_work_serializer_queue_depth_99p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 99, h.boundaries)
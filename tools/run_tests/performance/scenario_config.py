@@ -135,7 +135,8 @@ def _ping_pong_scenario(name,
                         messages_per_stream=None,
                         excluded_poll_engines=[],
                         minimal_stack=False,
-                        offered_load=None):
+                        offered_load=None,
+                        sync_server_thread_per_core=False):
     """Creates a basic ping pong scenario."""
     scenario = {
         'name': name,
@@ -166,6 +167,10 @@ def _ping_pong_scenario(name,
     }
     if resource_quota_size:
         scenario['server_config']['resource_quota_size'] = resource_quota_size
+    if sync_server_thread_per_core:
+        if server_type != 'SYNC_SERVER':
+            raise Exception('Thread per core is only for SYNC_SERVER.')
+        scenario['server_config']['sync_server_thread_per_core'] = True
     if use_generic_payload:
         if server_type != 'ASYNC_GENERIC_SERVER':
             raise Exception('Use ASYNC_GENERIC_SERVER for generic payload.')
@@ -472,6 +477,20 @@ class CXXLanguage:
                 categories=smoketest_categories + inproc_categories +
                 [SCALABLE])
 
+            # Same load, with the sync server polling one completion queue
+            # per core from a single pinned thread.
+            yield _ping_pong_scenario(
+                'cpp_protobuf_async_client_sync_server_unary_qps_unconstrained_thread_per_core_%s'
+                % secstr,
+                rpc_type='UNARY',
+                client_type='ASYNC_CLIENT',
+                server_type='SYNC_SERVER',
+                unconstrained_client='async',
+                secure=secure,
+                minimal_stack=not secure,
+                sync_server_thread_per_core=True,
+                categories=[SCALABLE])
+
             yield _ping_pong_scenario(
                 'cpp_protobuf_async_client_unary_1channel_64wide_128Breq_8MBresp_%s'
                 % (secstr),
@@ -498,6 +517,20 @@ class CXXLanguage:
                 categories=smoketest_categories + inproc_categories +
                 [SCALABLE])
 
+            # Same load, with the sync server polling one completion queue
+            # per core from a single pinned thread.
+            yield _ping_pong_scenario(
+                'cpp_protobuf_async_client_sync_server_streaming_qps_unconstrained_thread_per_core_%s'
+                % secstr,
+                rpc_type='STREAMING',
+                client_type='ASYNC_CLIENT',
+                server_type='SYNC_SERVER',
+                unconstrained_client='async',
+                secure=secure,
+                minimal_stack=not secure,
+                sync_server_thread_per_core=True,
+                categories=[SCALABLE])
+
             yield _ping_pong_scenario(
                 'cpp_protobuf_async_unary_ping_pong_%s_1MB' % secstr,
                 rpc_type='UNARY',